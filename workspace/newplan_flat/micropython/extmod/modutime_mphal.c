@@ -66,6 +66,19 @@ STATIC mp_obj_t mod_utime_ticks_cpu(void) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(mod_utime_ticks_cpu_obj, mod_utime_ticks_cpu);
 
+// --- ticks_ns() ---
+STATIC mp_obj_t mod_utime_ticks_ns(void) {
+    return mp_obj_new_int_from_uint(mp_hal_ticks_ns());
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mod_utime_ticks_ns_obj, mod_utime_ticks_ns);
+
+// --- monotonic_ns() ---
+// 64 位，不回绕；两次调用之差即为经过的纳秒数
+STATIC mp_obj_t mod_utime_monotonic_ns(void) {
+    return mp_obj_new_int_from_ull(mp_hal_monotonic_ns());
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mod_utime_monotonic_ns_obj, mod_utime_monotonic_ns);
+
 // --- ticks_diff(end, start) ---
 // Calculate the difference between two ticks values, handling wrap-around
 STATIC mp_obj_t mod_utime_ticks_diff(mp_obj_t end_in, mp_obj_t start_in) {
@@ -87,6 +100,8 @@ STATIC const mp_rom_map_elem_t mp_module_utime_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_ticks_ms),   MP_ROM_PTR(&mod_utime_ticks_ms_obj) },
     { MP_ROM_QSTR(MP_QSTR_ticks_us),   MP_ROM_PTR(&mod_utime_ticks_us_obj) },
     { MP_ROM_QSTR(MP_QSTR_ticks_cpu),  MP_ROM_PTR(&mod_utime_ticks_cpu_obj) },
+    { MP_ROM_QSTR(MP_QSTR_ticks_ns),   MP_ROM_PTR(&mod_utime_ticks_ns_obj) },
+    { MP_ROM_QSTR(MP_QSTR_monotonic_ns), MP_ROM_PTR(&mod_utime_monotonic_ns_obj) },
     { MP_ROM_QSTR(MP_QSTR_ticks_diff), MP_ROM_PTR(&mod_utime_ticks_diff_obj) },
 };
 
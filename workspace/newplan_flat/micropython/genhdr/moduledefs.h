@@ -1,4 +1,8 @@
 // Manually created module definitions header
+extern const struct _mp_obj_module_t mp_module_builtins;
+#undef MODULE_DEF_BUILTINS
+#define MODULE_DEF_BUILTINS { MP_ROM_QSTR(MP_QSTR_builtins), MP_ROM_PTR(&mp_module_builtins) },
+
 extern const struct _mp_obj_module_t mp_module_gc;
 #undef MODULE_DEF_GC
 #define MODULE_DEF_GC { MP_ROM_QSTR(MP_QSTR_gc), MP_ROM_PTR(&mp_module_gc) },
@@ -7,14 +11,25 @@ extern const struct _mp_obj_module_t mp_module_machine;
 #undef MODULE_DEF_MACHINE
 #define MODULE_DEF_MACHINE { MP_ROM_QSTR(MP_QSTR_machine), MP_ROM_PTR(&mp_module_machine) },
 
+extern const struct _mp_obj_module_t mp_module_micropython;
+#undef MODULE_DEF_MICROPYTHON
+#define MODULE_DEF_MICROPYTHON { MP_ROM_QSTR(MP_QSTR_micropython), MP_ROM_PTR(&mp_module_micropython) },
+
+extern const struct _mp_obj_module_t mp_module_sys;
+#undef MODULE_DEF_SYS
+#define MODULE_DEF_SYS { MP_ROM_QSTR(MP_QSTR_sys), MP_ROM_PTR(&mp_module_sys) },
+
 extern const struct _mp_obj_module_t mp_module_utime;
 #undef MODULE_DEF_UTIME
 #define MODULE_DEF_UTIME { MP_ROM_QSTR(MP_QSTR_utime), MP_ROM_PTR(&mp_module_utime) },
 
 #define MICROPY_REGISTERED_MODULES \
+    MODULE_DEF_BUILTINS \
     MODULE_DEF_GC \
     MODULE_DEF_MACHINE \
+    MODULE_DEF_MICROPYTHON \
+    MODULE_DEF_SYS \
     MODULE_DEF_UTIME \
 // MICROPY_REGISTERED_MODULES
 
-#define MICROPY_HAVE_REGISTERED_EXTENSIBLE_MODULES 0
\ No newline at end of file
+#define MICROPY_HAVE_REGISTERED_EXTENSIBLE_MODULES 0
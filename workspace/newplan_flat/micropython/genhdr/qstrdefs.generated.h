@@ -183,6 +183,7 @@ QDEF1(MP_QSTR__lt_stdin_gt_, 25571, 7, "<stdin>")
 QDEF1(MP_QSTR__lt_string_gt_, 21330, 8, "<string>")
 QDEF1(MP_QSTR__gt__gt__gt__space_, 44187, 4, ">>> ")
 QDEF1(MP_QSTR_ADC, 46691, 3, "ADC")
+QDEF1(MP_QSTR_ADCBlock, 12330, 8, "ADCBlock")
 QDEF1(MP_QSTR_ALT, 46972, 3, "ALT")
 QDEF1(MP_QSTR_ALT_OPEN_DRAIN, 60408, 14, "ALT_OPEN_DRAIN")
 QDEF1(MP_QSTR_ANALOG, 62127, 6, "ANALOG")
@@ -197,6 +198,7 @@ QDEF1(MP_QSTR_BFUINT8, 44991, 7, "BFUINT8")
 QDEF1(MP_QSTR_BF_LEN, 45081, 6, "BF_LEN")
 QDEF1(MP_QSTR_BF_POS, 40274, 6, "BF_POS")
 QDEF1(MP_QSTR_BIG_ENDIAN, 20991, 10, "BIG_ENDIAN")
+QDEF1(MP_QSTR_BULK, 22549, 4, "BULK")
 QDEF1(MP_QSTR_BytesIO, 46874, 7, "BytesIO")
 QDEF1(MP_QSTR_CORE_TEMP, 22733, 9, "CORE_TEMP")
 QDEF1(MP_QSTR_CORE_VREF, 22534, 9, "CORE_VREF")
@@ -232,6 +234,7 @@ QDEF1(MP_QSTR_EOPNOTSUPP, 38828, 10, "EOPNOTSUPP")
 QDEF1(MP_QSTR_EPERM, 32746, 5, "EPERM")
 QDEF1(MP_QSTR_ETIMEDOUT, 63743, 9, "ETIMEDOUT")
 QDEF1(MP_QSTR_ExtInt, 23679, 6, "ExtInt")
+QDEF1(MP_QSTR_FAST, 62565, 4, "FAST")
 QDEF1(MP_QSTR_FLOAT32, 34740, 7, "FLOAT32")
 QDEF1(MP_QSTR_FLOAT64, 34583, 7, "FLOAT64")
 QDEF1(MP_QSTR_FileIO, 5573, 6, "FileIO")
@@ -262,6 +265,7 @@ QDEF1(MP_QSTR_LED1, 28089, 4, "LED1")
 QDEF1(MP_QSTR_LITTLE_ENDIAN, 23487, 13, "LITTLE_ENDIAN")
 QDEF1(MP_QSTR_LONG, 25871, 4, "LONG")
 QDEF1(MP_QSTR_LONGLONG, 54405, 8, "LONGLONG")
+QDEF1(MP_QSTR_LOOP, 25913, 4, "LOOP")
 QDEF1(MP_QSTR_LSB, 57048, 3, "LSB")
 QDEF1(MP_QSTR_MONO_HLSB, 38988, 9, "MONO_HLSB")
 QDEF1(MP_QSTR_MONO_HMSB, 33741, 9, "MONO_HMSB")
@@ -271,6 +275,7 @@ QDEF1(MP_QSTR_MVLSB, 5123, 5, "MVLSB")
 QDEF1(MP_QSTR_NATIVE, 36356, 6, "NATIVE")
 QDEF1(MP_QSTR_None, 53615, 4, "None")
 QDEF1(MP_QSTR_NotImplemented, 50750, 14, "NotImplemented")
+QDEF1(MP_QSTR_ONESHOT, 2913, 7, "ONESHOT")
 QDEF1(MP_QSTR_ONE_SHOT, 65374, 8, "ONE_SHOT")
 QDEF1(MP_QSTR_OPEN_DRAIN, 18526, 10, "OPEN_DRAIN")
 QDEF1(MP_QSTR_OUT, 58123, 3, "OUT")
@@ -428,6 +433,7 @@ QDEF1(MP_QSTR_PULL_NONE, 46421, 9, "PULL_NONE")
 QDEF1(MP_QSTR_PULL_UP, 24250, 7, "PULL_UP")
 QDEF1(MP_QSTR_PWRON_RESET, 52187, 11, "PWRON_RESET")
 QDEF1(MP_QSTR_Pin, 5138, 3, "Pin")
+QDEF1(MP_QSTR_Port, 40252, 4, "Port")
 QDEF1(MP_QSTR_RAW, 1793, 3, "RAW")
 QDEF1(MP_QSTR_RGB565, 52324, 6, "RGB565")
 QDEF1(MP_QSTR_RTC, 1184, 3, "RTC")
@@ -438,6 +444,7 @@ QDEF1(MP_QSTR_SHORT, 7159, 5, "SHORT")
 QDEF1(MP_QSTR_SOFT_RESET, 50689, 10, "SOFT_RESET")
 QDEF1(MP_QSTR_SPI, 4591, 3, "SPI")
 QDEF1(MP_QSTR_SW1, 4400, 3, "SW1")
+QDEF1(MP_QSTR_SensorStream, 20111, 12, "SensorStream")
 QDEF1(MP_QSTR_Signal, 58523, 6, "Signal")
 QDEF1(MP_QSTR_SoftI2C, 61971, 7, "SoftI2C")
 QDEF1(MP_QSTR_SoftSPI, 22561, 7, "SoftSPI")
@@ -546,6 +553,9 @@ QDEF1(MP_QSTR_addressof, 63834, 9, "addressof")
 QDEF1(MP_QSTR_addrsize, 37267, 8, "addrsize")
 QDEF1(MP_QSTR_align, 64424, 5, "align")
 QDEF1(MP_QSTR_alloc_emergency_exception_buf, 10872, 29, "alloc_emergency_exception_buf")
+QDEF1(MP_QSTR_alloc_hint, 52972, 10, "alloc_hint")
+QDEF1(MP_QSTR_alloc_sites, 4591, 11, "alloc_sites")
+QDEF1(MP_QSTR_alloc_stats, 44918, 11, "alloc_stats")
 QDEF1(MP_QSTR_alt, 13148, 3, "alt")
 QDEF1(MP_QSTR_and_, 38033, 4, "and_")
 QDEF1(MP_QSTR_appendleft, 7856, 10, "appendleft")
@@ -565,13 +575,16 @@ QDEF1(MP_QSTR_baudrate, 55541, 8, "baudrate")
 QDEF1(MP_QSTR_bin, 18656, 3, "bin")
 QDEF1(MP_QSTR_binascii, 15505, 8, "binascii")
 QDEF1(MP_QSTR_bits, 26697, 4, "bits")
+QDEF1(MP_QSTR_bitstream, 5542, 9, "bitstream")
 QDEF1(MP_QSTR_bl, 28363, 2, "bl")
 QDEF1(MP_QSTR_blit, 20726, 4, "blit")
 QDEF1(MP_QSTR_board, 54399, 5, "board")
 QDEF1(MP_QSTR_bootloader, 61410, 10, "bootloader")
 QDEF1(MP_QSTR_bound_method, 41623, 12, "bound_method")
+QDEF1(MP_QSTR_buf, 18804, 3, "buf")
 QDEF1(MP_QSTR_buffer, 41189, 6, "buffer")
 QDEF1(MP_QSTR_buffering, 56101, 9, "buffering")
+QDEF1(MP_QSTR_bus, 18785, 3, "bus")
 QDEF1(MP_QSTR_bx, 28383, 2, "bx")
 QDEF1(MP_QSTR_bytearray_at, 23708, 12, "bytearray_at")
 QDEF1(MP_QSTR_byteorder, 39265, 9, "byteorder")
@@ -580,8 +593,10 @@ QDEF1(MP_QSTR_calcsize, 14413, 8, "calcsize")
 QDEF1(MP_QSTR_calibration, 13231, 11, "calibration")
 QDEF1(MP_QSTR_callback, 61516, 8, "callback")
 QDEF1(MP_QSTR_cancel, 34563, 6, "cancel")
+QDEF1(MP_QSTR_capture_pulses, 16306, 14, "capture_pulses")
 QDEF1(MP_QSTR_ceil, 45062, 4, "ceil")
 QDEF1(MP_QSTR_center, 48974, 6, "center")
+QDEF1(MP_QSTR_channels, 46485, 8, "channels")
 QDEF1(MP_QSTR_chdir, 45745, 5, "chdir")
 QDEF1(MP_QSTR_choice, 13102, 6, "choice")
 QDEF1(MP_QSTR_closure, 51828, 7, "closure")
@@ -591,8 +606,11 @@ QDEF1(MP_QSTR_cmp, 19515, 3, "cmp")
 QDEF1(MP_QSTR_code, 55912, 4, "code")
 QDEF1(MP_QSTR_collect, 26011, 7, "collect")
 QDEF1(MP_QSTR_collections, 51424, 11, "collections")
+QDEF1(MP_QSTR_compact, 43330, 7, "compact")
+QDEF1(MP_QSTR_compact_threshold, 6698, 17, "compact_threshold")
 QDEF1(MP_QSTR_compile, 51700, 7, "compile")
 QDEF1(MP_QSTR_complex, 40389, 7, "complex")
+QDEF1(MP_QSTR_connect, 15835, 7, "connect")
 QDEF1(MP_QSTR_copysign, 5171, 8, "copysign")
 QDEF1(MP_QSTR_coro, 56244, 4, "coro")
 QDEF1(MP_QSTR_cos, 19578, 3, "cos")
@@ -602,6 +620,7 @@ QDEF1(MP_QSTR_cpsie, 51177, 5, "cpsie")
 QDEF1(MP_QSTR_cpu, 19907, 3, "cpu")
 QDEF1(MP_QSTR_crc32, 59510, 5, "crc32")
 QDEF1(MP_QSTR_crc8, 61391, 4, "crc8")
+QDEF1(MP_QSTR_cs, 28405, 2, "cs")
 QDEF1(MP_QSTR_cur_task, 11763, 8, "cur_task")
 QDEF1(MP_QSTR_data, 56341, 4, "data")
 QDEF1(MP_QSTR_datetime, 1252, 8, "datetime")
@@ -613,6 +632,7 @@ QDEF1(MP_QSTR_degrees, 16642, 7, "degrees")
 QDEF1(MP_QSTR_deinit, 36254, 6, "deinit")
 QDEF1(MP_QSTR_delattr, 51419, 7, "delattr")
 QDEF1(MP_QSTR_deleter, 56174, 7, "deleter")
+QDEF1(MP_QSTR_depth, 31976, 5, "depth")
 QDEF1(MP_QSTR_deque, 39173, 5, "deque")
 QDEF1(MP_QSTR_dht_readinto, 25324, 12, "dht_readinto")
 QDEF1(MP_QSTR_dict_view, 43309, 9, "dict_view")
@@ -676,6 +696,7 @@ QDEF1(MP_QSTR_handler, 24029, 7, "handler")
 QDEF1(MP_QSTR_hard, 28890, 4, "hard")
 QDEF1(MP_QSTR_hashlib, 27920, 7, "hashlib")
 QDEF1(MP_QSTR_heap_lock, 36013, 9, "heap_lock")
+QDEF1(MP_QSTR_heap_map, 2202, 8, "heap_map")
 QDEF1(MP_QSTR_heap_unlock, 11606, 11, "heap_unlock")
 QDEF1(MP_QSTR_heapify, 11695, 7, "heapify")
 QDEF1(MP_QSTR_heappop, 10198, 7, "heappop")
@@ -687,9 +708,12 @@ QDEF1(MP_QSTR_hexlify, 32554, 7, "hexlify")
 QDEF1(MP_QSTR_high, 19499, 4, "high")
 QDEF1(MP_QSTR_hline, 15491, 5, "hline")
 QDEF1(MP_QSTR_idle, 56481, 4, "idle")
+QDEF1(MP_QSTR_idle_stats, 20799, 10, "idle_stats")
 QDEF1(MP_QSTR_ilistdir, 27249, 8, "ilistdir")
 QDEF1(MP_QSTR_imag, 46919, 4, "imag")
 QDEF1(MP_QSTR_implementation, 11543, 14, "implementation")
+QDEF1(MP_QSTR_incremental, 61129, 11, "incremental")
+QDEF1(MP_QSTR_incremental_stats, 50967, 17, "incremental_stats")
 QDEF1(MP_QSTR_indices, 18522, 7, "indices")
 QDEF1(MP_QSTR_inf, 21252, 3, "inf")
 QDEF1(MP_QSTR_info, 46059, 4, "info")
@@ -737,6 +761,7 @@ QDEF1(MP_QSTR_low, 16177, 3, "low")
 QDEF1(MP_QSTR_lsl, 16822, 3, "lsl")
 QDEF1(MP_QSTR_lsr, 16808, 3, "lsr")
 QDEF1(MP_QSTR_machine, 43872, 7, "machine")
+QDEF1(MP_QSTR_mask, 47761, 4, "mask")
 QDEF1(MP_QSTR_match, 8854, 5, "match")
 QDEF1(MP_QSTR_math, 47925, 4, "math")
 QDEF1(MP_QSTR_max, 17329, 3, "max")
@@ -761,6 +786,7 @@ QDEF1(MP_QSTR_modf, 49189, 4, "modf")
 QDEF1(MP_QSTR_modify, 26357, 6, "modify")
 QDEF1(MP_QSTR_module, 39359, 6, "module")
 QDEF1(MP_QSTR_modules, 53740, 7, "modules")
+QDEF1(MP_QSTR_monotonic_ns, 38715, 12, "monotonic_ns")
 QDEF1(MP_QSTR_mosi, 49693, 4, "mosi")
 QDEF1(MP_QSTR_mount, 3496, 5, "mount")
 QDEF1(MP_QSTR_mov, 17393, 3, "mov")
@@ -779,9 +805,12 @@ QDEF1(MP_QSTR_oct, 23805, 3, "oct")
 QDEF1(MP_QSTR_off, 23690, 3, "off")
 QDEF1(MP_QSTR_on, 28516, 2, "on")
 QDEF1(MP_QSTR_onewire, 64552, 7, "onewire")
+QDEF1(MP_QSTR_opcode_stats, 51401, 12, "opcode_stats")
+QDEF1(MP_QSTR_ops, 24265, 3, "ops")
 QDEF1(MP_QSTR_opt, 24270, 3, "opt")
 QDEF1(MP_QSTR_opt_level, 26503, 9, "opt_level")
 QDEF1(MP_QSTR_os, 28537, 2, "os")
+QDEF1(MP_QSTR_overruns, 37969, 8, "overruns")
 QDEF1(MP_QSTR_pack, 53692, 4, "pack")
 QDEF1(MP_QSTR_pack_into, 43295, 9, "pack_into")
 QDEF1(MP_QSTR_parity, 1346, 6, "parity")
@@ -796,13 +825,18 @@ QDEF1(MP_QSTR_pi, 28700, 2, "pi")
 QDEF1(MP_QSTR_pin, 29682, 3, "pin")
 QDEF1(MP_QSTR_pixel, 61517, 5, "pixel")
 QDEF1(MP_QSTR_platform, 6458, 8, "platform")
+QDEF1(MP_QSTR_playing, 53345, 7, "playing")
 QDEF1(MP_QSTR_polar, 3077, 5, "polar")
 QDEF1(MP_QSTR_polarity, 60737, 8, "polarity")
 QDEF1(MP_QSTR_poll, 55706, 4, "poll")
 QDEF1(MP_QSTR_poly, 55695, 4, "poly")
 QDEF1(MP_QSTR_popleft, 39537, 7, "popleft")
+QDEF1(MP_QSTR_port, 55388, 4, "port")
 QDEF1(MP_QSTR_preview, 54767, 7, "preview")
 QDEF1(MP_QSTR_print_exception, 8732, 15, "print_exception")
+QDEF1(MP_QSTR_profile_dump, 38461, 12, "profile_dump")
+QDEF1(MP_QSTR_profile_start, 40913, 13, "profile_start")
+QDEF1(MP_QSTR_profile_stop, 49097, 12, "profile_stop")
 QDEF1(MP_QSTR_property, 10690, 8, "property")
 QDEF1(MP_QSTR_ps1, 28919, 3, "ps1")
 QDEF1(MP_QSTR_ps2, 28916, 3, "ps2")
@@ -812,6 +846,9 @@ QDEF1(MP_QSTR_ptr32, 51890, 5, "ptr32")
 QDEF1(MP_QSTR_ptr8, 31371, 4, "ptr8")
 QDEF1(MP_QSTR_pull, 32128, 4, "pull")
 QDEF1(MP_QSTR_push, 32443, 4, "push")
+QDEF1(MP_QSTR_pystack_space_exhausted, 42021, 17, "pystack exhausted")
+QDEF1(MP_QSTR_pystack_stats, 36956, 13, "pystack_stats")
+QDEF1(MP_QSTR_pystack_use, 16894, 11, "pystack_use")
 QDEF1(MP_QSTR_python_compiler, 38285, 15, "python_compiler")
 QDEF1(MP_QSTR_qstr_info, 33200, 9, "qstr_info")
 QDEF1(MP_QSTR_r, 46551, 1, "r")
@@ -823,6 +860,8 @@ QDEF1(MP_QSTR_rb, 28885, 2, "rb")
 QDEF1(MP_QSTR_rbit, 61160, 4, "rbit")
 QDEF1(MP_QSTR_re, 28882, 2, "re")
 QDEF1(MP_QSTR_read_buf_len, 2465, 12, "read_buf_len")
+QDEF1(MP_QSTR_read_multi, 50369, 10, "read_multi")
+QDEF1(MP_QSTR_read_timed, 65273, 10, "read_timed")
 QDEF1(MP_QSTR_read_u16, 44762, 8, "read_u16")
 QDEF1(MP_QSTR_readbit, 20232, 7, "readbit")
 QDEF1(MP_QSTR_readblocks, 7213, 10, "readblocks")
@@ -831,10 +870,12 @@ QDEF1(MP_QSTR_readchar, 37615, 8, "readchar")
 QDEF1(MP_QSTR_readfrom, 45377, 8, "readfrom")
 QDEF1(MP_QSTR_readfrom_into, 16258, 13, "readfrom_into")
 QDEF1(MP_QSTR_readfrom_mem, 25915, 12, "readfrom_mem")
+QDEF1(MP_QSTR_readfrom_mem_batch, 15992, 18, "readfrom_mem_batch")
 QDEF1(MP_QSTR_readfrom_mem_into, 36408, 17, "readfrom_mem_into")
 QDEF1(MP_QSTR_readlines, 22890, 9, "readlines")
 QDEF1(MP_QSTR_readonly, 35075, 8, "readonly")
 QDEF1(MP_QSTR_real, 63935, 4, "real")
+QDEF1(MP_QSTR_record_size, 59282, 11, "record_size")
 QDEF1(MP_QSTR_rect, 63973, 4, "rect")
 QDEF1(MP_QSTR_register, 41388, 8, "register")
 QDEF1(MP_QSTR_regs, 64102, 4, "regs")
@@ -850,6 +891,7 @@ QDEF1(MP_QSTR_rpartition, 53269, 10, "rpartition")
 QDEF1(MP_QSTR_rxbuf, 26494, 5, "rxbuf")
 QDEF1(MP_QSTR_scan, 36378, 4, "scan")
 QDEF1(MP_QSTR_schedule, 44256, 8, "schedule")
+QDEF1(MP_QSTR_schedule_stats, 36606, 14, "schedule_stats")
 QDEF1(MP_QSTR_sck, 36862, 3, "sck")
 QDEF1(MP_QSTR_scl, 36857, 3, "scl")
 QDEF1(MP_QSTR_scroll, 23080, 6, "scroll")
@@ -874,9 +916,11 @@ QDEF1(MP_QSTR_slice, 62645, 5, "slice")
 QDEF1(MP_QSTR_soft_reset, 26081, 10, "soft_reset")
 QDEF1(MP_QSTR_splitlines, 54122, 10, "splitlines")
 QDEF1(MP_QSTR_sqrt, 17441, 4, "sqrt")
+QDEF1(MP_QSTR_stack_peak, 19051, 10, "stack_peak")
 QDEF1(MP_QSTR_stack_use, 63383, 9, "stack_use")
 QDEF1(MP_QSTR_stat, 13783, 4, "stat")
 QDEF1(MP_QSTR_state, 61650, 5, "state")
+QDEF1(MP_QSTR_stats, 61636, 5, "stats")
 QDEF1(MP_QSTR_statvfs, 6420, 7, "statvfs")
 QDEF1(MP_QSTR_stderr, 22691, 6, "stderr")
 QDEF1(MP_QSTR_stdin, 1057, 5, "stdin")
@@ -903,6 +947,7 @@ QDEF1(MP_QSTR_ticks_add, 44701, 9, "ticks_add")
 QDEF1(MP_QSTR_ticks_cpu, 42266, 9, "ticks_cpu")
 QDEF1(MP_QSTR_ticks_diff, 57521, 10, "ticks_diff")
 QDEF1(MP_QSTR_ticks_ms, 12866, 8, "ticks_ms")
+QDEF1(MP_QSTR_ticks_ns, 12833, 8, "ticks_ns")
 QDEF1(MP_QSTR_ticks_us, 12634, 8, "ticks_us")
 QDEF1(MP_QSTR_time, 49648, 4, "time")
 QDEF1(MP_QSTR_time_ns, 45682, 7, "time_ns")
@@ -910,6 +955,10 @@ QDEF1(MP_QSTR_time_pulse_us, 3209, 13, "time_pulse_us")
 QDEF1(MP_QSTR_timeout, 21566, 7, "timeout")
 QDEF1(MP_QSTR_timeout_char, 19065, 12, "timeout_char")
 QDEF1(MP_QSTR_toggle, 17335, 6, "toggle")
+QDEF1(MP_QSTR_trace, 17316, 5, "trace")
+QDEF1(MP_QSTR_trace_dump, 26199, 10, "trace_dump")
+QDEF1(MP_QSTR_trace_start, 22011, 11, "trace_start")
+QDEF1(MP_QSTR_trace_stop, 24291, 10, "trace_stop")
 QDEF1(MP_QSTR_trigger, 35997, 7, "trigger")
 QDEF1(MP_QSTR_trunc, 39259, 5, "trunc")
 QDEF1(MP_QSTR_txdone, 65481, 6, "txdone")
@@ -946,6 +995,7 @@ QDEF1(MP_QSTR_wakeup, 12920, 6, "wakeup")
 QDEF1(MP_QSTR_wfi, 32413, 3, "wfi")
 QDEF1(MP_QSTR_write_paren_close_Q_paren_open_ADC, 64942, 11, "write)Q(ADC")
 QDEF1(MP_QSTR_write_readinto, 33929, 14, "write_readinto")
+QDEF1(MP_QSTR_write_timed, 20374, 11, "write_timed")
 QDEF1(MP_QSTR_writebit, 42439, 8, "writebit")
 QDEF1(MP_QSTR_writeblocks, 57090, 11, "writeblocks")
 QDEF1(MP_QSTR_writebyte, 7890, 9, "writebyte")
@@ -18,5 +18,29 @@ const char *readline_hist[MICROPY_READLINE_HISTORY_SIZE];
 #endif
 
 #if MICROPY_ENABLE_SCHEDULER
-mp_sched_item_t sched_queue[MICROPY_SCHEDULER_DEPTH];
+mp_sched_item_t sched_queue[MICROPY_SCHEDULER_PRIORITIES][MICROPY_SCHEDULER_DEPTH];
 #endif
+
+#if MICROPY_PY_MICROPYTHON_PROFILE
+uintptr_t * sampleprof_buf;
+#endif
+
+#if MICROPY_GC_ALLOC_SITES
+const void * gc_site_where[MICROPY_GC_ALLOC_SITES_MAX];
+#endif
+
+#if MICROPY_COMP_ARENA
+struct _mp_comp_arena_chunk_t * comp_arena;
+#endif
+
+void * machine_sensor_stream_active[MICROPY_HW_SENSOR_STREAM_MAX];
+
+void * machine_adc_block_active[2];
+
+void * machine_dac_timed[2];
+
+void * machine_pin_irq_ctx[16];
+
+void * machine_timer_wheel[256];
+
+void * machine_timer_hw[MICROPY_HW_TIMER_NUM];
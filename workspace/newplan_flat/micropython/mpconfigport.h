@@ -10,6 +10,7 @@ int mp_hal_get_interrupt_char(void);
 #ifndef MICROPY_INCLUDED_RA8D1_MPCONFIGPORT_H
 #define MICROPY_INCLUDED_RA8D1_MPCONFIGPORT_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <alloca.h>
 
@@ -51,6 +52,21 @@ int mp_hal_get_interrupt_char(void);
 #define MICROPY_HW_MAX_UART                        (2)
 #define MICROPY_HW_MAX_LPUART                      (0)
 
+// machine.SensorStream：同时运行的传感器流数量（ISR 持有的对象登记在 root pointer 里）
+#define MICROPY_HW_SENSOR_STREAM_MAX               (4)
+
+// machine.ADCBlock：ADC0 用 GPT0、ADC1 用 GPT1 作为采样节拍（32 位通道）
+#define MICROPY_HW_ADC_BLOCK_GPT_CH(unit)          (unit)
+
+// DAC.write_timed：DAC0 用 GPT2、DAC1 用 GPT3 作为输出节拍
+#define MICROPY_HW_DAC_TIMED_GPT_CH(ch)            (2 + (ch))
+
+// machine.Timer：Timer(0) ~ Timer(4) 用 GPT8 ~ GPT12（16 位，自动选择预分频，超长周期由 ISR 计数分频），
+// 软件定时器 Timer(-1) 共用 GPT13 的 1kHz 节拍驱动分层时间轮
+#define MICROPY_HW_TIMER_NUM                       (5)
+#define MICROPY_HW_TIMER_GPT_CH(id)                (8 + (id))
+#define MICROPY_HW_TIMER_WHEEL_GPT_CH              (13)
+
 // ---------------------------------------------------------------------------
 
 // --- Core features we want ON ---
@@ -63,8 +79,76 @@ int mp_hal_get_interrupt_char(void);
 #define MICROPY_PY_GC                     (1)
 #define MICROPY_ENABLE_GC                 (1)
 
+// 多区域堆（hal_entry.c 初始化）：DTCM 顶端（零等待）+ 片上 SRAM 主堆 + 外部 SDRAM
+// 分配按大小放置：>= MICROPY_GC_BULK_THRESHOLD 字节的缓冲区优先放 SDRAM，其余（map、tuple、代码状态等）
+// 优先放 DTCM / SRAM；首选区域放不下时先用另一类区域，再触发 GC。gc.alloc_hint() 可临时指定
+// DTCM 区域带 GC_AREA_TCM 标记：机器码和 DTC 用到的内存（GC_ALLOC_FLAG_NO_TCM）不放在那里，
+// BULK 请求回退时也只回退到 SRAM
+#define MICROPY_GC_SPLIT_HEAP             (1)
+#define MICROPY_GC_AREA_PLACEMENT         (1)
+#define MICROPY_GC_BULK_THRESHOLD         (1024)
+#define MICROPY_HW_DTCM_HEAP_SIZE         (64 * 1024)   // 上限：DTCM 低端留给 FSP 的 DTCM 段和 pystack（链接脚本），其余作为堆
+// 1~8 块的小对象从按大小分级的空闲链表分配（清扫时重建），不再逐字节扫描分配表
+#define MICROPY_GC_FREELISTS              (1)
+#define MICROPY_GC_FREELIST_DEPTH         (64)
+// 分配耗时采样：gc.alloc_stats() 返回最近 1024 次分配的 DWT 周期数，默认关闭
+#ifndef MICROPY_GC_ALLOC_STATS
+#define MICROPY_GC_ALLOC_STATS            (0)
+#endif
+#define MICROPY_GC_ALLOC_STATS_CYCLES()   (*(volatile uint32_t *)0xE0001004)   // DWT->CYCCNT
+// 分配点追踪：记录每个对象由哪个函数的哪一行（或哪个 C 调用者）分配，gc.alloc_sites() 按分配点
+// 和大小统计存活块，gc.heap_map() 导出分配表（tools/gc_heapmap.py 画碎片图）。每块多占 1 字节，默认关闭
+#ifndef MICROPY_GC_ALLOC_SITES
+#define MICROPY_GC_ALLOC_SITES            (0)
+#endif
+// 可移动缓冲区：>= 256 字节的 bytearray / array 数据区只被所属对象引用时，完整 GC 后若最大空闲段不足 4KB
+// （或放不下触发这次 GC 的分配），就把它们滑向低地址、合并出大块空闲（HMI 长时间反复分配图像 / IO 缓冲区）。
+// memoryview、C 栈、驱动对象（DAC / ADC 的 DTC 缓冲区、UART 发送中的缓冲区）里的指针会钉住缓冲区。
+// gc.compact() 立即整理，gc.compact_threshold() 调整阈值。
+// 每次搬移都关中断进行，超过 4KB 的缓冲区不移动，限制整理带来的中断延迟
+#ifndef MICROPY_GC_MOVABLE
+#define MICROPY_GC_MOVABLE                (1)
+#endif
+#define MICROPY_GC_MOVABLE_MAX_BYTES      (4 * 1024)
+// 增量 GC：sleep_ms 的空闲时间里分片标记 / 清扫（每片 200us），分配满 64KB 后开始一轮；
+// 标记期间有 Python 代码要运行（回调、延时结束）就作废本轮标记；gc.incremental() 调整
+#define MICROPY_GC_INCREMENTAL            (1)
+#define MICROPY_GC_INCREMENTAL_BUDGET_US  (200)
+#define MICROPY_GC_INCREMENTAL_TRIGGER    (64 * 1024)
+// EK-RA8D1 板载 64MB SDRAM：需要先在 FSP 配置中打开 SDRAM Support 并配置 SDRAM 引脚，再设为非 0
+#define MICROPY_HW_SDRAM_HEAP_SIZE        (0)
+
 #define MICROPY_PY_SYS                    (1)
 #define MICROPY_PY_MICROPYTHON            (1)
+#define MICROPY_PY_MICROPYTHON_MEM_INFO   (1)
+// micropython.stack_use() 返回当前 C 栈深度；stack_peak() 由启动时填充的栈水位返回最大深度
+#define MICROPY_PY_MICROPYTHON_STACK_USE  (1)
+#define MICROPY_PY_MICROPYTHON_STACK_PEAK (1)
+
+// pystack：函数调用的代码状态（mp_code_state_t）和临时参数数组按 LIFO 从 DTCM 中的专用区分配，
+// 不再走 C 栈 alloca / gc_alloc（大帧原来每次调用都从堆分配）。区域大小在 script/fsp.ld 里设置；
+// 放不下时改从堆分配并计数（不抛 RuntimeError），micropython.pystack_stats() 返回水位和溢出次数
+#define MICROPY_ENABLE_PYSTACK            (1)
+#define MICROPY_PYSTACK_HEAP_FALLBACK     (1)
+
+// 采样 profiler：SysTick（1kHz）调用 mp_sampleprof_tick()，记录当前字节码帧
+// 行号需要字节码里的行号表（也让异常回溯显示正确行号）
+#define MICROPY_PY_MICROPYTHON_PROFILE    (1)
+#define MICROPY_SAMPLEPROF_TICK_HZ        (1000)
+#define MICROPY_ENABLE_SOURCE_LINE        (1)
+
+// 字节码统计（插桩版 VM）：每个 opcode 的执行次数和 DWT 周期数，micropython.opcode_stats() 读取
+// 默认关闭；打开后每次分派多约 10 个周期
+#ifndef MICROPY_VM_OPCODE_STATS
+#define MICROPY_VM_OPCODE_STATS           (0)
+#endif
+#define MICROPY_VM_OPCODE_STATS_CYCLES()  (*(volatile uint32_t *)0xE0001004)   // DWT->CYCCNT
+
+// 事件追踪环：GC / 调度器 / pyexec / UART、SPI、引脚中断写入时间戳记录，micropython.trace_dump() 导出
+#define MICROPY_PY_MICROPYTHON_TRACE      (1)
+#define MICROPY_TRACE_RING_SIZE           (1024)   // 8 字节/条，必须是 2 的幂
+#define MICROPY_TRACE_TIMESTAMP()         (*(volatile uint32_t *)0xE0001004)   // DWT->CYCCNT
+#define MICROPY_TRACE_TIMESTAMP_HZ()      (SystemCoreClock)
 
 #define MICROPY_USE_INTERNAL_PRINTF       (0)   // use printf from C lib
 
@@ -77,6 +161,11 @@ int mp_hal_get_interrupt_char(void);
 // bytearray is ok to keep
 #define MICROPY_PY_BUILTINS_BYTEARRAY     (1)
 
+// 切片：test_bitstream.py 等测试脚本截取 / 解码字节缓冲时要用
+#define MICROPY_PY_BUILTINS_SLICE         (1)
+// bytes.hex()：trace_dump() / gc.heap_map() 以十六进制打印到串口，交给 tools/ 下的脚本解析
+#define MICROPY_PY_BUILTINS_BYTES_HEX     (1)
+
 // Disable builtin open(), we do not provide file objects yet
 #define MICROPY_PY_BUILTINS_OPEN          (0)
 
@@ -113,16 +202,38 @@ int mp_hal_get_interrupt_char(void);
 #define MICROPY_PY_BUILTINS_HELP_MODULES   (1)
 
 // --- Misc config ---
+// 对象表示只用 A（默认，float 是堆上的对象），float 基准见 test_float_bench.py。
+// 端口和核心代码在 C（2）/ D（3）下也能通过编译检查，但还没有跑过测试集和 float 基准，先不开放：
+// C 要求单精度 float；D 的 mp_obj_t 为 64 位，Thumb 原生发射器不支持，必须关闭 MICROPY_EMIT_THUMB
+#if defined(MICROPY_OBJ_REPR) && MICROPY_OBJ_REPR != 0
+#error "only MICROPY_OBJ_REPR_A has been verified on this port"
+#endif
 #define MICROPY_FLOAT_IMPL                (MICROPY_FLOAT_IMPL_DOUBLE)
 #define MICROPY_LONGINT_IMPL              (MICROPY_LONGINT_IMPL_LONGLONG)  \
     // Enable long long support for large integers (needed for ticks_cpu)
 
+// 原生代码发射器：@micropython.native / @micropython.viper（Cortex-M85 兼容 ARMv7-M Thumb-2）
+#define MICROPY_EMIT_THUMB                (1)
+#define MICROPY_EMIT_INLINE_THUMB         (0)
+#define MICROPY_MAKE_POINTER_CALLABLE(p)  ((void *)((uintptr_t)(p) | 1))
+
+// 机器码写在 GC 堆（数据 RAM）中，执行前需要让 I-Cache 失效（mp_hal_ra8d1.c）。
+// M85 不能从 DTCM 取指，机器码只能分配在 DTCM 以外的区域（mp_hal_alloc_exec）
+#define MP_PLAT_ALLOC_EXEC(min_size, ptr, size) do { *(ptr) = mp_hal_alloc_exec(min_size); *(size) = (min_size); } while (0)
+#define MP_PLAT_FREE_EXEC(ptr, size) m_del(byte, ptr, size)
+void *mp_hal_alloc_exec(size_t len);
+#define MP_PLAT_COMMIT_EXEC(buf, len, reloc) mp_hal_commit_exec(buf, len)
+void *mp_hal_commit_exec(void *buf, unsigned int len);
+
 #define MICROPY_ALLOC_PATH_MAX            (256)
 #define MICROPY_ALLOC_PARSE_CHUNK_INIT    (16)
+// 编译器临时内存（语法树、解析栈、作用域、字节码发射器）从 4KB 的 arena 块中顺序分配，
+// 编译结束（或出错）后整体释放，堆中只留下 raw code、字节码和常量，不再留下大量小空洞
+#ifndef MICROPY_COMP_ARENA
+#define MICROPY_COMP_ARENA                (1)
+#endif
 
-// Basic integer types
-typedef intptr_t  mp_int_t;
-typedef uintptr_t mp_uint_t;
+// Basic integer types（mp_int_t / mp_uint_t 由 py/mpconfig.h 按对象表示选择宽度）
 typedef long      mp_off_t;
 
 // Board name / MCU name
@@ -140,9 +251,19 @@ typedef long      mp_off_t;
 
 // Enable MicroPython scheduler for IRQ callbacks
 #define MICROPY_ENABLE_SCHEDULER (1)
+// 两个优先级：传感器类中断（引脚 IRQ、ADCBlock、DAC 波形）用 MP_SCHED_PRIO_HIGH，
+// 其余（micropython.schedule 默认、定时器）用 0；每级 32 项，突发中断时不丢回调
+#define MICROPY_SCHEDULER_DEPTH      (32)
+#define MICROPY_SCHEDULER_PRIORITIES (2)
 
 // Event poll hook: 让调度队列里的 callback 能在阻塞期间被执行
-// mp_handle_pending 在 py/runtime.h 里声明
-#define MICROPY_EVENT_POLL_HOOK   mp_handle_pending(true);
+// 先内联检查 sched_state / 挂起异常，没有待处理工作时不调用 mp_handle_pending
+// mp_handle_pending / mp_handle_pending_needed 在 py/runtime.h 里声明
+#define MICROPY_EVENT_POLL_HOOK \
+    do { \
+        if (mp_handle_pending_needed()) { \
+            mp_handle_pending(true); \
+        } \
+    } while (0);
 
 #endif // MICROPY_INCLUDED_RA8D1_MPCONFIGPORT_H
@@ -6,14 +6,45 @@
 #include "hal_data.h"
 #include "py/mpconfig.h"
 
+// 原子区：关中断并返回进入前的 PRIMASK，退出时恢复（可嵌套，可在中断中使用）。
+// 调度队列、定时轮等在中断和主循环之间共享的状态靠它保护；要在 py/mphal.h 的空默认定义之前给出
+static inline mp_uint_t ra_atomic_begin(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+#define MICROPY_BEGIN_ATOMIC_SECTION()     ra_atomic_begin()
+#define MICROPY_END_ATOMIC_SECTION(state)  __set_PRIMASK(state)
+
 // 这些函数在一个单独的 C 文件里实现
 mp_uint_t mp_hal_ticks_ms(void);
 mp_uint_t mp_hal_ticks_us(void);
 mp_uint_t mp_hal_ticks_cpu(void);
+mp_uint_t mp_hal_ticks_ns(void);
+
+// 64 位时基：启动后的纳秒数 / CPU 周期数，不回绕
+uint64_t mp_hal_monotonic_ns(void);
+uint64_t mp_hal_ticks_cpu64(void);
+
+// 启动时初始化 DWT 时基；SysTick ISR（hal_entry.c）每 1ms 调用 mp_hal_time_tick 推进
+void mp_hal_time_init(void);
+void mp_hal_time_tick(void);
 
 void mp_hal_delay_ms(mp_uint_t ms);
 void mp_hal_delay_us(mp_uint_t us);
 
+// 空闲：睡眠到下一个中断；统计 WFI 中度过的周期数
+void mp_hal_idle(void);
+uint64_t mp_hal_idle_stats(uint64_t *elapsed, bool reset);
+
+// 启动时把主栈未用部分填成固定图案，供 mp_hal_stack_peak（micropython.stack_peak()）使用，实现在 mp_stub.c 中
+void mp_stack_paint_init(void);
+
+#if MICROPY_GC_INCREMENTAL
+// 开始增量 GC 并登记根（寄存器和 stack_bottom 以上的栈），实现在 mp_stub.c 中
+void mp_gc_inc_start(void *stack_bottom);
+#endif
+
 // 中断字符设置函数（在 mp_stub.c 中实现）
 void mp_hal_set_interrupt_char(int c);
 
@@ -325,8 +325,10 @@ void mp_setup_code_state(mp_code_state_t *code_state, size_t n_args, size_t n_kw
     #if MICROPY_STACKLESS
     code_state->prev = NULL;
     #endif
-    #if MICROPY_PY_SYS_SETTRACE
+    #if MICROPY_VM_TRACK_CODE_STATE
     code_state->prev_state = NULL;
+    #endif
+    #if MICROPY_PY_SYS_SETTRACE
     code_state->frame = NULL;
     #endif
     mp_setup_code_state_helper(code_state, n_args, n_kw, args);
@@ -343,3 +345,26 @@ void mp_setup_code_state_native(mp_code_state_native_t *code_state, size_t n_arg
     mp_setup_code_state_helper((mp_code_state_t *)code_state, n_args, n_kw, args);
 }
 #endif
+
+#if MICROPY_VM_TRACK_CODE_STATE
+size_t mp_bytecode_get_location(const mp_obj_fun_bc_t *fun, size_t offset, qstr *block, qstr *file) {
+    const byte *ip = fun->bytecode;
+    MP_BC_PRELUDE_SIG_DECODE(ip);
+    MP_BC_PRELUDE_SIZE_DECODE(ip);
+    const byte *line_info_top = ip + n_info;
+    const byte *bytecode_start = ip + n_info + n_cell;
+    qstr block_name = mp_decode_uint_value(ip);
+    for (size_t i = 0; i < 1 + n_pos_args + n_kwonly_args; ++i) {
+        ip = mp_decode_uint_skip(ip);
+    }
+    #if MICROPY_EMIT_BYTECODE_USES_QSTR_TABLE
+    *block = fun->context->constants.qstr_table[block_name];
+    *file = fun->context->constants.qstr_table[0];
+    #else
+    *block = block_name;
+    *file = fun->context->constants.source_file;
+    #endif
+    size_t bc = offset - (size_t)(bytecode_start - fun->bytecode);
+    return mp_bytecode_get_source_line(ip, line_info_top, bc);
+}
+#endif
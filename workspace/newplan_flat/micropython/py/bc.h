@@ -245,8 +245,10 @@ typedef struct _mp_code_state_t {
     #if MICROPY_STACKLESS
     struct _mp_code_state_t *prev;
     #endif
-    #if MICROPY_PY_SYS_SETTRACE
+    #if MICROPY_VM_TRACK_CODE_STATE
     struct _mp_code_state_t *prev_state;
+    #endif
+    #if MICROPY_PY_SYS_SETTRACE
     struct _mp_obj_frame_t *frame;
     #endif
     // Variable-length
@@ -279,9 +281,42 @@ mp_vm_return_kind_t mp_execute_bytecode(mp_code_state_t *code_state,
     volatile
 #endif
     mp_obj_t inject_exc);
+#if MICROPY_VM_OPCODE_STATS
+// Dispatch paths inside opcodes that are timed separately (inclusive of callees)
+typedef enum _mp_vm_path_t {
+    MP_VM_PATH_LOAD_ATTR_FAST,  // instance member found by MICROPY_OPT_LOAD_ATTR_FAST_PATH
+    MP_VM_PATH_LOAD_ATTR_SLOW,  // mp_load_attr
+    MP_VM_PATH_LOAD_METHOD,     // mp_load_method
+    MP_VM_PATH_LOAD_NAME,       // mp_load_name (locals/globals/builtins map lookups)
+    MP_VM_PATH_LOAD_GLOBAL,     // mp_load_global (globals/builtins map lookups)
+    MP_VM_PATH_CALL_BC,         // mp_call_function_n_kw / mp_call_method_n_kw on a bytecode function
+    MP_VM_PATH_CALL_OTHER,      // ... on anything else (builtins, native code, types, bound methods)
+    MP_VM_PATH_OUTSIDE,         // time between leaving the VM and the next opcode dispatch
+    MP_VM_PATH_NUM,
+} mp_vm_path_t;
+
+typedef struct _mp_vm_opcode_stats_t {
+    uint32_t count[256];
+    uint64_t cycles[256];       // exclusive: from dispatch of an opcode to the next dispatch
+    uint32_t path_count[MP_VM_PATH_NUM];
+    uint64_t path_cycles[MP_VM_PATH_NUM];
+    uint32_t last_cycles;
+    uint16_t last_op;           // opcode being timed, or 256 + MP_VM_PATH_OUTSIDE
+} mp_vm_opcode_stats_t;
+
+extern mp_vm_opcode_stats_t mp_vm_opcode_stats;
+
+void mp_vm_opcode_stats_reset(void);
+#endif
+
 mp_code_state_t *mp_obj_fun_bc_prepare_codestate(mp_obj_t func, size_t n_args, size_t n_kw, const mp_obj_t *args);
 void mp_setup_code_state(mp_code_state_t *code_state, size_t n_args, size_t n_kw, const mp_obj_t *args);
 void mp_setup_code_state_native(mp_code_state_native_t *code_state, size_t n_args, size_t n_kw, const mp_obj_t *args);
+#if MICROPY_VM_TRACK_CODE_STATE
+// Block name, source file and source line of the given offset from the start
+// of fun->bytecode (as recorded from a tracked code state's ip)
+size_t mp_bytecode_get_location(const struct _mp_obj_fun_bc_t *fun, size_t offset, qstr *block, qstr *file);
+#endif
 void mp_bytecode_print(const mp_print_t *print, const struct _mp_raw_code_t *rc, size_t fun_data_len, const mp_module_constants_t *cm);
 void mp_bytecode_print2(const mp_print_t *print, const byte *ip, size_t len, struct _mp_raw_code_t *const *child_table, const mp_module_constants_t *cm);
 const byte *mp_bytecode_print_str(const mp_print_t *print, const byte *ip_start, const byte *ip, struct _mp_raw_code_t *const *child_table, const mp_module_constants_t *cm);
@@ -0,0 +1,145 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/gc.h"
+#include "py/comparena.h"
+
+#if MICROPY_COMP_ARENA
+
+// The chunks form a list from the newest, MP_STATE_VM(comp_arena), through
+// prev; allocations are only ever made from the newest one.  A mark is the
+// address of the first free byte of the newest chunk, or NULL if there is no
+// chunk.  With MICROPY_GC_ALLOC_HIGH the chunks are taken from the top of the
+// heap while the compiler's output is allocated from the bottom as usual.
+typedef struct _mp_comp_arena_chunk_t {
+    struct _mp_comp_arena_chunk_t *prev;
+    size_t alloc;
+    size_t used;
+    byte data[];
+} mp_comp_arena_chunk_t;
+
+#define ARENA_ALIGN(n) (((n) + sizeof(mp_uint_t) - 1) & ~(sizeof(mp_uint_t) - 1))
+
+static mp_comp_arena_chunk_t *arena_chunk_new(size_t alloc) {
+    #if MICROPY_GC_ALLOC_HIGH
+    return gc_alloc(sizeof(mp_comp_arena_chunk_t) + alloc, GC_ALLOC_FLAG_HIGH);
+    #else
+    return (mp_comp_arena_chunk_t *)m_malloc_maybe(sizeof(mp_comp_arena_chunk_t) + alloc);
+    #endif
+}
+
+void *mp_comp_arena_mark(void) {
+    mp_comp_arena_chunk_t *chunk = MP_STATE_VM(comp_arena);
+    return chunk == NULL ? NULL : chunk->data + chunk->used;
+}
+
+void mp_comp_arena_release(void *mark) {
+    mp_comp_arena_chunk_t *chunk = MP_STATE_VM(comp_arena);
+    // free the chunks allocated after the one the mark points into
+    while (chunk != NULL && !(chunk->data <= (byte *)mark && (byte *)mark <= chunk->data + chunk->alloc)) {
+        mp_comp_arena_chunk_t *prev = chunk->prev;
+        MP_STATE_VM(comp_arena_size) -= chunk->alloc;
+        #if MICROPY_GC_ALLOC_HIGH
+        gc_free(chunk);
+        #else
+        m_del(byte, chunk, sizeof(mp_comp_arena_chunk_t) + chunk->alloc);
+        #endif
+        chunk = prev;
+    }
+    if (chunk != NULL) {
+        chunk->used = (byte *)mark - chunk->data;
+    }
+    MP_STATE_VM(comp_arena) = chunk;
+}
+
+void *mp_comp_arena_alloc(size_t num_bytes) {
+    num_bytes = ARENA_ALIGN(num_bytes);
+    mp_comp_arena_chunk_t *chunk = MP_STATE_VM(comp_arena);
+    if (chunk == NULL || chunk->alloc - chunk->used < num_bytes) {
+        // start a new chunk; the rest of the old one stays unused until the release
+        size_t alloc = MICROPY_COMP_ARENA_CHUNK;
+        if (alloc < num_bytes) {
+            alloc = num_bytes;
+        }
+        mp_comp_arena_chunk_t *new_chunk = arena_chunk_new(alloc);
+        if (new_chunk == NULL && alloc > num_bytes) {
+            // the heap is nearly full: take only what is needed
+            alloc = num_bytes;
+            new_chunk = arena_chunk_new(alloc);
+        }
+        if (new_chunk == NULL) {
+            m_malloc_fail(sizeof(mp_comp_arena_chunk_t) + alloc);
+        }
+        new_chunk->prev = chunk;
+        new_chunk->alloc = alloc;
+        new_chunk->used = 0;
+        MP_STATE_VM(comp_arena) = chunk = new_chunk;
+        MP_STATE_VM(comp_arena_size) += alloc;
+        if (MP_STATE_VM(comp_arena_size) > MP_STATE_VM(comp_arena_peak)) {
+            MP_STATE_VM(comp_arena_peak) = MP_STATE_VM(comp_arena_size);
+        }
+    }
+    void *ret = chunk->data + chunk->used;
+    chunk->used += num_bytes;
+    return ret;
+}
+
+void *mp_comp_arena_realloc(void *ptr, size_t old_num_bytes, size_t new_num_bytes, bool allow_move) {
+    old_num_bytes = ARENA_ALIGN(old_num_bytes);
+    new_num_bytes = ARENA_ALIGN(new_num_bytes);
+    mp_comp_arena_chunk_t *chunk = MP_STATE_VM(comp_arena);
+    if (ptr != NULL && chunk != NULL && (byte *)ptr + old_num_bytes == chunk->data + chunk->used) {
+        // the most recent allocation can be resized in place if it fits
+        size_t start = (byte *)ptr - chunk->data;
+        if (new_num_bytes <= chunk->alloc - start) {
+            chunk->used = start + new_num_bytes;
+            return ptr;
+        }
+    } else if (new_num_bytes <= old_num_bytes) {
+        return ptr;
+    }
+    if (!allow_move) {
+        return NULL;
+    }
+    void *new_ptr = mp_comp_arena_alloc(new_num_bytes);
+    if (ptr != NULL) {
+        memcpy(new_ptr, ptr, old_num_bytes);
+    }
+    return new_ptr;
+}
+
+void mp_comp_arena_free(void *ptr, size_t num_bytes) {
+    num_bytes = ARENA_ALIGN(num_bytes);
+    mp_comp_arena_chunk_t *chunk = MP_STATE_VM(comp_arena);
+    if (ptr != NULL && chunk != NULL && (byte *)ptr + num_bytes == chunk->data + chunk->used) {
+        chunk->used -= num_bytes;
+    }
+}
+
+MP_REGISTER_ROOT_POINTER(struct _mp_comp_arena_chunk_t *comp_arena);
+
+#endif // MICROPY_COMP_ARENA
@@ -0,0 +1,75 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MICROPY_INCLUDED_PY_COMPARENA_H
+#define MICROPY_INCLUDED_PY_COMPARENA_H
+
+#include <string.h>
+
+#include "py/misc.h"
+
+#if MICROPY_COMP_ARENA
+
+// Scratch memory for the parser and compiler.
+//
+// The parse tree, the parser stacks, scopes and the bytecode emitter are bump
+// allocated from chunks of MICROPY_COMP_ARENA_CHUNK bytes instead of as many
+// small GC blocks.  mp_parse takes a mark and mp_parse_tree_clear (called when
+// compilation finishes or raises) releases everything allocated since, so only
+// the raw code, bytecode and constants stay on the heap and the scratch data
+// leaves a few large holes rather than many small ones between them.  The
+// chunks are on the GC heap and reachable from a root pointer, so the objects
+// that parse nodes refer to stay alive until then.  Marks nest, eg for a
+// compile started by Python code that a lexer reader calls.
+//
+// Freeing or resizing the most recent allocation works in place; any other
+// free is a no-op and a resize that grows moves the block, leaving the old
+// space until the release.
+
+void *mp_comp_arena_mark(void);
+void mp_comp_arena_release(void *mark);
+void *mp_comp_arena_alloc(size_t num_bytes);
+void *mp_comp_arena_realloc(void *ptr, size_t old_num_bytes, size_t new_num_bytes, bool allow_move);
+void mp_comp_arena_free(void *ptr, size_t num_bytes);
+
+#define m_arena_new(type, num) ((type *)(mp_comp_arena_alloc(sizeof(type) * (num))))
+#define m_arena_new0(type, num) ((type *)(memset(mp_comp_arena_alloc(sizeof(type) * (num)), 0, sizeof(type) * (num))))
+#define m_arena_renew(type, ptr, old_num, new_num) ((type *)(mp_comp_arena_realloc((ptr), sizeof(type) * (old_num), sizeof(type) * (new_num), true)))
+#define m_arena_renew_maybe(type, ptr, old_num, new_num, allow_move) ((type *)mp_comp_arena_realloc((ptr), sizeof(type) * (old_num), sizeof(type) * (new_num), (allow_move)))
+#define m_arena_del(type, ptr, num) mp_comp_arena_free((ptr), sizeof(type) * (num))
+// Step by which an array of alloc items that normally grows by inc grows.
+// Moved arena blocks are only reclaimed by the release, so grow geometrically.
+#define m_arena_grow(alloc, inc) ((alloc) > (inc) ? (alloc) : (inc))
+
+#else
+
+#define m_arena_new(type, num) m_new(type, num)
+#define m_arena_new0(type, num) m_new0(type, num)
+#define m_arena_renew(type, ptr, old_num, new_num) m_renew(type, ptr, old_num, new_num)
+#define m_arena_renew_maybe(type, ptr, old_num, new_num, allow_move) m_renew_maybe(type, ptr, old_num, new_num, allow_move)
+#define m_arena_del(type, ptr, num) m_del(type, ptr, num)
+#define m_arena_grow(alloc, inc) (inc)
+
+#endif // MICROPY_COMP_ARENA
+
+#endif // MICROPY_INCLUDED_PY_COMPARENA_H
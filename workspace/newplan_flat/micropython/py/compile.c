@@ -3477,6 +3477,13 @@ void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool
     compiler_t comp_state = {0};
     compiler_t *comp = &comp_state;
 
+    #if MICROPY_COMP_ARENA
+    // scopes and emitters go in the arena after the parse tree; release it
+    // all if an exception is raised
+    MP_DEFINE_NLR_JUMP_CALLBACK_FUNCTION_1(arena_ctx, mp_parse_tree_clear, parse_tree);
+    nlr_push_jump_callback(&arena_ctx.callback, mp_call_function_1_from_nlr_jump_callback);
+    #endif
+
     comp->is_repl = is_repl;
     comp->break_label = INVALID_LABEL;
     comp->continue_label = INVALID_LABEL;
@@ -3659,9 +3666,6 @@ void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool
     }
     #endif
 
-    // free the parse tree
-    mp_parse_tree_clear(parse_tree);
-
     // free the scopes
     for (scope_t *s = module_scope; s;) {
         scope_t *next = s->next;
@@ -3669,6 +3673,13 @@ void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool
         s = next;
     }
 
+    // free the parse tree (last, with an arena this releases the scopes too)
+    #if MICROPY_COMP_ARENA
+    nlr_pop_jump_callback(true);
+    #else
+    mp_parse_tree_clear(parse_tree);
+    #endif
+
     if (comp->compile_error != MP_OBJ_NULL) {
         nlr_raise(comp->compile_error);
     }
@@ -3676,7 +3687,16 @@ void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool
 
 mp_obj_t mp_compile(mp_parse_tree_t *parse_tree, qstr source_file, bool is_repl) {
     mp_compiled_module_t cm;
+    #if MICROPY_COMP_ARENA
+    cm.context = m_new_obj_maybe(mp_module_context_t);
+    if (cm.context == NULL) {
+        // don't leave the parse tree in the arena
+        mp_parse_tree_clear(parse_tree);
+        m_malloc_fail(sizeof(mp_module_context_t));
+    }
+    #else
     cm.context = m_new_obj(mp_module_context_t);
+    #endif
     cm.context->module.globals = mp_globals_get();
     mp_compile_to_raw_code(parse_tree, source_file, is_repl, &cm);
     // return function that executes the outer module
@@ -31,6 +31,16 @@
 
 #include "py/gc.h"
 #include "py/runtime.h"
+#include "py/mptrace.h"
+
+#if MICROPY_GC_INCREMENTAL || MICROPY_GC_MOVABLE
+#include "py/mphal.h"
+#endif
+
+#if MICROPY_GC_ALLOC_SITES
+#include "py/bc.h"
+#include "py/objfun.h"
+#endif
 
 #if MICROPY_DEBUG_VALGRIND
 #include <valgrind/memcheck.h>
@@ -84,6 +94,18 @@
 #define NEXT_AREA(area) (NULL)
 #endif
 
+#if MICROPY_GC_AREA_PLACEMENT
+// Areas are visited in placement order: first those of the preferred kind.
+#define FIRST_ALLOC_AREA(kind, no_tcm) gc_area_next(NULL, (kind), (no_tcm))
+#define NEXT_ALLOC_AREA(area, kind, no_tcm) gc_area_next((area), (kind), (no_tcm))
+#elif MICROPY_GC_SPLIT_HEAP
+#define FIRST_ALLOC_AREA(kind, no_tcm) (MP_STATE_MEM(gc_last_free_area))
+#define NEXT_ALLOC_AREA(area, kind, no_tcm) NEXT_AREA(area)
+#else
+#define FIRST_ALLOC_AREA(kind, no_tcm) (&MP_STATE_MEM(area))
+#define NEXT_ALLOC_AREA(area, kind, no_tcm) NEXT_AREA(area)
+#endif
+
 #define BLOCK_SHIFT(block) (2 * ((block) & (BLOCKS_PER_ATB - 1)))
 #define ATB_GET_KIND(area, block) (((area)->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] >> BLOCK_SHIFT(block)) & 3)
 #define ATB_ANY_TO_FREE(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] &= (~(AT_MARK << BLOCK_SHIFT(block))); } while (0)
@@ -112,6 +134,18 @@
 #define FTB_CLEAR(area, block) do { area->gc_finaliser_table_start[(block) / BLOCKS_PER_FTB] &= (~(1 << ((block) & 7))); } while (0)
 #endif
 
+#if MICROPY_GC_ALLOC_SITES
+// STB = site table byte, one per block: the allocation site of a head block
+
+#if GC_SITE_NUM > 256
+#error MICROPY_GC_ALLOC_SITES_MAX must be at most 254
+#endif
+
+#define STB_BYTES_PER_ATB (BLOCKS_PER_ATB)
+#else
+#define STB_BYTES_PER_ATB (0)
+#endif
+
 #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
 #define GC_MUTEX_INIT() mp_thread_recursive_mutex_init(&MP_STATE_MEM(gc_mutex))
 #define GC_ENTER() mp_thread_recursive_mutex_lock(&MP_STATE_MEM(gc_mutex), 1)
@@ -123,8 +157,13 @@
 #define GC_EXIT()
 #endif
 
+#if MICROPY_GC_INCREMENTAL && MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
+#error MICROPY_GC_INCREMENTAL requires the GIL
+#endif
+
 // Static functions for individual steps of the GC mark/sweep sequence
 static void gc_collect_start_common(void);
+static void gc_collect_root_pointers(void);
 static void *gc_get_ptr(void **ptrs, int i);
 #if MICROPY_GC_SPLIT_HEAP
 static void gc_mark_subtree(mp_state_mem_area_t *area, size_t block);
@@ -134,14 +173,44 @@ static void gc_mark_subtree(size_t block);
 static void gc_deal_with_stack_overflow(void);
 static void gc_sweep_run_finalisers(void);
 static void gc_sweep_free_blocks(void);
+#if MICROPY_GC_FREELISTS
+static void gc_freelist_push(mp_state_mem_area_t *area, size_t block, size_t n);
+#endif
+#if MICROPY_GC_ALLOC_SITES
+static byte gc_site_lookup(const void *caller);
+#endif
+#if MICROPY_GC_INCREMENTAL
+static void gc_inc_finish(void);
+static void gc_inc_discard(void);
+static void gc_inc_mark_ptrs(void **ptrs, size_t len);
+static bool gc_inc_sweep_alloc(mp_state_mem_area_t *area, size_t start_block, size_t end_block);
+#endif
+#if MICROPY_GC_MOVABLE
+static void gc_movable_note(void **slot, const void *ptr);
+static void gc_movable_mark_done(void);
+static void gc_movable_freed(const void *ptr);
+static void gc_movable_realloc(const void *ptr_in, void *ptr_out, size_t n_blocks);
+static void gc_compact_if_fragmented(void);
+
+// Called by the full mark for every word it scans: the slow path only runs
+// for words that point into (or just past) one of the movable buffers.
+#define GC_MOVABLE_NOTE(slot, ptr) do { \
+        if ((uintptr_t)(ptr) - MP_STATE_MEM(gc_movable_lo) < MP_STATE_MEM(gc_movable_span)) { \
+            gc_movable_note((slot), (ptr)); \
+        } \
+} while (0)
+#else
+#define GC_MOVABLE_NOTE(slot, ptr)
+#endif
 
 // TODO waste less memory; currently requires that all entries in alloc_table have a corresponding block in pool
 static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
-    // calculate parameters for GC (T=total, A=alloc table, F=finaliser table, P=pool; all in bytes):
-    // T = A + F + P
+    // calculate parameters for GC (T=total, A=alloc table, F=finaliser table, S=site table, P=pool; all in bytes):
+    // T = A + F + S + P
     //     F = A * BLOCKS_PER_ATB / BLOCKS_PER_FTB
+    //     S = A * STB_BYTES_PER_ATB
     //     P = A * BLOCKS_PER_ATB * BYTES_PER_BLOCK
-    // => T = A * (1 + BLOCKS_PER_ATB / BLOCKS_PER_FTB + BLOCKS_PER_ATB * BYTES_PER_BLOCK)
+    // => T = A * (1 + BLOCKS_PER_ATB / BLOCKS_PER_FTB + STB_BYTES_PER_ATB + BLOCKS_PER_ATB * BYTES_PER_BLOCK)
     size_t total_byte_len = (byte *)end - (byte *)start;
     #if MICROPY_ENABLE_FINALISER
     area->gc_alloc_table_byte_len = (total_byte_len - ALLOC_TABLE_GAP_BYTE)
@@ -149,34 +218,35 @@ static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
         / (
             MP_BITS_PER_BYTE
             + MP_BITS_PER_BYTE * BLOCKS_PER_ATB / BLOCKS_PER_FTB
+            + MP_BITS_PER_BYTE * STB_BYTES_PER_ATB
             + MP_BITS_PER_BYTE * BLOCKS_PER_ATB * BYTES_PER_BLOCK
             );
     #else
-    area->gc_alloc_table_byte_len = (total_byte_len - ALLOC_TABLE_GAP_BYTE) / (1 + MP_BITS_PER_BYTE / 2 * BYTES_PER_BLOCK);
+    area->gc_alloc_table_byte_len = (total_byte_len - ALLOC_TABLE_GAP_BYTE) / (1 + STB_BYTES_PER_ATB + MP_BITS_PER_BYTE / 2 * BYTES_PER_BLOCK);
     #endif
 
     area->gc_alloc_table_start = (byte *)start;
+    byte *tables_end = area->gc_alloc_table_start + area->gc_alloc_table_byte_len + ALLOC_TABLE_GAP_BYTE;
 
     #if MICROPY_ENABLE_FINALISER
     size_t gc_finaliser_table_byte_len = (area->gc_alloc_table_byte_len * BLOCKS_PER_ATB + BLOCKS_PER_FTB - 1) / BLOCKS_PER_FTB;
-    area->gc_finaliser_table_start = area->gc_alloc_table_start + area->gc_alloc_table_byte_len + ALLOC_TABLE_GAP_BYTE;
+    area->gc_finaliser_table_start = tables_end;
+    tables_end += gc_finaliser_table_byte_len;
+    #endif
+
+    #if MICROPY_GC_ALLOC_SITES
+    area->gc_site_table_start = tables_end;
+    tables_end += area->gc_alloc_table_byte_len * STB_BYTES_PER_ATB;
     #endif
 
     size_t gc_pool_block_len = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
     area->gc_pool_start = (byte *)end - gc_pool_block_len * BYTES_PER_BLOCK;
     area->gc_pool_end = end;
 
-    #if MICROPY_ENABLE_FINALISER
-    assert(area->gc_pool_start >= area->gc_finaliser_table_start + gc_finaliser_table_byte_len);
-    #endif
+    assert(area->gc_pool_start >= tables_end);
 
-    #if MICROPY_ENABLE_FINALISER
-    // clear ATB's and FTB's
-    memset(area->gc_alloc_table_start, 0, gc_finaliser_table_byte_len + area->gc_alloc_table_byte_len + ALLOC_TABLE_GAP_BYTE);
-    #else
-    // clear ATB's
-    memset(area->gc_alloc_table_start, 0, area->gc_alloc_table_byte_len + ALLOC_TABLE_GAP_BYTE);
-    #endif
+    // clear ATB's, and FTB's and STB's if present
+    memset(area->gc_alloc_table_start, 0, tables_end - area->gc_alloc_table_start);
 
     area->gc_last_free_atb_index = 0;
     area->gc_last_used_block = 0;
@@ -185,6 +255,15 @@ static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     area->next = NULL;
     #endif
 
+    #if MICROPY_GC_AREA_PLACEMENT
+    area->gc_area_kind = GC_AREA_FAST;
+    area->gc_area_tcm = false;
+    #endif
+
+    #if MICROPY_GC_FREELISTS
+    memset(area->gc_freelist_len, 0, sizeof(area->gc_freelist_len));
+    #endif
+
     DEBUG_printf("GC layout:\n");
     DEBUG_printf("  alloc table at %p, length " UINT_FMT " bytes, "
         UINT_FMT " blocks\n",
@@ -225,6 +304,40 @@ void gc_init(void *start, void *end) {
     MP_STATE_MEM(gc_alloc_amount) = 0;
     #endif
 
+    #if MICROPY_GC_AREA_PLACEMENT
+    MP_STATE_MEM(gc_alloc_hint) = GC_AREA_AUTO;
+    MP_STATE_MEM(gc_bulk_threshold) = MICROPY_GC_BULK_THRESHOLD;
+    #endif
+
+    #if MICROPY_GC_ALLOC_SITES
+    memset(MP_STATE_MEM(gc_site_offset), 0, sizeof(MP_STATE_MEM(gc_site_offset)));
+    memset(MP_STATE_VM(gc_site_where), 0, sizeof(MP_STATE_VM(gc_site_where)));
+    MP_STATE_MEM(gc_site_caller) = NULL;
+    #endif
+
+    #if MICROPY_GC_MOVABLE
+    MP_STATE_MEM(gc_movable_len) = 0;
+    MP_STATE_MEM(gc_movable_lo) = 0;
+    MP_STATE_MEM(gc_movable_span) = 0;
+    MP_STATE_MEM(gc_compact_threshold) = MICROPY_GC_COMPACT_THRESHOLD;
+    MP_STATE_MEM(gc_compact_want) = 0;
+    MP_STATE_MEM(gc_compact_runs) = 0;
+    MP_STATE_MEM(gc_compact_moves) = 0;
+    MP_STATE_MEM(gc_compact_bytes) = 0;
+    #endif
+
+    #if MICROPY_GC_INCREMENTAL
+    MP_STATE_MEM(gc_inc_phase) = GC_INC_IDLE;
+    MP_STATE_MEM(gc_inc_alloc_blocks) = 0;
+    MP_STATE_MEM(gc_inc_trigger) = MICROPY_GC_INCREMENTAL_TRIGGER;
+    MP_STATE_MEM(gc_inc_budget_us) = MICROPY_GC_INCREMENTAL_BUDGET_US;
+    MP_STATE_MEM(gc_inc_last_mark_us) = 0;
+    MP_STATE_MEM(gc_inc_abort_run) = 0;
+    MP_STATE_MEM(gc_inc_max_slice_us) = 0;
+    MP_STATE_MEM(gc_inc_cycles) = 0;
+    MP_STATE_MEM(gc_inc_aborts) = 0;
+    #endif
+
     GC_MUTEX_INIT();
 }
 
@@ -250,6 +363,53 @@ void gc_add(void *start, void *end) {
     prev_area->next = area;
 }
 
+#if MICROPY_GC_AREA_PLACEMENT
+static void gc_area_set_kind(mp_state_mem_area_t *area, unsigned int kind) {
+    area->gc_area_kind = kind & ~GC_AREA_TCM;
+    area->gc_area_tcm = (kind & GC_AREA_TCM) != 0;
+}
+
+void gc_init_kind(void *start, void *end, unsigned int kind) {
+    gc_init(start, end);
+    gc_area_set_kind(&MP_STATE_MEM(area), kind);
+}
+
+void gc_add_kind(void *start, void *end, unsigned int kind) {
+    gc_add(start, end);
+    gc_area_set_kind((mp_state_mem_area_t *)start, kind);
+}
+
+// Return the area to search after 'area' (or the first one if NULL): all areas
+// of the preferred kind in list order, then all the others, skipping TCM areas
+// if no_tcm is set.  There are only a handful of areas, so walking the list
+// again costs next to nothing, and each area keeps its own
+// gc_last_free_atb_index to start the ATB scan from.
+static mp_state_mem_area_t *gc_area_next(mp_state_mem_area_t *area, unsigned int kind, bool no_tcm) {
+    bool preferred = area == NULL || area->gc_area_kind == kind;
+    area = area == NULL ? &MP_STATE_MEM(area) : area->next;
+    for (;;) {
+        for (; area != NULL; area = area->next) {
+            if ((area->gc_area_kind == kind) == preferred && !(no_tcm && area->gc_area_tcm)) {
+                return area;
+            }
+        }
+        if (!preferred) {
+            return NULL;
+        }
+        preferred = false;
+        area = &MP_STATE_MEM(area);
+    }
+}
+
+static unsigned int gc_alloc_area_kind(size_t n_bytes) {
+    unsigned int hint = MP_STATE_MEM(gc_alloc_hint);
+    if (hint != GC_AREA_AUTO) {
+        return hint;
+    }
+    return n_bytes >= MP_STATE_MEM(gc_bulk_threshold) ? GC_AREA_BULK : GC_AREA_FAST;
+}
+#endif
+
 #if MICROPY_GC_SPLIT_HEAP_AUTO
 // Try to automatically add a heap area large enough to fulfill 'failed_alloc'.
 static bool gc_try_add_heap(size_t failed_alloc) {
@@ -310,6 +470,7 @@ static bool gc_try_add_heap(size_t failed_alloc) {
         #if MICROPY_ENABLE_FINALISER
         + total_blocks / BLOCKS_PER_FTB
         #endif
+        + total_blocks / BLOCKS_PER_ATB * STB_BYTES_PER_ATB
         + total_blocks * BYTES_PER_BLOCK
         + ALLOC_TABLE_GAP_BYTE
         + sizeof(mp_state_mem_area_t);
@@ -383,6 +544,18 @@ static inline mp_state_mem_area_t *gc_get_ptr_area(const void *ptr) {
     && ptr < (void *)MP_STATE_MEM(area).gc_pool_end         /* must be below end of pool */ \
     )
 
+#if MICROPY_GC_ALLOC_SITES || MICROPY_GC_MOVABLE
+// The area of a pointer known to be in the heap
+static mp_state_mem_area_t *gc_ptr_area(const void *ptr) {
+    #if MICROPY_GC_SPLIT_HEAP
+    return gc_get_ptr_area(ptr);
+    #else
+    (void)ptr;
+    return &MP_STATE_MEM(area);
+    #endif
+}
+#endif
+
 #ifndef TRACE_MARK
 #if DEBUG_PRINT
 #define TRACE_MARK(block, ptr) DEBUG_printf("gc_mark(%p)\n", ptr)
@@ -396,7 +569,13 @@ void gc_collect_start(void) {
     #if MICROPY_GC_ALLOC_THRESHOLD
     MP_STATE_MEM(gc_alloc_amount) = 0;
     #endif
+    #if MICROPY_GC_INCREMENTAL
+    MP_STATE_MEM(gc_inc_alloc_blocks) = 0;
+    #endif
+    gc_collect_root_pointers();
+}
 
+static void gc_collect_root_pointers(void) {
     // Trace root pointers.  This relies on the root pointers being organised
     // correctly in the mp_state_ctx structure.  We scan nlr_top, dict_locals,
     // dict_globals, then the root pointer section of mp_state_vm.
@@ -413,19 +592,45 @@ void gc_collect_start(void) {
 }
 
 static void gc_collect_start_common(void) {
+    #if MICROPY_GC_INCREMENTAL
+    // a full collection supersedes an incremental cycle in progress
+    gc_inc_finish();
+    #endif
     GC_ENTER();
+    MP_TRACE_EVENT(MP_TRACE_GC_BEGIN, 0);
     assert((MP_STATE_THREAD(gc_lock_depth) & GC_COLLECT_FLAG) == 0);
     MP_STATE_THREAD(gc_lock_depth) |= GC_COLLECT_FLAG;
     MP_STATE_MEM(gc_stack_overflow) = 0;
+    #if MICROPY_GC_MOVABLE
+    for (size_t i = 0; i < MP_STATE_MEM(gc_movable_len); i++) {
+        MP_STATE_MEM(gc_movable)[i].seen = false;
+    }
+    #endif
 }
 
 void gc_collect_root(void **ptrs, size_t len) {
+    #if MICROPY_GC_INCREMENTAL
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_MARK) {
+        // Queue the range, gc_inc_step scans it.  The caller guarantees that
+        // it stays valid (and unchanged) while the mark is in progress.
+        uint8_t n = MP_STATE_MEM(gc_inc_n_roots);
+        if (n < MICROPY_GC_INCREMENTAL_ROOTS) {
+            MP_STATE_MEM(gc_inc_root_ptrs)[n] = ptrs;
+            MP_STATE_MEM(gc_inc_root_len)[n] = len;
+            MP_STATE_MEM(gc_inc_n_roots) = n + 1;
+        } else {
+            gc_inc_mark_ptrs(ptrs, len);
+        }
+        return;
+    }
+    #endif
     #if !MICROPY_GC_SPLIT_HEAP
     mp_state_mem_area_t *area = &MP_STATE_MEM(area);
     #endif
     for (size_t i = 0; i < len; i++) {
         MICROPY_GC_HOOK_LOOP(i);
         void *ptr = gc_get_ptr(ptrs, i);
+        GC_MOVABLE_NOTE(&ptrs[i], ptr);
         #if MICROPY_GC_SPLIT_HEAP
         mp_state_mem_area_t *area = gc_get_ptr_area(ptr);
         if (!area) {
@@ -480,6 +685,7 @@ static void gc_mark_subtree(size_t block)
         for (size_t i = n_blocks * BYTES_PER_BLOCK / sizeof(void *); i > 0; i--, ptrs++) {
             MICROPY_GC_HOOK_LOOP(i);
             void *ptr = *ptrs;
+            GC_MOVABLE_NOTE(ptrs, ptr);
             // If this is a heap pointer that hasn't been marked, mark it and push
             // it's children to the stack.
             #if MICROPY_GC_SPLIT_HEAP
@@ -534,8 +740,14 @@ void gc_sweep_all(void) {
 
 void gc_collect_end(void) {
     gc_deal_with_stack_overflow();
+    #if MICROPY_GC_MOVABLE
+    gc_movable_mark_done();
+    #endif
     gc_sweep_run_finalisers();
     gc_sweep_free_blocks();
+    #if MICROPY_GC_MOVABLE
+    gc_compact_if_fragmented();
+    #endif
     #if MICROPY_GC_SPLIT_HEAP
     MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
     #endif
@@ -543,6 +755,7 @@ void gc_collect_end(void) {
         area->gc_last_free_atb_index = 0;
     }
     MP_STATE_THREAD(gc_lock_depth) &= ~GC_COLLECT_FLAG;
+    MP_TRACE_EVENT(MP_TRACE_GC_END, 0);
     GC_EXIT();
 }
 
@@ -609,6 +822,39 @@ static void gc_sweep_run_finalisers(void) {
     #endif // MICROPY_ENABLE_FINALISER
 }
 
+// Sweep a single block: free it if it is an unmarked head or a tail of one
+// (free_tail tracks which), otherwise unmark it.  Returns true if freed.
+static inline bool gc_sweep_block(mp_state_mem_area_t *area, size_t block, int *free_tail, size_t *last_used_block) {
+    switch (ATB_GET_KIND(area, block)) {
+        case AT_HEAD:
+            *free_tail = 1;
+            DEBUG_printf("gc_sweep_free_blocks(%p)\n", (void *)PTR_FROM_BLOCK(area, block));
+            #if MICROPY_PY_GC_COLLECT_RETVAL
+            MP_STATE_MEM(gc_collected)++;
+            #endif
+            // fall through to free the head
+            MP_FALLTHROUGH
+
+        case AT_TAIL:
+            if (*free_tail) {
+                ATB_ANY_TO_FREE(area, block);
+                #if CLEAR_ON_SWEEP
+                memset((void *)PTR_FROM_BLOCK(area, block), 0, BYTES_PER_BLOCK);
+                #endif
+                return true;
+            }
+            *last_used_block = block;
+            break;
+
+        case AT_MARK:
+            ATB_MARK_TO_HEAD(area, block);
+            *free_tail = 0;
+            *last_used_block = block;
+            break;
+    }
+    return false;
+}
+
 // Free unmarked heads and their tails
 static void gc_sweep_free_blocks(void) {
     #if MICROPY_PY_GC_COLLECT_RETVAL
@@ -623,35 +869,27 @@ static void gc_sweep_free_blocks(void) {
         size_t last_used_block = 0;
         assert(area->gc_last_used_block <= area->gc_alloc_table_byte_len * BLOCKS_PER_ATB);
 
+        #if MICROPY_GC_FREELISTS
+        // rebuild the size-class free lists from the free runs left by this sweep;
+        // the free space after the last used block is left to the ATB scan
+        memset(area->gc_freelist_len, 0, sizeof(area->gc_freelist_len));
+        size_t free_run = 0;
+        #endif
+
         for (size_t block = 0; block <= area->gc_last_used_block; block++) {
             MICROPY_GC_HOOK_LOOP(block);
-            switch (ATB_GET_KIND(area, block)) {
-                case AT_HEAD:
-                    free_tail = 1;
-                    DEBUG_printf("gc_sweep_free_blocks(%p)\n", (void *)PTR_FROM_BLOCK(area, block));
-                    #if MICROPY_PY_GC_COLLECT_RETVAL
-                    MP_STATE_MEM(gc_collected)++;
-                    #endif
-                    // fall through to free the head
-                    MP_FALLTHROUGH
+            gc_sweep_block(area, block, &free_tail, &last_used_block);
 
-                case AT_TAIL:
-                    if (free_tail) {
-                        ATB_ANY_TO_FREE(area, block);
-                        #if CLEAR_ON_SWEEP
-                        memset((void *)PTR_FROM_BLOCK(area, block), 0, BYTES_PER_BLOCK);
-                        #endif
-                    } else {
-                        last_used_block = block;
-                    }
-                    break;
-
-                case AT_MARK:
-                    ATB_MARK_TO_HEAD(area, block);
-                    free_tail = 0;
-                    last_used_block = block;
-                    break;
+            #if MICROPY_GC_FREELISTS
+            if (ATB_GET_KIND(area, block) == AT_FREE) {
+                free_run++;
+            } else {
+                if (free_run > 0 && free_run <= MICROPY_GC_FREELIST_MAX_BLOCKS) {
+                    gc_freelist_push(area, block - free_run, free_run);
+                }
+                free_run = 0;
             }
+            #endif
         }
 
         area->gc_last_used_block = last_used_block;
@@ -669,6 +907,365 @@ static void gc_sweep_free_blocks(void) {
     }
 }
 
+#if MICROPY_GC_INCREMENTAL
+// Incremental collection.  The mark uses the same ATB mark bits and block
+// stack as gc_collect, but keeps its state (stack depth, root ranges still to
+// scan, overflow rescan position) in MP_STATE_MEM between slices.  There is no
+// write barrier, so a mark is only valid while the mutator is stopped: any
+// heap operation in the meantime, and gc_inc_abort, discard it.  Python code
+// run from a hard interrupt handler can move references without allocating,
+// so the handler calls gc_inc_note_mutation and the next step discards the
+// mark; a mutation after the mark is complete is harmless, since everything
+// reachable is then marked and the handler cannot allocate.
+// The sweep is lazy and runs concurrently with the mutator.  Objects it has
+// not reached yet are either marked (live) or unmarked heads (garbage, which
+// the mutator can no longer reach), so new objects in that region are
+// allocated marked ("black") and the sweep simply unmarks them.
+
+// Number of root pointers scanned between two checks of the slice budget.
+#define GC_INC_ROOT_CHUNK (64)
+// Number of blocks looked at between two budget checks in the overflow
+// rescan and the sweep.
+#define GC_INC_BLOCK_CHUNK (256)
+
+unsigned int gc_inc_phase(void) {
+    return MP_STATE_MEM(gc_inc_phase);
+}
+
+bool gc_inc_due(void) {
+    return MP_STATE_MEM(gc_inc_phase) != GC_INC_IDLE
+           || MP_STATE_MEM(gc_inc_alloc_blocks) * BYTES_PER_BLOCK >= MP_STATE_MEM(gc_inc_trigger);
+}
+
+// Mark the unmarked heads referenced by ptrs[0..len-1] and push them on the
+// mark stack; their children are scanned by later steps.
+static void gc_inc_mark_ptrs(void **ptrs, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        MICROPY_GC_HOOK_LOOP(i);
+        void *ptr = gc_get_ptr(ptrs, i);
+        #if MICROPY_GC_SPLIT_HEAP
+        mp_state_mem_area_t *area = gc_get_ptr_area(ptr);
+        if (!area) {
+            continue;
+        }
+        #else
+        if (!VERIFY_PTR(ptr)) {
+            continue;
+        }
+        mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+        #endif
+        size_t block = BLOCK_FROM_PTR(area, ptr);
+        if (ATB_GET_KIND(area, block) != AT_HEAD) {
+            continue;
+        }
+        TRACE_MARK(block, ptr);
+        ATB_HEAD_TO_MARK(area, block);
+        size_t sp = MP_STATE_MEM(gc_inc_sp);
+        if (sp < MICROPY_ALLOC_GC_STACK_SIZE) {
+            MP_STATE_MEM(gc_block_stack)[sp] = block;
+            #if MICROPY_GC_SPLIT_HEAP
+            MP_STATE_MEM(gc_area_stack)[sp] = area;
+            #endif
+            MP_STATE_MEM(gc_inc_sp) = sp + 1;
+        } else {
+            MP_STATE_MEM(gc_stack_overflow) = 1;
+        }
+    }
+}
+
+// Scan the children of the marked head at the given block.
+static void gc_inc_scan_block(mp_state_mem_area_t *area, size_t block) {
+    size_t n_blocks = 0;
+    do {
+        n_blocks += 1;
+    } while (ATB_GET_KIND(area, block + n_blocks) == AT_TAIL);
+    assert(area->gc_pool_start + (block + n_blocks) * BYTES_PER_BLOCK <= area->gc_pool_end);
+    gc_inc_mark_ptrs((void **)PTR_FROM_BLOCK(area, block), n_blocks * BYTES_PER_BLOCK / sizeof(void *));
+}
+
+// After a mark stack overflow: look for the next marked head, whose children
+// may not have been scanned, and scan them.
+static void gc_inc_rescan_step(void) {
+    mp_state_mem_area_t *area = MP_STATE_MEM(gc_inc_area);
+    size_t block = MP_STATE_MEM(gc_inc_block);
+    size_t end = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+    size_t limit = MIN(end, block + GC_INC_BLOCK_CHUNK);
+    for (; block < limit; block++) {
+        if (ATB_GET_KIND(area, block) == AT_MARK) {
+            gc_inc_scan_block(area, block++);
+            break;
+        }
+    }
+    if (block == end) {
+        area = NEXT_AREA(area);
+        block = 0;
+        if (area == NULL) {
+            MP_STATE_MEM(gc_inc_rescan) = false;
+        }
+    }
+    MP_STATE_MEM(gc_inc_area) = area;
+    MP_STATE_MEM(gc_inc_block) = block;
+}
+
+// Returns true when the mark is complete.
+static bool gc_inc_mark_step(uint32_t t0, uint32_t budget_us) {
+    for (;;) {
+        if (MP_STATE_MEM(gc_inc_sp) > 0) {
+            size_t sp = --MP_STATE_MEM(gc_inc_sp);
+            #if MICROPY_GC_SPLIT_HEAP
+            gc_inc_scan_block(MP_STATE_MEM(gc_area_stack)[sp], MP_STATE_MEM(gc_block_stack)[sp]);
+            #else
+            gc_inc_scan_block(&MP_STATE_MEM(area), MP_STATE_MEM(gc_block_stack)[sp]);
+            #endif
+        } else if (MP_STATE_MEM(gc_inc_n_roots) > 0) {
+            size_t r = MP_STATE_MEM(gc_inc_n_roots) - 1;
+            size_t len = MIN(MP_STATE_MEM(gc_inc_root_len)[r], GC_INC_ROOT_CHUNK);
+            gc_inc_mark_ptrs(MP_STATE_MEM(gc_inc_root_ptrs)[r], len);
+            MP_STATE_MEM(gc_inc_root_ptrs)[r] += len;
+            MP_STATE_MEM(gc_inc_root_len)[r] -= len;
+            if (MP_STATE_MEM(gc_inc_root_len)[r] == 0) {
+                MP_STATE_MEM(gc_inc_n_roots) = r;
+            }
+        } else if (MP_STATE_MEM(gc_inc_rescan)) {
+            gc_inc_rescan_step();
+        } else if (MP_STATE_MEM(gc_stack_overflow)) {
+            MP_STATE_MEM(gc_stack_overflow) = 0;
+            MP_STATE_MEM(gc_inc_rescan) = true;
+            MP_STATE_MEM(gc_inc_area) = &MP_STATE_MEM(area);
+            MP_STATE_MEM(gc_inc_block) = 0;
+        } else {
+            return true;
+        }
+        if (MICROPY_GC_INCREMENTAL_TICKS_US() - t0 >= budget_us) {
+            return false;
+        }
+    }
+}
+
+static void gc_inc_sweep_begin_area(mp_state_mem_area_t *area) {
+    MP_STATE_MEM(gc_inc_area) = area;
+    MP_STATE_MEM(gc_inc_block) = 0;
+    MP_STATE_MEM(gc_inc_free_tail) = 0;
+    MP_STATE_MEM(gc_inc_last_used_block) = 0;
+    MP_STATE_MEM(gc_inc_alloc_max) = 0;
+    #if MICROPY_GC_FREELISTS
+    memset(area->gc_freelist_len, 0, sizeof(area->gc_freelist_len));
+    MP_STATE_MEM(gc_inc_free_run) = 0;
+    #endif
+}
+
+static void gc_inc_mark_done(void) {
+    MP_STATE_MEM(gc_inc_phase) = GC_INC_SWEEP;
+    #if MICROPY_PY_GC_COLLECT_RETVAL
+    MP_STATE_MEM(gc_collected) = 0;
+    #endif
+    gc_inc_sweep_begin_area(&MP_STATE_MEM(area));
+    #if MICROPY_GC_MOVABLE
+    gc_movable_mark_done();
+    #endif
+    // finalisers run like in gc_collect_end, with the heap locked
+    MP_STATE_THREAD(gc_lock_depth) |= GC_COLLECT_FLAG;
+    gc_sweep_run_finalisers();
+    MP_STATE_THREAD(gc_lock_depth) &= ~GC_COLLECT_FLAG;
+}
+
+static void gc_inc_sweep_step(uint32_t t0, uint32_t budget_us) {
+    mp_state_mem_area_t *area = MP_STATE_MEM(gc_inc_area);
+    size_t block = MP_STATE_MEM(gc_inc_block);
+    int free_tail = MP_STATE_MEM(gc_inc_free_tail);
+    size_t last_used_block = MP_STATE_MEM(gc_inc_last_used_block);
+    #if MICROPY_GC_FREELISTS
+    size_t free_run = MP_STATE_MEM(gc_inc_free_run);
+    #endif
+
+    for (;;) {
+        if (block > area->gc_last_used_block) {
+            // Done with this area.  Blocks allocated behind the sweep were
+            // not seen by it.  Empty areas are kept (no MICROPY_GC_SPLIT_HEAP_AUTO).
+            area->gc_last_used_block = MAX(last_used_block, MP_STATE_MEM(gc_inc_alloc_max));
+            area = NEXT_AREA(area);
+            if (area == NULL) {
+                MP_STATE_MEM(gc_inc_phase) = GC_INC_IDLE;
+                MP_STATE_MEM(gc_inc_cycles)++;
+                break;
+            }
+            gc_inc_sweep_begin_area(area);
+            block = 0;
+            free_tail = 0;
+            last_used_block = 0;
+            #if MICROPY_GC_FREELISTS
+            free_run = 0;
+            #endif
+            continue;
+        }
+
+        if (gc_sweep_block(area, block, &free_tail, &last_used_block)) {
+            // the mutator may have allocated past this block since the sweep began
+            if (block / BLOCKS_PER_ATB < area->gc_last_free_atb_index) {
+                area->gc_last_free_atb_index = block / BLOCKS_PER_ATB;
+            }
+        }
+
+        #if MICROPY_GC_FREELISTS
+        if (ATB_GET_KIND(area, block) == AT_FREE) {
+            free_run++;
+        } else {
+            if (free_run > 0 && free_run <= MICROPY_GC_FREELIST_MAX_BLOCKS) {
+                gc_freelist_push(area, block - free_run, free_run);
+            }
+            free_run = 0;
+        }
+        #endif
+
+        if (++block % GC_INC_BLOCK_CHUNK == 0 && MICROPY_GC_INCREMENTAL_TICKS_US() - t0 >= budget_us) {
+            break;
+        }
+    }
+
+    MP_STATE_MEM(gc_inc_block) = block;
+    MP_STATE_MEM(gc_inc_free_tail) = free_tail;
+    MP_STATE_MEM(gc_inc_last_used_block) = last_used_block;
+    #if MICROPY_GC_FREELISTS
+    MP_STATE_MEM(gc_inc_free_run) = free_run;
+    #endif
+    #if MICROPY_GC_SPLIT_HEAP
+    // see comment in gc_free
+    MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
+    #endif
+}
+
+// Called by gc_alloc and gc_realloc for blocks start_block..end_block (both
+// inclusive) of area that were just allocated during the sweep.  Returns true
+// if the new head is in the region not swept yet, so must be allocated black.
+static bool gc_inc_sweep_alloc(mp_state_mem_area_t *area, size_t start_block, size_t end_block) {
+    mp_state_mem_area_t *sweep_area = MP_STATE_MEM(gc_inc_area);
+    if (area == sweep_area) {
+        size_t sweep_block = MP_STATE_MEM(gc_inc_block);
+        if (start_block >= sweep_block) {
+            return true;
+        }
+        if (end_block >= sweep_block) {
+            // the sweep is about to see tails of a live head
+            MP_STATE_MEM(gc_inc_free_tail) = 0;
+        } else {
+            MP_STATE_MEM(gc_inc_alloc_max) = MAX(MP_STATE_MEM(gc_inc_alloc_max), end_block);
+        }
+        return false;
+    }
+    for (mp_state_mem_area_t *a = NEXT_AREA(sweep_area); a != NULL; a = NEXT_AREA(a)) {
+        if (a == area) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void gc_inc_start(void) {
+    assert(MP_STATE_MEM(gc_inc_phase) == GC_INC_IDLE);
+    GC_ENTER();
+    MP_STATE_MEM(gc_inc_phase) = GC_INC_MARK;
+    MP_STATE_MEM(gc_inc_sp) = 0;
+    MP_STATE_MEM(gc_inc_n_roots) = 0;
+    MP_STATE_MEM(gc_inc_rescan) = false;
+    MP_STATE_MEM(gc_stack_overflow) = 0;
+    MP_STATE_MEM(gc_inc_mark_us) = 0;
+    MP_STATE_MEM(gc_inc_alloc_blocks) = 0;
+    MP_STATE_MEM(gc_inc_mutated) = false;
+    // queue the same roots as gc_collect_start
+    gc_collect_root_pointers();
+    GC_EXIT();
+}
+
+bool gc_inc_step(uint32_t budget_us) {
+    unsigned int phase = MP_STATE_MEM(gc_inc_phase);
+    if (phase == GC_INC_IDLE) {
+        return true;
+    }
+    GC_ENTER();
+    MP_TRACE_EVENT(MP_TRACE_GC_BEGIN, phase);
+    uint32_t t0 = MICROPY_GC_INCREMENTAL_TICKS_US();
+    if (phase == GC_INC_MARK) {
+        if (MP_STATE_MEM(gc_inc_mutated)) {
+            // an interrupt handler ran Python code since the mark began
+            gc_inc_discard();
+        } else if (gc_inc_mark_step(t0, budget_us)) {
+            // check again: the handler may have run during this slice
+            if (MP_STATE_MEM(gc_inc_mutated)) {
+                gc_inc_discard();
+            } else {
+                gc_inc_mark_done();
+            }
+        }
+    } else {
+        gc_inc_sweep_step(t0, budget_us);
+    }
+    uint32_t dt = MICROPY_GC_INCREMENTAL_TICKS_US() - t0;
+    if (phase == GC_INC_MARK) {
+        MP_STATE_MEM(gc_inc_mark_us) += dt;
+        if (MP_STATE_MEM(gc_inc_phase) == GC_INC_SWEEP) {
+            MP_STATE_MEM(gc_inc_last_mark_us) = MP_STATE_MEM(gc_inc_mark_us);
+            MP_STATE_MEM(gc_inc_abort_run) = 0;
+        } else if (MP_STATE_MEM(gc_inc_phase) == GC_INC_IDLE) {
+            // discarded during this slice: count the slice towards the estimate too
+            MP_STATE_MEM(gc_inc_last_mark_us) = MAX(MP_STATE_MEM(gc_inc_last_mark_us), MP_STATE_MEM(gc_inc_mark_us));
+        }
+    }
+    MP_STATE_MEM(gc_inc_max_slice_us) = MAX(MP_STATE_MEM(gc_inc_max_slice_us), dt);
+    MP_TRACE_EVENT(MP_TRACE_GC_END, phase);
+    GC_EXIT();
+    return MP_STATE_MEM(gc_inc_phase) == GC_INC_IDLE;
+}
+
+void gc_inc_note_mutation(void) {
+    MP_STATE_MEM(gc_inc_mutated) = true;
+}
+
+// Discard the mark in progress.  The caller holds the GC mutex.
+static void gc_inc_discard(void) {
+    // unmark all heads, four blocks per ATB byte: MARK (0b11) -> HEAD (0b01)
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        size_t atb_end = MIN(area->gc_last_used_block / BLOCKS_PER_ATB + 1, area->gc_alloc_table_byte_len);
+        for (size_t i = 0; i < atb_end; i++) {
+            byte a = area->gc_alloc_table_start[i];
+            area->gc_alloc_table_start[i] = a & ~((a & 0x55) << 1);
+        }
+    }
+    MP_STATE_MEM(gc_inc_phase) = GC_INC_IDLE;
+    MP_STATE_MEM(gc_inc_sp) = 0;
+    MP_STATE_MEM(gc_inc_n_roots) = 0;
+    MP_STATE_MEM(gc_inc_rescan) = false;
+    MP_STATE_MEM(gc_stack_overflow) = 0;
+    MP_STATE_MEM(gc_inc_aborts)++;
+    // A mark takes at least as long as the time spent on this one, so the
+    // next cycle waits for an idle window that long, even if no mark has
+    // completed yet (the estimate would otherwise stay 0 and every window
+    // would start a mark that gets thrown away).
+    MP_STATE_MEM(gc_inc_last_mark_us) = MAX(MP_STATE_MEM(gc_inc_last_mark_us), MP_STATE_MEM(gc_inc_mark_us));
+    if (MP_STATE_MEM(gc_inc_abort_run) < UINT8_MAX) {
+        MP_STATE_MEM(gc_inc_abort_run)++;
+    }
+}
+
+void gc_inc_abort(void) {
+    if (MP_STATE_MEM(gc_inc_phase) != GC_INC_MARK) {
+        return;
+    }
+    GC_ENTER();
+    gc_inc_discard();
+    GC_EXIT();
+}
+
+// Complete a sweep in progress, or discard a mark in progress.
+static void gc_inc_finish(void) {
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_MARK) {
+        gc_inc_abort();
+    } else {
+        while (!gc_inc_step(UINT32_MAX)) {
+        }
+    }
+}
+#endif // MICROPY_GC_INCREMENTAL
+
 // Address sanitizer needs to know that the access to ptrs[i] must always be
 // considered OK, even if it's a load from an address that would normally be
 // prohibited (due to being undefined, in a red zone, etc).
@@ -717,7 +1314,12 @@ void gc_info(gc_info_t *info) {
                     break;
 
                 case AT_MARK:
-                    // shouldn't happen
+                    #if MICROPY_GC_INCREMENTAL
+                    // a head allocated black during a lazy sweep
+                    info->used += 1;
+                    len = 1;
+                    #endif
+                    // otherwise shouldn't happen
                     break;
             }
 
@@ -728,7 +1330,7 @@ void gc_info(gc_info_t *info) {
                 kind = ATB_GET_KIND(area, block);
             }
 
-            if (finish || kind == AT_FREE || kind == AT_HEAD) {
+            if (finish || kind == AT_FREE || kind == AT_HEAD || kind == AT_MARK) {
                 if (len == 1) {
                     info->num_1block += 1;
                 } else if (len == 2) {
@@ -737,7 +1339,7 @@ void gc_info(gc_info_t *info) {
                 if (len > info->max_block) {
                     info->max_block = len;
                 }
-                if (finish || kind == AT_HEAD) {
+                if (finish || kind == AT_HEAD || kind == AT_MARK) {
                     if (len_free > info->max_free) {
                         info->max_free = len_free;
                     }
@@ -757,6 +1359,438 @@ void gc_info(gc_info_t *info) {
     GC_EXIT();
 }
 
+#if MICROPY_GC_FREELISTS
+// Size-class free lists: for each run length n (1 to MICROPY_GC_FREELIST_MAX_BLOCKS)
+// a stack of start blocks of free runs of exactly n blocks, filled by the sweep.
+// The entries are only hints: the ATB scan may since have taken part of a run,
+// so each run is checked against the ATB when popped and stale ones dropped.
+// Nothing is stored in the free blocks themselves.
+static void gc_freelist_push(mp_state_mem_area_t *area, size_t block, size_t n) {
+    uint16_t *len = &area->gc_freelist_len[n - 1];
+    if (*len < MICROPY_GC_FREELIST_DEPTH) {
+        area->gc_freelist[n - 1][(*len)++] = block;
+    }
+}
+
+static bool gc_freelist_pop(mp_state_mem_area_t *area, size_t n_blocks, size_t *start_block) {
+    // Exact size class first, then split the smallest larger run.
+    for (size_t n = n_blocks; n <= MICROPY_GC_FREELIST_MAX_BLOCKS; n++) {
+        uint16_t *len = &area->gc_freelist_len[n - 1];
+        while (*len > 0) {
+            size_t block = area->gc_freelist[n - 1][--(*len)];
+            size_t bl = block;
+            while (bl < block + n && ATB_GET_KIND(area, bl) == AT_FREE) {
+                bl++;
+            }
+            if (bl == block + n) {
+                if (n > n_blocks) {
+                    gc_freelist_push(area, block + n_blocks, n - n_blocks);
+                }
+                *start_block = block;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+#endif
+
+#if MICROPY_GC_ALLOC_HIGH
+// Find the highest run of n_blocks free blocks in the area, scanning down
+// from its end.
+static bool gc_alloc_high(mp_state_mem_area_t *area, size_t n_blocks, size_t *start_block) {
+    size_t n_free = 0;
+    for (size_t i = area->gc_alloc_table_byte_len; i-- > 0;) {
+        MICROPY_GC_HOOK_LOOP(i);
+        byte a = area->gc_alloc_table_start[i];
+        if (a == 0 && n_free + BLOCKS_PER_ATB < n_blocks) {
+            // four free blocks that don't complete the run
+            n_free += BLOCKS_PER_ATB;
+            continue;
+        }
+        for (size_t bl = i * BLOCKS_PER_ATB + BLOCKS_PER_ATB; bl-- > i * BLOCKS_PER_ATB;) {
+            if (ATB_GET_KIND(area, bl) != AT_FREE) {
+                n_free = 0;
+            } else if (++n_free >= n_blocks) {
+                *start_block = bl;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+#endif
+
+#if MICROPY_GC_ALLOC_STATS
+static struct {
+    uint32_t samples[MICROPY_GC_ALLOC_STATS_SIZE];
+    size_t count; // total recorded; the ring holds the last MICROPY_GC_ALLOC_STATS_SIZE
+    bool paused;
+} gc_alloc_stats;
+
+static void gc_alloc_stats_record(uint32_t t0) {
+    if (!gc_alloc_stats.paused) {
+        gc_alloc_stats.samples[gc_alloc_stats.count++ % MICROPY_GC_ALLOC_STATS_SIZE] = MICROPY_GC_ALLOC_STATS_CYCLES() - t0;
+    }
+}
+
+size_t gc_alloc_stats_begin(void) {
+    gc_alloc_stats.paused = true;
+    return MIN(gc_alloc_stats.count, MICROPY_GC_ALLOC_STATS_SIZE);
+}
+
+uint32_t gc_alloc_stats_get(size_t i) {
+    size_t n = MIN(gc_alloc_stats.count, MICROPY_GC_ALLOC_STATS_SIZE);
+    return gc_alloc_stats.samples[(gc_alloc_stats.count - n + i) % MICROPY_GC_ALLOC_STATS_SIZE];
+}
+
+void gc_alloc_stats_end(bool reset) {
+    if (reset) {
+        gc_alloc_stats.count = 0;
+    }
+    gc_alloc_stats.paused = false;
+}
+#endif
+
+#if MICROPY_GC_ALLOC_SITES
+// Linear probes per lookup before an allocation is counted as "other"
+#define GC_SITE_MAX_PROBES (8)
+
+// Return the site index for an allocation made now, on behalf of the given C
+// caller if no bytecode is executing.  The table is open addressed; a site is
+// claimed in the first free slot, so the cost stays bounded by the probes.
+static byte gc_site_lookup(const void *caller) {
+    const void *where = caller;
+    size_t offset = GC_SITE_C_CALLER;
+    const mp_code_state_t *code_state = MP_STATE_THREAD(current_code_state);
+    if (code_state != NULL) {
+        where = code_state->fun_bc;
+        offset = code_state->ip - code_state->fun_bc->bytecode;
+    }
+    size_t slot = (((uintptr_t)where >> 2) ^ (offset * 0x9e3779b1)) % MICROPY_GC_ALLOC_SITES_MAX;
+    for (size_t probe = 0; probe < GC_SITE_MAX_PROBES; probe++) {
+        const void **w = &MP_STATE_VM(gc_site_where)[slot];
+        if (*w == NULL) {
+            *w = where;
+            MP_STATE_MEM(gc_site_offset)[slot] = offset;
+            return GC_SITE_FIRST + slot;
+        }
+        if (*w == where && MP_STATE_MEM(gc_site_offset)[slot] == offset) {
+            return GC_SITE_FIRST + slot;
+        }
+        if (++slot == MICROPY_GC_ALLOC_SITES_MAX) {
+            slot = 0;
+        }
+    }
+    return GC_SITE_OTHER;
+}
+
+bool gc_site_get(size_t slot, const void **where, size_t *offset) {
+    *where = MP_STATE_VM(gc_site_where)[slot];
+    *offset = MP_STATE_MEM(gc_site_offset)[slot];
+    return *where != NULL;
+}
+
+void gc_site_histogram(size_t hist[GC_SITE_NUM][GC_SITE_HIST_COLS]) {
+    #if MICROPY_GC_INCREMENTAL
+    // objects left unmarked by the last mark are only freed by the lazy sweep
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_SWEEP) {
+        gc_inc_finish();
+    }
+    #endif
+    GC_ENTER();
+    memset(hist, 0, GC_SITE_NUM * sizeof(hist[0]));
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        size_t total_blocks = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+        for (size_t block = 0; block < total_blocks;) {
+            size_t kind = ATB_GET_KIND(area, block);
+            if ((kind != AT_HEAD && kind != AT_MARK) || (void *)PTR_FROM_BLOCK(area, block) == hist) {
+                // (the caller's buffer for the histogram is left out)
+                block++;
+                continue;
+            }
+            size_t n = 1;
+            while (block + n < total_blocks && ATB_GET_KIND(area, block + n) == AT_TAIL) {
+                n++;
+            }
+            size_t bucket = 0;
+            while (bucket < GC_SITE_SIZE_BUCKETS - 1 && n > ((size_t)1 << bucket)) {
+                bucket++;
+            }
+            size_t *row = hist[area->gc_site_table_start[block]];
+            row[bucket] += 1;
+            row[GC_SITE_SIZE_BUCKETS] += n;
+            block += n;
+        }
+    }
+    GC_EXIT();
+}
+
+void gc_site_reset(void) {
+    GC_ENTER();
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        memset(area->gc_site_table_start, GC_SITE_UNTRACKED, area->gc_alloc_table_byte_len * STB_BYTES_PER_ATB);
+    }
+    memset(MP_STATE_MEM(gc_site_offset), 0, sizeof(MP_STATE_MEM(gc_site_offset)));
+    memset(MP_STATE_VM(gc_site_where), 0, sizeof(MP_STATE_VM(gc_site_where)));
+    GC_EXIT();
+}
+#endif
+
+#if MICROPY_GC_MOVABLE
+// Movable buffers.  The table only changes when buffers are registered,
+// reallocated, moved or freed; gc_movable_lo/span cover all the buffers (and
+// the address just past each) so that the mark skips most words with one
+// comparison.
+
+static void gc_movable_update_range(void) {
+    uintptr_t lo = UINTPTR_MAX;
+    uintptr_t hi = 0;
+    for (size_t i = 0; i < MP_STATE_MEM(gc_movable_len); i++) {
+        const mp_state_mem_movable_t *m = &MP_STATE_MEM(gc_movable)[i];
+        lo = MIN(lo, (uintptr_t)m->buf);
+        hi = MAX(hi, (uintptr_t)m->buf + m->n_blocks * BYTES_PER_BLOCK + 1);
+    }
+    MP_STATE_MEM(gc_movable_lo) = lo;
+    MP_STATE_MEM(gc_movable_span) = hi > lo ? hi - lo : 0;
+}
+
+static mp_state_mem_movable_t *gc_movable_find(const void *buf) {
+    for (size_t i = 0; i < MP_STATE_MEM(gc_movable_len); i++) {
+        if (MP_STATE_MEM(gc_movable)[i].buf == buf) {
+            return &MP_STATE_MEM(gc_movable)[i];
+        }
+    }
+    return NULL;
+}
+
+static void gc_movable_remove(mp_state_mem_movable_t *m) {
+    *m = MP_STATE_MEM(gc_movable)[--MP_STATE_MEM(gc_movable_len)];
+    gc_movable_update_range();
+}
+
+static bool gc_is_marked(const void *ptr) {
+    mp_state_mem_area_t *area = gc_ptr_area(ptr);
+    return ATB_GET_KIND(area, BLOCK_FROM_PTR(area, ptr)) == AT_MARK;
+}
+
+void gc_movable_register(void *owner, void **handle) {
+    void *buf = *handle;
+    GC_ENTER();
+    size_t n_bytes = gc_nbytes(buf);
+    mp_state_mem_movable_t *m = gc_movable_find(buf);
+    if (m == NULL) {
+        if (n_bytes < MICROPY_GC_MOVABLE_MIN_BYTES || n_bytes > MICROPY_GC_MOVABLE_MAX_BYTES
+            || MP_STATE_MEM(gc_movable_len) == MICROPY_GC_MOVABLE_MAX) {
+            GC_EXIT();
+            return;
+        }
+        m = &MP_STATE_MEM(gc_movable)[MP_STATE_MEM(gc_movable_len)++];
+        m->buf = buf;
+        m->pins = 0;
+        m->seen = false;
+    }
+    m->owner = owner;
+    m->handle = handle;
+    m->n_blocks = n_bytes / BYTES_PER_BLOCK;
+    gc_movable_update_range();
+    GC_EXIT();
+}
+
+void gc_pin(const void *buf) {
+    GC_ENTER();
+    mp_state_mem_movable_t *m = gc_movable_find(buf);
+    // a count that reached the maximum stays there: the buffer never moves
+    if (m != NULL && m->pins < UINT8_MAX) {
+        m->pins++;
+    }
+    GC_EXIT();
+}
+
+void gc_unpin(const void *buf) {
+    GC_ENTER();
+    mp_state_mem_movable_t *m = gc_movable_find(buf);
+    if (m != NULL && m->pins > 0 && m->pins < UINT8_MAX) {
+        m->pins--;
+    }
+    GC_EXIT();
+}
+
+// Called by the full mark for a word at slot that points into (or just past)
+// some movable buffer: unless slot is that buffer's handle, pin the buffer.
+static void gc_movable_note(void **slot, const void *ptr) {
+    for (size_t i = 0; i < MP_STATE_MEM(gc_movable_len); i++) {
+        mp_state_mem_movable_t *m = &MP_STATE_MEM(gc_movable)[i];
+        if ((uintptr_t)ptr - (uintptr_t)m->buf <= m->n_blocks * BYTES_PER_BLOCK && slot != m->handle) {
+            m->seen = true;
+        }
+    }
+}
+
+// Called when a mark is complete, before the sweep: forget the buffers that
+// are about to be freed, and the handles in owners that are about to be freed.
+static void gc_movable_mark_done(void) {
+    for (size_t i = 0; i < MP_STATE_MEM(gc_movable_len);) {
+        mp_state_mem_movable_t *m = &MP_STATE_MEM(gc_movable)[i];
+        if (!gc_is_marked(m->buf)) {
+            gc_movable_remove(m);
+            continue;
+        }
+        if (m->handle != NULL && !gc_is_marked(m->owner)) {
+            m->handle = NULL;
+        }
+        i++;
+    }
+}
+
+// Called by gc_free.
+static void gc_movable_freed(const void *ptr) {
+    for (size_t i = 0; i < MP_STATE_MEM(gc_movable_len); i++) {
+        mp_state_mem_movable_t *m = &MP_STATE_MEM(gc_movable)[i];
+        if (m->buf == ptr) {
+            gc_movable_remove(m);
+            return;
+        }
+        if (m->owner == ptr) {
+            m->handle = NULL;
+        }
+    }
+}
+
+// Called by gc_realloc once the buffer at ptr_in is n_blocks long at ptr_out.
+static void gc_movable_realloc(const void *ptr_in, void *ptr_out, size_t n_blocks) {
+    mp_state_mem_movable_t *m = gc_movable_find(ptr_in);
+    if (m != NULL) {
+        m->buf = ptr_out;
+        m->n_blocks = n_blocks;
+        gc_movable_update_range();
+    }
+}
+
+static size_t gc_largest_free_run(void) {
+    size_t largest = 0;
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        size_t total_blocks = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+        for (size_t block = 0, run = 0; block < total_blocks; block++) {
+            if (ATB_GET_KIND(area, block) == AT_FREE) {
+                largest = MAX(largest, ++run);
+            } else {
+                run = 0;
+            }
+        }
+    }
+    return largest * BYTES_PER_BLOCK;
+}
+
+// Slide the movable buffers of area that are not pinned down, in address order,
+// each into the lowest free run below it that is long enough.  Buffers over
+// MICROPY_GC_MOVABLE_MAX_BYTES stay in place.  A buffer's own blocks count as
+// free, so one just above a shorter free run slides down into it.
+static void gc_movable_compact_area(mp_state_mem_area_t *area) {
+    uint8_t order[MICROPY_GC_MOVABLE_MAX];
+    size_t n = 0;
+    for (size_t i = 0; i < MP_STATE_MEM(gc_movable_len); i++) {
+        const mp_state_mem_movable_t *m = &MP_STATE_MEM(gc_movable)[i];
+        if (m->pins > 0 || m->seen || m->handle == NULL || gc_ptr_area(m->buf) != area) {
+            continue;
+        }
+        size_t j = n++;
+        for (; j > 0 && (uintptr_t)MP_STATE_MEM(gc_movable)[order[j - 1]].buf > (uintptr_t)m->buf; j--) {
+            order[j] = order[j - 1];
+        }
+        order[j] = i;
+    }
+
+    size_t first_free = 0;
+    for (size_t k = 0; k < n; k++) {
+        mp_state_mem_movable_t *m = &MP_STATE_MEM(gc_movable)[order[k]];
+        if (*m->handle != m->buf) {
+            // the owner no longer refers to the buffer through the handle
+            m->handle = NULL;
+            continue;
+        }
+        size_t block = BLOCK_FROM_PTR(area, m->buf);
+        size_t n_blocks = 1;
+        while (ATB_GET_KIND(area, block + n_blocks) == AT_TAIL) {
+            n_blocks++;
+        }
+        m->n_blocks = n_blocks;
+        #if MICROPY_ENABLE_FINALISER
+        assert(!FTB_GET(area, block));
+        #endif
+        if (n_blocks * BYTES_PER_BLOCK > MICROPY_GC_MOVABLE_MAX_BYTES) {
+            // grown by gc_realloc since it was registered: too long to move
+            // with interrupts disabled
+            continue;
+        }
+
+        while (first_free < block && ATB_GET_KIND(area, first_free) != AT_FREE) {
+            first_free++;
+        }
+        size_t dest = block;
+        size_t run = 0;
+        for (size_t bl = first_free; bl < block; bl++) {
+            if (ATB_GET_KIND(area, bl) != AT_FREE) {
+                run = 0;
+            } else if (++run == n_blocks) {
+                dest = bl + 1 - n_blocks;
+                break;
+            }
+        }
+        if (dest == block) {
+            // no run long enough: slide down into the run just below, if any
+            dest = block - run;
+            if (dest == block) {
+                continue;
+            }
+        }
+
+        // A hard interrupt handler may read the buffer through its owner:
+        // move it and update the handle with interrupts disabled.
+        void *ptr = (void *)PTR_FROM_BLOCK(area, dest);
+        mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+        memmove(ptr, m->buf, n_blocks * BYTES_PER_BLOCK);
+        #if MICROPY_GC_ALLOC_SITES
+        area->gc_site_table_start[dest] = area->gc_site_table_start[block];
+        #endif
+        // free the old blocks, then allocate the new ones (the two may overlap)
+        for (size_t bl = block; bl < block + n_blocks; bl++) {
+            ATB_ANY_TO_FREE(area, bl);
+        }
+        ATB_FREE_TO_HEAD(area, dest);
+        for (size_t bl = dest + 1; bl < dest + n_blocks; bl++) {
+            ATB_FREE_TO_TAIL(area, bl);
+        }
+        *m->handle = ptr;
+        MICROPY_END_ATOMIC_SECTION(atomic_state);
+        m->buf = ptr;
+        MP_STATE_MEM(gc_compact_moves)++;
+        MP_STATE_MEM(gc_compact_bytes) += n_blocks * BYTES_PER_BLOCK;
+    }
+}
+
+// Called by gc_collect_end after the sweep.
+static void gc_compact_if_fragmented(void) {
+    size_t want = MAX(MP_STATE_MEM(gc_compact_threshold), MP_STATE_MEM(gc_compact_want));
+    MP_STATE_MEM(gc_compact_want) = 0;
+    if (MP_STATE_MEM(gc_movable_len) == 0 || gc_largest_free_run() >= want) {
+        return;
+    }
+    MP_STATE_MEM(gc_compact_runs)++;
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+        gc_movable_compact_area(area);
+    }
+    gc_movable_update_range();
+}
+
+size_t gc_compact(void) {
+    size_t moves = MP_STATE_MEM(gc_compact_moves);
+    MP_STATE_MEM(gc_compact_want) = (size_t)-1;
+    gc_collect();
+    return MP_STATE_MEM(gc_compact_moves) - moves;
+}
+#endif
+
 void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
     bool has_finaliser = alloc_flags & GC_ALLOC_FLAG_HAS_FINALISER;
     size_t n_blocks = ((n_bytes + BYTES_PER_BLOCK - 1) & (~(BYTES_PER_BLOCK - 1))) / BYTES_PER_BLOCK;
@@ -772,6 +1806,26 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
         return NULL;
     }
 
+    #if MICROPY_GC_INCREMENTAL
+    // the mutator is running again, so a mark in progress is no longer valid
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_MARK) {
+        gc_inc_abort();
+    }
+    #endif
+
+    #if MICROPY_GC_ALLOC_STATS
+    uint32_t stats_t0 = MICROPY_GC_ALLOC_STATS_CYCLES();
+    #endif
+
+    #if MICROPY_GC_ALLOC_SITES
+    // the m_malloc family passes its caller; otherwise attribute to ours
+    const void *site_caller = MP_STATE_MEM(gc_site_caller);
+    MP_STATE_MEM(gc_site_caller) = NULL;
+    if (site_caller == NULL) {
+        site_caller = __builtin_return_address(0);
+    }
+    #endif
+
     GC_ENTER();
 
     mp_state_mem_area_t *area;
@@ -783,6 +1837,11 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
     #if MICROPY_GC_SPLIT_HEAP_AUTO
     bool added = false;
     #endif
+    #if MICROPY_GC_AREA_PLACEMENT
+    unsigned int area_kind = gc_alloc_area_kind(n_bytes);
+    // bulk buffers falling back from a full bulk area go to ordinary RAM, never TCM
+    bool no_tcm = (alloc_flags & GC_ALLOC_FLAG_NO_TCM) || area_kind == GC_AREA_BULK;
+    #endif
 
     #if MICROPY_GC_ALLOC_THRESHOLD
     if (!collected && MP_STATE_MEM(gc_alloc_amount) >= MP_STATE_MEM(gc_alloc_threshold)) {
@@ -795,14 +1854,40 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
 
     for (;;) {
 
-        #if MICROPY_GC_SPLIT_HEAP
-        area = MP_STATE_MEM(gc_last_free_area);
-        #else
-        area = &MP_STATE_MEM(area);
+        #if MICROPY_GC_FREELISTS
+        // short runs come from the size-class free lists, without an ATB scan
+        if (n_blocks <= MICROPY_GC_FREELIST_MAX_BLOCKS) {
+            for (area = FIRST_ALLOC_AREA(area_kind, no_tcm); area != NULL; area = NEXT_ALLOC_AREA(area, area_kind, no_tcm)) {
+                #if MICROPY_GC_AREA_PLACEMENT
+                if (area->gc_area_kind != area_kind) {
+                    // leave the fallback to the other kind to the ATB scan below
+                    continue;
+                }
+                #endif
+                if (gc_freelist_pop(area, n_blocks, &start_block)) {
+                    end_block = start_block + n_blocks - 1;
+                    goto found_run;
+                }
+            }
+        }
+        #endif
+
+        #if MICROPY_GC_ALLOC_HIGH
+        if (alloc_flags & GC_ALLOC_FLAG_HIGH) {
+            for (area = FIRST_ALLOC_AREA(area_kind, no_tcm); area != NULL; area = NEXT_ALLOC_AREA(area, area_kind, no_tcm)) {
+                if (gc_alloc_high(area, n_blocks, &start_block)) {
+                    end_block = start_block + n_blocks - 1;
+                    goto found_run;
+                }
+            }
+            // no run anywhere, so the scan below fails too and collects
+        }
         #endif
 
+        area = FIRST_ALLOC_AREA(area_kind, no_tcm);
+
         // look for a run of n_blocks available blocks
-        for (; area != NULL; area = NEXT_AREA(area), i = 0) {
+        for (; area != NULL; area = NEXT_ALLOC_AREA(area, area_kind, no_tcm), i = 0) {
             n_free = 0;
             for (i = area->gc_last_free_atb_index; i < area->gc_alloc_table_byte_len; i++) {
                 MICROPY_GC_HOOK_LOOP(i);
@@ -827,6 +1912,14 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
 
         GC_EXIT();
         // nothing found!
+        #if MICROPY_GC_INCREMENTAL
+        if (MP_STATE_MEM(gc_inc_phase) == GC_INC_SWEEP) {
+            // the rest of the lazy sweep may free enough
+            gc_inc_finish();
+            GC_ENTER();
+            continue;
+        }
+        #endif
         if (collected) {
             #if MICROPY_GC_SPLIT_HEAP_AUTO
             if (!added && gc_try_add_heap(n_bytes)) {
@@ -837,6 +1930,10 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
             return NULL;
         }
         DEBUG_printf("gc_alloc(" UINT_FMT "): no free mem, triggering GC\n", n_bytes);
+        #if MICROPY_GC_MOVABLE
+        // compact if that leaves no free run for this request
+        MP_STATE_MEM(gc_compact_want) = n_bytes;
+        #endif
         gc_collect();
         collected = 1;
         GC_ENTER();
@@ -860,11 +1957,26 @@ found:
         area->gc_last_free_atb_index = (i + 1) / BLOCKS_PER_ATB;
     }
 
+    #if MICROPY_GC_FREELISTS || MICROPY_GC_ALLOC_HIGH
+found_run:
+    #endif
     area->gc_last_used_block = MAX(area->gc_last_used_block, end_block);
 
     // mark first block as used head
     ATB_FREE_TO_HEAD(area, start_block);
 
+    #if MICROPY_GC_ALLOC_SITES
+    area->gc_site_table_start[start_block] = gc_site_lookup(site_caller);
+    #endif
+
+    #if MICROPY_GC_INCREMENTAL
+    MP_STATE_MEM(gc_inc_alloc_blocks) += n_blocks;
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_SWEEP && gc_inc_sweep_alloc(area, start_block, end_block)) {
+        // allocate black, so the lazy sweep keeps it
+        ATB_HEAD_TO_MARK(area, start_block);
+    }
+    #endif
+
     // mark rest of blocks as used tail
     // TODO for a run of many blocks can make this more efficient
     for (size_t bl = start_block + 1; bl <= end_block; bl++) {
@@ -911,6 +2023,10 @@ found:
     gc_dump_alloc_table(&mp_plat_print);
     #endif
 
+    #if MICROPY_GC_ALLOC_STATS
+    gc_alloc_stats_record(stats_t0);
+    #endif
+
     return ret_ptr;
 }
 
@@ -927,6 +2043,12 @@ void gc_free(void *ptr) {
         return;
     }
 
+    #if MICROPY_GC_INCREMENTAL
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_MARK) {
+        gc_inc_abort();
+    }
+    #endif
+
     GC_ENTER();
 
     DEBUG_printf("gc_free(%p)\n", ptr);
@@ -948,13 +2070,26 @@ void gc_free(void *ptr) {
     #endif
 
     size_t block = BLOCK_FROM_PTR(area, ptr);
+    #if MICROPY_GC_INCREMENTAL
+    // allocated black during a lazy sweep
+    assert(ATB_GET_KIND(area, block) == AT_HEAD
+        || (ATB_GET_KIND(area, block) == AT_MARK && (MP_STATE_THREAD(gc_lock_depth) & GC_COLLECT_FLAG))
+        || (ATB_GET_KIND(area, block) == AT_MARK && MP_STATE_MEM(gc_inc_phase) == GC_INC_SWEEP));
+    #else
     assert(ATB_GET_KIND(area, block) == AT_HEAD
         || (ATB_GET_KIND(area, block) == AT_MARK && (MP_STATE_THREAD(gc_lock_depth) & GC_COLLECT_FLAG)));
+    #endif
 
     #if MICROPY_ENABLE_FINALISER
     FTB_CLEAR(area, block);
     #endif
 
+    #if MICROPY_GC_MOVABLE
+    if (MP_STATE_MEM(gc_movable_len) > 0) {
+        gc_movable_freed(ptr);
+    }
+    #endif
+
     #if MICROPY_GC_SPLIT_HEAP
     if (MP_STATE_MEM(gc_last_free_area) != area) {
         // We freed something but it isn't the current area. Reset the
@@ -1004,7 +2139,11 @@ size_t gc_nbytes(const void *ptr) {
 
     if (area) {
         size_t block = BLOCK_FROM_PTR(area, ptr);
+        #if MICROPY_GC_INCREMENTAL
+        if (ATB_GET_KIND(area, block) == AT_HEAD || ATB_GET_KIND(area, block) == AT_MARK) {
+        #else
         if (ATB_GET_KIND(area, block) == AT_HEAD) {
+        #endif
             // work out number of consecutive blocks in the chain starting with this on
             size_t n_blocks = 0;
             do {
@@ -1036,6 +2175,12 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
         return NULL;
     }
 
+    #if MICROPY_GC_INCREMENTAL
+    if (MP_STATE_MEM(gc_inc_phase) == GC_INC_MARK) {
+        gc_inc_abort();
+    }
+    #endif
+
     void *ptr = ptr_in;
 
     GC_ENTER();
@@ -1050,7 +2195,12 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     area = &MP_STATE_MEM(area);
     #endif
     size_t block = BLOCK_FROM_PTR(area, ptr);
+    #if MICROPY_GC_INCREMENTAL
+    assert(ATB_GET_KIND(area, block) == AT_HEAD
+        || (ATB_GET_KIND(area, block) == AT_MARK && MP_STATE_MEM(gc_inc_phase) == GC_INC_SWEEP));
+    #else
     assert(ATB_GET_KIND(area, block) == AT_HEAD);
+    #endif
 
     // compute number of new blocks that are requested
     size_t new_blocks = (n_bytes + BYTES_PER_BLOCK - 1) / BYTES_PER_BLOCK;
@@ -1094,6 +2244,10 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
             ATB_ANY_TO_FREE(area, bl);
         }
 
+        #if MICROPY_GC_MOVABLE
+        gc_movable_realloc(ptr_in, ptr_in, new_blocks);
+        #endif
+
         #if MICROPY_GC_SPLIT_HEAP
         if (MP_STATE_MEM(gc_last_free_area) != area) {
             // See comment in gc_free.
@@ -1126,6 +2280,16 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
 
         area->gc_last_used_block = MAX(area->gc_last_used_block, end_block);
 
+        #if MICROPY_GC_INCREMENTAL
+        if (MP_STATE_MEM(gc_inc_phase) == GC_INC_SWEEP) {
+            gc_inc_sweep_alloc(area, block, end_block - 1);
+        }
+        #endif
+
+        #if MICROPY_GC_MOVABLE
+        gc_movable_realloc(ptr_in, ptr_in, new_blocks);
+        #endif
+
         GC_EXIT();
 
         #if MICROPY_GC_CONSERVATIVE_CLEAR
@@ -1149,6 +2313,10 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
     bool ftb_state = false;
     #endif
 
+    #if MICROPY_GC_ALLOC_SITES
+    byte site = area->gc_site_table_start[block];
+    #endif
+
     GC_EXIT();
 
     if (!allow_move) {
@@ -1164,8 +2332,22 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
         return NULL;
     }
 
+    #if MICROPY_GC_ALLOC_SITES
+    // a moved object keeps the site that allocated it
+    GC_ENTER();
+    area = gc_ptr_area(ptr_out);
+    area->gc_site_table_start[BLOCK_FROM_PTR(area, ptr_out)] = site;
+    GC_EXIT();
+    #endif
+
     DEBUG_printf("gc_realloc(%p -> %p)\n", ptr_in, ptr_out);
     memcpy(ptr_out, ptr_in, n_blocks * BYTES_PER_BLOCK);
+    #if MICROPY_GC_MOVABLE
+    // a movable buffer stays movable; the caller updates the handle
+    GC_ENTER();
+    gc_movable_realloc(ptr_in, ptr_out, new_blocks);
+    GC_EXIT();
+    #endif
     gc_free(ptr_in);
     return ptr_out;
 }
@@ -1180,6 +2362,11 @@ void gc_dump_info(const mp_print_t *print) {
     #endif
     mp_printf(print, "\n No. of 1-blocks: %u, 2-blocks: %u, max blk sz: %u, max free sz: %u\n",
         (uint)info.num_1block, (uint)info.num_2block, (uint)info.max_block, (uint)info.max_free);
+    #if MICROPY_GC_MOVABLE
+    mp_printf(print, " movable: %u/%u, compactions: %u, moved: %u buffers, %u bytes\n",
+        (uint)MP_STATE_MEM(gc_movable_len), (uint)MICROPY_GC_MOVABLE_MAX, (uint)MP_STATE_MEM(gc_compact_runs),
+        (uint)MP_STATE_MEM(gc_compact_moves), (uint)MP_STATE_MEM(gc_compact_bytes));
+    #endif
 }
 
 void gc_dump_alloc_table(const mp_print_t *print) {
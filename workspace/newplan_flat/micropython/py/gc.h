@@ -28,6 +28,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include "py/mpprint.h"
 
 void gc_init(void *start, void *end);
@@ -41,6 +42,25 @@ void gc_add(void *start, void *end);
 // RAM to allocate a new heap area into using MP_PLAT_ALLOC_HEAP.
 size_t gc_get_max_new_split(void);
 #endif // MICROPY_GC_SPLIT_HEAP_AUTO
+
+#if MICROPY_GC_AREA_PLACEMENT
+// Area kinds, also used as allocation hints.  GC_AREA_AUTO places by size:
+// requests of at least the bulk threshold prefer bulk areas, others fast ones.
+// An allocation falls back to the other kind before triggering a collection.
+#define GC_AREA_FAST (0)
+#define GC_AREA_BULK (1)
+#define GC_AREA_AUTO (2)
+// OR'ed into the kind of an area in tightly coupled memory, which the CPU can
+// read and write but not fetch instructions from, and which bus masters such
+// as DMA cannot reach.  Allocations with GC_ALLOC_FLAG_NO_TCM, and bulk
+// requests falling back from a full bulk area, never go there.
+#define GC_AREA_TCM (4)
+
+// Like gc_init/gc_add, but tag the area with the given kind (FAST or BULK,
+// optionally with GC_AREA_TCM).
+void gc_init_kind(void *start, void *end, unsigned int kind);
+void gc_add_kind(void *start, void *end, unsigned int kind);
+#endif // MICROPY_GC_AREA_PLACEMENT
 #endif // MICROPY_GC_SPLIT_HEAP
 
 // These lock/unlock functions can be nested.
@@ -58,8 +78,93 @@ void gc_collect_end(void);
 // Use this function to sweep the whole heap and run all finalisers
 void gc_sweep_all(void);
 
+#if MICROPY_GC_INCREMENTAL
+// Incremental collection.  gc_inc_start begins a cycle by queueing the root
+// pointers that gc_collect_start would scan; the port then adds its own roots
+// (eg the C stack) with gc_collect_root, and calls gc_inc_step to do up to
+// budget_us of work at a time.  gc_inc_step returns true once no cycle is in
+// progress.  While the phase is GC_INC_MARK no Python code may run (there is
+// no write barrier): the port calls gc_inc_abort before resuming it, and the
+// marks are discarded.  Interrupt handlers that run Python code call
+// gc_inc_note_mutation instead, and the next gc_inc_step discards the mark.
+// The sweep (GC_INC_SWEEP) may be interleaved with allocations; gc_alloc and
+// gc_collect finish it when they need to.
+#define GC_INC_IDLE (0)
+#define GC_INC_MARK (1)
+#define GC_INC_SWEEP (2)
+
+void gc_inc_start(void);
+bool gc_inc_step(uint32_t budget_us);
+void gc_inc_abort(void);
+void gc_inc_note_mutation(void);
+unsigned int gc_inc_phase(void);
+// Whether enough has been allocated since the last collection to start a cycle.
+bool gc_inc_due(void);
+#endif
+
+#if MICROPY_GC_ALLOC_STATS
+// Durations (in MICROPY_GC_ALLOC_STATS_CYCLES units) of the most recent
+// successful allocations.  gc_alloc_stats_begin pauses recording and returns
+// how many samples are held; gc_alloc_stats_get(i) returns the i-th oldest;
+// gc_alloc_stats_end resumes recording, optionally discarding the samples.
+size_t gc_alloc_stats_begin(void);
+uint32_t gc_alloc_stats_get(size_t i);
+void gc_alloc_stats_end(bool reset);
+#endif
+
+#if MICROPY_GC_ALLOC_SITES
+// Allocation sites.  Every head block records the index of the site that
+// allocated it: GC_SITE_UNTRACKED for objects allocated before the table was
+// last reset, GC_SITE_OTHER once the table is full, otherwise
+// GC_SITE_FIRST + the slot of the site.  gc_site_get returns the function
+// object and bytecode offset of a slot, or the C caller and GC_SITE_C_CALLER,
+// and false for an unused slot.  gc_site_histogram fills, for every site index,
+// a row of GC_SITE_HIST_COLS counts: live objects of 1, 2, 3-4, 5-8, 9-16 and
+// 17+ blocks, then their total number of blocks.
+#define GC_SITE_UNTRACKED (0)
+#define GC_SITE_OTHER (1)
+#define GC_SITE_FIRST (2)
+#define GC_SITE_NUM (GC_SITE_FIRST + MICROPY_GC_ALLOC_SITES_MAX)
+#define GC_SITE_C_CALLER ((size_t)-1)
+#define GC_SITE_SIZE_BUCKETS (6)
+#define GC_SITE_HIST_COLS (GC_SITE_SIZE_BUCKETS + 1)
+
+bool gc_site_get(size_t slot, const void **where, size_t *offset);
+void gc_site_histogram(size_t hist[GC_SITE_NUM][GC_SITE_HIST_COLS]);
+// Forget all sites; every live object becomes GC_SITE_UNTRACKED.
+void gc_site_reset(void);
+#endif
+
+#if MICROPY_GC_MOVABLE
+// Movable buffers.  gc_movable_register(owner, handle) makes the buffer that
+// *handle points to movable, if it is between MICROPY_GC_MOVABLE_MIN_BYTES and
+// MICROPY_GC_MOVABLE_MAX_BYTES long: handle is a field of the heap object
+// owner, and the buffer must not be freed other than by gc_free, gc_realloc or
+// the collector.  Calling it again after the buffer was reallocated is harmless
+// (a buffer grown past the maximum stays put).  When a full collection leaves no
+// free run of the compaction threshold (or of the allocation that triggered
+// it), buffers are slid down into lower free runs and *handle is updated.  A
+// buffer is pinned (not moved) by any reference, even into its middle, other
+// than the handle that the collection sees: C code keeping a raw pointer on the
+// stack, in a heap object or in a root pointer needs nothing else.
+// gc_pin/gc_unpin (nestable) are for pointers kept where the collector does not
+// look, eg DMA descriptors in static memory.  gc_compact runs a full collection
+// that compacts regardless of the threshold, and returns the number of buffers
+// moved.
+void gc_movable_register(void *owner, void **handle);
+void gc_pin(const void *buf);
+void gc_unpin(const void *buf);
+size_t gc_compact(void);
+#endif
+
 enum {
     GC_ALLOC_FLAG_HAS_FINALISER = 1,
+    #if MICROPY_GC_ALLOC_HIGH
+    // take the highest free run that fits, for short-lived blocks
+    GC_ALLOC_FLAG_HIGH = 2,
+    #endif
+    // the block must be reachable by DMA and instruction fetch (no TCM area)
+    GC_ALLOC_FLAG_NO_TCM = 4,
 };
 
 void *gc_alloc(size_t n_bytes, unsigned int alloc_flags);
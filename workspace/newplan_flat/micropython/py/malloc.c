@@ -56,8 +56,15 @@
 #undef malloc
 #undef free
 #undef realloc
+#if MICROPY_GC_ALLOC_SITES
+// Outside bytecode, attribute allocations to the caller of the m_malloc family
+#define GC_SITE_CALLER() (MP_STATE_MEM(gc_site_caller) = __builtin_return_address(0))
+#define malloc(b) (GC_SITE_CALLER(), gc_alloc((b), 0))
+#define malloc_with_finaliser(b) (GC_SITE_CALLER(), gc_alloc((b), GC_ALLOC_FLAG_HAS_FINALISER))
+#else
 #define malloc(b) gc_alloc((b), 0)
 #define malloc_with_finaliser(b) gc_alloc((b), GC_ALLOC_FLAG_HAS_FINALISER)
+#endif
 #define free gc_free
 #define realloc(ptr, n) gc_realloc(ptr, n, true)
 #define realloc_ext(ptr, n, mv) gc_realloc(ptr, n, mv)
@@ -24,9 +24,19 @@
  * THE SOFTWARE.
  */
 
+#include <string.h>
+
 #include "py/mpstate.h"
 #include "py/obj.h"
 #include "py/gc.h"
+#include "py/objlist.h"
+#include "py/runtime.h"
+
+#if MICROPY_GC_ALLOC_SITES
+#include "py/bc.h"
+#include "py/mphal.h"
+#include "py/objfun.h"
+#endif
 
 #if MICROPY_PY_GC && MICROPY_ENABLE_GC
 
@@ -100,6 +110,263 @@ static mp_obj_t gc_threshold(size_t n_args, const mp_obj_t *args) {
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_threshold_obj, 0, 1, gc_threshold);
 #endif
 
+#if MICROPY_GC_AREA_PLACEMENT
+// alloc_hint([hint[, threshold]]): set where new allocations go (gc.FAST,
+// gc.BULK or gc.AUTO) and the size from which gc.AUTO prefers bulk areas;
+// returns the previous (hint, threshold) so it can be restored afterwards
+static mp_obj_t gc_alloc_hint(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t prev[2] = {
+        MP_OBJ_NEW_SMALL_INT(MP_STATE_MEM(gc_alloc_hint)),
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_bulk_threshold)),
+    };
+    if (n_args > 0) {
+        mp_int_t hint = mp_obj_get_int(args[0]);
+        if (hint < GC_AREA_FAST || hint > GC_AREA_AUTO) {
+            mp_raise_ValueError(MP_ERROR_TEXT("invalid hint"));
+        }
+        MP_STATE_MEM(gc_alloc_hint) = hint;
+    }
+    if (n_args > 1) {
+        mp_int_t threshold = mp_obj_get_int(args[1]);
+        if (threshold < 0) {
+            mp_raise_ValueError(NULL);
+        }
+        MP_STATE_MEM(gc_bulk_threshold) = threshold;
+    }
+    return mp_obj_new_tuple(2, prev);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_alloc_hint_obj, 0, 2, gc_alloc_hint);
+#endif
+
+#if MICROPY_GC_ALLOC_STATS
+// alloc_stats(reset=False): durations in cycles of the most recent allocations,
+// oldest first (allocations that triggered a collection included)
+static mp_obj_t gc_alloc_stats(size_t n_args, const mp_obj_t *args) {
+    size_t n = gc_alloc_stats_begin();
+    mp_obj_list_t *list = MP_OBJ_TO_PTR(mp_obj_new_list(n, NULL));
+    for (size_t i = 0; i < n; i++) {
+        list->items[i] = mp_obj_new_int_from_uint(gc_alloc_stats_get(i));
+    }
+    gc_alloc_stats_end(n_args > 0 && mp_obj_is_true(args[0]));
+    return MP_OBJ_FROM_PTR(list);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_alloc_stats_obj, 0, 1, gc_alloc_stats);
+#endif
+
+#if MICROPY_GC_ALLOC_SITES
+// alloc_sites(reset=False): live objects grouped by the site that allocated
+// them, most blocks first, as (blocks, objects, function, file, line, sizes)
+// tuples; sizes counts the objects of 1, 2, 3-4, 5-8, 9-16 and 17+ blocks.
+// A C caller is given by its address as function, with an empty file.
+// reset=True forgets the sites afterwards: objects allocated before then
+// show up as "<untracked>".
+static mp_obj_t gc_alloc_sites(size_t n_args, const mp_obj_t *args) {
+    size_t (*hist)[GC_SITE_HIST_COLS] = (size_t (*)[GC_SITE_HIST_COLS])m_new(size_t, GC_SITE_NUM * GC_SITE_HIST_COLS);
+    gc_site_histogram(hist);
+
+    // bytecode sites are recorded per offset: merge those on the same line
+    size_t lines[GC_SITE_NUM];
+    for (size_t i = GC_SITE_FIRST; i < GC_SITE_NUM; i++) {
+        const void *where;
+        size_t offset;
+        lines[i] = 0;
+        if (hist[i][GC_SITE_SIZE_BUCKETS] == 0 || !gc_site_get(i - GC_SITE_FIRST, &where, &offset) || offset == GC_SITE_C_CALLER) {
+            continue;
+        }
+        qstr block, file;
+        lines[i] = mp_bytecode_get_location(where, offset, &block, &file);
+        for (size_t j = GC_SITE_FIRST; j < i; j++) {
+            const void *where_j;
+            size_t offset_j;
+            if (hist[j][GC_SITE_SIZE_BUCKETS] != 0 && lines[j] == lines[i]
+                && gc_site_get(j - GC_SITE_FIRST, &where_j, &offset_j) && where_j == where) {
+                for (size_t k = 0; k < GC_SITE_HIST_COLS; k++) {
+                    hist[j][k] += hist[i][k];
+                    hist[i][k] = 0;
+                }
+                break;
+            }
+        }
+    }
+
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+    for (;;) {
+        size_t best = GC_SITE_NUM;
+        for (size_t i = 0; i < GC_SITE_NUM; i++) {
+            if (hist[i][GC_SITE_SIZE_BUCKETS] != 0
+                && (best == GC_SITE_NUM || hist[i][GC_SITE_SIZE_BUCKETS] > hist[best][GC_SITE_SIZE_BUCKETS])) {
+                best = i;
+            }
+        }
+        if (best == GC_SITE_NUM) {
+            break;
+        }
+        mp_obj_t sizes[GC_SITE_SIZE_BUCKETS];
+        size_t objects = 0;
+        for (size_t k = 0; k < GC_SITE_SIZE_BUCKETS; k++) {
+            sizes[k] = mp_obj_new_int_from_uint(hist[best][k]);
+            objects += hist[best][k];
+        }
+        mp_obj_t item[6] = {
+            mp_obj_new_int_from_uint(hist[best][GC_SITE_SIZE_BUCKETS]),
+            mp_obj_new_int_from_uint(objects),
+            MP_OBJ_NEW_QSTR(MP_QSTR_),
+            MP_OBJ_NEW_QSTR(MP_QSTR_),
+            MP_OBJ_NEW_SMALL_INT(0),
+            mp_obj_new_tuple(GC_SITE_SIZE_BUCKETS, sizes),
+        };
+        const void *where;
+        size_t offset;
+        if (best < GC_SITE_FIRST) {
+            const char *what = best == GC_SITE_UNTRACKED ? "<untracked>" : "<other>";
+            item[2] = mp_obj_new_str(what, strlen(what));
+        } else if (gc_site_get(best - GC_SITE_FIRST, &where, &offset) && offset == GC_SITE_C_CALLER) {
+            item[2] = mp_obj_new_int_from_uint((uintptr_t)where);
+        } else {
+            qstr block, file;
+            mp_bytecode_get_location(where, offset, &block, &file);
+            item[2] = MP_OBJ_NEW_QSTR(block);
+            item[3] = MP_OBJ_NEW_QSTR(file);
+            item[4] = MP_OBJ_NEW_SMALL_INT(lines[best]);
+        }
+        mp_obj_list_append(list, mp_obj_new_tuple(6, item));
+        hist[best][GC_SITE_SIZE_BUCKETS] = 0;
+    }
+    m_del(size_t, hist, GC_SITE_NUM * GC_SITE_HIST_COLS);
+
+    if (n_args > 0 && mp_obj_is_true(args[0])) {
+        gc_site_reset();
+    }
+    return list;
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_alloc_sites_obj, 0, 1, gc_alloc_sites);
+
+static mp_state_mem_area_t *gc_heap_map_next(mp_state_mem_area_t *area) {
+    #if MICROPY_GC_SPLIT_HEAP
+    return area->next;
+    #else
+    (void)area;
+    return NULL;
+    #endif
+}
+
+static byte *gc_heap_map_put_u32(byte *p, uint32_t v) {
+    for (size_t i = 0; i < 4; i++) {
+        *p++ = v >> (8 * i);
+    }
+    return p;
+}
+
+// heap_map(): snapshot of the allocation tables for tools/gc_heapmap.py, as
+// bytes: b"MPHM", ticks_ms, number of areas and bytes per block, then for each
+// area its pool address, number of blocks and kind followed by its ATB (two
+// bits per block: 0 free, 1 head, 2 tail, 3 marked head); all words are
+// little-endian uint32.
+static mp_obj_t gc_heap_map(void) {
+    size_t len = 16;
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = gc_heap_map_next(area)) {
+        len += 12 + area->gc_alloc_table_byte_len;
+    }
+    vstr_t vstr;
+    vstr_init_len(&vstr, len);
+    byte *p = (byte *)vstr.buf;
+    memcpy(p, "MPHM", 4);
+    p = gc_heap_map_put_u32(p + 4, mp_hal_ticks_ms());
+    byte *n_areas = p;
+    p = gc_heap_map_put_u32(p + 4, MICROPY_BYTES_PER_GC_BLOCK);
+    uint32_t n = 0;
+    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = gc_heap_map_next(area)) {
+        size_t n_blocks = area->gc_alloc_table_byte_len * 4;
+        p = gc_heap_map_put_u32(p, (uintptr_t)area->gc_pool_start);
+        p = gc_heap_map_put_u32(p, n_blocks);
+        #if MICROPY_GC_AREA_PLACEMENT
+        p = gc_heap_map_put_u32(p, area->gc_area_kind);
+        #else
+        p = gc_heap_map_put_u32(p, 0);
+        #endif
+        memcpy(p, area->gc_alloc_table_start, area->gc_alloc_table_byte_len);
+        p += area->gc_alloc_table_byte_len;
+        n++;
+    }
+    gc_heap_map_put_u32(n_areas, n);
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+MP_DEFINE_CONST_FUN_OBJ_0(gc_heap_map_obj, gc_heap_map);
+#endif
+
+#if MICROPY_GC_MOVABLE
+// compact(): run a collection that slides the movable buffers (large
+// bytearray and array items that nothing but their owner refers to) together;
+// returns the number of buffers moved
+static mp_obj_t py_gc_compact(void) {
+    return MP_OBJ_NEW_SMALL_INT(gc_compact());
+}
+MP_DEFINE_CONST_FUN_OBJ_0(gc_compact_obj, py_gc_compact);
+
+// compact_threshold([bytes]): set the size of the largest free run below
+// which a collection compacts (0 only compacts when an allocation fails);
+// returns the previous value
+static mp_obj_t gc_compact_threshold(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t prev = mp_obj_new_int_from_uint(MP_STATE_MEM(gc_compact_threshold));
+    if (n_args > 0) {
+        mp_int_t threshold = mp_obj_get_int(args[0]);
+        if (threshold < 0) {
+            mp_raise_ValueError(NULL);
+        }
+        MP_STATE_MEM(gc_compact_threshold) = threshold;
+    }
+    return prev;
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_compact_threshold_obj, 0, 1, gc_compact_threshold);
+#endif
+
+#if MICROPY_GC_INCREMENTAL
+// incremental([budget_us[, trigger]]): set the duration of one incremental
+// slice (0 disables incremental collection) and the number of bytes allocated
+// after which a cycle is started; returns the previous (budget_us, trigger)
+static mp_obj_t gc_incremental(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t prev[2] = {
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_inc_budget_us)),
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_inc_trigger)),
+    };
+    if (n_args > 0) {
+        mp_int_t budget = mp_obj_get_int(args[0]);
+        if (budget < 0) {
+            mp_raise_ValueError(NULL);
+        }
+        MP_STATE_MEM(gc_inc_budget_us) = budget;
+    }
+    if (n_args > 1) {
+        mp_int_t trigger = mp_obj_get_int(args[1]);
+        if (trigger < 0) {
+            mp_raise_ValueError(NULL);
+        }
+        MP_STATE_MEM(gc_inc_trigger) = trigger;
+    }
+    return mp_obj_new_tuple(2, prev);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_incremental_obj, 0, 2, gc_incremental);
+
+// incremental_stats(reset=False): (completed cycles, aborted marks,
+// longest slice in us, expected mark duration in us: that of the last complete
+// mark, or the time spent on a longer discarded one since)
+static mp_obj_t gc_incremental_stats(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t items[4] = {
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_inc_cycles)),
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_inc_aborts)),
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_inc_max_slice_us)),
+        mp_obj_new_int_from_uint(MP_STATE_MEM(gc_inc_last_mark_us)),
+    };
+    if (n_args > 0 && mp_obj_is_true(args[0])) {
+        MP_STATE_MEM(gc_inc_cycles) = 0;
+        MP_STATE_MEM(gc_inc_aborts) = 0;
+        MP_STATE_MEM(gc_inc_max_slice_us) = 0;
+    }
+    return mp_obj_new_tuple(4, items);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(gc_incremental_stats_obj, 0, 1, gc_incremental_stats);
+#endif
+
 static const mp_rom_map_elem_t mp_module_gc_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_gc) },
     { MP_ROM_QSTR(MP_QSTR_collect), MP_ROM_PTR(&gc_collect_obj) },
@@ -111,6 +378,27 @@ static const mp_rom_map_elem_t mp_module_gc_globals_table[] = {
     #if MICROPY_GC_ALLOC_THRESHOLD
     { MP_ROM_QSTR(MP_QSTR_threshold), MP_ROM_PTR(&gc_threshold_obj) },
     #endif
+    #if MICROPY_GC_ALLOC_STATS
+    { MP_ROM_QSTR(MP_QSTR_alloc_stats), MP_ROM_PTR(&gc_alloc_stats_obj) },
+    #endif
+    #if MICROPY_GC_ALLOC_SITES
+    { MP_ROM_QSTR(MP_QSTR_alloc_sites), MP_ROM_PTR(&gc_alloc_sites_obj) },
+    { MP_ROM_QSTR(MP_QSTR_heap_map), MP_ROM_PTR(&gc_heap_map_obj) },
+    #endif
+    #if MICROPY_GC_MOVABLE
+    { MP_ROM_QSTR(MP_QSTR_compact), MP_ROM_PTR(&gc_compact_obj) },
+    { MP_ROM_QSTR(MP_QSTR_compact_threshold), MP_ROM_PTR(&gc_compact_threshold_obj) },
+    #endif
+    #if MICROPY_GC_INCREMENTAL
+    { MP_ROM_QSTR(MP_QSTR_incremental), MP_ROM_PTR(&gc_incremental_obj) },
+    { MP_ROM_QSTR(MP_QSTR_incremental_stats), MP_ROM_PTR(&gc_incremental_stats_obj) },
+    #endif
+    #if MICROPY_GC_AREA_PLACEMENT
+    { MP_ROM_QSTR(MP_QSTR_alloc_hint), MP_ROM_PTR(&gc_alloc_hint_obj) },
+    { MP_ROM_QSTR(MP_QSTR_FAST), MP_ROM_INT(GC_AREA_FAST) },
+    { MP_ROM_QSTR(MP_QSTR_BULK), MP_ROM_INT(GC_AREA_BULK) },
+    { MP_ROM_QSTR(MP_QSTR_AUTO), MP_ROM_INT(GC_AREA_AUTO) },
+    #endif
 };
 
 static MP_DEFINE_CONST_DICT(mp_module_gc_globals, mp_module_gc_globals_table);
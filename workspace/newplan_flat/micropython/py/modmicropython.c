@@ -25,12 +25,16 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "py/builtin.h"
 #include "py/cstack.h"
 #include "py/runtime.h"
 #include "py/gc.h"
 #include "py/mphal.h"
+#include "py/sampleprof.h"
+#include "py/mptrace.h"
+#include "py/bc.h"
 
 #if MICROPY_PY_MICROPYTHON
 
@@ -80,6 +84,11 @@ mp_obj_t mp_micropython_mem_info(size_t n_args, const mp_obj_t *args) {
     #else
     mp_printf(&mp_plat_print, "stack: " UINT_FMT "\n", mp_cstack_usage());
     #endif
+    #if MICROPY_ENABLE_PYSTACK
+    mp_printf(&mp_plat_print, "pystack: " UINT_FMT " out of " UINT_FMT ", peak " UINT_FMT ", " UINT_FMT " to heap\n",
+        (mp_uint_t)mp_pystack_usage(), (mp_uint_t)mp_pystack_limit(), (mp_uint_t)mp_pystack_peak(),
+        (mp_uint_t)MP_STATE_THREAD(pystack_overflows));
+    #endif
     #if MICROPY_ENABLE_GC
     gc_dump_info(&mp_plat_print);
     if (n_args == 1) {
@@ -89,6 +98,10 @@ mp_obj_t mp_micropython_mem_info(size_t n_args, const mp_obj_t *args) {
     #else
     (void)n_args;
     #endif
+    #if MICROPY_COMP_ARENA
+    mp_printf(&mp_plat_print, "compile arena: " UINT_FMT " held, " UINT_FMT " peak\n",
+        (mp_uint_t)MP_STATE_VM(comp_arena_size), (mp_uint_t)MP_STATE_VM(comp_arena_peak));
+    #endif
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_mem_info_obj, 0, 1, mp_micropython_mem_info);
@@ -116,11 +129,38 @@ static mp_obj_t mp_micropython_stack_use(void) {
 static MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_stack_use_obj, mp_micropython_stack_use);
 #endif
 
+#if MICROPY_PY_MICROPYTHON_STACK_PEAK
+// stack_peak(reset=False): deepest C stack use in bytes since startup (or the
+// last reset), including interrupt frames
+static mp_obj_t mp_micropython_stack_peak(size_t n_args, const mp_obj_t *args) {
+    return MP_OBJ_NEW_SMALL_INT(mp_hal_stack_peak(n_args > 0 && mp_obj_is_true(args[0])));
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_stack_peak_obj, 0, 1, mp_micropython_stack_peak);
+#endif
+
 #if MICROPY_ENABLE_PYSTACK
 static mp_obj_t mp_micropython_pystack_use(void) {
     return MP_OBJ_NEW_SMALL_INT(mp_pystack_usage());
 }
 static MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_pystack_use_obj, mp_micropython_pystack_use);
+
+// pystack_stats(reset=False) -> (use, peak, limit, overflows): bytes in use,
+// the most in use since startup (or the last reset), the size of the pystack
+// and the number of blocks that did not fit and were taken from the heap
+static mp_obj_t mp_micropython_pystack_stats(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t items[4] = {
+        MP_OBJ_NEW_SMALL_INT(mp_pystack_usage()),
+        MP_OBJ_NEW_SMALL_INT(mp_pystack_peak()),
+        MP_OBJ_NEW_SMALL_INT(mp_pystack_limit()),
+        mp_obj_new_int_from_uint(MP_STATE_THREAD(pystack_overflows)),
+    };
+    if (n_args > 0 && mp_obj_is_true(args[0])) {
+        MP_STATE_THREAD(pystack_peak) = MP_STATE_THREAD(pystack_cur);
+        MP_STATE_THREAD(pystack_overflows) = 0;
+    }
+    return mp_obj_new_tuple(4, items);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_pystack_stats_obj, 0, 1, mp_micropython_pystack_stats);
 #endif
 
 #if MICROPY_ENABLE_GC
@@ -156,14 +196,74 @@ static mp_obj_t mp_micropython_kbd_intr(mp_obj_t int_chr_in) {
 static MP_DEFINE_CONST_FUN_OBJ_1(mp_micropython_kbd_intr_obj, mp_micropython_kbd_intr);
 #endif
 
+#if MICROPY_VM_OPCODE_STATS
+// opcode_stats(reset=False) -> (ops, paths)
+//   ops:   list of (opcode, count, cycles) for every opcode executed at least once
+//   paths: dict of dispatch path name -> (count, cycles)
+// Cycles are exclusive per opcode; path cycles include the callee.
+static mp_obj_t mp_micropython_opcode_stats(size_t n_args, const mp_obj_t *args) {
+    static const char *const path_names[MP_VM_PATH_NUM] = {
+        "load_attr_fast", "load_attr_slow", "load_method", "load_name",
+        "load_global", "call_bc", "call_other", "outside_vm",
+    };
+    const mp_vm_opcode_stats_t *s = &mp_vm_opcode_stats;
+    mp_obj_t ops = mp_obj_new_list(0, NULL);
+    for (size_t op = 0; op < 256; op++) {
+        if (s->count[op] != 0) {
+            mp_obj_t item[3] = {
+                MP_OBJ_NEW_SMALL_INT(op),
+                mp_obj_new_int_from_uint(s->count[op]),
+                mp_obj_new_int_from_ull(s->cycles[op]),
+            };
+            mp_obj_list_append(ops, mp_obj_new_tuple(3, item));
+        }
+    }
+    mp_obj_t paths = mp_obj_new_dict(MP_VM_PATH_NUM);
+    for (size_t i = 0; i < MP_VM_PATH_NUM; i++) {
+        mp_obj_t item[2] = {
+            mp_obj_new_int_from_uint(s->path_count[i]),
+            mp_obj_new_int_from_ull(s->path_cycles[i]),
+        };
+        mp_obj_dict_store(paths, mp_obj_new_str(path_names[i], strlen(path_names[i])), mp_obj_new_tuple(2, item));
+    }
+    if (n_args > 0 && mp_obj_is_true(args[0])) {
+        mp_vm_opcode_stats_reset();
+    }
+    mp_obj_t result[2] = { ops, paths };
+    return mp_obj_new_tuple(2, result);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_opcode_stats_obj, 0, 1, mp_micropython_opcode_stats);
+#endif
+
 #if MICROPY_ENABLE_SCHEDULER
-static mp_obj_t mp_micropython_schedule(mp_obj_t function, mp_obj_t arg) {
-    if (!mp_sched_schedule(function, arg)) {
+// schedule(function, arg, prio=0): prio 0 is the default class, higher classes run first
+static mp_obj_t mp_micropython_schedule(size_t n_args, const mp_obj_t *args) {
+    mp_int_t prio = n_args > 2 ? mp_obj_get_int(args[2]) : MP_SCHED_PRIO_NORMAL;
+    if (prio < 0 || prio >= MICROPY_SCHEDULER_PRIORITIES) {
+        mp_raise_ValueError(MP_ERROR_TEXT("bad priority"));
+    }
+    if (!mp_sched_schedule_prio(args[0], args[1], prio)) {
         mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("schedule queue full"));
     }
     return mp_const_none;
 }
-static MP_DEFINE_CONST_FUN_OBJ_2(mp_micropython_schedule_obj, mp_micropython_schedule);
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_schedule_obj, 2, 3, mp_micropython_schedule);
+
+// schedule_stats(reset=False) -> (overflows, peak_pending)
+static mp_obj_t mp_micropython_schedule_stats(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t items[2] = {
+        mp_obj_new_int_from_uint(MP_STATE_VM(sched_overflow)),
+        MP_OBJ_NEW_SMALL_INT(MP_STATE_VM(sched_peak)),
+    };
+    if (n_args > 0 && mp_obj_is_true(args[0])) {
+        mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+        MP_STATE_VM(sched_overflow) = 0;
+        MP_STATE_VM(sched_peak) = mp_sched_num_pending();
+        MICROPY_END_ATOMIC_SECTION(atomic_state);
+    }
+    return mp_obj_new_tuple(2, items);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_schedule_stats_obj, 0, 1, mp_micropython_schedule_stats);
 #endif
 
 static const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
@@ -184,11 +284,15 @@ static const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     #if MICROPY_PY_MICROPYTHON_STACK_USE
     { MP_ROM_QSTR(MP_QSTR_stack_use), MP_ROM_PTR(&mp_micropython_stack_use_obj) },
     #endif
+    #if MICROPY_PY_MICROPYTHON_STACK_PEAK
+    { MP_ROM_QSTR(MP_QSTR_stack_peak), MP_ROM_PTR(&mp_micropython_stack_peak_obj) },
+    #endif
     #if MICROPY_ENABLE_EMERGENCY_EXCEPTION_BUF && (MICROPY_EMERGENCY_EXCEPTION_BUF_SIZE == 0)
     { MP_ROM_QSTR(MP_QSTR_alloc_emergency_exception_buf), MP_ROM_PTR(&mp_alloc_emergency_exception_buf_obj) },
     #endif
     #if MICROPY_ENABLE_PYSTACK
     { MP_ROM_QSTR(MP_QSTR_pystack_use), MP_ROM_PTR(&mp_micropython_pystack_use_obj) },
+    { MP_ROM_QSTR(MP_QSTR_pystack_stats), MP_ROM_PTR(&mp_micropython_pystack_stats_obj) },
     #endif
     #if MICROPY_ENABLE_GC
     { MP_ROM_QSTR(MP_QSTR_heap_lock), MP_ROM_PTR(&mp_micropython_heap_lock_obj) },
@@ -205,6 +309,21 @@ static const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     #endif
     #if MICROPY_ENABLE_SCHEDULER
     { MP_ROM_QSTR(MP_QSTR_schedule), MP_ROM_PTR(&mp_micropython_schedule_obj) },
+    { MP_ROM_QSTR(MP_QSTR_schedule_stats), MP_ROM_PTR(&mp_micropython_schedule_stats_obj) },
+    #endif
+    #if MICROPY_VM_OPCODE_STATS
+    { MP_ROM_QSTR(MP_QSTR_opcode_stats), MP_ROM_PTR(&mp_micropython_opcode_stats_obj) },
+    #endif
+    #if MICROPY_PY_MICROPYTHON_PROFILE
+    { MP_ROM_QSTR(MP_QSTR_profile_start), MP_ROM_PTR(&mp_micropython_profile_start_obj) },
+    { MP_ROM_QSTR(MP_QSTR_profile_stop), MP_ROM_PTR(&mp_micropython_profile_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_profile_dump), MP_ROM_PTR(&mp_micropython_profile_dump_obj) },
+    #endif
+    #if MICROPY_PY_MICROPYTHON_TRACE
+    { MP_ROM_QSTR(MP_QSTR_trace_start), MP_ROM_PTR(&mp_micropython_trace_start_obj) },
+    { MP_ROM_QSTR(MP_QSTR_trace_stop), MP_ROM_PTR(&mp_micropython_trace_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_trace_dump), MP_ROM_PTR(&mp_micropython_trace_dump_obj) },
+    { MP_ROM_QSTR(MP_QSTR_trace), MP_ROM_PTR(&mp_micropython_trace_obj) },
     #endif
 };
 
@@ -340,6 +340,25 @@ typedef uint64_t mp_uint_t;
 #define MICROPY_ALLOC_SCOPE_ID_INC (6)
 #endif
 
+// Whether the parser and compiler allocate their scratch data (parse tree,
+// parser stacks, scopes, bytecode emitter) from an arena that is released as
+// a whole once compilation finishes, see py/comparena.h.
+#ifndef MICROPY_COMP_ARENA
+#define MICROPY_COMP_ARENA (0)
+#endif
+
+// Size of the chunks the compiler arena allocates from the heap.
+#ifndef MICROPY_COMP_ARENA_CHUNK
+#define MICROPY_COMP_ARENA_CHUNK (4096)
+#endif
+
+// Whether gc_alloc accepts GC_ALLOC_FLAG_HIGH, which places a block at the top
+// of an area.  The compiler arena uses it so its chunks stay clear of the
+// long-lived objects that compilation produces.
+#ifndef MICROPY_GC_ALLOC_HIGH
+#define MICROPY_GC_ALLOC_HIGH (MICROPY_COMP_ARENA)
+#endif
+
 // Maximum length of a path in the filesystem
 // So we can allocate a buffer on the stack for path manipulation in import
 #ifndef MICROPY_ALLOC_PATH_MAX
@@ -642,6 +661,17 @@ typedef uint64_t mp_uint_t;
 #endif
 
 // Whether to enable extra instrumentation for valgrind
+// Whether to count executions and cycles per opcode and per VM dispatch path,
+// exposed as micropython.opcode_stats(). Compiles out completely when disabled.
+#ifndef MICROPY_VM_OPCODE_STATS
+#define MICROPY_VM_OPCODE_STATS (0)
+#endif
+
+// Free-running cycle counter read by the opcode statistics (0 = counts only)
+#ifndef MICROPY_VM_OPCODE_STATS_CYCLES
+#define MICROPY_VM_OPCODE_STATS_CYCLES() (0)
+#endif
+
 #ifndef MICROPY_DEBUG_VALGRIND
 #define MICROPY_DEBUG_VALGRIND (0)
 #endif
@@ -758,6 +788,122 @@ typedef uint64_t mp_uint_t;
 #define MICROPY_GC_SPLIT_HEAP_AUTO (0)
 #endif
 
+// Whether split-heap areas are tagged as fast (on-chip SRAM/TCM) or bulk
+// (external RAM) and gc_alloc places each allocation by size or by hint.
+#ifndef MICROPY_GC_AREA_PLACEMENT
+#define MICROPY_GC_AREA_PLACEMENT (0)
+#endif
+
+// Default size in bytes at and above which an allocation prefers bulk areas.
+#ifndef MICROPY_GC_BULK_THRESHOLD
+#define MICROPY_GC_BULK_THRESHOLD (1024)
+#endif
+
+// Whether gc_alloc keeps per-size-class free lists of short free runs (1 to
+// MICROPY_GC_FREELIST_MAX_BLOCKS blocks), rebuilt during sweep, and only scans
+// the allocation table for larger requests or when the lists are exhausted.
+#ifndef MICROPY_GC_FREELISTS
+#define MICROPY_GC_FREELISTS (0)
+#endif
+
+#ifndef MICROPY_GC_FREELIST_MAX_BLOCKS
+#define MICROPY_GC_FREELIST_MAX_BLOCKS (8)
+#endif
+
+// Number of free runs remembered per size class and heap area.
+#ifndef MICROPY_GC_FREELIST_DEPTH
+#define MICROPY_GC_FREELIST_DEPTH (32)
+#endif
+
+// Whether gc_alloc records the duration of recent allocations (gc.alloc_stats).
+// The port must define MICROPY_GC_ALLOC_STATS_CYCLES() to read a cycle counter.
+#ifndef MICROPY_GC_ALLOC_STATS
+#define MICROPY_GC_ALLOC_STATS (0)
+#endif
+
+#ifndef MICROPY_GC_ALLOC_STATS_SIZE
+#define MICROPY_GC_ALLOC_STATS_SIZE (1024)
+#endif
+
+// Whether gc_alloc records where each object was allocated: the function and
+// bytecode offset being executed or, outside bytecode, the caller of the
+// m_malloc family (see gc.alloc_sites and gc.heap_map).  This costs one byte
+// per block, taken from the heap, and a lookup of bounded length per
+// allocation in a fixed table of sites.
+#ifndef MICROPY_GC_ALLOC_SITES
+#define MICROPY_GC_ALLOC_SITES (0)
+#endif
+
+// Number of distinct sites remembered (at most 254); allocations from further
+// sites are counted together as "other".
+#ifndef MICROPY_GC_ALLOC_SITES_MAX
+#define MICROPY_GC_ALLOC_SITES_MAX (126)
+#endif
+
+// Whether large raw buffers (the items of bytearray and array objects) can be
+// moved by a full collection to merge free space.  Each is reached through a
+// handle, the field of its owner that points to it; a buffer referenced from
+// anywhere else (a memoryview, the C stack, a driver object) is pinned for
+// that collection.  The full mark checks every scanned word against the
+// range of the movable buffers (see gc_movable_register).
+#ifndef MICROPY_GC_MOVABLE
+#define MICROPY_GC_MOVABLE (0)
+#endif
+
+// Number of movable buffers tracked; further buffers simply stay in place.
+#ifndef MICROPY_GC_MOVABLE_MAX
+#define MICROPY_GC_MOVABLE_MAX (32)
+#endif
+
+// Size in bytes from which a buffer is made movable.
+#ifndef MICROPY_GC_MOVABLE_MIN_BYTES
+#define MICROPY_GC_MOVABLE_MIN_BYTES (256)
+#endif
+
+// Size in bytes above which a buffer is not moved.  Each move is done with
+// interrupts disabled, so this bounds the interrupt latency added by
+// compaction; larger buffers stay where they are.
+#ifndef MICROPY_GC_MOVABLE_MAX_BYTES
+#define MICROPY_GC_MOVABLE_MAX_BYTES (4096)
+#endif
+
+// Default size in bytes of the largest free run below which a full
+// collection compacts the movable buffers (see gc.compact_threshold).
+#ifndef MICROPY_GC_COMPACT_THRESHOLD
+#define MICROPY_GC_COMPACT_THRESHOLD (4096)
+#endif
+
+// Whether the collector can also run incrementally, in slices of bounded
+// duration (see gc_inc_step).  Marking has no write barrier, so the port may
+// only run mark slices while no Python code runs (eg from idle time) and
+// must abort the mark before resuming it; the sweep is done lazily and may be
+// interleaved with Python code.  Not supported with non-GIL threading.
+#ifndef MICROPY_GC_INCREMENTAL
+#define MICROPY_GC_INCREMENTAL (0)
+#endif
+
+// Default duration of one incremental slice, in microseconds.
+#ifndef MICROPY_GC_INCREMENTAL_BUDGET_US
+#define MICROPY_GC_INCREMENTAL_BUDGET_US (200)
+#endif
+
+// Default number of bytes allocated since the last collection from which an
+// incremental cycle is due (see gc_inc_due).
+#ifndef MICROPY_GC_INCREMENTAL_TRIGGER
+#define MICROPY_GC_INCREMENTAL_TRIGGER (32 * 1024)
+#endif
+
+// Number of root ranges (eg the root pointer section, the Python stack and
+// the C stack) that a mark in progress can hold for later scanning.
+#ifndef MICROPY_GC_INCREMENTAL_ROOTS
+#define MICROPY_GC_INCREMENTAL_ROOTS (4)
+#endif
+
+// Time source for the slice budget.
+#ifndef MICROPY_GC_INCREMENTAL_TICKS_US
+#define MICROPY_GC_INCREMENTAL_TICKS_US() mp_hal_ticks_us()
+#endif
+
 // Hook to run code during time consuming garbage collector operations
 // *i* is the loop index variable (e.g. can be used to run every x loops)
 #ifndef MICROPY_GC_HOOK_LOOP
@@ -785,6 +931,14 @@ typedef uint64_t mp_uint_t;
 #define MICROPY_PYSTACK_ALIGN (8)
 #endif
 
+// Whether a pystack allocation that does not fit is taken from the heap
+// instead of raising RuntimeError("pystack exhausted").  Such blocks are
+// freed like pystack ones (or left to the GC after an exception) and are
+// counted in MP_STATE_THREAD(pystack_overflows).
+#ifndef MICROPY_PYSTACK_HEAP_FALLBACK
+#define MICROPY_PYSTACK_HEAP_FALLBACK (0)
+#endif
+
 // Whether to check C stack usage. C stack used for calling Python functions,
 // etc. Not checking means segfault on overflow.
 #ifndef MICROPY_STACK_CHECK
@@ -1200,11 +1354,20 @@ typedef time_t mp_timestamp_t;
 #define MICROPY_SCHEDULER_STATIC_NODES (0)
 #endif
 
-// Maximum number of entries in the scheduler
+// Maximum number of entries in the scheduler, per priority class
+// (must be a power of 2, at most 128)
 #ifndef MICROPY_SCHEDULER_DEPTH
 #define MICROPY_SCHEDULER_DEPTH (4)
 #endif
 
+// Number of scheduler priority classes. Each class has its own queue of
+// MICROPY_SCHEDULER_DEPTH entries and a pending callback of a higher class
+// always runs before any of a lower class. Class 0 is the default used by
+// mp_sched_schedule(); MP_SCHED_PRIO_HIGH is the highest class.
+#ifndef MICROPY_SCHEDULER_PRIORITIES
+#define MICROPY_SCHEDULER_PRIORITIES (1)
+#endif
+
 // Support for generic VFS sub-system
 #ifndef MICROPY_VFS
 #define MICROPY_VFS (0)
@@ -1545,6 +1708,12 @@ typedef time_t mp_timestamp_t;
 #define MICROPY_PY_MICROPYTHON_STACK_USE (MICROPY_PY_MICROPYTHON_MEM_INFO)
 #endif
 
+// Whether to provide "micropython.stack_peak" function (port must implement
+// mp_hal_stack_peak, eg by painting the unused stack at startup)
+#ifndef MICROPY_PY_MICROPYTHON_STACK_PEAK
+#define MICROPY_PY_MICROPYTHON_STACK_PEAK (0)
+#endif
+
 // Whether to provide the "micropython.heap_locked" function
 #ifndef MICROPY_PY_MICROPYTHON_HEAP_LOCKED
 #define MICROPY_PY_MICROPYTHON_HEAP_LOCKED (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
@@ -1555,6 +1724,40 @@ typedef time_t mp_timestamp_t;
 #define MICROPY_PY_MICROPYTHON_RINGIO (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
 
+// Support for the statistical sampling profiler, micropython.profile_start/stop/dump().
+// The port must call mp_sampleprof_tick() from a periodic interrupt running at
+// MICROPY_SAMPLEPROF_TICK_HZ (see py/sampleprof.h).
+#ifndef MICROPY_PY_MICROPYTHON_PROFILE
+#define MICROPY_PY_MICROPYTHON_PROFILE (0)
+#endif
+
+#ifndef MICROPY_SAMPLEPROF_TICK_HZ
+#define MICROPY_SAMPLEPROF_TICK_HZ (1000)
+#endif
+
+// Host builds: drive the sampler from setitimer(ITIMER_PROF)/SIGPROF at the
+// requested rate instead of from a port interrupt
+#ifndef MICROPY_SAMPLEPROF_POSIX
+#define MICROPY_SAMPLEPROF_POSIX (0)
+#endif
+
+// Support for the event trace ring, micropython.trace_start/stop/dump/trace().
+// The GC, scheduler, pyexec and port interrupt handlers record timestamped
+// events into a static ring of MICROPY_TRACE_RING_SIZE 8-byte records (must
+// be a power of 2). The port may provide a cheaper timestamp source.
+#ifndef MICROPY_PY_MICROPYTHON_TRACE
+#define MICROPY_PY_MICROPYTHON_TRACE (0)
+#endif
+
+#ifndef MICROPY_TRACE_RING_SIZE
+#define MICROPY_TRACE_RING_SIZE (1024)
+#endif
+
+#ifndef MICROPY_TRACE_TIMESTAMP
+#define MICROPY_TRACE_TIMESTAMP() ((uint32_t)mp_hal_ticks_us())
+#define MICROPY_TRACE_TIMESTAMP_HZ() (1000000)
+#endif
+
 // Whether to provide "array" module. Note that large chunk of the
 // underlying code is shared with "bytearray" builtin type, so to
 // get real savings, it should be disabled too.
@@ -1787,6 +1990,10 @@ typedef time_t mp_timestamp_t;
 #define MICROPY_PY_SYS_SETTRACE (0)
 #endif
 
+// Whether the VM keeps MP_STATE_THREAD(current_code_state) up to date
+// (needed by sys.settrace, the sampling profiler and allocation sites)
+#define MICROPY_VM_TRACK_CODE_STATE (MICROPY_PY_SYS_SETTRACE || MICROPY_PY_MICROPYTHON_PROFILE || MICROPY_GC_ALLOC_SITES)
+
 // Whether to provide "sys.getsizeof" function
 #ifndef MICROPY_PY_SYS_GETSIZEOF
 #define MICROPY_PY_SYS_GETSIZEOF (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
@@ -89,6 +89,11 @@ mp_uint_t mp_hal_ticks_cpu(void);
 uint64_t mp_hal_time_ns(void);
 #endif
 
+#if MICROPY_PY_MICROPYTHON_STACK_PEAK
+// Deepest C stack use in bytes (below stack_top) since startup or the last reset.
+mp_uint_t mp_hal_stack_peak(bool reset);
+#endif
+
 // If port HAL didn't define its own pin API, use generic
 // "virtual pin" API from the core.
 #ifndef mp_hal_pin_obj_t
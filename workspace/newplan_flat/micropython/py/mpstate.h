@@ -107,13 +107,39 @@ typedef struct _mp_state_mem_area_t {
     #if MICROPY_ENABLE_FINALISER
     byte *gc_finaliser_table_start;
     #endif
+    #if MICROPY_GC_ALLOC_SITES
+    byte *gc_site_table_start; // one site index per block
+    #endif
     byte *gc_pool_start;
     byte *gc_pool_end;
 
     size_t gc_last_free_atb_index;
     size_t gc_last_used_block; // The block ID of the highest block allocated in the area
+
+    #if MICROPY_GC_AREA_PLACEMENT
+    uint8_t gc_area_kind; // GC_AREA_FAST or GC_AREA_BULK
+    bool gc_area_tcm; // in TCM: no DMA, no instruction fetch
+    #endif
+
+    #if MICROPY_GC_FREELISTS
+    // Start blocks of free runs of exactly n+1 blocks, collected during sweep.
+    uint16_t gc_freelist_len[MICROPY_GC_FREELIST_MAX_BLOCKS];
+    size_t gc_freelist[MICROPY_GC_FREELIST_MAX_BLOCKS][MICROPY_GC_FREELIST_DEPTH];
+    #endif
 } mp_state_mem_area_t;
 
+#if MICROPY_GC_MOVABLE
+// A movable buffer, see gc_movable_register in gc.c.
+typedef struct _mp_state_mem_movable_t {
+    void *buf;
+    void *owner; // the heap object holding the handle
+    void **handle; // NULL once the owner has died: the buffer stays put
+    size_t n_blocks;
+    uint8_t pins; // gc_pin count
+    bool seen; // referenced other than through the handle during this mark
+} mp_state_mem_movable_t;
+#endif
+
 // This structure hold information about the memory allocation system.
 typedef struct _mp_state_mem_t {
     #if MICROPY_MEM_STATS
@@ -145,10 +171,76 @@ typedef struct _mp_state_mem_t {
     mp_state_mem_area_t *gc_last_free_area;
     #endif
 
+    #if MICROPY_GC_AREA_PLACEMENT
+    // Placement hint for new allocations (GC_AREA_FAST/BULK/AUTO) and the
+    // size in bytes from which GC_AREA_AUTO prefers bulk areas.
+    uint8_t gc_alloc_hint;
+    size_t gc_bulk_threshold;
+    #endif
+
     #if MICROPY_PY_GC_COLLECT_RETVAL
     size_t gc_collected;
     #endif
 
+    #if MICROPY_GC_ALLOC_SITES
+    // Bytecode offset of each allocation site, or GC_SITE_C_CALLER; the
+    // function (or C caller) is in MP_STATE_VM(gc_site_where).  The caller
+    // of the m_malloc family is passed to gc_alloc in gc_site_caller.
+    size_t gc_site_offset[MICROPY_GC_ALLOC_SITES_MAX];
+    const void *gc_site_caller;
+    #endif
+
+    #if MICROPY_GC_MOVABLE
+    // Movable buffers; this table does not keep them (or their owners) alive.
+    // The full mark looks up words in gc_movable_lo..gc_movable_lo+gc_movable_span.
+    mp_state_mem_movable_t gc_movable[MICROPY_GC_MOVABLE_MAX];
+    uint8_t gc_movable_len;
+    uintptr_t gc_movable_lo;
+    size_t gc_movable_span;
+    // compact when the largest free run is below this many bytes, or below
+    // gc_compact_want (the allocation that triggered the collection)
+    size_t gc_compact_threshold;
+    size_t gc_compact_want;
+    // statistics
+    size_t gc_compact_runs;
+    size_t gc_compact_moves;
+    size_t gc_compact_bytes;
+    #endif
+
+    #if MICROPY_GC_INCREMENTAL
+    // State of the incremental collector, see gc_inc_step in gc.c.
+    uint8_t gc_inc_phase; // GC_INC_IDLE, GC_INC_MARK or GC_INC_SWEEP
+    // mark: entries used on gc_block_stack, root ranges still to be scanned,
+    // and whether the heap is being rescanned after a mark stack overflow
+    uint16_t gc_inc_sp;
+    uint8_t gc_inc_n_roots;
+    bool gc_inc_rescan;
+    // set by gc_inc_note_mutation (from interrupt handlers) during a mark
+    volatile bool gc_inc_mutated;
+    void **gc_inc_root_ptrs[MICROPY_GC_INCREMENTAL_ROOTS];
+    size_t gc_inc_root_len[MICROPY_GC_INCREMENTAL_ROOTS];
+    // rescan or sweep position, and the sweep state within that area
+    mp_state_mem_area_t *gc_inc_area;
+    size_t gc_inc_block;
+    uint8_t gc_inc_free_tail;
+    size_t gc_inc_last_used_block;
+    size_t gc_inc_alloc_max; // highest block allocated behind the sweep position
+    #if MICROPY_GC_FREELISTS
+    size_t gc_inc_free_run;
+    #endif
+    // blocks allocated since the last collection, and the policy
+    size_t gc_inc_alloc_blocks;
+    size_t gc_inc_trigger;
+    uint32_t gc_inc_budget_us;
+    // statistics
+    uint32_t gc_inc_mark_us; // mark time of the cycle in progress
+    uint32_t gc_inc_last_mark_us; // mark time of the last completed cycle, or more if a later one was discarded
+    uint32_t gc_inc_max_slice_us;
+    size_t gc_inc_cycles;
+    size_t gc_inc_aborts;
+    uint8_t gc_inc_abort_run; // marks discarded in a row since the last completed one
+    #endif
+
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     // This is a global mutex used to make the GC thread-safe.
     mp_thread_recursive_mutex_t gc_mutex;
@@ -228,6 +320,11 @@ typedef struct _mp_state_vm_t {
     #if MICROPY_EMIT_NATIVE
     uint8_t default_emit_opt; // one of MP_EMIT_OPT_xxx
     #endif
+    #if MICROPY_COMP_ARENA
+    // bytes currently held by compiler arena chunks, and the most ever held
+    size_t comp_arena_size;
+    size_t comp_arena_peak;
+    #endif
     #endif
 
     // size of the emergency exception buf, if it's dynamically allocated
@@ -246,9 +343,14 @@ typedef struct _mp_state_vm_t {
     struct _mp_sched_node_t *sched_tail;
     #endif
 
-    // These index sched_queue.
-    uint8_t sched_len;
-    uint8_t sched_idx;
+    // These index sched_queue, one circular queue per priority class.
+    uint16_t sched_len;     // total over all classes, see mp_sched_num_pending()
+    uint8_t sched_class_len[MICROPY_SCHEDULER_PRIORITIES];
+    uint8_t sched_class_idx[MICROPY_SCHEDULER_PRIORITIES];
+
+    // Statistics for micropython.schedule_stats()
+    uint16_t sched_peak;
+    mp_uint_t sched_overflow;
     #endif
 
     #if MICROPY_ENABLE_VM_ABORT
@@ -283,6 +385,9 @@ typedef struct _mp_state_thread_t {
     uint8_t *pystack_start;
     uint8_t *pystack_end;
     uint8_t *pystack_cur;
+    // High-water mark of pystack_cur, and number of blocks that did not fit
+    uint8_t *pystack_peak;
+    size_t pystack_overflows;
     #endif
 
     // Locking of the GC is done per thread.
@@ -310,6 +415,8 @@ typedef struct _mp_state_thread_t {
     #if MICROPY_PY_SYS_SETTRACE
     mp_obj_t prof_trace_callback;
     bool prof_callback_is_executing;
+    #endif
+    #if MICROPY_VM_TRACK_CODE_STATE
     struct _mp_code_state_t *current_code_state;
     #endif
 
@@ -0,0 +1,108 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/mptrace.h"
+
+#if MICROPY_PY_MICROPYTHON_TRACE
+
+#if (MICROPY_TRACE_RING_SIZE & (MICROPY_TRACE_RING_SIZE - 1)) != 0 || MICROPY_TRACE_RING_SIZE < 2
+#error MICROPY_TRACE_RING_SIZE must be a power of 2
+#endif
+
+#define TRACE_HEADER_SIZE (16)
+
+// Static rather than on the GC heap: interrupts record into it at any time,
+// including during a collection and across soft reset.
+mp_trace_ring_t mp_trace_ring;
+
+static void put_u32(byte *p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+// trace_start(): clear the ring and start recording
+static mp_obj_t mp_micropython_trace_start(void) {
+    mp_trace_ring.enabled = false;
+    mp_trace_ring.head = 0;
+    mp_trace_ring.enabled = true;
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_trace_start_obj, mp_micropython_trace_start);
+
+// trace_stop() -> number of records claimed since trace_start(), including overwritten ones
+static mp_obj_t mp_micropython_trace_stop(void) {
+    mp_trace_ring.enabled = false;
+    return mp_obj_new_int_from_uint(mp_trace_ring.head);
+}
+MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_trace_stop_obj, mp_micropython_trace_stop);
+
+// trace_dump() -> bytes, see py/mptrace.h for the layout.
+// Recording is paused while the ring is copied so the snapshot is consistent.
+static mp_obj_t mp_micropython_trace_dump(void) {
+    bool was_enabled = mp_trace_ring.enabled;
+    mp_trace_ring.enabled = false;
+
+    uint32_t head = mp_trace_ring.head;
+    uint32_t n = head < MICROPY_TRACE_RING_SIZE ? head : MICROPY_TRACE_RING_SIZE;
+    vstr_t vstr;
+    vstr_init_len(&vstr, TRACE_HEADER_SIZE + n * 8);
+    byte *p = (byte *)vstr.buf;
+    memcpy(p, "MPTR", 4);
+    put_u32(p + 4, MICROPY_TRACE_TIMESTAMP_HZ());
+    put_u32(p + 8, n);
+    put_u32(p + 12, head - n);
+    p += TRACE_HEADER_SIZE;
+    for (uint32_t i = head - n; i != head; i++) {
+        const mp_trace_record_t *r = &mp_trace_ring.rec[i & (MICROPY_TRACE_RING_SIZE - 1)];
+        put_u32(p, r->t);
+        p[4] = r->id;
+        p[5] = r->id >> 8;
+        p[6] = r->arg;
+        p[7] = r->arg >> 8;
+        p += 8;
+    }
+
+    mp_trace_ring.enabled = was_enabled;
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_trace_dump_obj, mp_micropython_trace_dump);
+
+// trace(id, arg=0): record a user event, id 0..0x7fff
+static mp_obj_t mp_micropython_trace(size_t n_args, const mp_obj_t *args) {
+    mp_uint_t id = mp_obj_get_int(args[0]);
+    if (id >= MP_TRACE_USER) {
+        mp_raise_ValueError(MP_ERROR_TEXT("bad id"));
+    }
+    mp_uint_t arg = n_args > 1 ? mp_obj_get_int(args[1]) : 0;
+    mp_trace_event(MP_TRACE_USER | id, arg);
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_trace_obj, 1, 2, mp_micropython_trace);
+
+#endif // MICROPY_PY_MICROPYTHON_TRACE
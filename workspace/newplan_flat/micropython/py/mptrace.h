@@ -0,0 +1,105 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MICROPY_INCLUDED_PY_MPTRACE_H
+#define MICROPY_INCLUDED_PY_MPTRACE_H
+
+#include "py/obj.h"
+
+#if MICROPY_PY_MICROPYTHON_TRACE
+
+#include "py/mphal.h"
+
+// Event trace ring.
+//
+// A fixed-size ring of 8-byte binary records (timestamp, event id, argument)
+// that interrupt handlers, the scheduler, the GC and pyexec append to while
+// tracing is enabled. Recording is lock-free: a slot is claimed with a single
+// atomic increment of the head index, so an interrupt that preempts a writer
+// simply takes the next slot. When the ring is full the oldest records are
+// overwritten. micropython.trace_dump() returns the ring as bytes and
+// tools/mptrace_chrome.py converts that into Chrome trace (about:tracing /
+// Perfetto) JSON.
+//
+// Dump layout (little endian):
+//   "MPTR" | u32 timestamp_hz | u32 n_records | u32 n_lost | records...
+// with the records oldest first, each u32 timestamp | u16 id | u16 arg.
+
+// Event ids. *_BEGIN/*_END pairs become duration slices in the Chrome trace,
+// everything else an instant event. Keep tools/mptrace_chrome.py in sync.
+enum {
+    MP_TRACE_NONE = 0,
+    MP_TRACE_GC_BEGIN,
+    MP_TRACE_GC_END,
+    MP_TRACE_SCHED_BEGIN,       // arg: Python callbacks queued
+    MP_TRACE_SCHED_END,
+    MP_TRACE_PYEXEC_BEGIN,      // arg: parse input kind
+    MP_TRACE_PYEXEC_END,        // arg: pyexec return value
+    MP_TRACE_ISR_UART,          // arg: uart_event_t
+    MP_TRACE_ISR_SPI,           // arg: spi_event_t
+    MP_TRACE_ISR_PIN,           // arg: IRQn
+    MP_TRACE_USER = 0x8000,     // micropython.trace(id, arg): MP_TRACE_USER | id
+};
+
+typedef struct _mp_trace_record_t {
+    uint32_t t;
+    uint16_t id;
+    uint16_t arg;
+} mp_trace_record_t;
+
+typedef struct _mp_trace_ring_t {
+    volatile uint32_t head;     // total records claimed since trace_start()
+    volatile bool enabled;
+    mp_trace_record_t rec[MICROPY_TRACE_RING_SIZE];
+} mp_trace_ring_t;
+
+extern mp_trace_ring_t mp_trace_ring;
+
+// Safe to call from any context, including interrupts running at any priority.
+// A handful of instructions: a flag test, an exclusive-access increment, a
+// cycle counter read and two stores.
+static inline void mp_trace_event(uint16_t id, uint16_t arg) {
+    if (!mp_trace_ring.enabled) {
+        return;
+    }
+    uint32_t i = __atomic_fetch_add(&mp_trace_ring.head, 1, __ATOMIC_RELAXED) & (MICROPY_TRACE_RING_SIZE - 1);
+    mp_trace_record_t *r = &mp_trace_ring.rec[i];
+    r->t = MICROPY_TRACE_TIMESTAMP();
+    r->id = id;
+    r->arg = arg;
+}
+
+#define MP_TRACE_EVENT(id, arg) mp_trace_event((id), (uint16_t)(arg))
+
+MP_DECLARE_CONST_FUN_OBJ_0(mp_micropython_trace_start_obj);
+MP_DECLARE_CONST_FUN_OBJ_0(mp_micropython_trace_stop_obj);
+MP_DECLARE_CONST_FUN_OBJ_0(mp_micropython_trace_dump_obj);
+MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_trace_obj);
+
+#else
+
+#define MP_TRACE_EVENT(id, arg)
+
+#endif // MICROPY_PY_MICROPYTHON_TRACE
+
+#endif // MICROPY_INCLUDED_PY_MPTRACE_H
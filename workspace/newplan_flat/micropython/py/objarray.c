@@ -30,6 +30,7 @@
 #include <stdint.h>
 
 #include "py/runtime.h"
+#include "py/gc.h"
 #include "py/binary.h"
 #include "py/objstr.h"
 #include "py/objarray.h"
@@ -61,6 +62,16 @@
 // so not defined to catch errors
 #endif
 
+// Let the collector move a large item buffer, through the items field, to
+// merge free space; called after each (re)allocation of the items.
+static inline void array_items_movable(mp_obj_array_t *o) {
+    #if MICROPY_GC_MOVABLE
+    gc_movable_register(o, &o->items);
+    #else
+    (void)o;
+    #endif
+}
+
 static mp_obj_t array_iterator_new(mp_obj_t array_in, mp_obj_iter_buf_t *iter_buf);
 static mp_obj_t array_append(mp_obj_t self_in, mp_obj_t arg);
 static mp_obj_t array_extend(mp_obj_t self_in, mp_obj_t arg_in);
@@ -108,6 +119,7 @@ static mp_obj_array_t *array_new(char typecode, size_t n) {
     o->free = 0;
     o->len = n;
     o->items = m_new(byte, typecode_size * o->len);
+    array_items_movable(o);
     return o;
 }
 #endif
@@ -396,6 +408,7 @@ static mp_obj_t array_append(mp_obj_t self_in, mp_obj_t arg) {
         // TODO: alloc policy
         size_t add_cnt = 8;
         self->items = m_renew(byte, self->items, item_sz * self->len, item_sz * (self->len + add_cnt));
+        array_items_movable(self);
         self->free = add_cnt;
         mp_seq_clear(self->items, self->len + 1, self->len + self->free, item_sz);
     }
@@ -429,6 +442,7 @@ static mp_obj_t array_extend(mp_obj_t self_in, mp_obj_t arg_in) {
     // TODO: alloc policy; at the moment we go conservative
     if (self->free < len) {
         self->items = m_renew(byte, self->items, (self->len + self->free) * sz, (self->len + len) * sz);
+        array_items_movable(self);
         self->free = 0;
 
         if (self_in == arg_in) {
@@ -517,6 +531,7 @@ static mp_obj_t array_subscr(mp_obj_t self_in, mp_obj_t index_in, mp_obj_t value
                     if ((size_t)len_adj > o->free) {
                         // TODO: alloc policy; at the moment we go conservative
                         o->items = m_renew(byte, o->items, (o->len + o->free) * item_sz, (o->len + len_adj) * item_sz);
+                        array_items_movable(o);
                         o->free = len_adj;
                         // m_renew may have moved o->items
                         if (src_items == dest_items) {
@@ -64,7 +64,7 @@ mp_obj_t mp_obj_int_from_bytes_impl(bool big_endian, size_t len, const byte *buf
 
 bool mp_obj_int_to_bytes_impl(mp_obj_t self_in, bool big_endian, size_t len, byte *buf) {
     assert(mp_obj_is_exact_type(self_in, &mp_type_int));
-    mp_obj_int_t *self = self_in;
+    mp_obj_int_t *self = MP_OBJ_TO_PTR(self_in);
     long long val = self->val;
     size_t slen; // Number of bytes to represent val
 
@@ -103,7 +103,7 @@ int mp_obj_int_sign(mp_obj_t self_in) {
     if (mp_obj_is_small_int(self_in)) {
         val = MP_OBJ_SMALL_INT_VALUE(self_in);
     } else {
-        mp_obj_int_t *self = self_in;
+        mp_obj_int_t *self = MP_OBJ_TO_PTR(self_in);
         val = self->val;
     }
     if (val < 0) {
@@ -116,7 +116,7 @@ int mp_obj_int_sign(mp_obj_t self_in) {
 }
 
 mp_obj_t mp_obj_int_unary_op(mp_unary_op_t op, mp_obj_t o_in) {
-    mp_obj_int_t *o = o_in;
+    mp_obj_int_t *o = MP_OBJ_TO_PTR(o_in);
     switch (op) {
         case MP_UNARY_OP_BOOL:
             return mp_obj_new_bool(o->val != 0);
@@ -136,7 +136,7 @@ mp_obj_t mp_obj_int_unary_op(mp_unary_op_t op, mp_obj_t o_in) {
             if (self->val >= 0) {
                 return o_in;
             }
-            self = mp_obj_new_int_from_ll(self->val);
+            self = MP_OBJ_TO_PTR(mp_obj_new_int_from_ll(self->val));
             // TODO could overflow long long
             self->val = -self->val;
             return MP_OBJ_FROM_PTR(self);
@@ -158,13 +158,13 @@ mp_obj_t mp_obj_int_binary_op(mp_binary_op_t op, mp_obj_t lhs_in, mp_obj_t rhs_i
         lhs_val = MP_OBJ_SMALL_INT_VALUE(lhs_in);
     } else {
         assert(mp_obj_is_exact_type(lhs_in, &mp_type_int));
-        lhs_val = ((mp_obj_int_t *)lhs_in)->val;
+        lhs_val = ((mp_obj_int_t *)MP_OBJ_TO_PTR(lhs_in))->val;
     }
 
     if (mp_obj_is_small_int(rhs_in)) {
         rhs_val = MP_OBJ_SMALL_INT_VALUE(rhs_in);
     } else if (mp_obj_is_exact_type(rhs_in, &mp_type_int)) {
-        rhs_val = ((mp_obj_int_t *)rhs_in)->val;
+        rhs_val = ((mp_obj_int_t *)MP_OBJ_TO_PTR(rhs_in))->val;
     #if MICROPY_PY_BUILTINS_FLOAT
     } else if (mp_obj_is_float(rhs_in)) {
         return mp_obj_float_binary_op(op, (mp_float_t)lhs_val, rhs_in);
@@ -319,7 +319,7 @@ mp_int_t mp_obj_int_get_truncated(mp_const_obj_t self_in) {
     if (mp_obj_is_small_int(self_in)) {
         return MP_OBJ_SMALL_INT_VALUE(self_in);
     } else {
-        const mp_obj_int_t *self = self_in;
+        const mp_obj_int_t *self = MP_OBJ_TO_PTR(self_in);
         return self->val;
     }
 }
@@ -328,7 +328,7 @@ mp_int_t mp_obj_int_get_checked(mp_const_obj_t self_in) {
     if (mp_obj_is_small_int(self_in)) {
         return MP_OBJ_SMALL_INT_VALUE(self_in);
     } else {
-        const mp_obj_int_t *self = self_in;
+        const mp_obj_int_t *self = MP_OBJ_TO_PTR(self_in);
         long long value = self->val;
         mp_int_t truncated = (mp_int_t)value;
         if ((long long)truncated == value) {
@@ -344,7 +344,7 @@ mp_uint_t mp_obj_int_get_uint_checked(mp_const_obj_t self_in) {
             return MP_OBJ_SMALL_INT_VALUE(self_in);
         }
     } else {
-        const mp_obj_int_t *self = self_in;
+        const mp_obj_int_t *self = MP_OBJ_TO_PTR(self_in);
         long long value = self->val;
         mp_uint_t truncated = (mp_uint_t)value;
         if (value >= 0 && (long long)truncated == value) {
@@ -357,7 +357,7 @@ mp_uint_t mp_obj_int_get_uint_checked(mp_const_obj_t self_in) {
 #if MICROPY_PY_BUILTINS_FLOAT
 mp_float_t mp_obj_int_as_float_impl(mp_obj_t self_in) {
     assert(mp_obj_is_exact_type(self_in, &mp_type_int));
-    mp_obj_int_t *self = self_in;
+    mp_obj_int_t *self = MP_OBJ_TO_PTR(self_in);
     return self->val;
 }
 #endif
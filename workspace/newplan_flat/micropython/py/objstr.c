@@ -2153,7 +2153,7 @@ MP_DEFINE_CONST_DICT_WITH_SIZE(mp_obj_str_locals_dict,
     array_bytearray_str_bytes_locals_table + TABLE_ENTRIES_ARRAY + TABLE_ENTRIES_HEX + TABLE_ENTRIES_COMPAT,
     MP_ARRAY_SIZE(array_bytearray_str_bytes_locals_table) - (TABLE_ENTRIES_ARRAY + TABLE_ENTRIES_HEX + TABLE_ENTRIES_COMPAT));
 
-#if TABLE_ENTRIES_COMPAT == 0
+#if TABLE_ENTRIES_COMPAT == 0 && TABLE_ENTRIES_HEX == 0
 #define mp_obj_bytes_locals_dict mp_obj_str_locals_dict
 #else
 MP_DEFINE_CONST_DICT_WITH_SIZE(mp_obj_bytes_locals_dict,
@@ -38,6 +38,7 @@
 #include "py/objint.h"
 #include "py/objstr.h"
 #include "py/builtin.h"
+#include "py/comparena.h"
 
 #if MICROPY_ENABLE_COMPILER
 
@@ -259,12 +260,12 @@ static void *parser_alloc(parser_t *parser, size_t num_bytes) {
 
     if (chunk != NULL && chunk->union_.used + num_bytes > chunk->alloc) {
         // not enough room at end of previously allocated chunk so try to grow
-        mp_parse_chunk_t *new_data = (mp_parse_chunk_t *)m_renew_maybe(byte, chunk,
+        mp_parse_chunk_t *new_data = (mp_parse_chunk_t *)m_arena_renew_maybe(byte, chunk,
             sizeof(mp_parse_chunk_t) + chunk->alloc,
             sizeof(mp_parse_chunk_t) + chunk->alloc + num_bytes, false);
         if (new_data == NULL) {
             // could not grow existing memory; shrink it to fit previous
-            (void)m_renew_maybe(byte, chunk, sizeof(mp_parse_chunk_t) + chunk->alloc,
+            (void)m_arena_renew_maybe(byte, chunk, sizeof(mp_parse_chunk_t) + chunk->alloc,
                 sizeof(mp_parse_chunk_t) + chunk->union_.used, false);
             chunk->alloc = chunk->union_.used;
             chunk->union_.next = parser->tree.chunk;
@@ -282,7 +283,7 @@ static void *parser_alloc(parser_t *parser, size_t num_bytes) {
         if (alloc < num_bytes) {
             alloc = num_bytes;
         }
-        chunk = (mp_parse_chunk_t *)m_new(byte, sizeof(mp_parse_chunk_t) + alloc);
+        chunk = (mp_parse_chunk_t *)m_arena_new(byte, sizeof(mp_parse_chunk_t) + alloc);
         chunk->alloc = alloc;
         chunk->union_.used = 0;
         parser->cur_chunk = chunk;
@@ -305,9 +306,10 @@ static void parser_free_parse_node_struct(parser_t *parser, mp_parse_node_struct
 
 static void push_rule(parser_t *parser, size_t src_line, uint8_t rule_id, size_t arg_i) {
     if (parser->rule_stack_top >= parser->rule_stack_alloc) {
-        rule_stack_t *rs = m_renew(rule_stack_t, parser->rule_stack, parser->rule_stack_alloc, parser->rule_stack_alloc + MICROPY_ALLOC_PARSE_RULE_INC);
+        size_t inc = m_arena_grow(parser->rule_stack_alloc, MICROPY_ALLOC_PARSE_RULE_INC);
+        rule_stack_t *rs = m_arena_renew(rule_stack_t, parser->rule_stack, parser->rule_stack_alloc, parser->rule_stack_alloc + inc);
         parser->rule_stack = rs;
-        parser->rule_stack_alloc += MICROPY_ALLOC_PARSE_RULE_INC;
+        parser->rule_stack_alloc += inc;
     }
     rule_stack_t *rs = &parser->rule_stack[parser->rule_stack_top++];
     rs->src_line = src_line;
@@ -549,9 +551,10 @@ static mp_parse_node_t peek_result(parser_t *parser, size_t pos) {
 
 static void push_result_node(parser_t *parser, mp_parse_node_t pn) {
     if (parser->result_stack_top >= parser->result_stack_alloc) {
-        mp_parse_node_t *stack = m_renew(mp_parse_node_t, parser->result_stack, parser->result_stack_alloc, parser->result_stack_alloc + MICROPY_ALLOC_PARSE_RESULT_INC);
+        size_t inc = m_arena_grow(parser->result_stack_alloc, MICROPY_ALLOC_PARSE_RESULT_INC);
+        mp_parse_node_t *stack = m_arena_renew(mp_parse_node_t, parser->result_stack, parser->result_stack_alloc, parser->result_stack_alloc + inc);
         parser->result_stack = stack;
-        parser->result_stack_alloc += MICROPY_ALLOC_PARSE_RESULT_INC;
+        parser->result_stack_alloc += inc;
     }
     parser->result_stack[parser->result_stack_top++] = pn;
 }
@@ -1049,13 +1052,21 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
 
     parser_t parser;
 
+    #if MICROPY_COMP_ARENA
+    // Everything allocated from the arena from here on belongs to the parse
+    // tree: release it if an exception is raised, else mp_parse_tree_clear does.
+    parser.tree.arena_mark = mp_comp_arena_mark();
+    MP_DEFINE_NLR_JUMP_CALLBACK_FUNCTION_1(arena_ctx, mp_parse_tree_clear, &parser.tree);
+    nlr_push_jump_callback(&arena_ctx.callback, mp_call_function_1_from_nlr_jump_callback);
+    #endif
+
     parser.rule_stack_alloc = MICROPY_ALLOC_PARSE_RULE_INIT;
     parser.rule_stack_top = 0;
-    parser.rule_stack = m_new(rule_stack_t, parser.rule_stack_alloc);
+    parser.rule_stack = m_arena_new(rule_stack_t, parser.rule_stack_alloc);
 
     parser.result_stack_alloc = MICROPY_ALLOC_PARSE_RESULT_INIT;
     parser.result_stack_top = 0;
-    parser.result_stack = m_new(mp_parse_node_t, parser.result_stack_alloc);
+    parser.result_stack = m_arena_new(mp_parse_node_t, parser.result_stack_alloc);
 
     parser.lexer = lex;
 
@@ -1344,7 +1355,7 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
 
     // truncate final chunk and link into chain of chunks
     if (parser.cur_chunk != NULL) {
-        (void)m_renew_maybe(byte, parser.cur_chunk,
+        (void)m_arena_renew_maybe(byte, parser.cur_chunk,
             sizeof(mp_parse_chunk_t) + parser.cur_chunk->alloc,
             sizeof(mp_parse_chunk_t) + parser.cur_chunk->union_.used,
             false);
@@ -1385,8 +1396,12 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
     parser.tree.root = parser.result_stack[0];
 
     // free the memory that we don't need anymore
-    m_del(rule_stack_t, parser.rule_stack, parser.rule_stack_alloc);
-    m_del(mp_parse_node_t, parser.result_stack, parser.result_stack_alloc);
+    m_arena_del(rule_stack_t, parser.rule_stack, parser.rule_stack_alloc);
+    m_arena_del(mp_parse_node_t, parser.result_stack, parser.result_stack_alloc);
+
+    #if MICROPY_COMP_ARENA
+    nlr_pop_jump_callback(false);
+    #endif
 
     // Deregister exception handler and free the lexer.
     nlr_pop_jump_callback(true);
@@ -1395,12 +1410,17 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
 }
 
 void mp_parse_tree_clear(mp_parse_tree_t *tree) {
+    #if MICROPY_COMP_ARENA
+    // the chunks, and whatever the compiler put in the arena after them
+    mp_comp_arena_release(tree->arena_mark);
+    #else
     mp_parse_chunk_t *chunk = tree->chunk;
     while (chunk != NULL) {
         mp_parse_chunk_t *next = chunk->union_.next;
         m_del(byte, chunk, sizeof(mp_parse_chunk_t) + chunk->alloc);
         chunk = next;
     }
+    #endif
     tree->chunk = NULL; // Avoid dangling pointer that may live on stack
 }
 
@@ -106,6 +106,9 @@ typedef enum {
 typedef struct _mp_parse_t {
     mp_parse_node_t root;
     struct _mp_parse_chunk_t *chunk;
+    #if MICROPY_COMP_ARENA
+    void *arena_mark; // compiler arena position before parsing, see py/comparena.h
+    #endif
 } mp_parse_tree_t;
 
 // the parser will raise an exception if an error occurred
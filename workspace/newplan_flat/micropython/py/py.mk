@@ -103,6 +103,7 @@ PY_CORE_O_BASENAME = $(addprefix py/,\
 	reader.o \
 	lexer.o \
 	parse.o \
+	comparena.o \
 	scope.o \
 	compile.o \
 	emitcommon.o \
@@ -141,6 +142,8 @@ PY_CORE_O_BASENAME = $(addprefix py/,\
 	argcheck.o \
 	warning.o \
 	profile.o \
+	sampleprof.o \
+	mptrace.o \
 	map.o \
 	obj.o \
 	objarray.o \
@@ -25,17 +25,63 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "py/runtime.h"
+#include "py/gc.h"
 
 #if MICROPY_ENABLE_PYSTACK
 
+#if MICROPY_PYSTACK_HEAP_FALLBACK && !MICROPY_ENABLE_GC
+#error MICROPY_PYSTACK_HEAP_FALLBACK requires MICROPY_ENABLE_GC
+#endif
+
 void mp_pystack_init(void *start, void *end) {
     MP_STATE_THREAD(pystack_start) = start;
     MP_STATE_THREAD(pystack_end) = end;
     MP_STATE_THREAD(pystack_cur) = start;
+    MP_STATE_THREAD(pystack_peak) = start;
+    MP_STATE_THREAD(pystack_overflows) = 0;
+}
+
+#if MICROPY_PYSTACK_HEAP_FALLBACK
+
+// A block that does not fit in the pystack is allocated on the heap with the
+// value of pystack_cur at the time of the allocation in its last word.  Freeing
+// the block restores pystack_cur to that value, which frees everything
+// allocated on the pystack after it, as mp_pystack_free does for a pystack
+// block.  The block itself is handed out so the GC sees it from the C stack.
+static uint8_t **pystack_heap_restore(void *ptr) {
+    return (uint8_t **)((uint8_t *)ptr + gc_nbytes(ptr)) - 1;
+}
+
+static void *pystack_heap_alloc(size_t n_bytes, uint8_t *restore) {
+    void *ptr = gc_alloc(n_bytes + sizeof(uint8_t *), 0);
+    if (ptr == NULL) {
+        m_malloc_fail(n_bytes + sizeof(uint8_t *));
+    }
+    *pystack_heap_restore(ptr) = restore;
+    MP_STATE_THREAD(pystack_overflows) += 1;
+    return ptr;
+}
+
+void mp_pystack_heap_free(void *ptr) {
+    MP_STATE_THREAD(pystack_cur) = *pystack_heap_restore(ptr);
+    gc_free(ptr);
+}
+
+void *mp_pystack_heap_realloc(void *ptr, size_t old_n_bytes, size_t new_n_bytes) {
+    // allocate the new block before releasing the old one so that the objects
+    // it refers to stay reachable if the allocation collects
+    uint8_t *restore = mp_pystack_owns(ptr) ? ptr : *pystack_heap_restore(ptr);
+    void *new_ptr = pystack_heap_alloc(new_n_bytes, restore);
+    memcpy(new_ptr, ptr, old_n_bytes < new_n_bytes ? old_n_bytes : new_n_bytes);
+    mp_pystack_free(ptr);
+    return new_ptr;
 }
 
+#endif
+
 void *mp_pystack_alloc(size_t n_bytes) {
     n_bytes = (n_bytes + (MICROPY_PYSTACK_ALIGN - 1)) & ~(MICROPY_PYSTACK_ALIGN - 1);
     #if MP_PYSTACK_DEBUG
@@ -43,10 +89,17 @@ void *mp_pystack_alloc(size_t n_bytes) {
     #endif
     if (MP_STATE_THREAD(pystack_cur) + n_bytes > MP_STATE_THREAD(pystack_end)) {
         // out of memory in the pystack
+        #if MICROPY_PYSTACK_HEAP_FALLBACK
+        return pystack_heap_alloc(n_bytes, MP_STATE_THREAD(pystack_cur));
+        #else
         mp_raise_type_arg(&mp_type_RuntimeError, MP_OBJ_NEW_QSTR(MP_QSTR_pystack_space_exhausted));
+        #endif
     }
     void *ptr = MP_STATE_THREAD(pystack_cur);
     MP_STATE_THREAD(pystack_cur) += n_bytes;
+    if (MP_STATE_THREAD(pystack_cur) > MP_STATE_THREAD(pystack_peak)) {
+        MP_STATE_THREAD(pystack_peak) = MP_STATE_THREAD(pystack_cur);
+    }
     #if MP_PYSTACK_DEBUG
     *(size_t *)(MP_STATE_THREAD(pystack_cur) - MICROPY_PYSTACK_ALIGN) = n_bytes;
     #endif
@@ -37,10 +37,28 @@
 void mp_pystack_init(void *start, void *end);
 void *mp_pystack_alloc(size_t n_bytes);
 
+// A zero-sized block taken when the pystack is full is at pystack_end.
+static inline bool mp_pystack_owns(void *ptr) {
+    return (uint8_t *)ptr >= MP_STATE_THREAD(pystack_start) && (uint8_t *)ptr <= MP_STATE_THREAD(pystack_end);
+}
+
+#if MICROPY_PYSTACK_HEAP_FALLBACK
+// With the heap fallback mp_pystack_alloc may return a heap block; these
+// handle such blocks (see pystack.c).
+void mp_pystack_heap_free(void *ptr);
+void *mp_pystack_heap_realloc(void *ptr, size_t old_n_bytes, size_t new_n_bytes);
+#endif
+
 // This function can free multiple continuous blocks at once: just pass the
 // pointer to the block that was allocated first and it and all subsequently
 // allocated blocks will be freed.
 static inline void mp_pystack_free(void *ptr) {
+    #if MICROPY_PYSTACK_HEAP_FALLBACK
+    if (!mp_pystack_owns(ptr)) {
+        mp_pystack_heap_free(ptr);
+        return;
+    }
+    #endif
     assert((uint8_t *)ptr >= MP_STATE_THREAD(pystack_start));
     assert((uint8_t *)ptr <= MP_STATE_THREAD(pystack_cur));
     #if MP_PYSTACK_DEBUG
@@ -58,9 +76,18 @@ static inline void mp_pystack_free(void *ptr) {
     MP_STATE_THREAD(pystack_cur) = (uint8_t *)ptr;
 }
 
-static inline void mp_pystack_realloc(void *ptr, size_t n_bytes) {
+// Resizes the most recently allocated block.  The block only moves if the
+// heap fallback is enabled and the new size does not fit.
+static inline void *mp_pystack_realloc(void *ptr, size_t old_n_bytes, size_t new_n_bytes) {
+    #if MICROPY_PYSTACK_HEAP_FALLBACK
+    if (!mp_pystack_owns(ptr) || new_n_bytes > (size_t)(MP_STATE_THREAD(pystack_end) - (uint8_t *)ptr)) {
+        return mp_pystack_heap_realloc(ptr, old_n_bytes, new_n_bytes);
+    }
+    #endif
+    (void)old_n_bytes;
     mp_pystack_free(ptr);
-    mp_pystack_alloc(n_bytes);
+    mp_pystack_alloc(new_n_bytes);
+    return ptr;
 }
 
 static inline size_t mp_pystack_usage(void) {
@@ -71,6 +98,10 @@ static inline size_t mp_pystack_limit(void) {
     return MP_STATE_THREAD(pystack_end) - MP_STATE_THREAD(pystack_start);
 }
 
+static inline size_t mp_pystack_peak(void) {
+    return MP_STATE_THREAD(pystack_peak) - MP_STATE_THREAD(pystack_start);
+}
+
 #endif
 
 #if !MICROPY_ENABLE_PYSTACK
@@ -108,9 +139,7 @@ static inline void *mp_nonlocal_alloc(size_t n_bytes) {
 }
 
 static inline void *mp_nonlocal_realloc(void *ptr, size_t old_n_bytes, size_t new_n_bytes) {
-    (void)old_n_bytes;
-    mp_pystack_realloc(ptr, new_n_bytes);
-    return ptr;
+    return mp_pystack_realloc(ptr, old_n_bytes, new_n_bytes);
 }
 
 static inline void mp_nonlocal_free(void *ptr, size_t n_bytes) {
@@ -82,8 +82,13 @@ void mp_init(void) {
         MP_STATE_VM(sched_state) = MP_SCHED_PENDING;
     }
     #endif
-    MP_STATE_VM(sched_idx) = 0;
     MP_STATE_VM(sched_len) = 0;
+    for (size_t i = 0; i < MICROPY_SCHEDULER_PRIORITIES; i++) {
+        MP_STATE_VM(sched_class_len)[i] = 0;
+        MP_STATE_VM(sched_class_idx)[i] = 0;
+    }
+    MP_STATE_VM(sched_peak) = 0;
+    MP_STATE_VM(sched_overflow) = 0;
     #endif
 
     #if MICROPY_ENABLE_EMERGENCY_EXCEPTION_BUF
@@ -105,6 +110,11 @@ void mp_init(void) {
     #if MICROPY_EMIT_NATIVE
     MP_STATE_VM(default_emit_opt) = MP_EMIT_OPT_NONE;
     #endif
+    #if MICROPY_COMP_ARENA
+    // the heap has been reinitialised, so forget any chunks left from before
+    MP_STATE_VM(comp_arena) = NULL;
+    MP_STATE_VM(comp_arena_size) = 0;
+    #endif
     #endif
 
     // init global module dict
@@ -164,6 +174,8 @@ void mp_init(void) {
     #if MICROPY_PY_SYS_SETTRACE
     MP_STATE_THREAD(prof_trace_callback) = MP_OBJ_NULL;
     MP_STATE_THREAD(prof_callback_is_executing) = false;
+    #endif
+    #if MICROPY_VM_TRACK_CODE_STATE
     MP_STATE_THREAD(current_code_state) = NULL;
     #endif
 
@@ -116,13 +116,35 @@ static inline void mp_handle_pending(bool raise_exc) {
 }
 
 #if MICROPY_ENABLE_SCHEDULER
+#define MP_SCHED_PRIO_NORMAL (0)
+#define MP_SCHED_PRIO_HIGH (MICROPY_SCHEDULER_PRIORITIES - 1)
+
 void mp_sched_lock(void);
 void mp_sched_unlock(void);
 #define mp_sched_num_pending() (MP_STATE_VM(sched_len))
-bool mp_sched_schedule(mp_obj_t function, mp_obj_t arg);
+bool mp_sched_schedule_prio(mp_obj_t function, mp_obj_t arg, size_t prio);
+static inline bool mp_sched_schedule(mp_obj_t function, mp_obj_t arg) {
+    return mp_sched_schedule_prio(function, arg, MP_SCHED_PRIO_NORMAL);
+}
 bool mp_sched_schedule_node(mp_sched_node_t *node, mp_sched_callback_t callback);
 #endif
 
+// Cheap test for polling loops (MICROPY_EVENT_POLL_HOOK): true if
+// mp_handle_pending() has a callback to run or an exception to raise.
+static inline bool mp_handle_pending_needed(void) {
+    #if MICROPY_ENABLE_VM_ABORT
+    if (MP_STATE_VM(vm_abort)) {
+        return true;
+    }
+    #endif
+    #if MICROPY_ENABLE_SCHEDULER
+    if (MP_STATE_VM(sched_state) == MP_SCHED_PENDING) {
+        return true;
+    }
+    #endif
+    return MP_STATE_THREAD(mp_pending_exception) != MP_OBJ_NULL;
+}
+
 // Handles any pending MicroPython events without waiting for an interrupt or event.
 void mp_event_handle_nowait(void);
 
@@ -185,6 +207,8 @@ static inline void mp_thread_init_state(mp_state_thread_t *ts, size_t stack_size
     #if MICROPY_PY_SYS_SETTRACE
     ts->prof_trace_callback = MP_OBJ_NULL;
     ts->prof_callback_is_executing = false;
+    #endif
+    #if MICROPY_VM_TRACK_CODE_STATE
     ts->current_code_state = NULL;
     #endif
 
@@ -0,0 +1,273 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/bc.h"
+#include "py/objfun.h"
+#include "py/sampleprof.h"
+
+#if MICROPY_PY_MICROPYTHON_PROFILE
+
+#if MICROPY_SAMPLEPROF_POSIX
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+// MP_STATE_VM(sampleprof_buf) holds two words per sample: the function object
+// and either the bytecode offset or, if the function is NULL, a marker.
+// profile_dump() aggregates the samples in place into entries of the same
+// size: the function object and (line | count << 16), sorted by count.
+// The buffer lives on the GC heap and is a root pointer, so the sampled
+// functions stay alive until the profile has been dumped.
+#define ENTRY_LINE_MASK (0xffff)
+#define ENTRY_COUNT_SHIFT (16)
+#define SAMPLEPROF_MAX_SAMPLES (0xffff)
+#define SAMPLEPROF_DEFAULT_SAMPLES (1024)
+
+typedef struct _sampleprof_t {
+    volatile bool running;
+    bool aggregated;
+    uint16_t period;            // ticks per sample
+    uint16_t countdown;
+    mp_uint_t freq;
+    size_t n_max;
+    volatile size_t n;          // samples, or entries once aggregated
+    volatile size_t dropped;    // samples lost because the buffer was full
+    size_t n_samples;           // samples before aggregation
+} sampleprof_t;
+
+static sampleprof_t sampleprof;
+
+#if MICROPY_SAMPLEPROF_POSIX
+static void sampleprof_sigprof(int signum) {
+    (void)signum;
+    mp_sampleprof_tick();
+}
+
+static void sampleprof_timer_set(mp_uint_t freq) {
+    struct itimerval it;
+    memset(&it, 0, sizeof(it));
+    if (freq > 0) {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = sampleprof_sigprof;
+        sigemptyset(&sa.sa_mask);
+        sa.sa_flags = SA_RESTART;
+        sigaction(SIGPROF, &sa, NULL);
+        it.it_interval.tv_usec = 1000000 / freq;
+        it.it_value = it.it_interval;
+    }
+    setitimer(ITIMER_PROF, &it, NULL);
+}
+#define SAMPLEPROF_MAX_FREQ (1000000)
+#else
+// The port drives mp_sampleprof_tick() from its own periodic interrupt
+#define sampleprof_timer_set(freq) (void)(freq)
+#define SAMPLEPROF_MAX_FREQ (MICROPY_SAMPLEPROF_TICK_HZ)
+#endif
+
+// Called from interrupt context: must not allocate or raise
+void mp_sampleprof_tick(void) {
+    if (!sampleprof.running || --sampleprof.countdown != 0) {
+        return;
+    }
+    sampleprof.countdown = sampleprof.period;
+    size_t n = sampleprof.n;
+    if (n >= sampleprof.n_max) {
+        sampleprof.dropped++;
+        return;
+    }
+    uintptr_t *s = &MP_STATE_VM(sampleprof_buf)[2 * n];
+    const mp_code_state_t *code_state = MP_STATE_THREAD(current_code_state);
+    if (MP_STATE_THREAD(gc_lock_depth) & GC_COLLECT_FLAG) {
+        s[0] = 0;
+        s[1] = MP_SAMPLEPROF_GC;
+    } else if (code_state == NULL) {
+        s[0] = 0;
+        s[1] = MP_SAMPLEPROF_OTHER;
+    } else {
+        s[0] = (uintptr_t)code_state->fun_bc;
+        s[1] = (uintptr_t)(code_state->ip - code_state->fun_bc->bytecode);
+    }
+    sampleprof.n = n + 1;
+}
+
+static void sampleprof_stop(void) {
+    sampleprof.running = false;
+    sampleprof_timer_set(0);
+}
+
+void mp_sampleprof_deinit(void) {
+    sampleprof_stop();
+    memset(&sampleprof, 0, sizeof(sampleprof));
+    MP_STATE_VM(sampleprof_buf) = NULL;
+}
+
+static bool sampleprof_entry_less(const uintptr_t *a, const uintptr_t *b, bool by_count) {
+    if (by_count) {
+        return (a[1] >> ENTRY_COUNT_SHIFT) > (b[1] >> ENTRY_COUNT_SHIFT);
+    }
+    return a[0] < b[0] || (a[0] == b[0] && a[1] < b[1]);
+}
+
+// Shell sort of two-word entries, in place (no extra heap needed)
+static void sampleprof_sort(uintptr_t *e, size_t n, bool by_count) {
+    for (size_t gap = n / 2; gap > 0; gap /= 2) {
+        for (size_t i = gap; i < n; i++) {
+            uintptr_t t[2] = { e[2 * i], e[2 * i + 1] };
+            size_t j = i;
+            for (; j >= gap && sampleprof_entry_less(t, &e[2 * (j - gap)], by_count); j -= gap) {
+                e[2 * j] = e[2 * (j - gap)];
+                e[2 * j + 1] = e[2 * (j - gap) + 1];
+            }
+            e[2 * j] = t[0];
+            e[2 * j + 1] = t[1];
+        }
+    }
+}
+
+// Replace offsets by lines, then collapse equal (function, line) samples
+static void sampleprof_aggregate(void) {
+    uintptr_t *s = MP_STATE_VM(sampleprof_buf);
+    size_t n = sampleprof.n;
+    for (size_t i = 0; i < n; i++) {
+        if (s[2 * i] != 0) {
+            qstr block, file;
+            size_t line = mp_bytecode_get_location((const mp_obj_fun_bc_t *)s[2 * i], s[2 * i + 1], &block, &file);
+            s[2 * i + 1] = MIN(line, ENTRY_LINE_MASK);
+        }
+    }
+    sampleprof_sort(s, n, false);
+
+    size_t n_entries = 0;
+    for (size_t i = 0; i < n; i++) {
+        uintptr_t *prev = &s[2 * (n_entries - 1)];
+        if (n_entries > 0 && prev[0] == s[2 * i] && (prev[1] & ENTRY_LINE_MASK) == s[2 * i + 1]) {
+            prev[1] += 1 << ENTRY_COUNT_SHIFT;
+        } else {
+            s[2 * n_entries] = s[2 * i];
+            s[2 * n_entries + 1] = s[2 * i + 1] | (1 << ENTRY_COUNT_SHIFT);
+            n_entries++;
+        }
+    }
+    sampleprof_sort(s, n_entries, true);
+
+    sampleprof.n_samples = n;
+    sampleprof.n = n_entries;
+    sampleprof.aggregated = true;
+}
+
+// micropython.profile_start(freq=MICROPY_SAMPLEPROF_TICK_HZ, n_samples=1024)
+static mp_obj_t mp_micropython_profile_start(size_t n_args, const mp_obj_t *args) {
+    mp_int_t freq = n_args > 0 ? mp_obj_get_int(args[0]) : MICROPY_SAMPLEPROF_TICK_HZ;
+    mp_int_t n_max = n_args > 1 ? mp_obj_get_int(args[1]) : SAMPLEPROF_DEFAULT_SAMPLES;
+    if (freq <= 0 || freq > SAMPLEPROF_MAX_FREQ) {
+        mp_raise_ValueError(MP_ERROR_TEXT("bad freq"));
+    }
+    if (n_max <= 0 || n_max > SAMPLEPROF_MAX_SAMPLES) {
+        mp_raise_ValueError(MP_ERROR_TEXT("bad n_samples"));
+    }
+
+    sampleprof_stop();
+    if (MP_STATE_VM(sampleprof_buf) == NULL || sampleprof.n_max != (size_t)n_max) {
+        uintptr_t *old = MP_STATE_VM(sampleprof_buf);
+        MP_STATE_VM(sampleprof_buf) = NULL;
+        m_del(uintptr_t, old, 2 * sampleprof.n_max);
+        sampleprof.n_max = 0;
+        MP_STATE_VM(sampleprof_buf) = m_new(uintptr_t, 2 * n_max);
+        sampleprof.n_max = n_max;
+    }
+
+    #if MICROPY_SAMPLEPROF_POSIX
+    sampleprof.period = 1;
+    #else
+    sampleprof.period = MICROPY_SAMPLEPROF_TICK_HZ / freq;
+    #endif
+    sampleprof.countdown = sampleprof.period;
+    sampleprof.freq = freq;
+    sampleprof.n = 0;
+    sampleprof.dropped = 0;
+    sampleprof.aggregated = false;
+    sampleprof.running = true;
+    sampleprof_timer_set(freq);
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_profile_start_obj, 0, 2, mp_micropython_profile_start);
+
+// micropython.profile_stop() -> number of samples recorded
+static mp_obj_t mp_micropython_profile_stop(void) {
+    sampleprof_stop();
+    return MP_OBJ_NEW_SMALL_INT(sampleprof.aggregated ? sampleprof.n_samples : sampleprof.n);
+}
+MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_profile_stop_obj, mp_micropython_profile_stop);
+
+// micropython.profile_dump(top=20)
+// Stops sampling, prints a flat profile (hottest lines first) and returns it
+// as a list of (count, function, file, line) tuples
+static mp_obj_t mp_micropython_profile_dump(size_t n_args, const mp_obj_t *args) {
+    size_t top = n_args > 0 ? (size_t)mp_obj_get_int(args[0]) : 20;
+    sampleprof_stop();
+    mp_obj_t result = mp_obj_new_list(0, NULL);
+    if (MP_STATE_VM(sampleprof_buf) == NULL) {
+        return result;
+    }
+    if (!sampleprof.aggregated) {
+        sampleprof_aggregate();
+    }
+
+    size_t total = sampleprof.n_samples;
+    mp_printf(&mp_plat_print, "%u samples at %u Hz, %u dropped\n",
+        (uint)total, (uint)sampleprof.freq, (uint)sampleprof.dropped);
+    const uintptr_t *e = MP_STATE_VM(sampleprof_buf);
+    for (size_t i = 0; i < sampleprof.n && i < top; i++, e += 2) {
+        size_t count = e[1] >> ENTRY_COUNT_SHIFT;
+        size_t line = e[1] & ENTRY_LINE_MASK;
+        size_t permille = count * 1000 / total;
+        mp_obj_t item[4];
+        item[0] = MP_OBJ_NEW_SMALL_INT(count);
+        if (e[0] == 0) {
+            const char *what = line == MP_SAMPLEPROF_GC ? "<gc>" : "<other>";
+            mp_printf(&mp_plat_print, "%6u %3u.%u%%  %s\n", (uint)count, (uint)(permille / 10), (uint)(permille % 10), what);
+            item[1] = mp_obj_new_str(what, strlen(what));
+            item[2] = MP_OBJ_NEW_QSTR(MP_QSTR_);
+            item[3] = MP_OBJ_NEW_SMALL_INT(0);
+        } else {
+            qstr block, file;
+            mp_bytecode_get_location((const mp_obj_fun_bc_t *)e[0], 0, &block, &file);
+            mp_printf(&mp_plat_print, "%6u %3u.%u%%  %q  %q:%u\n", (uint)count, (uint)(permille / 10), (uint)(permille % 10), block, file, (uint)line);
+            item[1] = MP_OBJ_NEW_QSTR(block);
+            item[2] = MP_OBJ_NEW_QSTR(file);
+            item[3] = MP_OBJ_NEW_SMALL_INT(line);
+        }
+        mp_obj_list_append(result, mp_obj_new_tuple(4, item));
+    }
+    return result;
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_profile_dump_obj, 0, 1, mp_micropython_profile_dump);
+
+MP_REGISTER_ROOT_POINTER(uintptr_t *sampleprof_buf);
+
+#endif // MICROPY_PY_MICROPYTHON_PROFILE
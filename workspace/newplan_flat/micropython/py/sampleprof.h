@@ -0,0 +1,55 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MICROPY_INCLUDED_PY_SAMPLEPROF_H
+#define MICROPY_INCLUDED_PY_SAMPLEPROF_H
+
+#include "py/obj.h"
+
+#if MICROPY_PY_MICROPYTHON_PROFILE
+
+// Statistical (sampling) profiler.
+//
+// While running, every tick records the function and bytecode offset of the
+// frame that MP_STATE_THREAD(current_code_state) points to. Nothing is done
+// per opcode, so the cost is a few stores per call plus one short interrupt
+// per sample. The port calls mp_sampleprof_tick() from a periodic interrupt
+// at MICROPY_SAMPLEPROF_TICK_HZ; with MICROPY_SAMPLEPROF_POSIX a host build
+// uses setitimer(ITIMER_PROF) instead.
+
+// Sample markers (stored with a NULL function)
+#define MP_SAMPLEPROF_OTHER (0)     // no bytecode frame: REPL, native code, startup
+#define MP_SAMPLEPROF_GC    (1)     // garbage collection in progress
+
+void mp_sampleprof_tick(void);
+
+// Stop sampling and forget the buffer (soft reset)
+void mp_sampleprof_deinit(void);
+
+MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_profile_start_obj);
+MP_DECLARE_CONST_FUN_OBJ_0(mp_micropython_profile_stop_obj);
+MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_profile_dump_obj);
+
+#endif // MICROPY_PY_MICROPYTHON_PROFILE
+
+#endif // MICROPY_INCLUDED_PY_SAMPLEPROF_H
@@ -28,6 +28,7 @@
 
 #include "py/mphal.h"
 #include "py/runtime.h"
+#include "py/mptrace.h"
 
 // Schedules an exception on the main thread (for exceptions "thrown" by async
 // sources such as interrupts and UNIX signal handlers).
@@ -63,12 +64,13 @@ void MICROPY_WRAP_MP_SCHED_VM_ABORT(mp_sched_vm_abort)(void) {
 #define IDX_MASK(i) ((i) & (MICROPY_SCHEDULER_DEPTH - 1))
 
 // This is a macro so it is guaranteed to be inlined in functions like
-// mp_sched_schedule that may be located in a special memory region.
-#define mp_sched_full() (mp_sched_num_pending() == MICROPY_SCHEDULER_DEPTH)
+// mp_sched_schedule_prio that may be located in a special memory region.
+#define mp_sched_full(prio) (MP_STATE_VM(sched_class_len)[prio] == MICROPY_SCHEDULER_DEPTH)
 
 static inline bool mp_sched_empty(void) {
     MP_STATIC_ASSERT(MICROPY_SCHEDULER_DEPTH <= 255); // MICROPY_SCHEDULER_DEPTH must fit in 8 bits
     MP_STATIC_ASSERT((IDX_MASK(MICROPY_SCHEDULER_DEPTH) == 0)); // MICROPY_SCHEDULER_DEPTH must be a power of 2
+    MP_STATIC_ASSERT(MICROPY_SCHEDULER_PRIORITIES >= 1 && MICROPY_SCHEDULER_PRIORITIES * MICROPY_SCHEDULER_DEPTH <= 0xffff);
 
     return mp_sched_num_pending() == 0;
 }
@@ -85,6 +87,7 @@ static inline void mp_sched_run_pending(void) {
     // Equivalent to mp_sched_lock(), but we're already in the atomic
     // section and know that we're pending.
     MP_STATE_VM(sched_state) = MP_SCHED_LOCKED;
+    MP_TRACE_EVENT(MP_TRACE_SCHED_BEGIN, MP_STATE_VM(sched_len));
 
     #if MICROPY_SCHEDULER_STATIC_NODES
     // Run all pending C callbacks.
@@ -106,16 +109,23 @@ static inline void mp_sched_run_pending(void) {
     }
     #endif
 
-    // Run at most one pending Python callback.
+    // Run at most one pending Python callback, from the highest non-empty class.
     if (!mp_sched_empty()) {
-        mp_sched_item_t item = MP_STATE_VM(sched_queue)[MP_STATE_VM(sched_idx)];
-        MP_STATE_VM(sched_idx) = IDX_MASK(MP_STATE_VM(sched_idx) + 1);
+        size_t prio = MICROPY_SCHEDULER_PRIORITIES - 1;
+        while (MP_STATE_VM(sched_class_len)[prio] == 0) {
+            --prio;
+        }
+        uint8_t iget = MP_STATE_VM(sched_class_idx)[prio];
+        mp_sched_item_t item = MP_STATE_VM(sched_queue)[prio][iget];
+        MP_STATE_VM(sched_class_idx)[prio] = IDX_MASK(iget + 1);
+        --MP_STATE_VM(sched_class_len)[prio];
         --MP_STATE_VM(sched_len);
         MICROPY_END_ATOMIC_SECTION(atomic_state);
         mp_call_function_1_protected(item.func, item.arg);
     } else {
         MICROPY_END_ATOMIC_SECTION(atomic_state);
     }
+    MP_TRACE_EVENT(MP_TRACE_SCHED_END, 0);
 
     // Restore MP_STATE_VM(sched_state) to idle (or pending if there are still
     // tasks in the queue).
@@ -160,20 +170,28 @@ void mp_sched_unlock(void) {
     MICROPY_END_ATOMIC_SECTION(atomic_state);
 }
 
-bool MICROPY_WRAP_MP_SCHED_SCHEDULE(mp_sched_schedule)(mp_obj_t function, mp_obj_t arg) {
+// May be called from an interrupt. Out-of-range priorities are clamped.
+bool MICROPY_WRAP_MP_SCHED_SCHEDULE(mp_sched_schedule_prio)(mp_obj_t function, mp_obj_t arg, size_t prio) {
+    if (prio >= MICROPY_SCHEDULER_PRIORITIES) {
+        prio = MP_SCHED_PRIO_HIGH;
+    }
     mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
     bool ret;
-    if (!mp_sched_full()) {
+    if (!mp_sched_full(prio)) {
         if (MP_STATE_VM(sched_state) == MP_SCHED_IDLE) {
             MP_STATE_VM(sched_state) = MP_SCHED_PENDING;
         }
-        uint8_t iput = IDX_MASK(MP_STATE_VM(sched_idx) + MP_STATE_VM(sched_len)++);
-        MP_STATE_VM(sched_queue)[iput].func = function;
-        MP_STATE_VM(sched_queue)[iput].arg = arg;
+        uint8_t iput = IDX_MASK(MP_STATE_VM(sched_class_idx)[prio] + MP_STATE_VM(sched_class_len)[prio]++);
+        MP_STATE_VM(sched_queue)[prio][iput].func = function;
+        MP_STATE_VM(sched_queue)[prio][iput].arg = arg;
+        if (++MP_STATE_VM(sched_len) > MP_STATE_VM(sched_peak)) {
+            MP_STATE_VM(sched_peak) = MP_STATE_VM(sched_len);
+        }
         MICROPY_SCHED_HOOK_SCHEDULED;
         ret = true;
     } else {
         // schedule queue is full
+        ++MP_STATE_VM(sched_overflow);
         ret = false;
     }
     MICROPY_END_ATOMIC_SECTION(atomic_state);
@@ -207,7 +225,7 @@ bool mp_sched_schedule_node(mp_sched_node_t *node, mp_sched_callback_t callback)
 }
 #endif
 
-MP_REGISTER_ROOT_POINTER(mp_sched_item_t sched_queue[MICROPY_SCHEDULER_DEPTH]);
+MP_REGISTER_ROOT_POINTER(mp_sched_item_t sched_queue[MICROPY_SCHEDULER_PRIORITIES][MICROPY_SCHEDULER_DEPTH]);
 
 #endif // MICROPY_ENABLE_SCHEDULER
 
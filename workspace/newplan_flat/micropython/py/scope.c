@@ -27,6 +27,7 @@
 #include <assert.h>
 
 #include "py/scope.h"
+#include "py/comparena.h"
 
 #if MICROPY_ENABLE_COMPILER
 
@@ -51,7 +52,7 @@ scope_t *scope_new(scope_kind_t kind, mp_parse_node_t pn, mp_uint_t emit_options
     MP_STATIC_ASSERT(MP_QSTR__lt_setcomp_gt_ <= UINT8_MAX);
     MP_STATIC_ASSERT(MP_QSTR__lt_genexpr_gt_ <= UINT8_MAX);
 
-    scope_t *scope = m_new0(scope_t, 1);
+    scope_t *scope = m_arena_new0(scope_t, 1);
     scope->kind = kind;
     scope->pn = pn;
     if (kind == SCOPE_FUNCTION || kind == SCOPE_CLASS) {
@@ -63,14 +64,14 @@ scope_t *scope_new(scope_kind_t kind, mp_parse_node_t pn, mp_uint_t emit_options
     scope->raw_code = mp_emit_glue_new_raw_code();
     scope->emit_options = emit_options;
     scope->id_info_alloc = MICROPY_ALLOC_SCOPE_ID_INIT;
-    scope->id_info = m_new(id_info_t, scope->id_info_alloc);
+    scope->id_info = m_arena_new(id_info_t, scope->id_info_alloc);
 
     return scope;
 }
 
 void scope_free(scope_t *scope) {
-    m_del(id_info_t, scope->id_info, scope->id_info_alloc);
-    m_del(scope_t, scope, 1);
+    m_arena_del(id_info_t, scope->id_info, scope->id_info_alloc);
+    m_arena_del(scope_t, scope, 1);
 }
 
 id_info_t *scope_find_or_add_id(scope_t *scope, qstr qst, id_info_kind_t kind) {
@@ -81,8 +82,9 @@ id_info_t *scope_find_or_add_id(scope_t *scope, qstr qst, id_info_kind_t kind) {
 
     // make sure we have enough memory
     if (scope->id_info_len >= scope->id_info_alloc) {
-        scope->id_info = m_renew(id_info_t, scope->id_info, scope->id_info_alloc, scope->id_info_alloc + MICROPY_ALLOC_SCOPE_ID_INC);
-        scope->id_info_alloc += MICROPY_ALLOC_SCOPE_ID_INC;
+        size_t inc = m_arena_grow(scope->id_info_alloc, MICROPY_ALLOC_SCOPE_ID_INC);
+        scope->id_info = m_arena_renew(id_info_t, scope->id_info, scope->id_info_alloc, scope->id_info_alloc + inc);
+        scope->id_info_alloc += inc;
     }
 
     // add new id to end of array of all ids; this seems to match CPython
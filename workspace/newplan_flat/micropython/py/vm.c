@@ -187,6 +187,26 @@
     } \
 } while(0)
 
+#elif MICROPY_VM_TRACK_CODE_STATE
+
+// Only keep track of the executing frame, for the sampling profiler: a few
+// stores per call, nothing per opcode (code_state->ip is already kept up to
+// date by MARK_EXC_IP_GLOBAL)
+#define FRAME_SETUP() do { \
+    MP_STATE_THREAD(current_code_state) = code_state; \
+} while(0)
+
+#define FRAME_ENTER() do { \
+    code_state->prev_state = MP_STATE_THREAD(current_code_state); \
+} while(0)
+
+#define FRAME_LEAVE() do { \
+    MP_STATE_THREAD(current_code_state) = code_state->prev_state; \
+} while(0)
+
+#define FRAME_UPDATE()
+#define TRACE_TICK(current_ip, current_sp, is_exception)
+
 #else // MICROPY_PY_SYS_SETTRACE
 #define FRAME_SETUP()
 #define FRAME_ENTER()
@@ -195,6 +215,65 @@
 #define TRACE_TICK(current_ip, current_sp, is_exception)
 #endif // MICROPY_PY_SYS_SETTRACE
 
+#if MICROPY_VM_OPCODE_STATS
+
+#define OPSTATS_OUTSIDE (256 + MP_VM_PATH_OUTSIDE)
+
+mp_vm_opcode_stats_t mp_vm_opcode_stats = { .last_op = OPSTATS_OUTSIDE };
+
+void mp_vm_opcode_stats_reset(void) {
+    memset(&mp_vm_opcode_stats, 0, sizeof(mp_vm_opcode_stats));
+    mp_vm_opcode_stats.last_op = OPSTATS_OUTSIDE;
+    mp_vm_opcode_stats.last_cycles = MICROPY_VM_OPCODE_STATS_CYCLES();
+}
+
+// Charge the cycles since the previous dispatch (or VM exit) to what was running then
+static inline void opstats_charge(uint32_t now) {
+    mp_vm_opcode_stats_t *s = &mp_vm_opcode_stats;
+    uint32_t dt = now - s->last_cycles;
+    if (s->last_op < 256) {
+        s->cycles[s->last_op] += dt;
+    } else {
+        s->path_cycles[s->last_op - 256] += dt;
+    }
+    s->last_cycles = now;
+}
+
+static inline void opstats_dispatch(byte op) {
+    opstats_charge(MICROPY_VM_OPCODE_STATS_CYCLES());
+    mp_vm_opcode_stats.count[op]++;
+    mp_vm_opcode_stats.last_op = op;
+}
+
+static inline void opstats_leave(void) {
+    opstats_charge(MICROPY_VM_OPCODE_STATS_CYCLES());
+    mp_vm_opcode_stats.path_count[MP_VM_PATH_OUTSIDE]++;
+    mp_vm_opcode_stats.last_op = OPSTATS_OUTSIDE;
+}
+
+static inline void opstats_path(mp_vm_path_t path, uint32_t t0) {
+    mp_vm_opcode_stats.path_count[path]++;
+    mp_vm_opcode_stats.path_cycles[path] += (uint32_t)(MICROPY_VM_OPCODE_STATS_CYCLES() - t0);
+}
+
+#define OPSTATS_DISPATCH(ip) opstats_dispatch(*(ip))
+#define OPSTATS_LEAVE() opstats_leave()
+#define OPSTATS_PATH_BEGIN() uint32_t opstats_t0 = MICROPY_VM_OPCODE_STATS_CYCLES()
+#define OPSTATS_PATH_END(path) opstats_path((path), opstats_t0)
+#define OPSTATS_CALL_BEGIN(fun) \
+    mp_vm_path_t opstats_call = mp_obj_is_type((fun), &mp_type_fun_bc) ? MP_VM_PATH_CALL_BC : MP_VM_PATH_CALL_OTHER; \
+    OPSTATS_PATH_BEGIN()
+#define OPSTATS_CALL_END() OPSTATS_PATH_END(opstats_call)
+
+#else
+#define OPSTATS_DISPATCH(ip)
+#define OPSTATS_LEAVE()
+#define OPSTATS_PATH_BEGIN()
+#define OPSTATS_PATH_END(path)
+#define OPSTATS_CALL_BEGIN(fun)
+#define OPSTATS_CALL_END()
+#endif // MICROPY_VM_OPCODE_STATS
+
 #if MICROPY_PY_BUILTINS_SLICE
 // This function is marked "no inline" so it doesn't increase the C stack usage of the main VM function.
 MP_NOINLINE static mp_obj_t *build_slice_stack_allocated(byte op, mp_obj_t *sp, mp_obj_t step) {
@@ -248,6 +327,7 @@ mp_vm_return_kind_t MICROPY_WRAP_MP_EXECUTE_BYTECODE(mp_execute_bytecode)(mp_cod
         TRACE(ip); \
         MARK_EXC_IP_GLOBAL(); \
         TRACE_TICK(ip, sp, false); \
+        OPSTATS_DISPATCH(ip); \
         goto *entry_table[*ip++]; \
     } while (0)
     #define DISPATCH_WITH_PEND_EXC_CHECK() goto pending_exception_check
@@ -329,6 +409,7 @@ dispatch_loop:
                 TRACE(ip);
                 MARK_EXC_IP_GLOBAL();
                 TRACE_TICK(ip, sp, false);
+                OPSTATS_DISPATCH(ip);
                 switch (*ip++) {
                 #endif
 
@@ -397,14 +478,18 @@ dispatch_loop:
                 ENTRY(MP_BC_LOAD_NAME): {
                     MARK_EXC_IP_SELECTIVE();
                     DECODE_QSTR;
+                    OPSTATS_PATH_BEGIN();
                     PUSH(mp_load_name(qst));
+                    OPSTATS_PATH_END(MP_VM_PATH_LOAD_NAME);
                     DISPATCH();
                 }
 
                 ENTRY(MP_BC_LOAD_GLOBAL): {
                     MARK_EXC_IP_SELECTIVE();
                     DECODE_QSTR;
+                    OPSTATS_PATH_BEGIN();
                     PUSH(mp_load_global(qst));
+                    OPSTATS_PATH_END(MP_VM_PATH_LOAD_GLOBAL);
                     DISPATCH();
                 }
 
@@ -414,6 +499,7 @@ dispatch_loop:
                     DECODE_QSTR;
                     mp_obj_t top = TOP();
                     mp_obj_t obj;
+                    OPSTATS_PATH_BEGIN();
                     #if MICROPY_OPT_LOAD_ATTR_FAST_PATH
                     // For the specific case of an instance type, it implements .attr
                     // and forwards to its members map. Attribute lookups on instance
@@ -426,10 +512,12 @@ dispatch_loop:
                     }
                     if (elem) {
                         obj = elem->value;
+                        OPSTATS_PATH_END(MP_VM_PATH_LOAD_ATTR_FAST);
                     } else
                     #endif
                     {
                         obj = mp_load_attr(top, qst);
+                        OPSTATS_PATH_END(MP_VM_PATH_LOAD_ATTR_SLOW);
                     }
                     SET_TOP(obj);
                     DISPATCH();
@@ -438,7 +526,9 @@ dispatch_loop:
                 ENTRY(MP_BC_LOAD_METHOD): {
                     MARK_EXC_IP_SELECTIVE();
                     DECODE_QSTR;
+                    OPSTATS_PATH_BEGIN();
                     mp_load_method(*sp, qst, sp);
+                    OPSTATS_PATH_END(MP_VM_PATH_LOAD_METHOD);
                     sp += 1;
                     DISPATCH();
                 }
@@ -981,7 +1071,9 @@ unwind_jump:;
                         }
                     }
                     #endif
+                    OPSTATS_CALL_BEGIN(*sp);
                     SET_TOP(mp_call_function_n_kw(*sp, unum & 0xff, (unum >> 8) & 0xff, sp + 1));
+                    OPSTATS_CALL_END();
                     DISPATCH();
                 }
 
@@ -1027,7 +1119,9 @@ unwind_jump:;
                         }
                     }
                     #endif
+                    OPSTATS_CALL_BEGIN(*sp);
                     SET_TOP(mp_call_method_n_kw_var(false, unum, sp));
+                    OPSTATS_CALL_END();
                     DISPATCH();
                 }
 
@@ -1066,7 +1160,9 @@ unwind_jump:;
                         }
                     }
                     #endif
+                    OPSTATS_CALL_BEGIN(*sp);
                     SET_TOP(mp_call_method_n_kw(unum & 0xff, (unum >> 8) & 0xff, sp));
+                    OPSTATS_CALL_END();
                     DISPATCH();
                 }
 
@@ -1112,7 +1208,9 @@ unwind_jump:;
                         }
                     }
                     #endif
+                    OPSTATS_CALL_BEGIN(*sp);
                     SET_TOP(mp_call_method_n_kw_var(true, unum, sp));
+                    OPSTATS_CALL_END();
                     DISPATCH();
                 }
 
@@ -1172,6 +1270,7 @@ unwind_return:
                     }
                     #endif
                     FRAME_LEAVE();
+                    OPSTATS_LEAVE();
                     return MP_VM_RETURN_NORMAL;
 
                 ENTRY(MP_BC_RAISE_LAST): {
@@ -1213,6 +1312,7 @@ yield:
                     code_state->sp = sp;
                     code_state->exc_sp_idx = MP_CODE_STATE_EXC_SP_IDX_FROM_PTR(exc_stack, exc_sp);
                     FRAME_LEAVE();
+                    OPSTATS_LEAVE();
                     return MP_VM_RETURN_YIELD;
 
                 ENTRY(MP_BC_YIELD_FROM): {
@@ -1331,6 +1431,7 @@ yield:
                     nlr_pop();
                     code_state->state[0] = obj;
                     FRAME_LEAVE();
+                    OPSTATS_LEAVE();
                     return MP_VM_RETURN_EXCEPTION;
                 }
 
@@ -1509,6 +1610,7 @@ unwind_loop:
                 // Note: ip and sp don't have usable values at this point
                 code_state->state[0] = MP_OBJ_FROM_PTR(nlr.ret_val); // put exception here because sp is invalid
                 FRAME_LEAVE();
+                OPSTATS_LEAVE();
                 return MP_VM_RETURN_EXCEPTION;
             }
         }
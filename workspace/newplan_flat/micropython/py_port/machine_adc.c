@@ -35,6 +35,14 @@
 static bool g_adc0_open = false;
 static bool g_adc1_open = false;
 
+// Units currently owned by an ADCBlock timed capture (single-shot reads not allowed)
+static bool g_adc_unit_acquired[2] = {false, false};
+
+// Scan configuration currently programmed into each unit.
+// scanCfg is only called again when a channel outside the cached mask is requested.
+static adc_channel_cfg_t g_adc_channel_cfg[2];
+static uint32_t g_adc_scan_mask[2] = {0, 0};   // 0 = unit not configured since open
+
 // Pin to ADC channel mapping structure
 typedef struct {
     bsp_io_port_pin_t pin;
@@ -114,6 +122,10 @@ static fsp_err_t adc_unit_open(uint8_t unit) {
     const adc_instance_t *instance = (unit == 0) ? &g_adc0 : &g_adc1;
     bool *is_open = (unit == 0) ? &g_adc0_open : &g_adc1_open;
     
+    if (g_adc_unit_acquired[unit]) {
+        return FSP_ERR_IN_USE;  // Owned by ADCBlock
+    }
+
     if (*is_open) {
         return FSP_SUCCESS;  // Already open
     }
@@ -121,11 +133,54 @@ static fsp_err_t adc_unit_open(uint8_t unit) {
     fsp_err_t err = instance->p_api->open(instance->p_ctrl, instance->p_cfg);
     if (err == FSP_SUCCESS) {
         *is_open = true;
+        g_adc_scan_mask[unit] = 0;
     }
     
     return err;
 }
 
+// Look up the ADC unit/channel of a pin and switch it to analog mode
+bool ra_adc_pin_setup(mp_obj_t pin_in, uint8_t *unit, uint8_t *channel) {
+    bsp_io_port_pin_t pin_id = get_pin_id_from_obj(pin_in);
+    const pin_adc_map_t *map = find_adc_channel(pin_id);
+    if (map == NULL) {
+        return false;
+    }
+
+    // Manual pin configuration for P014/P015
+    if (map->needs_manual_cfg) {
+        uint8_t port = (pin_id >> 8) & 0xFF;
+        uint8_t pin = pin_id & 0xFF;
+        RA_SETUP_ANALOG_PIN(port, pin);
+    }
+
+    *unit = map->unit;
+    *channel = map->channel;
+    return true;
+}
+
+// Take a unit away from single-shot reads (ADCBlock reopens it with its own trigger config)
+bool ra_adc_unit_acquire(uint8_t unit) {
+    const adc_instance_t *instance = (unit == 0) ? &g_adc0 : &g_adc1;
+    bool *is_open = (unit == 0) ? &g_adc0_open : &g_adc1_open;
+
+    if (g_adc_unit_acquired[unit]) {
+        return false;
+    }
+    if (*is_open) {
+        instance->p_api->close(instance->p_ctrl);
+        *is_open = false;
+    }
+    g_adc_scan_mask[unit] = 0;
+    g_adc_unit_acquired[unit] = true;
+    return true;
+}
+
+// Give the unit back; the next read_u16 reopens it with the default configuration
+void ra_adc_unit_release(uint8_t unit) {
+    g_adc_unit_acquired[unit] = false;
+}
+
 // ========== ADC Object Implementation ==========
 
 static void adc_obj_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
@@ -144,35 +199,25 @@ static mp_obj_t adc_obj_make_new(const mp_obj_type_t *type, size_t n_args, size_
     mp_arg_val_t vals[MP_ARRAY_SIZE(allowed_args)];
     mp_arg_parse_all_kw_array(n_args, n_kw, args, MP_ARRAY_SIZE(allowed_args), allowed_args, vals);
     
-    // Get pin ID
-    bsp_io_port_pin_t pin_id = get_pin_id_from_obj(vals[ARG_id].u_obj);
-    
-    // Find ADC channel mapping
-    const pin_adc_map_t *map = find_adc_channel(pin_id);
-    if (map == NULL) {
+    // Find ADC channel mapping (also configures P014/P015 as analog)
+    uint8_t unit, channel;
+    if (!ra_adc_pin_setup(vals[ARG_id].u_obj, &unit, &channel)) {
         mp_raise_msg_varg(&mp_type_ValueError,
                          MP_ERROR_TEXT("Pin 0x%04X is not a valid ADC pin"),
-                         (unsigned int)pin_id);
+                         (unsigned int)get_pin_id_from_obj(vals[ARG_id].u_obj));
     }
     
     // Create ADC object
     ra_adc_obj_t *self = m_new_obj(ra_adc_obj_t);
     self->base.type = type;
-    self->unit = map->unit;
-    self->channel = map->channel;
+    self->unit = unit;
+    self->channel = channel;
     self->is_open = false;
-    self->adc_instance = (map->unit == 0) ? &g_adc0 : &g_adc1;
+    self->adc_instance = (unit == 0) ? &g_adc0 : &g_adc1;
     
-    // Manual pin configuration for P014/P015
-    if (map->needs_manual_cfg) {
-        uint8_t port = (pin_id >> 8) & 0xFF;
-        uint8_t pin = pin_id & 0xFF;
-        RA_SETUP_ANALOG_PIN(port, pin);
-    }
-    
-    // Lazy initialization of ADC unit
+    // Lazy initialization of ADC unit (skipped while an ADCBlock capture owns it)
     fsp_err_t err = adc_unit_open(self->unit);
-    if (err != FSP_SUCCESS) {
+    if (err != FSP_SUCCESS && err != FSP_ERR_IN_USE) {
         mp_raise_msg_varg(&mp_type_RuntimeError,
                          MP_ERROR_TEXT("Failed to open ADC unit %u: %d"),
                          self->unit, err);
@@ -181,96 +226,155 @@ static mp_obj_t adc_obj_make_new(const mp_obj_type_t *type, size_t n_args, size_
     return MP_OBJ_FROM_PTR(self);
 }
 
-// read_u16() - Read ADC value and scale to 16-bit
-static mp_obj_t adc_obj_read_u16(mp_obj_t self_in) {
-    ra_adc_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    
-    // Ensure ADC unit is open
-    fsp_err_t err = adc_unit_open(self->unit);
+// Open the unit and make sure every channel in mask is part of its scan group.
+// The first call programs the generated default mask plus the requested channels;
+// later calls only reconfigure when a channel joins.
+static const adc_instance_t *adc_unit_prepare(uint8_t unit, uint32_t mask) {
+    const adc_instance_t *instance = (unit == 0) ? &g_adc0 : &g_adc1;
+
+    fsp_err_t err = adc_unit_open(unit);
+    if (err == FSP_ERR_IN_USE) {
+        mp_raise_msg_varg(&mp_type_OSError,
+                         MP_ERROR_TEXT("ADC unit %u is busy with ADCBlock"), unit);
+    }
     if (err != FSP_SUCCESS) {
         mp_raise_msg_varg(&mp_type_RuntimeError,
                          MP_ERROR_TEXT("Failed to open ADC unit %u: %d"),
-                         self->unit, err);
-    }
-    
-    // Create a copy of channel config to modify scan_mask
-    // scan_mask is in adc_channel_cfg_t, not adc_cfg_t
-    // p_channel_cfg is void const *, need to cast to adc_channel_cfg_t const *
-    adc_channel_cfg_t const *p_channel_cfg = (adc_channel_cfg_t const *)self->adc_instance->p_channel_cfg;
-    adc_channel_cfg_t channel_cfg_shadow = *p_channel_cfg;
-    
-    // Add the channel to scan_mask if not already present
-    // For P014 (Unit 0, Channel 7) or P015 (Unit 1, Channel 5), these are not in the default scan_mask
-    // For other channels, they should already be in scan_mask, but we ensure it anyway
-    uint32_t channel_bit;
-    switch (self->channel) {
-        case 0: channel_bit = ADC_MASK_CHANNEL_0; break;
-        case 1: channel_bit = ADC_MASK_CHANNEL_1; break;
-        case 2: channel_bit = ADC_MASK_CHANNEL_2; break;
-        case 3: channel_bit = ADC_MASK_CHANNEL_3; break;
-        case 4: channel_bit = ADC_MASK_CHANNEL_4; break;
-        case 5: channel_bit = ADC_MASK_CHANNEL_5; break;
-        case 6: channel_bit = ADC_MASK_CHANNEL_6; break;
-        case 7: channel_bit = ADC_MASK_CHANNEL_7; break;
-        default: channel_bit = (1UL << self->channel); break;  // Fallback for channels > 7
+                         unit, err);
     }
-    channel_cfg_shadow.scan_mask |= channel_bit;
-    
-    // Configure scan (this may need to be done each time if channel changes)
-    // scanCfg expects adc_channel_cfg_t pointer as p_extend parameter
-    err = self->adc_instance->p_api->scanCfg(self->adc_instance->p_ctrl, &channel_cfg_shadow);
-    if (err != FSP_SUCCESS) {
-        mp_raise_msg_varg(&mp_type_RuntimeError,
-                         MP_ERROR_TEXT("Failed to configure ADC scan: %d"), err);
+
+    if ((g_adc_scan_mask[unit] & mask) != mask || g_adc_scan_mask[unit] == 0) {
+        // scan_mask is in adc_channel_cfg_t, not adc_cfg_t
+        // For P014 (Unit 0, Channel 7) or P015 (Unit 1, Channel 5), these are not in the default scan_mask
+        if (g_adc_scan_mask[unit] == 0) {
+            g_adc_channel_cfg[unit] = *(adc_channel_cfg_t const *)instance->p_channel_cfg;
+        }
+        g_adc_channel_cfg[unit].scan_mask |= mask;
+
+        err = instance->p_api->scanCfg(instance->p_ctrl, &g_adc_channel_cfg[unit]);
+        if (err != FSP_SUCCESS) {
+            g_adc_scan_mask[unit] = 0;
+            mp_raise_msg_varg(&mp_type_RuntimeError,
+                             MP_ERROR_TEXT("Failed to configure ADC scan: %d"), err);
+        }
+        g_adc_scan_mask[unit] = g_adc_channel_cfg[unit].scan_mask;
     }
-    
-    // Start scan
-    err = self->adc_instance->p_api->scanStart(self->adc_instance->p_ctrl);
+
+    return instance;
+}
+
+// Run one software-triggered scan of the configured group and wait for it
+static void adc_unit_scan(const adc_instance_t *instance) {
+    fsp_err_t err = instance->p_api->scanStart(instance->p_ctrl);
     if (err != FSP_SUCCESS) {
         mp_raise_msg_varg(&mp_type_RuntimeError,
                          MP_ERROR_TEXT("Failed to start ADC scan: %d"), err);
     }
-    
-    // Wait for scan completion (blocking)
+
+    // Wait for scan completion (blocking). A scan takes a few us, so poll the
+    // status first and only look at the clock / pending events if it runs long.
     adc_status_t status;
-    uint32_t timeout = 200;  // 1 second timeout
-    uint32_t start_time = mp_hal_ticks_ms();
-    
-    do {
-        err = self->adc_instance->p_api->scanStatusGet(self->adc_instance->p_ctrl, &status);
+    uint32_t spins = 0;
+    uint32_t timeout = 200;
+    uint32_t start_time = 0;
+
+    for (;;) {
+        err = instance->p_api->scanStatusGet(instance->p_ctrl, &status);
         if (err != FSP_SUCCESS) {
             mp_raise_msg_varg(&mp_type_RuntimeError,
                              MP_ERROR_TEXT("Failed to get ADC status: %d"), err);
         }
-        
-        if ((mp_hal_ticks_ms() - start_time) > timeout) {
+        if (status.state == ADC_STATE_IDLE) {
+            break;
+        }
+
+        if (++spins < 1000) {
+            continue;
+        }
+        if (spins == 1000) {
+            start_time = mp_hal_ticks_ms();
+        } else if ((mp_hal_ticks_ms() - start_time) > timeout) {
             mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("ADC scan timeout"));
         }
-        
+
         MICROPY_EVENT_POLL_HOOK
-    } while (status.state != ADC_STATE_IDLE);
-    
-    // Read result
+    }
+}
+
+// Read a channel result of the last scan, scaled from 12-bit to 16-bit
+static uint16_t adc_read_scaled(const adc_instance_t *instance, uint8_t channel) {
     // read() function uses adc_channel_t type, not uint8_t
     uint16_t adc_value;
-    adc_channel_t adc_channel = (adc_channel_t)self->channel;
-    err = self->adc_instance->p_api->read(self->adc_instance->p_ctrl, adc_channel, &adc_value);
+    fsp_err_t err = instance->p_api->read(instance->p_ctrl, (adc_channel_t)channel, &adc_value);
     if (err != FSP_SUCCESS) {
         mp_raise_msg_varg(&mp_type_RuntimeError,
                          MP_ERROR_TEXT("Failed to read ADC channel %u: %d"),
-                         self->channel, err);
+                         channel, err);
     }
-    
+
     // Scale from 12-bit (0-4095) to 16-bit (0-65535)
-    uint16_t scaled_value = (uint16_t)(((uint32_t)adc_value * 65535) / 4095);
-    
-    return mp_obj_new_int_from_uint(scaled_value);
+    return (uint16_t)(((uint32_t)adc_value * 65535) / 4095);
+}
+
+// read_u16() - Read ADC value and scale to 16-bit
+static mp_obj_t adc_obj_read_u16(mp_obj_t self_in) {
+    ra_adc_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    const adc_instance_t *instance = adc_unit_prepare(self->unit, 1UL << self->channel);
+    adc_unit_scan(instance);
+
+    return MP_OBJ_NEW_SMALL_INT(adc_read_scaled(instance, self->channel));
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(adc_obj_read_u16_obj, adc_obj_read_u16);
 
+// ADC.read_multi(channels, buf) - sample several ADC objects with one scan per unit.
+// buf receives one uint16 (read_u16 scale, little endian) per entry of channels.
+static mp_obj_t adc_read_multi(mp_obj_t channels_in, mp_obj_t buf_in) {
+    size_t n;
+    mp_obj_t *items;
+    mp_obj_get_array(channels_in, &n, &items);
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+    if (bufinfo.len < n * sizeof(uint16_t)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+    }
+
+    uint32_t unit_mask[2] = {0, 0};
+    for (size_t i = 0; i < n; i++) {
+        if (!mp_obj_is_type(items[i], &ra_adc_type)) {
+            mp_raise_TypeError(MP_ERROR_TEXT("channels must be ADC objects"));
+        }
+        ra_adc_obj_t *adc = MP_OBJ_TO_PTR(items[i]);
+        unit_mask[adc->unit] |= 1UL << adc->channel;
+    }
+
+    uint8_t *dest = bufinfo.buf;
+    for (uint8_t unit = 0; unit < 2; unit++) {
+        if (unit_mask[unit] == 0) {
+            continue;
+        }
+        const adc_instance_t *instance = adc_unit_prepare(unit, unit_mask[unit]);
+        adc_unit_scan(instance);
+        for (size_t i = 0; i < n; i++) {
+            ra_adc_obj_t *adc = MP_OBJ_TO_PTR(items[i]);
+            if (adc->unit == unit) {
+                uint16_t value = adc_read_scaled(instance, adc->channel);
+                dest[2 * i] = (uint8_t)value;
+                dest[2 * i + 1] = (uint8_t)(value >> 8);
+            }
+        }
+    }
+
+    return MP_OBJ_NEW_SMALL_INT(n);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(adc_read_multi_fun_obj, adc_read_multi);
+static MP_DEFINE_CONST_STATICMETHOD_OBJ(adc_read_multi_obj, MP_ROM_PTR(&adc_read_multi_fun_obj));
+
 // ADC class methods dictionary
 static const mp_rom_map_elem_t adc_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_read_u16), MP_ROM_PTR(&adc_obj_read_u16_obj) },
+    { MP_ROM_QSTR(MP_QSTR_read_multi), MP_ROM_PTR(&adc_read_multi_obj) },
 };
 static MP_DEFINE_CONST_DICT(adc_locals_dict, adc_locals_dict_table);
 
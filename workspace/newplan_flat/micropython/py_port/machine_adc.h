@@ -16,5 +16,12 @@ typedef struct _ra_adc_obj_t {
 // Forward declaration of ADC type
 extern const mp_obj_type_t ra_adc_type;
 
+// Look up unit/channel of an analog pin and put it in analog mode (false if not an ADC pin)
+bool ra_adc_pin_setup(mp_obj_t pin_in, uint8_t *unit, uint8_t *channel);
+
+// Exclusive use of an ADC unit by ADCBlock; ADC.read_u16 raises while acquired
+bool ra_adc_unit_acquire(uint8_t unit);
+void ra_adc_unit_release(uint8_t unit);
+
 #endif // MICROPY_INCLUDED_RA8D1_MACHINE_ADC_H
 
@@ -0,0 +1,388 @@
+/*
+ * machine_adc_block.c - Timed multi-channel ADC capture for RA8D1
+ *
+ * GPT overflow --ELC--> ADC group scan --scan end--> DTC block transfer
+ *
+ * A GPT channel paces the conversions, every trigger scans all connected
+ * channels once and the scan-end event makes the DTC copy the result
+ * registers into the user buffer. The CPU only sees one interrupt per
+ * buffer (or per half buffer in continuous mode), so the sample rate is
+ * limited by the converter, not by the VM.
+ *
+ * Frame layout: one uint16 per channel from the lowest to the highest
+ * connected channel (channels in between are converted too), raw 12-bit
+ * right-aligned values.
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/mphal.h"
+#include "hal_data.h"
+#include "bsp_api.h"
+#include "machine_adc.h"
+#include "machine_adc_block.h"
+#include "ra_irq.h"
+#include "ra_dtc.h"
+#include "ra_gpt.h"
+
+// Define STATIC macro
+#ifndef STATIC
+#define STATIC static
+#endif
+
+#define ADC_BLOCK_NUM_UNITS       (2)
+#define ADC_BLOCK_MAX_CHANNEL     (28)      // ADDR[0..28]
+#define ADC_BLOCK_IRQ_PRIORITY    (8)
+
+typedef struct _ra_adc_block_obj_t {
+    mp_obj_base_t base;
+    uint8_t unit;
+    uint8_t gpt_ch;
+    uint32_t channel_mask;                  // connected channels
+
+    // Running capture
+    volatile bool running;
+    volatile bool done;
+    bool continuous;
+    uint8_t ch_first;
+    uint8_t span;                           // channels per frame
+    IRQn_Type irq;
+    uint16_t *buf;
+    uint32_t frames;                        // frames per DTC run (half buffer in continuous mode)
+    volatile uint8_t half;                  // half being filled (continuous mode)
+    mp_obj_t buf_obj;
+    mp_obj_t callback;
+    volatile uint32_t overruns;
+
+    // ADC configuration used while capturing (hardware trigger)
+    adc_cfg_t cfg;
+    adc_extended_cfg_t cfg_extend;
+    adc_channel_cfg_t channel_cfg;
+    transfer_info_t dtc_info __attribute__((aligned(BSP_FEATURE_DTC_TRANSFER_INFO_ALIGNMENT)));
+} ra_adc_block_obj_t;
+
+MP_REGISTER_ROOT_POINTER(void *machine_adc_block_active[2]);
+
+static const adc_instance_t *adc_block_instance(uint8_t unit) {
+    return (unit == 0) ? &g_adc0 : &g_adc1;
+}
+
+static R_ADC0_Type *adc_block_regs(uint8_t unit) {
+    return (unit == 0) ? R_ADC0 : R_ADC1;
+}
+
+// ========== Interrupt Side ==========
+
+// Reached once per DTC run: the last scan-end of the run is passed on to the CPU
+static void adc_block_scan_end_isr(void) {
+    IRQn_Type irq = R_FSP_CurrentIrqGet();
+    R_BSP_IrqStatusClear(irq);
+
+    ra_adc_block_obj_t *self = ra_irq_context_get(irq);
+    if (self == NULL || !self->running) {
+        return;
+    }
+
+    if (!self->continuous) {
+        ra_gpt_stop(self->gpt_ch);
+        self->done = true;
+        return;
+    }
+
+    // Re-arm the DTC for the other half before the next trigger arrives
+    uint8_t completed = self->half;
+    self->half ^= 1;
+    self->dtc_info.p_dest = self->buf + (size_t)self->half * self->frames * self->span;
+    self->dtc_info.num_blocks = (uint16_t)self->frames;
+    ra_dtc_enable(irq);
+
+    if (self->callback != mp_const_none) {
+        if (!mp_sched_schedule_prio(self->callback, MP_OBJ_NEW_SMALL_INT(completed), MP_SCHED_PRIO_HIGH)) {
+            self->overruns++;
+        }
+    }
+}
+
+// ========== Capture Control ==========
+
+static void adc_block_stop(ra_adc_block_obj_t *self) {
+    if (!self->running) {
+        return;
+    }
+
+    const adc_instance_t *instance = adc_block_instance(self->unit);
+
+    ra_gpt_stop(self->gpt_ch);
+    R_ELC->ELSR[ELC_PERIPHERAL_ADC0 + 2 * self->unit].HA = 0;
+    instance->p_api->scanStop(instance->p_ctrl);
+    ra_dtc_disable(self->irq);
+    ra_irq_free(self->irq);
+    instance->p_api->close(instance->p_ctrl);
+    ra_adc_unit_release(self->unit);
+
+    self->running = false;
+    self->buf_obj = MP_OBJ_NULL;
+    self->callback = mp_const_none;
+    MP_STATE_PORT(machine_adc_block_active)[self->unit] = NULL;
+}
+
+void machine_adc_block_deinit_all(void) {
+    for (size_t i = 0; i < ADC_BLOCK_NUM_UNITS; i++) {
+        ra_adc_block_obj_t *self = MP_STATE_PORT(machine_adc_block_active)[i];
+        if (self != NULL) {
+            adc_block_stop(self);
+        }
+    }
+}
+
+static void adc_block_start(ra_adc_block_obj_t *self, mp_obj_t buf_in, mp_int_t freq, bool continuous) {
+    if (self->running) {
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("ADCBlock already running"));
+    }
+    if (self->channel_mask == 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("no channels connected"));
+    }
+
+    uint8_t ch_first = (uint8_t)__CLZ(__RBIT(self->channel_mask));
+    uint8_t ch_last = (uint8_t)(31 - __CLZ(self->channel_mask));
+    uint8_t span = (uint8_t)(ch_last - ch_first + 1);
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+    uint32_t frames = bufinfo.len / (sizeof(uint16_t) * span);
+    if (((uintptr_t)bufinfo.buf & 1) || frames == 0 || (continuous && (frames & 1))) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer must hold a whole (even in continuous mode) number of frames"));
+    }
+    ra_dtc_check_buffer(bufinfo.buf, bufinfo.len);
+    if (continuous) {
+        frames /= 2;
+    }
+    if (frames > 0xFFFF) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too large"));
+    }
+
+    if (ra_gpt_periodic_init(self->gpt_ch, (uint32_t)freq) == 0) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("freq %d out of range"), (int)freq);
+    }
+
+    if (!ra_adc_unit_acquire(self->unit)) {
+        mp_raise_msg_varg(&mp_type_OSError, MP_ERROR_TEXT("ADC unit %u is busy"), self->unit);
+    }
+
+    // Interrupt slot for the scan-end event (DTC activation + end-of-run CPU interrupt)
+    elc_event_t scan_end = (elc_event_t)(ELC_EVENT_ADC0_SCAN_END +
+        self->unit * (ELC_EVENT_ADC1_SCAN_END - ELC_EVENT_ADC0_SCAN_END));
+    IRQn_Type irq = ra_irq_alloc(scan_end, adc_block_scan_end_isr, ADC_BLOCK_IRQ_PRIORITY, self);
+    if (irq == RA_IRQ_INVALID) {
+        ra_adc_unit_release(self->unit);
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("no free interrupt slot"));
+    }
+
+    // Reopen the unit triggered by ELC instead of software
+    const adc_instance_t *instance = adc_block_instance(self->unit);
+    self->cfg = *instance->p_cfg;
+    self->cfg_extend = *(const adc_extended_cfg_t *)instance->p_cfg->p_extend;
+    self->channel_cfg = *(const adc_channel_cfg_t *)instance->p_channel_cfg;
+    self->cfg_extend.trigger = ADC_START_SOURCE_ELC_AD0;
+    self->cfg.mode = ADC_MODE_SINGLE_SCAN;
+    self->cfg.p_callback = NULL;
+    self->cfg.scan_end_irq = FSP_INVALID_VECTOR;
+    self->cfg.p_extend = &self->cfg_extend;
+    self->channel_cfg.scan_mask = ((1UL << span) - 1) << ch_first;
+    self->channel_cfg.scan_mask_group_b = 0;
+
+    fsp_err_t err = instance->p_api->open(instance->p_ctrl, &self->cfg);
+    if (err == FSP_SUCCESS) {
+        err = instance->p_api->scanCfg(instance->p_ctrl, &self->channel_cfg);
+        if (err != FSP_SUCCESS) {
+            instance->p_api->close(instance->p_ctrl);
+        }
+    }
+    if (err != FSP_SUCCESS) {
+        ra_irq_free(irq);
+        ra_adc_unit_release(self->unit);
+        mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("Failed to configure ADC unit %u: %d"), self->unit, err);
+    }
+
+    self->ch_first = ch_first;
+    self->span = span;
+    self->irq = irq;
+    self->buf = bufinfo.buf;
+    self->frames = frames;
+    self->half = 0;
+    self->continuous = continuous;
+    self->buf_obj = buf_in;
+    self->overruns = 0;
+    self->done = false;
+    self->running = true;
+    MP_STATE_PORT(machine_adc_block_active)[self->unit] = self;
+
+    // DTC: one block (= one frame) per scan end, source area restored after each block
+    ra_dtc_info_block16(&self->dtc_info, &adc_block_regs(self->unit)->ADDR[ch_first], self->buf,
+                        span, (uint16_t)frames);
+    ra_dtc_set_info(irq, &self->dtc_info);
+    ra_dtc_enable(irq);
+
+    // ELC: GPT overflow starts a group A scan
+    R_BSP_MODULE_START(FSP_IP_ELC, 0);
+    R_ELC->ELSR[ELC_PERIPHERAL_ADC0 + 2 * self->unit].HA = (uint16_t)ra_gpt_overflow_event(self->gpt_ch);
+    R_ELC->ELCR_b.ELCON = 1;
+
+    // Scan-end event must be raised for the DTC (not set by the FSP driver)
+    ((adc_instance_ctrl_t *)instance->p_ctrl)->scan_start_adcsr |= R_ADC0_ADCSR_ADIE_Msk;
+    instance->p_api->scanStart(instance->p_ctrl);
+
+    ra_gpt_start(self->gpt_ch);
+}
+
+// ========== ADCBlock Object Implementation ==========
+
+static void adc_block_obj_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
+    ra_adc_block_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_printf(print, "ADCBlock(%u, channels=0x%08x, gpt=%u)",
+              self->unit, (unsigned int)self->channel_mask, self->gpt_ch);
+}
+
+// Constructor: ADCBlock(id)
+static mp_obj_t adc_block_obj_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 1, 1, false);
+
+    mp_int_t unit = mp_obj_get_int(args[0]);
+    if (unit < 0 || unit >= ADC_BLOCK_NUM_UNITS) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("ADCBlock(%d) doesn't exist"), (int)unit);
+    }
+
+    // A running capture keeps its object, hand that one back
+    ra_adc_block_obj_t *active = MP_STATE_PORT(machine_adc_block_active)[unit];
+    if (active != NULL) {
+        return MP_OBJ_FROM_PTR(active);
+    }
+
+    ra_adc_block_obj_t *self = ra_dtc_alloc(sizeof(ra_adc_block_obj_t));
+    memset(self, 0, sizeof(*self));
+    self->base.type = type;
+    self->unit = (uint8_t)unit;
+    self->gpt_ch = MICROPY_HW_ADC_BLOCK_GPT_CH(unit);
+    self->irq = RA_IRQ_INVALID;
+    self->callback = mp_const_none;
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+// connect(pin) - add the pin's channel to the block, returns a machine.ADC for it
+static mp_obj_t adc_block_obj_connect(mp_obj_t self_in, mp_obj_t pin_in) {
+    ra_adc_block_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    uint8_t unit, channel;
+    if (!ra_adc_pin_setup(pin_in, &unit, &channel) || unit != self->unit || channel > ADC_BLOCK_MAX_CHANNEL) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("pin is not on ADC unit %u"), self->unit);
+    }
+    if (self->running) {
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("ADCBlock already running"));
+    }
+    self->channel_mask |= 1UL << channel;
+
+    return MP_OBJ_TYPE_GET_SLOT(&ra_adc_type, make_new)(&ra_adc_type, 1, 0, &pin_in);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(adc_block_obj_connect_obj, adc_block_obj_connect);
+
+// channels() - channel numbers in frame order
+static mp_obj_t adc_block_obj_channels(mp_obj_t self_in) {
+    ra_adc_block_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->channel_mask == 0) {
+        return mp_const_empty_tuple;
+    }
+    uint8_t ch_first = (uint8_t)__CLZ(__RBIT(self->channel_mask));
+    uint8_t ch_last = (uint8_t)(31 - __CLZ(self->channel_mask));
+    mp_obj_tuple_t *t = MP_OBJ_TO_PTR(mp_obj_new_tuple(ch_last - ch_first + 1, NULL));
+    for (size_t i = 0; i < t->len; i++) {
+        t->items[i] = MP_OBJ_NEW_SMALL_INT(ch_first + i);
+    }
+    return MP_OBJ_FROM_PTR(t);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(adc_block_obj_channels_obj, adc_block_obj_channels);
+
+// read_timed(buf, freq) - fill buf with frames sampled at freq Hz, returns the frame count
+static mp_obj_t adc_block_obj_read_timed(mp_obj_t self_in, mp_obj_t buf_in, mp_obj_t freq_in) {
+    ra_adc_block_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_int_t freq = mp_obj_get_int(freq_in);
+
+    adc_block_start(self, buf_in, freq, false);
+    uint32_t frames = self->frames;
+
+    // Conversions run without the CPU; sleep until the DTC run ends
+    uint32_t timeout = (uint32_t)((uint64_t)frames * 1000 / (uint32_t)freq) + 100;
+    uint32_t start_time = mp_hal_ticks_ms();
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        while (!self->done) {
+            if ((mp_hal_ticks_ms() - start_time) > timeout) {
+                mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("ADCBlock timeout"));
+            }
+            MICROPY_EVENT_POLL_HOOK
+            __WFI();
+        }
+        nlr_pop();
+    } else {
+        adc_block_stop(self);
+        nlr_jump(nlr.ret_val);
+    }
+
+    adc_block_stop(self);
+
+    return mp_obj_new_int_from_uint(frames);
+}
+static MP_DEFINE_CONST_FUN_OBJ_3(adc_block_obj_read_timed_obj, adc_block_obj_read_timed);
+
+// start(buf, freq, callback) - continuous double-buffered capture;
+// callback(half) is scheduled each time half 0 or 1 of buf has been filled
+static mp_obj_t adc_block_obj_start(size_t n_args, const mp_obj_t *args) {
+    ra_adc_block_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_obj_t callback = args[3];
+    if (callback != mp_const_none && !mp_obj_is_callable(callback)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("callback must be callable"));
+    }
+
+    self->callback = callback;
+    adc_block_start(self, args[1], mp_obj_get_int(args[2]), true);
+
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(adc_block_obj_start_obj, 4, 4, adc_block_obj_start);
+
+// stop() - stop a continuous capture
+static mp_obj_t adc_block_obj_stop(mp_obj_t self_in) {
+    adc_block_stop(MP_OBJ_TO_PTR(self_in));
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(adc_block_obj_stop_obj, adc_block_obj_stop);
+
+// overruns() - halves completed while the scheduler queue was full
+static mp_obj_t adc_block_obj_overruns(mp_obj_t self_in) {
+    ra_adc_block_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_int_from_uint(self->overruns);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(adc_block_obj_overruns_obj, adc_block_obj_overruns);
+
+// ADCBlock class methods dictionary
+static const mp_rom_map_elem_t adc_block_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_connect), MP_ROM_PTR(&adc_block_obj_connect_obj) },
+    { MP_ROM_QSTR(MP_QSTR_channels), MP_ROM_PTR(&adc_block_obj_channels_obj) },
+    { MP_ROM_QSTR(MP_QSTR_read_timed), MP_ROM_PTR(&adc_block_obj_read_timed_obj) },
+    { MP_ROM_QSTR(MP_QSTR_start), MP_ROM_PTR(&adc_block_obj_start_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&adc_block_obj_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&adc_block_obj_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_overruns), MP_ROM_PTR(&adc_block_obj_overruns_obj) },
+};
+static MP_DEFINE_CONST_DICT(adc_block_locals_dict, adc_block_locals_dict_table);
+
+// ADCBlock type definition
+MP_DEFINE_CONST_OBJ_TYPE(
+    ra_adc_block_type,
+    MP_QSTR_ADCBlock,
+    MP_TYPE_FLAG_NONE,
+    make_new, adc_block_obj_make_new,
+    print, adc_block_obj_print,
+    locals_dict, &adc_block_locals_dict
+);
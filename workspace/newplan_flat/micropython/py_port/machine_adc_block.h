@@ -0,0 +1,12 @@
+#ifndef MICROPY_INCLUDED_RA8D1_MACHINE_ADC_BLOCK_H
+#define MICROPY_INCLUDED_RA8D1_MACHINE_ADC_BLOCK_H
+
+#include "py/obj.h"
+
+// Forward declaration of ADCBlock type
+extern const mp_obj_type_t ra_adc_block_type;
+
+// Stop all timed captures (soft reset)
+void machine_adc_block_deinit_all(void);
+
+#endif // MICROPY_INCLUDED_RA8D1_MACHINE_ADC_BLOCK_H
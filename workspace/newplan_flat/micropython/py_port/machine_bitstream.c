@@ -0,0 +1,401 @@
+/*
+ * machine_bitstream.c - GPT 硬件定时的 bitstream 输出和脉冲宽度测量
+ *
+ *   machine.bitstream(pin, encoding, timing, buf)
+ *       GPT 锯齿波 PWM：每个比特一个 PWM 周期，周期结束时引脚拉高、比较匹配时拉低。
+ *       GPT 溢出事件触发 DTC，把下一个比特的占空比（和周期）写入缓冲寄存器，
+ *       硬件在下一个周期开始时装载，所以波形与 CPU/VM 负载、其他中断无关。
+ *   machine.time_pulse_us(pin, pulse_level, timeout_us=1000000)
+ *   machine.capture_pulses(pin, buf, timeout_us=1000000)
+ *       GPT 输入捕获：边沿时刻由硬件锁存，DTC 逐个搬到缓冲区。
+ *
+ * 只支持 GPT4 ~ GPT7 的 GTIOCnA/GTIOCnB 引脚（32 位通道；GPT0 ~ 3 用于 ADCBlock/DAC 节拍）。
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/mphal.h"
+#include "py/mperrno.h"
+#include "hal_data.h"
+#include "bsp_api.h"
+#include "r_ioport.h"
+#include "machine_pin.h"
+#include "machine_bitstream.h"
+#include "ra_irq.h"
+#include "ra_dtc.h"
+#include "ra_gpt.h"
+
+// 比特之间只有一个比特时间来处理最后一次 DTC 结束中断，优先级要高于其他驱动
+#define BITSTREAM_IRQ_PRIORITY      (4)
+#define BITSTREAM_MAX_BITS          (0xFFFF)
+
+// GTIOR.GTIOA/GTIOB：bit4 初始电平，bit3:2 比较匹配动作，bit1:0 周期结束动作
+#define GTIO_CYCLE_HIGH_MATCH_LOW   (0x06)
+#define GTIO_CYCLE_LOW_MATCH_LOW    (0x05)
+
+// GTCCR[] 下标：A/B 为比较/捕获寄存器，C/E 分别是 A/B 的缓冲寄存器
+#define GTCCRA                      (0)
+#define GTCCRB                      (1)
+#define GTCCRC                      (2)
+#define GTCCRE                      (4)
+
+typedef struct _gpt_pin_t {
+    bsp_io_port_pin_t pin_id;
+    uint8_t ch;
+    bool io_b;
+    R_GPT0_Type *gpt;
+} gpt_pin_t;
+
+// 一次 bitstream/捕获的状态，ISR 通过 ra_irq 上下文访问（调用期间位于 C 栈上）
+typedef struct _gpt_xfer_t {
+    gpt_pin_t p;
+    IRQn_Type irq;
+    volatile bool done;
+    transfer_info_t dtc_info[2] __attribute__((aligned(BSP_FEATURE_DTC_TRANSFER_INFO_ALIGNMENT)));
+} gpt_xfer_t;
+
+static void gpt_pin_from_obj(mp_obj_t pin_in, gpt_pin_t *p) {
+    if (mp_obj_is_type(pin_in, &ra_pin_type)) {
+        p->pin_id = ((ra_pin_obj_t *)MP_OBJ_TO_PTR(pin_in))->pin_id;
+    } else {
+        p->pin_id = (bsp_io_port_pin_t)mp_obj_get_int(pin_in);
+    }
+    if (!ra_gpt_pin_lookup(p->pin_id, &p->ch, &p->io_b)) {
+        mp_raise_msg_varg(&mp_type_ValueError,
+                         MP_ERROR_TEXT("Pin 0x%04X has no GPT4-7 GTIOC function"),
+                         (unsigned int)p->pin_id);
+    }
+    p->gpt = ra_gpt_regs(p->ch);
+}
+
+// 纳秒 -> GPT 计数（四舍五入）
+static uint32_t ns_to_counts(uint32_t ns) {
+    return (uint32_t)(((uint64_t)ns * ra_gpt_clock_hz() + 500000000u) / 1000000000u);
+}
+
+static uint32_t counts_to_ns(uint32_t counts) {
+    return (uint32_t)(((uint64_t)counts * 1000000000u) / ra_gpt_clock_hz());
+}
+
+static void gpt_xfer_free(gpt_xfer_t *x) {
+    ra_gpt_stop(x->p.ch);
+    if (x->irq != RA_IRQ_INVALID) {
+        ra_dtc_disable(x->irq);
+        ra_irq_free(x->irq);
+        x->irq = RA_IRQ_INVALID;
+    }
+    x->p.gpt->GTIOR = 0;
+    x->p.gpt->GTICASR = 0;
+    x->p.gpt->GTICBSR = 0;
+    x->p.gpt->GTBER = 0;
+}
+
+// ========== bitstream ==========
+
+// DTC 已写入终止项：引脚上正在输出最后一个比特，把周期结束动作改成“拉低”，
+// 下一次溢出时不再产生高电平
+static void bitstream_isr(void) {
+    IRQn_Type irq = R_FSP_CurrentIrqGet();
+    R_BSP_IrqStatusClear(irq);
+
+    gpt_xfer_t *x = ra_irq_context_get(irq);
+    if (x == NULL) {
+        return;
+    }
+    R_GPT0_Type *gpt = x->p.gpt;
+    uint32_t pos = x->p.io_b ? R_GPT0_GTIOR_GTIOB_Pos : R_GPT0_GTIOR_GTIOA_Pos;
+    gpt->GTIOR = (gpt->GTIOR & ~(0x1FU << pos)) | (GTIO_CYCLE_LOW_MATCH_LOW << pos);
+    gpt->GTST &= ~R_GPT0_GTST_TCFPO_Msk;
+    x->done = true;
+}
+
+// bitstream(pin, encoding, timing, buf)
+//   encoding 0: timing = (high_0, low_0, high_1, low_1) 纳秒，buf 中每个字节高位在前
+static mp_obj_t machine_bitstream(size_t n_args, const mp_obj_t *args) {
+    mp_int_t encoding = mp_obj_get_int(args[1]);
+    if (encoding != 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("encoding must be 0"));
+    }
+
+    size_t n_timing;
+    mp_obj_t *timing;
+    mp_obj_get_array(args[2], &n_timing, &timing);
+    if (n_timing != 4) {
+        mp_raise_ValueError(MP_ERROR_TEXT("timing must have 4 entries"));
+    }
+    uint32_t high[2], period[2];
+    for (int b = 0; b < 2; b++) {
+        high[b] = ns_to_counts((uint32_t)mp_obj_get_int(timing[2 * b]));
+        period[b] = high[b] + ns_to_counts((uint32_t)mp_obj_get_int(timing[2 * b + 1]));
+        if (high[b] == 0 || period[b] <= high[b]) {
+            mp_raise_ValueError(MP_ERROR_TEXT("timing too short for GPT clock"));
+        }
+    }
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[3], &bufinfo, MP_BUFFER_READ);
+    size_t n_bits = bufinfo.len * 8;
+    if (n_bits == 0) {
+        return mp_const_none;
+    }
+    if (n_bits > BITSTREAM_MAX_BITS) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too large"));
+    }
+
+    gpt_xfer_t x;
+    memset(&x, 0, sizeof(x));
+    x.irq = RA_IRQ_INVALID;
+    gpt_pin_from_obj(args[0], &x.p);
+    R_GPT0_Type *gpt = x.p.gpt;
+
+    // 展开为每比特一项：占空比（高电平计数），周期不同时再加一组 GTPBR 值。
+    // 末尾追加一个终止项，DTC 写完它时最后一个比特刚开始输出。
+    bool var_period = (period[0] != period[1]);
+    size_t n_items = n_bits + 1;
+    uint32_t *duty = ra_dtc_alloc(sizeof(uint32_t) * (var_period ? 2 * n_items : n_items));
+    uint32_t *gtpbr = var_period ? duty + n_items : NULL;
+    const uint8_t *src = bufinfo.buf;
+    for (size_t i = 0; i < n_bits; i++) {
+        int b = (src[i >> 3] >> (7 - (i & 7))) & 1;
+        duty[i] = high[b];
+        if (var_period) {
+            gtpbr[i] = period[b] - 1;
+        }
+    }
+    duty[n_bits] = 0;
+    if (var_period) {
+        gtpbr[n_bits] = period[0] - 1;
+    }
+
+    int b0 = src[0] >> 7;
+    R_BSP_MODULE_START(FSP_IP_GPT, x.p.ch);
+    gpt->GTCR = 0;                                          // 停止，锯齿波 PWM，PCLKD/1
+    gpt->GTUDDTYC = R_GPT0_GTUDDTYC_UDF_Msk | R_GPT0_GTUDDTYC_UD_Msk;
+    gpt->GTUDDTYC = R_GPT0_GTUDDTYC_UD_Msk;
+    gpt->GTCNT = 0;
+    gpt->GTST = 0;
+    // 引导周期：输出保持初始低电平（比较值大于周期，不会匹配）
+    gpt->GTPR = period[b0] - 1;
+    gpt->GTPBR = period[b0] - 1;
+    // 比较寄存器单缓冲（A: GTCCRC -> GTCCRA，B: GTCCRE -> GTCCRB），周期单缓冲
+    volatile uint32_t *ccr_buf;
+    if (x.p.io_b) {
+        gpt->GTCCR[GTCCRB] = 0xFFFFFFFF;
+        gpt->GTCCR[GTCCRE] = duty[0];
+        gpt->GTBER = (1U << R_GPT0_GTBER_CCRB_Pos) | (1U << R_GPT0_GTBER_PR_Pos);
+        gpt->GTIOR = R_GPT0_GTIOR_OBE_Msk | (GTIO_CYCLE_HIGH_MATCH_LOW << R_GPT0_GTIOR_GTIOB_Pos);
+        ccr_buf = &gpt->GTCCR[GTCCRE];
+    } else {
+        gpt->GTCCR[GTCCRA] = 0xFFFFFFFF;
+        gpt->GTCCR[GTCCRC] = duty[0];
+        gpt->GTBER = (1U << R_GPT0_GTBER_CCRA_Pos) | (1U << R_GPT0_GTBER_PR_Pos);
+        gpt->GTIOR = R_GPT0_GTIOR_OAE_Msk | (GTIO_CYCLE_HIGH_MATCH_LOW << R_GPT0_GTIOR_GTIOA_Pos);
+        ccr_buf = &gpt->GTCCR[GTCCRC];
+    }
+    if (var_period) {
+        gpt->GTPBR = gtpbr[0];
+    }
+
+    // 每次溢出：DTC 把下一个比特写入缓冲寄存器（第 0 项已预装）
+    x.irq = ra_irq_alloc(ra_gpt_overflow_event(x.p.ch), bitstream_isr, BITSTREAM_IRQ_PRIORITY, &x);
+    if (x.irq == RA_IRQ_INVALID) {
+        m_del(uint32_t, duty, var_period ? 2 * n_items : n_items);
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("no free interrupt slot"));
+    }
+    ra_dtc_info_write32(&x.dtc_info[0], duty + 1, ccr_buf, (uint16_t)n_bits);
+    if (var_period) {
+        ra_dtc_info_chain(&x.dtc_info[0]);
+        ra_dtc_info_write32(&x.dtc_info[1], gtpbr + 1, &gpt->GTPBR, (uint16_t)n_bits);
+    }
+    ra_dtc_set_info(x.irq, &x.dtc_info[0]);
+    ra_dtc_enable(x.irq);
+
+    R_IOPORT_PinCfg(&g_ioport_ctrl, x.p.pin_id, (uint32_t)IOPORT_CFG_PERIPHERAL_PIN | (uint32_t)IOPORT_PERIPHERAL_GPT1);
+
+    // 总时长上限（按较长的比特估算）+ 1ms 余量，防止异常情况下死等
+    uint32_t max_period = period[0] > period[1] ? period[0] : period[1];
+    uint32_t timeout_us = (uint32_t)((uint64_t)(n_bits + 2) * max_period * 1000000u / ra_gpt_clock_hz()) + 1000;
+    mp_uint_t t0 = mp_hal_ticks_us();
+
+    ra_gpt_start(x.p.ch);
+
+    // 等 ISR 处理完终止项，再等最后一个比特的周期结束
+    while (!x.done && mp_hal_ticks_us() - t0 < timeout_us) {
+    }
+    while (x.done && !(gpt->GTST & R_GPT0_GTST_TCFPO_Msk) && mp_hal_ticks_us() - t0 < timeout_us) {
+    }
+    bool ok = x.done;
+
+    gpt_xfer_free(&x);
+    R_IOPORT_PinCfg(&g_ioport_ctrl, x.p.pin_id, IOPORT_CFG_PORT_DIRECTION_OUTPUT | IOPORT_CFG_PORT_OUTPUT_LOW);
+    m_del(uint32_t, duty, var_period ? 2 * n_items : n_items);
+
+    if (!ok) {
+        mp_raise_OSError(MP_ETIMEDOUT);
+    }
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(machine_bitstream_obj, 4, 4, machine_bitstream);
+
+// ========== 输入捕获 ==========
+
+// DTC 已搬完请求的捕获次数
+static void capture_isr(void) {
+    IRQn_Type irq = R_FSP_CurrentIrqGet();
+    R_BSP_IrqStatusClear(irq);
+
+    gpt_xfer_t *x = ra_irq_context_get(irq);
+    if (x != NULL) {
+        x->done = true;
+    }
+}
+
+// 在 x->p 指定的引脚上开始捕获：edges 为 GTICASR 格式的边沿位（B 通道自动换算），
+// 每个边沿的计数值由 DTC 依次写入 ts[0..n-1]。计数器从 0 开始自由运行。
+static void capture_start(gpt_xfer_t *x, bool rising, bool falling, uint32_t *ts, uint16_t n) {
+    R_GPT0_Type *gpt = x->p.gpt;
+
+    R_BSP_MODULE_START(FSP_IP_GPT, x->p.ch);
+    gpt->GTCR = 0;
+    gpt->GTUDDTYC = R_GPT0_GTUDDTYC_UDF_Msk | R_GPT0_GTUDDTYC_UD_Msk;
+    gpt->GTUDDTYC = R_GPT0_GTUDDTYC_UD_Msk;
+    gpt->GTPR = 0xFFFFFFFF;
+    gpt->GTCNT = 0;
+    gpt->GTST = 0;
+    gpt->GTIOR = 0;
+    gpt->GTBER = 0;
+
+    // 对端引脚电平无关：每种边沿同时使能“对端为低”和“对端为高”两个条件
+    uint32_t src = 0;
+    if (x->p.io_b) {
+        src |= rising ? (R_GPT0_GTICBSR_BSCBRAL_Msk | R_GPT0_GTICBSR_BSCBRAH_Msk) : 0;
+        src |= falling ? (R_GPT0_GTICBSR_BSCBFAL_Msk | R_GPT0_GTICBSR_BSCBFAH_Msk) : 0;
+        gpt->GTICBSR = src;
+        gpt->GTICASR = 0;
+    } else {
+        src |= rising ? (R_GPT0_GTICASR_ASCARBL_Msk | R_GPT0_GTICASR_ASCARBH_Msk) : 0;
+        src |= falling ? (R_GPT0_GTICASR_ASCAFBL_Msk | R_GPT0_GTICASR_ASCAFBH_Msk) : 0;
+        gpt->GTICASR = src;
+        gpt->GTICBSR = 0;
+    }
+
+    x->irq = ra_irq_alloc(ra_gpt_capture_event(x->p.ch, x->p.io_b), capture_isr, BITSTREAM_IRQ_PRIORITY, x);
+    if (x->irq == RA_IRQ_INVALID) {
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("no free interrupt slot"));
+    }
+    ra_dtc_info_read32(&x->dtc_info[0], x->p.io_b ? &gpt->GTCCR[GTCCRB] : &gpt->GTCCR[GTCCRA], ts, n);
+    ra_dtc_set_info(x->irq, &x->dtc_info[0]);
+    ra_dtc_enable(x->irq);
+
+    R_IOPORT_PinCfg(&g_ioport_ctrl, x->p.pin_id, (uint32_t)IOPORT_CFG_PERIPHERAL_PIN | (uint32_t)IOPORT_PERIPHERAL_GPT1);
+    ra_gpt_start(x->p.ch);
+}
+
+// 已捕获的边沿数：DTC 每次传输后把剩余次数写回传输记录
+static uint16_t capture_count(gpt_xfer_t *x, uint16_t n) {
+    if (x->done) {
+        return n;
+    }
+    return (uint16_t)(n - *(volatile uint16_t *)&x->dtc_info[0].length);
+}
+
+static void capture_end(gpt_xfer_t *x) {
+    gpt_xfer_free(x);
+    R_IOPORT_PinCfg(&g_ioport_ctrl, x->p.pin_id, IOPORT_CFG_PORT_DIRECTION_INPUT);
+}
+
+// time_pulse_us(pin, pulse_level, timeout_us=1000000)
+//   与 extmod/machine_pulse.c 语义相同：等待引脚变为 pulse_level（超时返回 -2），
+//   再测量该电平持续的时间（超时返回 -1）。边沿时刻由 GPT 捕获，分辨率 1/PCLKD。
+static mp_obj_t machine_time_pulse_us(size_t n_args, const mp_obj_t *args) {
+    int level = mp_obj_is_true(args[1]);
+    mp_uint_t timeout_us = (n_args > 2) ? (mp_uint_t)mp_obj_get_int(args[2]) : 1000000;
+    uint32_t timeout_counts = (uint32_t)((uint64_t)timeout_us * ra_gpt_clock_hz() / 1000000u);
+
+    gpt_xfer_t x;
+    memset(&x, 0, sizeof(x));
+    x.irq = RA_IRQ_INVALID;
+    gpt_pin_from_obj(args[0], &x.p);
+
+    uint32_t ts[2] = {0, 0};
+    bool rising_end = !level;     // 脉冲结束边沿：高脉冲为下降沿
+    bool at_level = ((ra_port_regs(x.p.pin_id >> 8)->PIDR >> (x.p.pin_id & 0xFF)) & 1) == level;
+    uint16_t n;
+    if (at_level) {
+        // 已处于脉冲电平：从现在开始计时，只捕获结束边沿
+        n = 1;
+        capture_start(&x, rising_end, !rising_end, &ts[1], n);
+        ts[0] = 0;
+    } else {
+        n = 2;
+        capture_start(&x, true, true, ts, n);
+    }
+
+    mp_int_t result;
+    R_GPT0_Type *gpt = x.p.gpt;
+    for (;;) {
+        uint16_t got = capture_count(&x, n);
+        uint32_t now = gpt->GTCNT;
+        if (got == n) {
+            result = (mp_int_t)((uint64_t)(ts[1] - ts[0]) * 1000000u / ra_gpt_clock_hz());
+            break;
+        }
+        if (got == n - 1 && now - ts[0] >= timeout_counts) {
+            result = -1;
+            break;
+        }
+        if (got == 0 && n == 2 && now >= timeout_counts) {
+            result = -2;
+            break;
+        }
+    }
+
+    capture_end(&x);
+    return MP_OBJ_NEW_SMALL_INT(result);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(machine_time_pulse_us_obj, 2, 3, machine_time_pulse_us);
+
+// capture_pulses(pin, buf, timeout_us=1000000)
+//   记录引脚上的边沿，直到 buf 写满或超时。buf 按小端 uint32 写入相邻边沿之间的间隔（纳秒），
+//   第一个间隔从调用后的第一个边沿开始（引脚原来为低电平时即为高电平宽度）。返回间隔个数。
+static mp_obj_t machine_capture_pulses(size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_WRITE);
+    mp_uint_t timeout_us = (n_args > 2) ? (mp_uint_t)mp_obj_get_int(args[2]) : 1000000;
+    if ((uintptr_t)bufinfo.buf & 3) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer must be 4-byte aligned"));
+    }
+    size_t n_edges = bufinfo.len / sizeof(uint32_t) + 1;
+    if (n_edges < 2) {
+        return MP_OBJ_NEW_SMALL_INT(0);
+    }
+    if (n_edges > 0xFFFF) {
+        n_edges = 0xFFFF;
+    }
+
+    gpt_xfer_t x;
+    memset(&x, 0, sizeof(x));
+    x.irq = RA_IRQ_INVALID;
+    gpt_pin_from_obj(args[0], &x.p);
+
+    // 时间戳先写入 buf（多出的一个边沿放在临时变量里），结束后原地换算成间隔
+    uint32_t *ts = ra_dtc_alloc(sizeof(uint32_t) * n_edges);
+    capture_start(&x, true, true, ts, (uint16_t)n_edges);
+
+    mp_uint_t t0 = mp_hal_ticks_us();
+    while (!x.done && mp_hal_ticks_us() - t0 < timeout_us) {
+    }
+    uint16_t got = capture_count(&x, (uint16_t)n_edges);
+    capture_end(&x);
+
+    uint32_t *out = bufinfo.buf;
+    size_t n_out = got > 0 ? got - 1 : 0;
+    for (size_t i = 0; i < n_out; i++) {
+        out[i] = counts_to_ns(ts[i + 1] - ts[i]);
+    }
+    m_del(uint32_t, ts, n_edges);
+
+    return MP_OBJ_NEW_SMALL_INT(n_out);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(machine_capture_pulses_obj, 2, 3, machine_capture_pulses);
@@ -0,0 +1,11 @@
+#ifndef MICROPY_INCLUDED_RA8D1_MACHINE_BITSTREAM_H
+#define MICROPY_INCLUDED_RA8D1_MACHINE_BITSTREAM_H
+
+#include "py/obj.h"
+
+// GPT 硬件定时的 machine.bitstream / time_pulse_us / capture_pulses
+MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(machine_bitstream_obj);
+MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(machine_time_pulse_us_obj);
+MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(machine_capture_pulses_obj);
+
+#endif // MICROPY_INCLUDED_RA8D1_MACHINE_BITSTREAM_H
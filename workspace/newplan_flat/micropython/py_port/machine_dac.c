@@ -5,12 +5,17 @@
  * Author: Embedded Systems Engineer
  */
 
+#include <string.h>
+
 #include "py/runtime.h"
 #include "py/mphal.h"
 #include "hal_data.h"
 #include "bsp_api.h"
 #include "machine_pin.h"
 #include "machine_dac.h"
+#include "ra_irq.h"
+#include "ra_dtc.h"
+#include "ra_gpt.h"
 // R_DAC register definitions are included via bsp_api.h -> renesas.h -> R7FA8D1BH.h
 
 // Define STATIC macro
@@ -42,6 +47,31 @@ static const pin_dac_map_t pin_dac_map[] = {
 
 #define PIN_DAC_MAP_SIZE (sizeof(pin_dac_map) / sizeof(pin_dac_map_t))
 
+// ========== Timed Playback State ==========
+
+#define DAC_TIMED_IRQ_PRIORITY  (8)
+#define DAC_TIMED_REPEAT_MAX    (256)   // DTC repeat mode limit
+
+// One playback per channel, shared by every DAC object of that channel.
+// GPT overflow -> DTC copies the next sample into DADR. The CPU only runs
+// when a half buffer has been played (to re-arm the DTC for the other half).
+typedef struct _dac_timed_t {
+    uint8_t channel;
+    uint8_t gpt_ch;
+    bool oneshot;
+    volatile bool running;
+    volatile uint8_t half;              // half being played
+    IRQn_Type irq;
+    const uint16_t *buf;
+    uint16_t half_len;                  // samples per half (whole buffer in repeat mode)
+    mp_obj_t buf_obj;
+    mp_obj_t callback;
+    volatile uint32_t overruns;
+    transfer_info_t dtc_info __attribute__((aligned(BSP_FEATURE_DTC_TRANSFER_INFO_ALIGNMENT)));
+} dac_timed_t;
+
+MP_REGISTER_ROOT_POINTER(void *machine_dac_timed[2]);
+
 // Find DAC channel for a given pin
 static const pin_dac_map_t *find_dac_channel(bsp_io_port_pin_t pin_id) {
     for (size_t i = 0; i < PIN_DAC_MAP_SIZE; i++) {
@@ -201,9 +231,168 @@ static mp_obj_t dac_obj_write(mp_obj_t self_in, mp_obj_t value_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_2(dac_obj_write_obj, dac_obj_write);
 
+// End of a half-buffer DTC run: the overflow that moved its last sample reaches the CPU
+static void dac_timed_isr(void) {
+    IRQn_Type irq = R_FSP_CurrentIrqGet();
+    R_BSP_IrqStatusClear(irq);
+
+    dac_timed_t *st = ra_irq_context_get(irq);
+    if (st == NULL || !st->running) {
+        return;
+    }
+
+    uint8_t completed = st->half;
+    if (st->oneshot && completed == 1) {
+        // Whole buffer played: the DAC keeps holding the last sample
+        ra_gpt_stop(st->gpt_ch);
+        st->running = false;
+    } else {
+        // Re-arm for the other half before the next overflow
+        st->half ^= 1;
+        st->dtc_info.p_src = st->buf + (size_t)st->half * st->half_len;
+        st->dtc_info.length = st->half_len;
+        ra_dtc_enable(irq);
+    }
+
+    if (st->callback != mp_const_none) {
+        if (!mp_sched_schedule_prio(st->callback, MP_OBJ_NEW_SMALL_INT(completed), MP_SCHED_PRIO_HIGH)) {
+            st->overruns++;
+        }
+    }
+}
+
+static void dac_timed_stop(uint8_t channel) {
+    dac_timed_t *st = MP_STATE_PORT(machine_dac_timed)[channel];
+    if (st == NULL) {
+        return;
+    }
+
+    ra_gpt_stop(st->gpt_ch);
+    st->running = false;
+    ra_dtc_disable(st->irq);
+    ra_irq_free(st->irq);
+    MP_STATE_PORT(machine_dac_timed)[channel] = NULL;
+}
+
+void machine_dac_deinit_all(void) {
+    for (uint8_t ch = 0; ch < 2; ch++) {
+        dac_timed_stop(ch);
+    }
+}
+
+// write_timed(buf, freq, mode=DAC.LOOP, callback=None)
+//   buf: 12-bit samples (0-4095) as little-endian uint16, played at freq samples/s.
+//   The buffer is played in two halves; callback(half) is scheduled after each
+//   half has gone out so it can be refilled. ONESHOT stops after half 1.
+//   LOOP without callback and with <= 256 samples runs without any interrupt.
+static mp_obj_t dac_obj_write_timed(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_buf, ARG_freq, ARG_mode, ARG_callback };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_buf, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_freq, MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = 0} },
+        { MP_QSTR_mode, MP_ARG_INT, {.u_int = MP_DAC_TIMED_LOOP} },
+        { MP_QSTR_callback, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+    };
+
+    ra_dac_obj_t *self = MP_OBJ_TO_PTR(pos_args[0]);
+    mp_arg_val_t vals[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, vals);
+
+    mp_obj_t callback = vals[ARG_callback].u_obj;
+    if (callback != mp_const_none && !mp_obj_is_callable(callback)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("callback must be callable"));
+    }
+    mp_int_t mode = vals[ARG_mode].u_int;
+    if (mode != MP_DAC_TIMED_LOOP && mode != MP_DAC_TIMED_ONESHOT) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid mode"));
+    }
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(vals[ARG_buf].u_obj, &bufinfo, MP_BUFFER_READ);
+    size_t n_samples = bufinfo.len / sizeof(uint16_t);
+    bool repeat = (mode == MP_DAC_TIMED_LOOP && callback == mp_const_none && n_samples <= DAC_TIMED_REPEAT_MAX);
+    if (((uintptr_t)bufinfo.buf & 1) || n_samples == 0 || (!repeat && (n_samples & 1))) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer must hold an even number of uint16 samples"));
+    }
+    if (n_samples / 2 > 0xFFFF) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too large"));
+    }
+    ra_dtc_check_buffer(bufinfo.buf, bufinfo.len);
+
+    // Restart: stop whatever this channel was playing
+    dac_timed_stop(self->channel);
+
+    uint8_t gpt_ch = MICROPY_HW_DAC_TIMED_GPT_CH(self->channel);
+    if (ra_gpt_periodic_init(gpt_ch, (uint32_t)vals[ARG_freq].u_int) == 0) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("freq %d out of range"), (int)vals[ARG_freq].u_int);
+    }
+
+    dac_timed_t *st = ra_dtc_alloc(sizeof(dac_timed_t));
+    memset(st, 0, sizeof(*st));
+    st->channel = self->channel;
+    st->gpt_ch = gpt_ch;
+    st->oneshot = (mode == MP_DAC_TIMED_ONESHOT);
+    st->buf = bufinfo.buf;
+    st->half_len = (uint16_t)(repeat ? n_samples : n_samples / 2);
+    st->buf_obj = vals[ARG_buf].u_obj;
+    st->callback = callback;
+
+    st->irq = ra_irq_alloc(ra_gpt_overflow_event(gpt_ch), dac_timed_isr, DAC_TIMED_IRQ_PRIORITY, st);
+    if (st->irq == RA_IRQ_INVALID) {
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("no free interrupt slot"));
+    }
+    MP_STATE_PORT(machine_dac_timed)[self->channel] = st;
+
+    if (repeat) {
+        ra_dtc_info_repeat16(&st->dtc_info, st->buf, &R_DAC->DADR[self->channel], st->half_len);
+    } else {
+        ra_dtc_info_normal16(&st->dtc_info, st->buf, &R_DAC->DADR[self->channel], st->half_len);
+    }
+    ra_dtc_set_info(st->irq, &st->dtc_info);
+    ra_dtc_enable(st->irq);
+
+    st->running = true;
+    ra_gpt_start(gpt_ch);
+
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(dac_obj_write_timed_obj, 3, dac_obj_write_timed);
+
+// stop() - stop timed playback on this channel (output holds the last sample)
+static mp_obj_t dac_obj_stop(mp_obj_t self_in) {
+    ra_dac_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    dac_timed_stop(self->channel);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(dac_obj_stop_obj, dac_obj_stop);
+
+// playing() - True while timed playback is running
+static mp_obj_t dac_obj_playing(mp_obj_t self_in) {
+    ra_dac_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    dac_timed_t *st = MP_STATE_PORT(machine_dac_timed)[self->channel];
+    return mp_obj_new_bool(st != NULL && st->running);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(dac_obj_playing_obj, dac_obj_playing);
+
+// overruns() - half-buffer callbacks dropped because the scheduler queue was full
+static mp_obj_t dac_obj_overruns(mp_obj_t self_in) {
+    ra_dac_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    dac_timed_t *st = MP_STATE_PORT(machine_dac_timed)[self->channel];
+    return mp_obj_new_int_from_uint(st != NULL ? st->overruns : 0);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(dac_obj_overruns_obj, dac_obj_overruns);
+
 // DAC class methods dictionary
 static const mp_rom_map_elem_t dac_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&dac_obj_write_obj) },
+    { MP_ROM_QSTR(MP_QSTR_write_timed), MP_ROM_PTR(&dac_obj_write_timed_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&dac_obj_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_playing), MP_ROM_PTR(&dac_obj_playing_obj) },
+    { MP_ROM_QSTR(MP_QSTR_overruns), MP_ROM_PTR(&dac_obj_overruns_obj) },
+
+    // write_timed 模式常量
+    { MP_ROM_QSTR(MP_QSTR_LOOP), MP_ROM_INT(MP_DAC_TIMED_LOOP) },
+    { MP_ROM_QSTR(MP_QSTR_ONESHOT), MP_ROM_INT(MP_DAC_TIMED_ONESHOT) },
 };
 static MP_DEFINE_CONST_DICT(dac_locals_dict, dac_locals_dict_table);
 
@@ -10,8 +10,15 @@ typedef struct _ra_dac_obj_t {
     bool is_initialized;      // Track if DAC is initialized
 } ra_dac_obj_t;
 
+// write_timed() playback modes
+#define MP_DAC_TIMED_LOOP       (0)
+#define MP_DAC_TIMED_ONESHOT    (1)
+
 // Forward declaration of DAC type
 extern const mp_obj_type_t ra_dac_type;
 
+// Stop timed playback on all channels (soft reset)
+void machine_dac_deinit_all(void);
+
 #endif // MICROPY_INCLUDED_RA8D1_MACHINE_DAC_H
 
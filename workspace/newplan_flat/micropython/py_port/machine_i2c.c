@@ -22,6 +22,92 @@
 
 // ========== FSP I2C Callback Implementation ==========
 
+// ========== Batch Engine (runs in IIC interrupt context) ==========
+
+// Finish the running batch and notify the owner
+static void i2c_batch_finish(ra_i2c_obj_t *self, fsp_err_t result) {
+    ra_i2c_batch_done_t done = self->batch_done;
+    void *arg = self->batch_done_arg;
+
+    self->batch_ops = NULL;
+    self->transfer_result = result;
+    self->transfer_complete = true;
+
+    if (done != NULL) {
+        done(self, result, arg);
+    }
+}
+
+// Issue the register address write of the current op (repeated start follows)
+static fsp_err_t i2c_batch_issue(ra_i2c_obj_t *self) {
+    const ra_i2c_batch_op_t *op = &self->batch_ops[self->batch_index];
+    i2c_master_ctrl_t *p_ctrl = self->i2c_instance->p_ctrl;
+
+    fsp_err_t err = self->i2c_instance->p_api->slaveAddressSet(p_ctrl, op->addr, I2C_MASTER_ADDR_MODE_7BIT);
+    if (err != FSP_SUCCESS) {
+        return err;
+    }
+
+    self->batch_reg = op->reg;
+    self->batch_reading = false;
+    return self->i2c_instance->p_api->write(p_ctrl, &self->batch_reg, 1, true);
+}
+
+// Advance the batch state machine on a driver event
+static void i2c_batch_step(ra_i2c_obj_t *self, i2c_master_event_t event) {
+    fsp_err_t err;
+
+    if (event == I2C_MASTER_EVENT_ABORTED) {
+        i2c_batch_finish(self, FSP_ERR_ABORTED);
+        return;
+    }
+
+    if (!self->batch_reading) {
+        // Register address sent: read the data and release the bus with STOP
+        const ra_i2c_batch_op_t *op = &self->batch_ops[self->batch_index];
+        self->batch_reading = true;
+        err = self->i2c_instance->p_api->read(self->i2c_instance->p_ctrl, op->dest, op->len, false);
+    } else {
+        // Data received: move on to the next op
+        if (++self->batch_index >= self->batch_count) {
+            i2c_batch_finish(self, FSP_SUCCESS);
+            return;
+        }
+        err = i2c_batch_issue(self);
+    }
+
+    if (err != FSP_SUCCESS) {
+        i2c_batch_finish(self, err);
+    }
+}
+
+fsp_err_t ra_i2c_batch_start(ra_i2c_obj_t *self, const ra_i2c_batch_op_t *ops, size_t n_ops,
+                             ra_i2c_batch_done_t done, void *arg) {
+    if (!self->is_open) {
+        return FSP_ERR_NOT_OPEN;
+    }
+    if (n_ops == 0 || n_ops > MP_I2C_BATCH_MAX_OPS) {
+        return FSP_ERR_INVALID_ARGUMENT;
+    }
+    if (self->batch_ops != NULL) {
+        return FSP_ERR_IN_USE;
+    }
+
+    self->transfer_complete = false;
+    self->transfer_result = FSP_SUCCESS;
+    self->batch_count = (uint8_t)n_ops;
+    self->batch_index = 0;
+    self->batch_done = done;
+    self->batch_done_arg = arg;
+    self->batch_ops = ops;
+
+    fsp_err_t err = i2c_batch_issue(self);
+    if (err != FSP_SUCCESS) {
+        self->batch_ops = NULL;
+    }
+    return err;
+}
+
 // I2C Master callback function for FSP driver
 void i2c_master_callback(i2c_master_callback_args_t *p_args) {
     // Get I2C object from context
@@ -31,6 +117,13 @@ void i2c_master_callback(i2c_master_callback_args_t *p_args) {
     if (self == NULL) {
         return;
     }
+
+    // A batch is running: chain the next transfer directly from the interrupt
+    if (self->batch_ops != NULL) {
+        self->last_event = p_args->event;
+        i2c_batch_step(self, p_args->event);
+        return;
+    }
     
     // Store the event and mark transfer as complete
     self->last_event = p_args->event;
@@ -117,6 +210,12 @@ static mp_obj_t i2c_obj_make_new(const mp_obj_type_t *type, size_t n_args, size_
     self->transfer_complete = false;
     self->transfer_result = FSP_SUCCESS;
     self->last_event = (i2c_master_event_t)0;
+    self->batch_ops = NULL;
+    self->batch_count = 0;
+    self->batch_index = 0;
+    self->batch_reading = false;
+    self->batch_done = NULL;
+    self->batch_done_arg = NULL;
 
     // Initialize the I2C driver
     fsp_err_t err = self->i2c_instance->p_api->open(self->i2c_instance->p_ctrl, self->i2c_instance->p_cfg);
@@ -452,6 +551,74 @@ static mp_obj_t i2c_obj_writeto_mem(size_t n_args, const mp_obj_t *args) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(i2c_obj_writeto_mem_obj, 4, 5, i2c_obj_writeto_mem);
 
+// Read several registers in one call: readfrom_mem_batch(ops, buf)
+// ops: sequence of (addr, memaddr, nbytes, offset); each result lands in buf[offset:offset+nbytes].
+// All transfers are chained from the IIC interrupt; the VM only waits once for the whole batch.
+static mp_obj_t i2c_obj_readfrom_mem_batch(mp_obj_t self_in, mp_obj_t ops_in, mp_obj_t buf_in) {
+    ra_i2c_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (!self->is_open) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("I2C not initialized"));
+    }
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+
+    size_t n_ops;
+    mp_obj_t *items;
+    mp_obj_get_array(ops_in, &n_ops, &items);
+    if (n_ops == 0) {
+        return mp_const_none;
+    }
+    if (n_ops > MP_I2C_BATCH_MAX_OPS) {
+        mp_raise_ValueError(MP_ERROR_TEXT("too many ops in batch"));
+    }
+
+    // Ops live on the C stack: this call blocks until the batch has finished
+    ra_i2c_batch_op_t ops[MP_I2C_BATCH_MAX_OPS];
+    for (size_t i = 0; i < n_ops; i++) {
+        mp_obj_t *op;
+        mp_obj_get_array_fixed_n(items[i], 4, &op);
+        mp_int_t addr = mp_obj_get_int(op[0]);
+        mp_int_t memaddr = mp_obj_get_int(op[1]);
+        mp_int_t nbytes = mp_obj_get_int(op[2]);
+        mp_int_t offset = mp_obj_get_int(op[3]);
+        if (nbytes <= 0 || nbytes > 0xFFFF || offset < 0 || (size_t)(offset + nbytes) > bufinfo.len) {
+            mp_raise_ValueError(MP_ERROR_TEXT("batch op out of buffer range"));
+        }
+        ops[i].addr = (uint8_t)addr;
+        ops[i].reg = (uint8_t)memaddr;
+        ops[i].len = (uint16_t)nbytes;
+        ops[i].dest = (uint8_t *)bufinfo.buf + offset;
+    }
+
+    fsp_err_t err = ra_i2c_batch_start(self, ops, n_ops, NULL, NULL);
+    if (err != FSP_SUCCESS) {
+        mp_raise_msg_varg(&mp_type_RuntimeError,
+                         MP_ERROR_TEXT("Failed to start I2C batch: %d"), err);
+    }
+
+    // Sleep until the IIC interrupt finishes the whole chain (SysTick wakes us for the timeout)
+    uint32_t start_time = mp_hal_ticks_ms();
+    while (!self->transfer_complete) {
+        if ((mp_hal_ticks_ms() - start_time) > 100u * n_ops) {
+            self->i2c_instance->p_api->abort(self->i2c_instance->p_ctrl);
+            self->batch_ops = NULL;
+            mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("I2C batch timeout"));
+        }
+        __WFI();
+    }
+
+    if (self->transfer_result != FSP_SUCCESS) {
+        mp_raise_msg_varg(&mp_type_RuntimeError,
+                         MP_ERROR_TEXT("I2C batch failed at op %u: %d"),
+                         (unsigned int)self->batch_index, self->transfer_result);
+    }
+
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_3(i2c_obj_readfrom_mem_batch_obj, i2c_obj_readfrom_mem_batch);
+
 // ========== I2C Type Definition ==========
 
 // I2C class methods dictionary
@@ -462,6 +629,7 @@ static const mp_rom_map_elem_t i2c_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_writeto), MP_ROM_PTR(&i2c_obj_writeto_obj) },
     { MP_ROM_QSTR(MP_QSTR_readfrom_mem), MP_ROM_PTR(&i2c_obj_readfrom_mem_obj) },
     { MP_ROM_QSTR(MP_QSTR_writeto_mem), MP_ROM_PTR(&i2c_obj_writeto_mem_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readfrom_mem_batch), MP_ROM_PTR(&i2c_obj_readfrom_mem_batch_obj) },
 };
 static MP_DEFINE_CONST_DICT(i2c_locals_dict, i2c_locals_dict_table);
 
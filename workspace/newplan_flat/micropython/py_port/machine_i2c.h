@@ -8,6 +8,22 @@
 #define MP_I2C_FREQ_100K  (100000)
 #define MP_I2C_FREQ_400K  (400000)
 
+// Maximum number of operations in one batch (readfrom_mem_batch / C batch API)
+#define MP_I2C_BATCH_MAX_OPS  (16)
+
+// One register read in a batch: write `reg` to `addr`, repeated-start, read `len` bytes into `dest`
+typedef struct _ra_i2c_batch_op_t {
+    uint8_t addr;
+    uint8_t reg;
+    uint16_t len;
+    uint8_t *dest;
+} ra_i2c_batch_op_t;
+
+struct _ra_i2c_obj_t;
+
+// Batch completion callback, called from the IIC interrupt when the last op finished or failed
+typedef void (*ra_i2c_batch_done_t)(struct _ra_i2c_obj_t *self, fsp_err_t result, void *arg);
+
 // I2C object structure
 typedef struct _ra_i2c_obj_t {
     mp_obj_base_t base;
@@ -18,9 +34,22 @@ typedef struct _ra_i2c_obj_t {
     volatile bool transfer_complete;
     volatile fsp_err_t transfer_result;
     volatile i2c_master_event_t last_event;
+    // Batch engine state (advanced from i2c_master_callback, no VM involvement between ops)
+    const ra_i2c_batch_op_t *volatile batch_ops;
+    uint8_t batch_count;
+    volatile uint8_t batch_index;
+    volatile bool batch_reading;   // false: register address phase, true: data phase
+    uint8_t batch_reg;             // TX byte of the current op (must outlive the transfer)
+    ra_i2c_batch_done_t batch_done;
+    void *batch_done_arg;
 } ra_i2c_obj_t;
 
 // Forward declaration of I2C type
 extern const mp_obj_type_t ra_i2c_type;
 
+// Start a batch of register reads; safe to call from interrupt context.
+// `ops` must stay valid until `done` has been called.
+fsp_err_t ra_i2c_batch_start(ra_i2c_obj_t *self, const ra_i2c_batch_op_t *ops, size_t n_ops,
+                             ra_i2c_batch_done_t done, void *arg);
+
 #endif // MICROPY_INCLUDED_RA8D1_MACHINE_I2C_H
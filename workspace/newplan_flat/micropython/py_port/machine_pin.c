@@ -11,11 +11,12 @@
 #include "bsp_api.h"  // 已包含 bsp_irq.h 和 R_ICU 寄存器定义
 #include "r_ioport_api.h"
 #include "r_ioport.h"  // 需要包含此头文件以使用 IOPORT_CFG_NMOS_ENABLE
+#include "py/gc.h"
+#include "py/mptrace.h"
 #include "r_external_irq_api.h"  // FSP External IRQ API
-#include "r_icu.h"  // 包含 ICU_OPEN 定义和 icu_instance_ctrl_t
-#include "common_data.h"  // 包含 g_external_irq_s2 定义
-#include "vector_data.h"  // 包含 ICU_IRQ12_IRQn 定义
+#include "common_data.h"  // 包含 external_irq_callback 声明（g_external_irq_s2 的回调）
 #include "machine_pin.h"
+#include "ra_irq.h"
  
  // 定义 STATIC 宏
  #ifndef STATIC
@@ -30,6 +31,9 @@ struct _pin_irq_context_t {
     mp_obj_t handler;              // Python 回调函数
     ra_pin_obj_t *pin_obj;         // 指向 Pin 对象
     mp_int_t trigger;              // 触发模式：IRQ_RISING 或 IRQ_FALLING
+    bool hard;                     // true：在 ISR 中直接调用 handler（GC 锁定），否则经调度器
+    ra_pin_irq_c_handler_t c_handler;  // C 级回调（非 NULL 时优先于 handler，在 ISR 中直接调用）
+    void *c_arg;                   // C 级回调参数
 };
  
  // ========== 引脚 ID 验证辅助函数 ========== 
@@ -110,6 +114,13 @@ struct _pin_irq_context_t {
      return false;
  }
  
+ uint16_t ra_pin_port_valid_mask(uint32_t port) {
+     if (port >= VALID_PIN_MASK_ARRAY_SIZE) {
+         return 0;
+     }
+     return valid_pin_mask_per_port[port];
+ }
+
  // 将 Python 传入的 id 转换为 bsp_io_port_pin_t
  static bsp_io_port_pin_t pin_id_from_python(mp_obj_t id_in) {
      mp_int_t id = mp_obj_get_int(id_in);
@@ -133,48 +144,81 @@ typedef struct _pin_irq_map_t {
     uint8_t icu_channel;       // 对应的 ICU 通道 (0-15)
 } pin_irq_map_t;
 
-// 引脚中断映射表
-// 根据 RA8D1 硬件特性配置常用引脚映射
-// 注意：需要确保对应的 FSP External IRQ 实例已配置
+// 引脚中断映射表：RA8D1 224-pin BGA 上所有带 IRQn 复用功能的引脚
+// （来自 FSP 引脚配置的功能列表，见 ra_cfg.txt；-DS 表示该引脚可在 Deep Software Standby 下唤醒）
+// 引脚与 ICU 通道的对应关系由硬件固定，多个引脚可能共用同一个通道，但同一时间只能有一个生效
 static const pin_irq_map_t pin_irq_map[] = {
-    // 当前支持的映射：P008 -> ICU Channel 12
-    {BSP_IO_PORT_00_PIN_08, 12},
-
-    // 示例扩展映射（需要对应的 FSP External IRQ 实例）
-    // 以下是常见的中断引脚示例，根据实际硬件配置启用：
-    // {BSP_IO_PORT_01_PIN_05, 0},   // P105 -> ICU Channel 0 (示例)
-    // {BSP_IO_PORT_04_PIN_00, 1},   // P400 -> ICU Channel 1 (示例)
-    // {BSP_IO_PORT_02_PIN_03, 2},   // P203 -> ICU Channel 2 (示例)
-
-    // TODO: 根据实际硬件添加更多映射
-    // 需要在 FSP 配置中添加对应的 External IRQ Stack
+    {BSP_IO_PORT_00_PIN_00,  6},   // P000 -> IRQ6-DS
+    {BSP_IO_PORT_00_PIN_01,  7},   // P001 -> IRQ7-DS
+    {BSP_IO_PORT_00_PIN_02,  8},   // P002 -> IRQ8-DS
+    {BSP_IO_PORT_00_PIN_04,  9},   // P004 -> IRQ9-DS
+    {BSP_IO_PORT_00_PIN_05, 10},   // P005 -> IRQ10-DS
+    {BSP_IO_PORT_00_PIN_06, 11},   // P006 -> IRQ11-DS
+    {BSP_IO_PORT_00_PIN_08, 12},   // P008 -> IRQ12-DS
+    {BSP_IO_PORT_00_PIN_09, 13},   // P009 -> IRQ13-DS
+    {BSP_IO_PORT_00_PIN_10, 14},   // P010 -> IRQ14
+    {BSP_IO_PORT_00_PIN_15, 13},   // P015 -> IRQ13
+    {BSP_IO_PORT_01_PIN_00,  2},   // P100 -> IRQ2
+    {BSP_IO_PORT_01_PIN_01,  1},   // P101 -> IRQ1
+    {BSP_IO_PORT_01_PIN_04,  1},   // P104 -> IRQ1
+    {BSP_IO_PORT_01_PIN_05,  0},   // P105 -> IRQ0
+    {BSP_IO_PORT_02_PIN_06,  0},   // P206 -> IRQ0-DS
+    {BSP_IO_PORT_02_PIN_08,  3},   // P208 -> IRQ3
+    {BSP_IO_PORT_02_PIN_12,  3},   // P212 -> IRQ3
+    {BSP_IO_PORT_02_PIN_13,  2},   // P213 -> IRQ2
+    {BSP_IO_PORT_03_PIN_00,  4},   // P300 -> IRQ4
+    {BSP_IO_PORT_03_PIN_01,  6},   // P301 -> IRQ6
+    {BSP_IO_PORT_03_PIN_02,  5},   // P302 -> IRQ5
+    {BSP_IO_PORT_03_PIN_04,  9},   // P304 -> IRQ9
+    {BSP_IO_PORT_03_PIN_05,  8},   // P305 -> IRQ8
+    {BSP_IO_PORT_04_PIN_00,  0},   // P400 -> IRQ0
+    {BSP_IO_PORT_04_PIN_01,  5},   // P401 -> IRQ5-DS
+    {BSP_IO_PORT_04_PIN_02,  4},   // P402 -> IRQ4-DS
+    {BSP_IO_PORT_04_PIN_03, 14},   // P403 -> IRQ14-DS
+    {BSP_IO_PORT_04_PIN_04, 15},   // P404 -> IRQ15-DS
+    {BSP_IO_PORT_04_PIN_08,  7},   // P408 -> IRQ7
+    {BSP_IO_PORT_04_PIN_09,  6},   // P409 -> IRQ6
+    {BSP_IO_PORT_04_PIN_10,  5},   // P410 -> IRQ5
+    {BSP_IO_PORT_04_PIN_11,  4},   // P411 -> IRQ4
+    {BSP_IO_PORT_04_PIN_14,  9},   // P414 -> IRQ9
+    {BSP_IO_PORT_04_PIN_15,  8},   // P415 -> IRQ8
+    {BSP_IO_PORT_05_PIN_08,  1},   // P508 -> IRQ1
+    {BSP_IO_PORT_05_PIN_09,  2},   // P509 -> IRQ2
+    {BSP_IO_PORT_05_PIN_10,  3},   // P510 -> IRQ3
+    {BSP_IO_PORT_05_PIN_11, 15},   // P511 -> IRQ15
+    {BSP_IO_PORT_05_PIN_12, 14},   // P512 -> IRQ14
+    {BSP_IO_PORT_06_PIN_15,  7},   // P615 -> IRQ7
+    {BSP_IO_PORT_07_PIN_06,  7},   // P706 -> IRQ7
+    {BSP_IO_PORT_07_PIN_07,  8},   // P707 -> IRQ8
+    {BSP_IO_PORT_07_PIN_08, 11},   // P708 -> IRQ11
+    {BSP_IO_PORT_07_PIN_09, 10},   // P709 -> IRQ10
+    {BSP_IO_PORT_08_PIN_00, 11},   // P800 -> IRQ11
+    {BSP_IO_PORT_08_PIN_01, 12},   // P801 -> IRQ12
+    {BSP_IO_PORT_08_PIN_04, 14},   // P804 -> IRQ14
+    {BSP_IO_PORT_08_PIN_06,  0},   // P806 -> IRQ0
+    {BSP_IO_PORT_08_PIN_08, 15},   // P808 -> IRQ15
+    {BSP_IO_PORT_09_PIN_05,  8},   // P905 -> IRQ8
+    {BSP_IO_PORT_09_PIN_06,  9},   // P906 -> IRQ9
+    {BSP_IO_PORT_09_PIN_07, 10},   // P907 -> IRQ10
+    {BSP_IO_PORT_09_PIN_08, 11},   // P908 -> IRQ11
+    {BSP_IO_PORT_10_PIN_08,  6},   // PA08 -> IRQ6
+    {BSP_IO_PORT_10_PIN_09,  5},   // PA09 -> IRQ5
+    {BSP_IO_PORT_10_PIN_10,  4},   // PA10 -> IRQ4
 };
 
 // 获取映射表大小
 #define PIN_IRQ_MAP_SIZE (sizeof(pin_irq_map) / sizeof(pin_irq_map_t))
 
-// FSP External IRQ 实例数组
-// 索引严格对应 ICU Channel 编号 (0-15)
-// 注意：目前只定义了 g_external_irq_s2 (配置为 ICU Channel 12)
-// 其他实例需要通过 FSP 配置生成或手动定义
-static const external_irq_instance_t * const m_irq_instances[16] = {
-    NULL,  // ICU Channel 0
-    NULL,  // ICU Channel 1
-    NULL,  // ICU Channel 2
-    NULL,  // ICU Channel 3
-    NULL,  // ICU Channel 4
-    NULL,  // ICU Channel 5
-    NULL,  // ICU Channel 6
-    NULL,  // ICU Channel 7
-    NULL,  // ICU Channel 8
-    NULL,  // ICU Channel 9
-    NULL,  // ICU Channel 10
-    NULL,  // ICU Channel 11
-    &g_external_irq_s2,  // ICU Channel 12
-    NULL,  // ICU Channel 13
-    NULL,  // ICU Channel 14
-    NULL,  // ICU Channel 15
-};
+#define PIN_IRQ_NUM_CHANNELS   (16)
+
+// 外部引脚中断优先级（与 FSP 配置的 g_external_irq_s2 相同）
+#define PIN_IRQ_PRIORITY       (12)
+
+// 每个 ICU 通道占用的 NVIC 槽位（通过 ra_irq 运行时分配，不需要 FSP 生成的 External IRQ 实例）
+static IRQn_Type pin_irq_slot[PIN_IRQ_NUM_CHANNELS] = { [0 ... PIN_IRQ_NUM_CHANNELS - 1] = RA_IRQ_INVALID };
+
+// 每个 ICU 通道当前生效的中断上下文；ISR 会访问它，所以登记为 root pointer 防止被 GC 回收
+MP_REGISTER_ROOT_POINTER(void *machine_pin_irq_ctx[16]);
 
 // Pin ID 到 ICU 通道的映射
 static int pin_id_to_icu_channel(bsp_io_port_pin_t pin_id) {
@@ -189,42 +233,72 @@ static int pin_id_to_icu_channel(bsp_io_port_pin_t pin_id) {
     return -1;
 }
 
-// 获取 External IRQ 实例
-static const external_irq_instance_t *pin_id_to_external_irq_instance(bsp_io_port_pin_t pin_id) {
-    // 先找到对应的 ICU 通道号
-    int channel = pin_id_to_icu_channel(pin_id);
-    if (channel == -1) {
-        return NULL;
+// ========== 中断处理函数 ==========
+
+// 执行一次引脚中断：C 级回调 > hard 回调 > 调度器
+static void pin_irq_dispatch(pin_irq_context_t *ctx) {
+    if (ctx == NULL) {
+        return;
+    }
+
+    if (ctx->c_handler != NULL) {
+        // 驱动内部的 C 级回调：直接在中断上下文中执行
+        ctx->c_handler(ctx->c_arg);
+        return;
     }
 
-    // 从实例数组中获取对应的 FSP 实例
-    // ICU Channel 直接作为数组索引
-    if (channel >= 0 && channel < 16) {
-        return m_irq_instances[channel];
+    if (ctx->handler == MP_OBJ_NULL) {
+        return;
     }
 
-    return NULL;
+    if (ctx->hard) {
+        // hard=True：在 ISR 中直接调用 Python 函数
+        // 锁住 GC 和调度器，handler 中分配内存会抛出 MemoryError
+        mp_sched_lock();
+        gc_lock();
+        #if MICROPY_GC_INCREMENTAL
+        // handler 不分配内存也能改写对象间的引用：作废进行中的增量标记
+        gc_inc_note_mutation();
+        #endif
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            mp_call_function_1(ctx->handler, MP_OBJ_FROM_PTR(ctx->pin_obj));
+            nlr_pop();
+        } else {
+            // 未捕获的异常：禁用该 handler，避免每个边沿都重复报错
+            ctx->handler = MP_OBJ_NULL;
+            mp_printf(MICROPY_ERROR_PRINTER, "Uncaught exception in IRQ callback handler\n");
+            mp_obj_print_exception(MICROPY_ERROR_PRINTER, MP_OBJ_FROM_PTR(nlr.ret_val));
+        }
+        gc_unlock();
+        mp_sched_unlock();
+        return;
+    }
+
+    // 默认使用调度器，不在中断上下文中直接调用 Python 函数
+    // 引脚中断走高优先级队列，先于普通回调（定时器等）执行
+    #if MICROPY_ENABLE_SCHEDULER
+    mp_sched_schedule_prio(ctx->handler, MP_OBJ_FROM_PTR(ctx->pin_obj), MP_SCHED_PRIO_HIGH);
+    // 注意：这里我们不检查返回值，队列满时由 micropython.schedule_stats() 的溢出计数反映
+    #endif
 }
 
-// ========== 中断处理函数 ==========
+// ICU IRQn 中断服务函数（由 ra_irq 安装到 RAM 向量表）
+static void pin_irq_isr(void) {
+    IRQn_Type irq = R_FSP_CurrentIrqGet();
+    MP_TRACE_EVENT(MP_TRACE_ISR_PIN, irq);
+
+    // 边沿触发：先清除 IR 标志，handler 执行期间的新边沿会再次挂起
+    R_BSP_IrqStatusClear(irq);
+
+    pin_irq_dispatch((pin_irq_context_t *)ra_irq_context_get(irq));
+}
 
 // FSP External IRQ 回调函数
-// 这个函数会被 FSP 的 r_icu_isr 调用
+// 仍被 FSP 生成的 g_external_irq_s2 配置引用；引脚中断现在由 pin_irq_isr 处理
 void external_irq_callback(external_irq_callback_args_t *p_args) {
-    // 从回调参数中获取上下文
-    pin_irq_context_t *ctx = (pin_irq_context_t *)p_args->p_context;
-
-    if (ctx != NULL && ctx->handler != MP_OBJ_NULL) {
-        // 只使用调度器，不在中断上下文中直接调用 Python 函数
-        // 这可以避免栈溢出和内存管理问题
-        #if MICROPY_ENABLE_SCHEDULER
-        mp_sched_schedule(ctx->handler, MP_OBJ_FROM_PTR(ctx->pin_obj));
-        // 注意：这里我们不检查返回值，因为调度失败不应该导致系统崩溃
-        #else
-        // 如果没有调度器，我们简单地忽略中断
-        // 在中断上下文中调用 Python 是非常危险的
-        #endif
-    }
+    MP_TRACE_EVENT(MP_TRACE_ISR_PIN, R_FSP_CurrentIrqGet());
+    pin_irq_dispatch((pin_irq_context_t *)p_args->p_context);
 }
 
 // ========== 引脚配置辅助函数 ==========
@@ -326,6 +400,8 @@ static void pin_configure(ra_pin_obj_t *self) {
     self->mode = mode;
     self->pull = pull;
     self->irq_ctx = NULL;  // 初始化为无中断配置
+    self->port = ra_port_regs(pin_id >> 8);
+    self->mask = (uint16_t)(1U << (pin_id & 0xFF));
     
     // 配置引脚
     pin_configure(self);
@@ -335,47 +411,25 @@ static void pin_configure(ra_pin_obj_t *self) {
  
  /// \method value([val])
  /// 获取或设置引脚电平
+ ///
+ /// 快速路径：直接访问缓存的端口寄存器，读 PCNTR2.PIDR，写 PCNTR3 的 POSR/PORR。
+ /// POSR/PORR 只影响写 1 的位，不需要读-改-写，也不会被中断打断而改到同端口的其他引脚。
+ ///
+ /// 对于开漏模式 (MP_PIN_MODE_OPEN_DRAIN)：
+ /// - 写入 HIGH (1): NMOS 关闭，引脚进入高阻态 (High-Z)，电平由上拉电阻或外部电路决定
+ /// - 写入 LOW (0): NMOS 导通，引脚被拉低到 GND
+ /// PmnPFS 中 NCODR 已由 pin_configure 设置（IOPORT_CFG_NMOS_ENABLE），PMOS 始终禁用。
  static mp_obj_t pin_obj_value(size_t n_args, const mp_obj_t *args) {
      ra_pin_obj_t *self = MP_OBJ_TO_PTR(args[0]);
-     
+
      if (n_args == 1) {
          // 读取引脚状态
-         bsp_io_level_t level;
-         fsp_err_t err = R_IOPORT_PinRead(&g_ioport_ctrl, self->pin_id, &level);
-         if (err != FSP_SUCCESS) {
-             mp_raise_msg_varg(&mp_type_RuntimeError,
-                              MP_ERROR_TEXT("Failed to read pin: 0x%04X"),
-                              (unsigned int)self->pin_id);
-         }
-         return mp_obj_new_int((mp_int_t)level);
-    } else {
-        // 设置引脚状态
-        mp_int_t val = mp_obj_is_true(args[1]);
-        bsp_io_level_t level = val ? BSP_IO_LEVEL_HIGH : BSP_IO_LEVEL_LOW;
-        
-        // 写入引脚电平
-        // 
-        // 对于开漏模式 (MP_PIN_MODE_OPEN_DRAIN) 的处理：
-        // - 写入 HIGH (1): FSP 硬件自动关闭 NMOS 驱动，引脚进入高阻态 (High-Z)
-        //   此时引脚电平由外部上拉电阻（如果配置了 IOPORT_CFG_PULLUP_ENABLE）或外部电路决定
-        //   这是符合 MicroPython 开漏输出语义的正确行为：输出"高"对应高阻态
-        // - 写入 LOW (0): FSP 硬件使能 NMOS 驱动，引脚被拉低到 GND
-        //
-        // 注意：FSP 的 R_IOPORT_PinWrite 在引脚配置为开漏模式时，会根据写入的电平值
-        // 自动控制 NMOS 的开关状态，无需额外的 API 调用。PMOS 在开漏模式下始终禁用
-        // （由 pin_configure 中的 IOPORT_CFG_NMOS_ENABLE 配置保证）。
-        //
-        // 对于推挽输出模式 (MP_PIN_MODE_OUT)：
-        // - 写入 HIGH (1): 引脚输出高电平（通过 PMOS）
-        // - 写入 LOW (0): 引脚输出低电平（通过 NMOS）
-        fsp_err_t err = R_IOPORT_PinWrite(&g_ioport_ctrl, self->pin_id, level);
-        if (err != FSP_SUCCESS) {
-            mp_raise_msg_varg(&mp_type_RuntimeError,
-                             MP_ERROR_TEXT("Failed to write pin: 0x%04X"),
-                             (unsigned int)self->pin_id);
-        }
-        return mp_const_none;
-    }
+         return MP_OBJ_NEW_SMALL_INT(ra_pin_fast_read(self));
+     }
+
+     // 设置引脚状态
+     ra_pin_fast_write(self, mp_obj_is_true(args[1]));
+     return mp_const_none;
  }
  static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(pin_obj_value_obj, 1, 2, pin_obj_value);
  
@@ -383,18 +437,7 @@ static void pin_configure(ra_pin_obj_t *self) {
 /// 设置引脚为高电平
 /// 在开漏模式下，这将使引脚进入高阻态（High-Z），需要上拉电阻才能呈现高电平
 static mp_obj_t pin_obj_on(mp_obj_t self_in) {
-    ra_pin_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    bsp_io_level_t level = BSP_IO_LEVEL_HIGH;
-    
-    // 写入高电平
-    // 对于开漏模式：FSP 硬件自动关闭 NMOS，引脚进入高阻态
-    // 对于推挽模式：FSP 硬件使能 PMOS，引脚输出高电平
-    fsp_err_t err = R_IOPORT_PinWrite(&g_ioport_ctrl, self->pin_id, level);
-    if (err != FSP_SUCCESS) {
-        mp_raise_msg_varg(&mp_type_RuntimeError,
-                         MP_ERROR_TEXT("Failed to write pin: 0x%04X"),
-                         (unsigned int)self->pin_id);
-    }
+    ra_pin_fast_write(MP_OBJ_TO_PTR(self_in), 1);
     return mp_const_none;
 }
  static MP_DEFINE_CONST_FUN_OBJ_1(pin_obj_on_obj, pin_obj_on);
@@ -403,41 +446,140 @@ static mp_obj_t pin_obj_on(mp_obj_t self_in) {
  /// 设置引脚为低电平
  /// 在开漏模式下，这将使能 NMOS 驱动，将引脚拉低到 GND
  static mp_obj_t pin_obj_off(mp_obj_t self_in) {
-     ra_pin_obj_t *self = MP_OBJ_TO_PTR(self_in);
-     bsp_io_level_t level = BSP_IO_LEVEL_LOW;
-     
-     // 写入低电平
-     // 对于开漏模式：FSP 硬件使能 NMOS，引脚被拉低到 GND
-     // 对于推挽模式：FSP 硬件使能 NMOS，引脚输出低电平
-     fsp_err_t err = R_IOPORT_PinWrite(&g_ioport_ctrl, self->pin_id, level);
-     if (err != FSP_SUCCESS) {
-         mp_raise_msg_varg(&mp_type_RuntimeError,
-                          MP_ERROR_TEXT("Failed to write pin: 0x%04X"),
-                          (unsigned int)self->pin_id);
-     }
+     ra_pin_fast_write(MP_OBJ_TO_PTR(self_in), 0);
      return mp_const_none;
  }
  static MP_DEFINE_CONST_FUN_OBJ_1(pin_obj_off_obj, pin_obj_off);
  
-// 修改 machine_pin.c 中的 pin_obj_irq 函数
+// ========== 中断配置 ==========
 
+// 关闭 ICU 通道：释放 NVIC 槽位并解除上下文
+static void pin_irq_channel_disable(int channel) {
+    if (pin_irq_slot[channel] != RA_IRQ_INVALID) {
+        ra_irq_free(pin_irq_slot[channel]);
+        pin_irq_slot[channel] = RA_IRQ_INVALID;
+    }
+    MP_STATE_PORT(machine_pin_irq_ctx)[channel] = NULL;
+}
+
+// 按 trigger 配置引脚对应的 ICU 通道，回调上下文为 self->irq_ctx
+static void pin_irq_enable(ra_pin_obj_t *self, int channel, mp_int_t trigger) {
+    // 配置引脚为 IRQ 模式 (设置 ISEL 位)
+    uint32_t pin_cfg = IOPORT_CFG_PORT_DIRECTION_INPUT | IOPORT_CFG_IRQ_ENABLE;
+    if (self->pull == MP_PIN_PULL_UP) pin_cfg |= IOPORT_CFG_PULLUP_ENABLE;
+
+    // 调用 FSP API 配置引脚
+    R_IOPORT_PinCfg(&g_ioport_ctrl, self->pin_id, pin_cfg);
 
-// [修复] micropython/py_port/machine_pin.c 中的 pin_obj_irq 函数
+    // 重新配置已启用的通道时先屏蔽，修改 IRQCR 可能产生误触发
+    if (pin_irq_slot[channel] != RA_IRQ_INVALID) {
+        NVIC_DisableIRQ(pin_irq_slot[channel]);
+    }
 
+    // 检测方式：IRQMD = 0 下降沿，1 上升沿，2 双边沿；不使用数字滤波以获得最小延迟
+    uint8_t irqmd;
+    if (trigger == MP_PIN_IRQ_RISING) {
+        irqmd = EXTERNAL_IRQ_TRIG_RISING;
+    } else if (trigger == MP_PIN_IRQ_FALLING) {
+        irqmd = EXTERNAL_IRQ_TRIG_FALLING;
+    } else {
+        irqmd = EXTERNAL_IRQ_TRIG_BOTH_EDGE;
+    }
+    R_ICU->IRQCR[channel] = (uint8_t)(irqmd << R_ICU_IRQCR_IRQMD_Pos);
+
+    MP_STATE_PORT(machine_pin_irq_ctx)[channel] = self->irq_ctx;
+
+    if (pin_irq_slot[channel] == RA_IRQ_INVALID) {
+        pin_irq_slot[channel] = ra_irq_alloc((elc_event_t)(ELC_EVENT_ICU_IRQ0 + channel),
+                                             pin_irq_isr, PIN_IRQ_PRIORITY, self->irq_ctx);
+        if (pin_irq_slot[channel] == RA_IRQ_INVALID) {
+            MP_STATE_PORT(machine_pin_irq_ctx)[channel] = NULL;
+            mp_raise_msg_varg(&mp_type_OSError, MP_ERROR_TEXT("no free interrupt slot for IRQ%d"), channel);
+        }
+    } else {
+        // 通道已由本引脚占用：只更新上下文并清除修改 IRQCR 期间可能产生的误触发
+        ra_irq_set_context(pin_irq_slot[channel], self->irq_ctx);
+        R_BSP_IrqStatusClear(pin_irq_slot[channel]);
+        NVIC_ClearPendingIRQ(pin_irq_slot[channel]);
+        NVIC_EnableIRQ(pin_irq_slot[channel]);
+    }
+}
+
+// 获取引脚的 ICU 通道，不支持中断或通道被其他引脚占用时抛出异常
+static int pin_irq_channel_or_raise(ra_pin_obj_t *self) {
+    int channel = pin_id_to_icu_channel(self->pin_id);
+    if (channel < 0) {
+        mp_raise_msg_varg(&mp_type_ValueError,
+                         MP_ERROR_TEXT("Pin 0x%04X does not support interrupts (no IRQ mapping found)"),
+                         (unsigned int)self->pin_id);
+    }
+
+    pin_irq_context_t *owner = MP_STATE_PORT(machine_pin_irq_ctx)[channel];
+    if (owner != NULL && owner->pin_obj->pin_id != self->pin_id) {
+        mp_raise_msg_varg(&mp_type_OSError,
+                         MP_ERROR_TEXT("IRQ%d already in use by Pin 0x%04X"),
+                         channel, (unsigned int)owner->pin_obj->pin_id);
+    }
+    return channel;
+}
+
+// 释放引脚的中断上下文（不改变通道状态）
+static void pin_irq_ctx_free(ra_pin_obj_t *self) {
+    if (self->irq_ctx != NULL) {
+        m_del(pin_irq_context_t, self->irq_ctx, 1);
+        self->irq_ctx = NULL;
+    }
+}
+
+void ra_pin_irq_set_c_handler(ra_pin_obj_t *self, mp_int_t trigger,
+                              ra_pin_irq_c_handler_t handler, void *arg) {
+    int channel = pin_irq_channel_or_raise(self);
+
+    if (handler == NULL) {
+        pin_irq_channel_disable(channel);
+        pin_irq_ctx_free(self);
+        return;
+    }
+
+    if (self->irq_ctx == NULL) {
+        self->irq_ctx = m_new(pin_irq_context_t, 1);
+    }
+    self->irq_ctx->handler = MP_OBJ_NULL;
+    self->irq_ctx->pin_obj = self;
+    self->irq_ctx->trigger = trigger;
+    self->irq_ctx->hard = false;
+    self->irq_ctx->c_handler = handler;
+    self->irq_ctx->c_arg = arg;
+
+    pin_irq_enable(self, channel, trigger);
+}
+
+void machine_pin_irq_deinit_all(void) {
+    for (int channel = 0; channel < PIN_IRQ_NUM_CHANNELS; channel++) {
+        pin_irq_channel_disable(channel);
+    }
+}
+
+/// \method irq(handler=None, trigger=IRQ_RISING, *, hard=False)
+/// 配置引脚中断
+///   - `handler`: 回调函数，参数为 Pin 对象；None 表示关闭中断
+///   - `trigger`: IRQ_RISING、IRQ_FALLING 或两者相或（双边沿）
+///   - `hard`: True 时 handler 直接在中断上下文中运行（GC 锁定，不能分配内存），
+///     延迟在微秒以内；False 时经 micropython.schedule 延后执行
 static mp_obj_t pin_obj_irq(size_t n_args, const mp_obj_t *args, mp_map_t *kwargs) {
     ra_pin_obj_t *self = MP_OBJ_TO_PTR(args[0]);
     
-    // ========== 1. 参数解析 (绝对不能少!) ==========
-    enum { ARG_handler, ARG_trigger };
+    // ========== 1. 参数解析 ==========
+    enum { ARG_handler, ARG_trigger, ARG_hard };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_handler, MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
         { MP_QSTR_trigger, MP_ARG_INT, {.u_int = MP_PIN_IRQ_RISING} },
+        { MP_QSTR_hard, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false} },
     };
     
     mp_arg_val_t vals[MP_ARRAY_SIZE(allowed_args)];
     mp_arg_parse_all(n_args - 1, args + 1, kwargs, MP_ARRAY_SIZE(allowed_args), allowed_args, vals);
     
-    // 获取解析出的变量 (之前报错就是因为缺少这两行)
     mp_obj_t handler = vals[ARG_handler].u_obj;
     mp_int_t trigger = vals[ARG_trigger].u_int;
     
@@ -446,18 +588,10 @@ static mp_obj_t pin_obj_irq(size_t n_args, const mp_obj_t *args, mp_map_t *kwarg
         mp_raise_ValueError(MP_ERROR_TEXT("trigger must be IRQ_RISING or IRQ_FALLING"));
     }
 
-    // ========== 2. 获取硬件实例 ==========
-    const external_irq_instance_t *p_irq_instance = pin_id_to_external_irq_instance(self->pin_id);
-    if (!p_irq_instance) {
-        mp_raise_msg_varg(&mp_type_ValueError,
-                         MP_ERROR_TEXT("Pin 0x%04X does not support interrupts (no IRQ mapping found)"),
-                         (unsigned int)self->pin_id);
-    }
+    // ========== 2. 获取 ICU 通道 ==========
+    int channel = pin_irq_channel_or_raise(self);
 
     // ========== 3. 配置逻辑 ==========
-    
-    // 总是先关闭 IRQ 实例，以便重新配置
-    p_irq_instance->p_api->close(p_irq_instance->p_ctrl);
 
     // 处理 Handler 和 Context
     if (handler != MP_OBJ_NULL && handler != mp_const_none) {
@@ -472,56 +606,21 @@ static mp_obj_t pin_obj_irq(size_t n_args, const mp_obj_t *args, mp_map_t *kwarg
         self->irq_ctx->handler = handler;
         self->irq_ctx->pin_obj = self;
         self->irq_ctx->trigger = trigger;
+        self->irq_ctx->hard = vals[ARG_hard].u_bool;
+        self->irq_ctx->c_handler = NULL;
+        self->irq_ctx->c_arg = NULL;
     } else {
-        // 如果 handler 为 None，说明是禁用中断，直接返回即可（因为前面已经 Close 了）
-        if (self->irq_ctx != NULL) {
-             m_del(pin_irq_context_t, self->irq_ctx, 1);
-             self->irq_ctx = NULL;
-        }
+        // 如果 handler 为 None，说明是禁用中断
+        pin_irq_channel_disable(channel);
+        pin_irq_ctx_free(self);
         return mp_const_none;
     }
 
-    // 配置引脚为 IRQ 模式 (设置 ISEL 位)
-    // 必须在 Open 之前做
-    uint32_t pin_cfg = IOPORT_CFG_PORT_DIRECTION_INPUT | IOPORT_CFG_IRQ_ENABLE;
-    if (self->pull == MP_PIN_PULL_UP) pin_cfg |= IOPORT_CFG_PULLUP_ENABLE;
-    
-    // 调用 FSP API 配置引脚
-    R_IOPORT_PinCfg(&g_ioport_ctrl, self->pin_id, pin_cfg);
-
-    // ========== 4. 创建 Shadow Config 并 Open ==========
-    
-    // 复制 const 配置到临时变量
-    external_irq_cfg_t irq_cfg_shadow = *(p_irq_instance->p_cfg); 
-    
-    // 修改 Trigger
-    if (trigger == MP_PIN_IRQ_RISING) {
-        irq_cfg_shadow.trigger = EXTERNAL_IRQ_TRIG_RISING;
-    } else if (trigger == MP_PIN_IRQ_FALLING) {
-        irq_cfg_shadow.trigger = EXTERNAL_IRQ_TRIG_FALLING;
-    } else {
-        irq_cfg_shadow.trigger = EXTERNAL_IRQ_TRIG_BOTH_EDGE; 
-    }
-
-    // 绑定回调函数
-    irq_cfg_shadow.p_callback = external_irq_callback;
-    irq_cfg_shadow.p_context = self->irq_ctx;
-
-    // 使用新配置重新 Open
-    fsp_err_t err = p_irq_instance->p_api->open(p_irq_instance->p_ctrl, &irq_cfg_shadow);
-    
-    if (err != FSP_SUCCESS) {
-         mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("IRQ Open failed: %d"), err);
-    }
-
-    // 启用中断
-    p_irq_instance->p_api->enable(p_irq_instance->p_ctrl);
+    // ========== 4. 配置引脚和 ICU 通道 ==========
+    pin_irq_enable(self, channel, trigger);
 
     return mp_const_none;
 }
-
-
-
  static MP_DEFINE_CONST_FUN_OBJ_KW(pin_obj_irq_obj, 0, pin_obj_irq);
  
 // Pin 类的方法字典
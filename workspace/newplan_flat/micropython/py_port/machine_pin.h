@@ -32,7 +32,41 @@ struct _ra_pin_obj_t {
     mp_int_t mode;                 // 模式：IN 或 OUT
     mp_int_t pull;                 // 上拉/下拉：PULL_NONE, PULL_UP, PULL_DOWN
     pin_irq_context_t *irq_ctx;    // 中断回调上下文（不完整类型，避免循环依赖）
+    R_PORT0_Type *port;            // 缓存的端口寄存器（PCNTR2 读、PCNTR3 置位/复位）
+    uint16_t mask;                 // 引脚在端口中的位掩码
 };
 typedef struct _ra_pin_obj_t ra_pin_obj_t;
 
+// 端口寄存器地址：R_PORT0 ~ R_PORT14 间隔 0x20
+static inline R_PORT0_Type *ra_port_regs(uint32_t port) {
+    return (R_PORT0_Type *)((uint32_t)R_PORT0 + ((uint32_t)R_PORT1 - (uint32_t)R_PORT0) * port);
+}
+
+// 快速 GPIO：直接读 PIDR、写 POSR/PORR，不经过 FSP 参数检查
+static inline uint32_t ra_pin_fast_read(const ra_pin_obj_t *self) {
+    return (self->port->PIDR & self->mask) != 0;
+}
+
+static inline void ra_pin_fast_write(const ra_pin_obj_t *self, uint32_t level) {
+    if (level) {
+        self->port->POSR = self->mask;
+    } else {
+        self->port->PORR = self->mask;
+    }
+}
+
+// 端口中有效引脚的位掩码（RA8D1 224-pin BGA），无效端口返回 0
+uint16_t ra_pin_port_valid_mask(uint32_t port);
+
+// C 级中断回调：在中断上下文中直接调用，不经过 mp_sched_schedule
+// 供驱动内部使用（如 machine.SensorStream），不能分配内存或调用 Python
+typedef void (*ra_pin_irq_c_handler_t)(void *arg);
+
+// 为引脚安装 C 级中断回调；handler 为 NULL 时关闭该引脚的中断
+void ra_pin_irq_set_c_handler(ra_pin_obj_t *self, mp_int_t trigger,
+                              ra_pin_irq_c_handler_t handler, void *arg);
+
+// 关闭所有 ICU 通道的引脚中断（软复位）
+void machine_pin_irq_deinit_all(void);
+
 #endif // MICROPY_INCLUDED_RA8D1_MACHINE_PIN_H
\ No newline at end of file
@@ -0,0 +1,175 @@
+/*
+ * machine_port.c - RA8D1 整端口 GPIO 读写（machine.Port）
+ *
+ * 一次调用读写同一端口的最多 16 个引脚：
+ *   - 读：PCNTR2.PIDR
+ *   - 写：PCNTR3 的一次 32 位写入同时完成置位 (POSR) 和复位 (PORR)，
+ *         所有被选中的引脚在同一个总线周期内改变，不需要读-改-写，可在中断中安全使用
+ */
+
+#include "py/runtime.h"
+#include "py/mphal.h"
+#include "hal_data.h"
+#include "bsp_api.h"
+#include "r_ioport.h"
+#include "machine_pin.h"
+#include "machine_port.h"
+
+typedef struct _ra_port_obj_t {
+    mp_obj_base_t base;
+    uint8_t port;             // 端口号 0 ~ 11（PA = 10, PB = 11）
+    uint16_t mask;            // 本对象管理的引脚
+    R_PORT0_Type *regs;       // 缓存的端口寄存器
+} ra_port_obj_t;
+
+static void port_obj_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
+    ra_port_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_printf(print, "Port(%u, mask=0x%04X)", self->port, self->mask);
+}
+
+// 按 mode/pull 配置 mask 中的每个引脚（与 Pin 的配置方式一致，仅在构造时执行）
+static void port_configure(ra_port_obj_t *self, mp_int_t mode, mp_int_t pull) {
+    uint32_t cfg;
+    if (mode == MP_PIN_MODE_OUT) {
+        cfg = IOPORT_CFG_PORT_DIRECTION_OUTPUT | IOPORT_CFG_PORT_OUTPUT_LOW;
+    } else if (mode == MP_PIN_MODE_OPEN_DRAIN) {
+        cfg = IOPORT_CFG_PORT_DIRECTION_OUTPUT | IOPORT_CFG_PORT_OUTPUT_LOW | IOPORT_CFG_NMOS_ENABLE;
+    } else {
+        cfg = IOPORT_CFG_PORT_DIRECTION_INPUT;
+    }
+    if (pull == MP_PIN_PULL_UP) {
+        cfg |= IOPORT_CFG_PULLUP_ENABLE;
+    }
+
+    for (uint32_t pin = 0; pin < 16; pin++) {
+        if (!(self->mask & (1U << pin))) {
+            continue;
+        }
+        bsp_io_port_pin_t pin_id = (bsp_io_port_pin_t)((self->port << 8) | pin);
+        fsp_err_t err = R_IOPORT_PinCfg(&g_ioport_ctrl, pin_id, cfg);
+        if (err != FSP_SUCCESS) {
+            mp_raise_msg_varg(&mp_type_RuntimeError,
+                             MP_ERROR_TEXT("Failed to configure pin: 0x%04X"),
+                             (unsigned int)pin_id);
+        }
+    }
+}
+
+/// \classmethod \constructor(port, mask=0xFFFF, mode=-1, pull=-1)
+/// 创建 Port 对象
+///   - `port`: 端口号 0 ~ 11（0x0A 表示 PA，0x0B 表示 PB）
+///   - `mask`: 要操作的引脚位掩码，默认该端口全部有效引脚
+///   - `mode`: Pin.IN, Pin.OUT 或 Pin.OPEN_DRAIN；不指定时保持引脚当前配置
+///   - `pull`: Pin.PULL_NONE 或 Pin.PULL_UP
+static mp_obj_t port_obj_make_new(const mp_obj_type_t *type, size_t n_args,
+                                  size_t n_kw, const mp_obj_t *args) {
+    enum { ARG_port, ARG_mask, ARG_mode, ARG_pull };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_port, MP_ARG_REQUIRED | MP_ARG_INT, {.u_int = -1} },
+        { MP_QSTR_mask, MP_ARG_INT, {.u_int = 0xFFFF} },
+        { MP_QSTR_mode, MP_ARG_INT, {.u_int = -1} },
+        { MP_QSTR_pull, MP_ARG_INT, {.u_int = -1} },
+    };
+
+    mp_arg_val_t vals[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, args, MP_ARRAY_SIZE(allowed_args), allowed_args, vals);
+
+    mp_int_t port = vals[ARG_port].u_int;
+    uint16_t valid = (port >= 0) ? ra_pin_port_valid_mask((uint32_t)port) : 0;
+    if (valid == 0) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("Invalid Port: %d"), (int)port);
+    }
+
+    mp_int_t mask = vals[ARG_mask].u_int;
+    if (mask <= 0 || mask > 0xFFFF) {
+        mp_raise_ValueError(MP_ERROR_TEXT("mask must be 1..0xFFFF"));
+    }
+
+    mp_int_t mode = vals[ARG_mode].u_int;
+    if (mode != -1 && mode != MP_PIN_MODE_IN && mode != MP_PIN_MODE_OUT && mode != MP_PIN_MODE_OPEN_DRAIN) {
+        mp_raise_ValueError(MP_ERROR_TEXT("mode must be Pin.IN, Pin.OUT, or Pin.OPEN_DRAIN"));
+    }
+
+    ra_port_obj_t *self = m_new_obj(ra_port_obj_t);
+    self->base.type = type;
+    self->port = (uint8_t)port;
+    self->mask = (uint16_t)mask & valid;     // 不存在的引脚直接忽略
+    self->regs = ra_port_regs((uint32_t)port);
+
+    if (mode != -1) {
+        port_configure(self, mode, vals[ARG_pull].u_int);
+    }
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+/// \method value([val])
+/// 读取端口输入电平（只返回 mask 中的位），或一次性写入 mask 中的所有引脚
+static mp_obj_t port_obj_value(size_t n_args, const mp_obj_t *args) {
+    ra_port_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+
+    if (n_args == 1) {
+        return MP_OBJ_NEW_SMALL_INT(self->regs->PIDR & self->mask);
+    }
+
+    uint32_t val = (uint32_t)mp_obj_get_int_truncated(args[1]);
+    uint32_t set = val & self->mask;
+    uint32_t reset = ~val & self->mask;
+    // 低 16 位 POSR、高 16 位 PORR：一次写入，所有引脚同时更新
+    self->regs->PCNTR3 = set | (reset << 16);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(port_obj_value_obj, 1, 2, port_obj_value);
+
+/// \method set(bits)
+/// 将 bits 中（且在 mask 内）的引脚置高，其他引脚不变
+static mp_obj_t port_obj_set(mp_obj_t self_in, mp_obj_t bits_in) {
+    ra_port_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    self->regs->POSR = (uint16_t)(mp_obj_get_int_truncated(bits_in) & self->mask);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(port_obj_set_obj, port_obj_set);
+
+/// \method reset(bits)
+/// 将 bits 中（且在 mask 内）的引脚置低，其他引脚不变
+static mp_obj_t port_obj_reset(mp_obj_t self_in, mp_obj_t bits_in) {
+    ra_port_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    self->regs->PORR = (uint16_t)(mp_obj_get_int_truncated(bits_in) & self->mask);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(port_obj_reset_obj, port_obj_reset);
+
+/// \method mask()
+/// 返回实际生效的引脚掩码（已去掉该端口不存在的引脚）
+static mp_obj_t port_obj_mask(mp_obj_t self_in) {
+    ra_port_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return MP_OBJ_NEW_SMALL_INT(self->mask);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(port_obj_mask_obj, port_obj_mask);
+
+/// \method addr()
+/// 端口寄存器基地址（PCNTR1），供 viper 代码直接访问：
+/// +4 为 PIDR (ptr16)，+8 为 POSR (ptr16)，+10 为 PORR (ptr16)
+static mp_obj_t port_obj_addr(mp_obj_t self_in) {
+    ra_port_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_int_from_uint((uintptr_t)self->regs);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(port_obj_addr_obj, port_obj_addr);
+
+static const mp_rom_map_elem_t port_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_value), MP_ROM_PTR(&port_obj_value_obj) },
+    { MP_ROM_QSTR(MP_QSTR_set), MP_ROM_PTR(&port_obj_set_obj) },
+    { MP_ROM_QSTR(MP_QSTR_reset), MP_ROM_PTR(&port_obj_reset_obj) },
+    { MP_ROM_QSTR(MP_QSTR_mask), MP_ROM_PTR(&port_obj_mask_obj) },
+    { MP_ROM_QSTR(MP_QSTR_addr), MP_ROM_PTR(&port_obj_addr_obj) },
+};
+static MP_DEFINE_CONST_DICT(port_locals_dict, port_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    ra_port_type,
+    MP_QSTR_Port,
+    MP_TYPE_FLAG_NONE,
+    make_new, port_obj_make_new,
+    print, port_obj_print,
+    locals_dict, &port_locals_dict
+);
@@ -0,0 +1,9 @@
+#ifndef MICROPY_INCLUDED_RA8D1_MACHINE_PORT_H
+#define MICROPY_INCLUDED_RA8D1_MACHINE_PORT_H
+
+#include "py/obj.h"
+
+// Forward declaration of Port type
+extern const mp_obj_type_t ra_port_type;
+
+#endif // MICROPY_INCLUDED_RA8D1_MACHINE_PORT_H
@@ -0,0 +1,396 @@
+/*
+ * machine_sensor_stream.c - IRQ driven sensor FIFO streaming for RA8D1
+ *
+ * A data-ready / FIFO-watermark pin interrupt starts a burst read on I2C
+ * (batch engine) or SPI directly from interrupt context. Each burst becomes
+ * one fixed-size record in a ring buffer:
+ *
+ *     [ticks_us (u32 LE)] [payload ...]
+ *
+ * Python only drains complete records in bulk with readinto(), so the sensor
+ * ODR is decoupled from VM latency.
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/mphal.h"
+#include "hal_data.h"
+#include "bsp_api.h"
+#include "machine_pin.h"
+#include "machine_i2c.h"
+#include "machine_spi.h"
+#include "machine_sensor_stream.h"
+
+// Define STATIC macro
+#ifndef STATIC
+#define STATIC static
+#endif
+
+typedef struct _ra_sensor_stream_obj_t {
+    mp_obj_base_t base;
+    mp_obj_t bus;                   // I2C or SPI object
+    ra_pin_obj_t *irq_pin;          // data-ready / watermark pin
+    ra_pin_obj_t *cs_pin;           // SPI chip select (NULL for I2C)
+    mp_int_t trigger;
+    bool is_spi;
+    bool running;
+
+    // Bus operations for one record
+    ra_i2c_batch_op_t *ops;         // I2C: dest is relative to the payload (offset)
+    ra_i2c_batch_op_t *ops_live;    // I2C: dest patched to the slot being filled
+    size_t n_ops;
+    uint8_t *spi_tx;                // SPI: command byte + dummy bytes
+
+    // Ring buffer of records
+    uint8_t *ring;
+    uint16_t record_size;           // MP_SENSOR_STREAM_TS_SIZE + payload
+    uint16_t payload_len;
+    uint32_t depth;                 // power of two, so free-running indices map continuously across 2^32
+    volatile uint32_t head;         // records published by the ISR (free running)
+    volatile uint32_t tail;         // records consumed by Python (free running)
+
+    // In-flight record
+    volatile bool busy;
+    uint32_t pending_ts;
+
+    // Statistics
+    volatile uint32_t n_records;
+    volatile uint32_t n_overrun;    // ring full, sample dropped
+    volatile uint32_t n_missed;     // IRQ while the previous burst was still running
+    volatile uint32_t n_errors;     // bus errors
+} ra_sensor_stream_obj_t;
+
+MP_REGISTER_ROOT_POINTER(void *machine_sensor_stream_active[MICROPY_HW_SENSOR_STREAM_MAX]);
+
+static inline uint8_t *stream_slot(ra_sensor_stream_obj_t *self, uint32_t index) {
+    return self->ring + (size_t)(index & (self->depth - 1)) * self->record_size;
+}
+
+// ========== Interrupt Side ==========
+
+// Record finished: stamp it and publish to the consumer
+static void stream_complete(ra_sensor_stream_obj_t *self, fsp_err_t result) {
+    if (self->cs_pin != NULL) {
+        R_IOPORT_PinWrite(&g_ioport_ctrl, self->cs_pin->pin_id, BSP_IO_LEVEL_HIGH);
+    }
+
+    if (result == FSP_SUCCESS) {
+        uint8_t *slot = stream_slot(self, self->head);
+        // For SPI the byte clocked in during the command overwrote slot[3]: write the stamp last
+        uint32_t ts = self->pending_ts;
+        slot[0] = (uint8_t)ts;
+        slot[1] = (uint8_t)(ts >> 8);
+        slot[2] = (uint8_t)(ts >> 16);
+        slot[3] = (uint8_t)(ts >> 24);
+        self->head = self->head + 1;
+        self->n_records++;
+    } else {
+        self->n_errors++;
+    }
+
+    self->busy = false;
+}
+
+static void stream_i2c_done(ra_i2c_obj_t *i2c, fsp_err_t result, void *arg) {
+    (void)i2c;
+    stream_complete((ra_sensor_stream_obj_t *)arg, result);
+}
+
+static void stream_spi_done(fsp_err_t result, void *arg) {
+    stream_complete((ra_sensor_stream_obj_t *)arg, result);
+}
+
+// Pin interrupt: start the burst read of one record
+static void stream_irq_handler(void *arg) {
+    ra_sensor_stream_obj_t *self = (ra_sensor_stream_obj_t *)arg;
+
+    if (!self->running) {
+        return;
+    }
+    if (self->busy) {
+        self->n_missed++;
+        return;
+    }
+    if (self->head - self->tail >= self->depth) {
+        self->n_overrun++;
+        return;
+    }
+
+    self->busy = true;
+    self->pending_ts = (uint32_t)mp_hal_ticks_us();
+
+    uint8_t *payload = stream_slot(self, self->head) + MP_SENSOR_STREAM_TS_SIZE;
+    fsp_err_t err;
+
+    if (self->is_spi) {
+        R_IOPORT_PinWrite(&g_ioport_ctrl, self->cs_pin->pin_id, BSP_IO_LEVEL_LOW);
+        // Receive starts one byte early so the command-phase byte lands in the stamp area
+        err = ra_spi_transfer_start(MP_OBJ_TO_PTR(self->bus), self->spi_tx, payload - 1,
+                                    (size_t)self->payload_len + 1, stream_spi_done, self);
+    } else {
+        for (size_t i = 0; i < self->n_ops; i++) {
+            self->ops_live[i] = self->ops[i];
+            self->ops_live[i].dest = payload + (uintptr_t)self->ops[i].dest;
+        }
+        err = ra_i2c_batch_start(MP_OBJ_TO_PTR(self->bus), self->ops_live, self->n_ops,
+                                 stream_i2c_done, self);
+    }
+
+    if (err != FSP_SUCCESS) {
+        stream_complete(self, err);
+    }
+}
+
+// ========== SensorStream Object Implementation ==========
+
+static void stream_stop(ra_sensor_stream_obj_t *self) {
+    if (!self->running) {
+        return;
+    }
+    ra_pin_irq_set_c_handler(self->irq_pin, self->trigger, NULL, NULL);
+    self->running = false;
+
+    // Let an in-flight burst finish before the buffers can be reused
+    uint32_t start_time = mp_hal_ticks_ms();
+    while (self->busy && (mp_hal_ticks_ms() - start_time) < 100) {
+        __WFI();
+    }
+    self->busy = false;
+
+    for (size_t i = 0; i < MICROPY_HW_SENSOR_STREAM_MAX; i++) {
+        if (MP_STATE_PORT(machine_sensor_stream_active)[i] == self) {
+            MP_STATE_PORT(machine_sensor_stream_active)[i] = NULL;
+        }
+    }
+}
+
+void machine_sensor_stream_deinit_all(void) {
+    for (size_t i = 0; i < MICROPY_HW_SENSOR_STREAM_MAX; i++) {
+        ra_sensor_stream_obj_t *self = MP_STATE_PORT(machine_sensor_stream_active)[i];
+        if (self != NULL) {
+            stream_stop(self);
+        }
+    }
+}
+
+static void sensor_stream_obj_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
+    ra_sensor_stream_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_printf(print, "SensorStream(%s, record_size=%u, depth=%u, running=%d)",
+              self->is_spi ? "SPI" : "I2C", self->record_size, (unsigned int)self->depth, self->running);
+}
+
+// Constructor: SensorStream(bus, pin, ops, *, depth=32, cs=None, trigger=Pin.IRQ_RISING)
+//   I2C: ops = [(addr, memaddr, nbytes, offset), ...]  (same format as I2C.readfrom_mem_batch)
+//   SPI: ops = [(cmd, nbytes)]; cmd is sent first (e.g. 0x80 | reg), nbytes are read after it
+static mp_obj_t sensor_stream_obj_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    enum { ARG_bus, ARG_pin, ARG_ops, ARG_depth, ARG_cs, ARG_trigger };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_bus, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_pin, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_ops, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_depth, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 32} },
+        { MP_QSTR_cs, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_trigger, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = MP_PIN_IRQ_RISING} },
+    };
+
+    mp_arg_val_t vals[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all_kw_array(n_args, n_kw, args, MP_ARRAY_SIZE(allowed_args), allowed_args, vals);
+
+    mp_obj_t bus = vals[ARG_bus].u_obj;
+    bool is_spi = mp_obj_is_type(bus, &ra_spi_type);
+    if (!is_spi && !mp_obj_is_type(bus, &ra_i2c_type)) {
+        mp_raise_TypeError(MP_ERROR_TEXT("bus must be machine.I2C or machine.SPI"));
+    }
+    if (!mp_obj_is_type(vals[ARG_pin].u_obj, &ra_pin_type)) {
+        mp_raise_TypeError(MP_ERROR_TEXT("pin must be machine.Pin"));
+    }
+    mp_int_t depth = vals[ARG_depth].u_int;
+    if (depth < 2 || (depth & (depth - 1)) != 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("depth must be a power of 2 >= 2"));
+    }
+
+    size_t n_ops;
+    mp_obj_t *items;
+    mp_obj_get_array(vals[ARG_ops].u_obj, &n_ops, &items);
+    if (n_ops == 0 || n_ops > MP_I2C_BATCH_MAX_OPS || (is_spi && n_ops != 1)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid number of ops"));
+    }
+
+    ra_sensor_stream_obj_t *self = m_new_obj(ra_sensor_stream_obj_t);
+    memset(self, 0, sizeof(*self));
+    self->base.type = type;
+    self->bus = bus;
+    self->irq_pin = MP_OBJ_TO_PTR(vals[ARG_pin].u_obj);
+    self->trigger = vals[ARG_trigger].u_int;
+    self->is_spi = is_spi;
+    self->depth = (uint32_t)depth;
+
+    size_t payload_len = 0;
+    if (is_spi) {
+        mp_obj_t *op;
+        mp_obj_get_array_fixed_n(items[0], 2, &op);
+        mp_int_t cmd = mp_obj_get_int(op[0]);
+        mp_int_t nbytes = mp_obj_get_int(op[1]);
+        if (nbytes <= 0 || nbytes > 0xFFFF - MP_SENSOR_STREAM_TS_SIZE) {
+            mp_raise_ValueError(MP_ERROR_TEXT("invalid burst length"));
+        }
+        if (!mp_obj_is_type(vals[ARG_cs].u_obj, &ra_pin_type)) {
+            mp_raise_ValueError(MP_ERROR_TEXT("SPI stream needs cs=Pin"));
+        }
+        self->cs_pin = MP_OBJ_TO_PTR(vals[ARG_cs].u_obj);
+        payload_len = (size_t)nbytes;
+        self->spi_tx = m_new0(uint8_t, payload_len + 1);
+        self->spi_tx[0] = (uint8_t)cmd;
+    } else {
+        self->ops = m_new(ra_i2c_batch_op_t, n_ops);
+        self->ops_live = m_new(ra_i2c_batch_op_t, n_ops);
+        self->n_ops = n_ops;
+        for (size_t i = 0; i < n_ops; i++) {
+            mp_obj_t *op;
+            mp_obj_get_array_fixed_n(items[i], 4, &op);
+            mp_int_t nbytes = mp_obj_get_int(op[2]);
+            mp_int_t offset = mp_obj_get_int(op[3]);
+            if (nbytes <= 0 || offset < 0 || offset + nbytes > 0xFFFF - MP_SENSOR_STREAM_TS_SIZE) {
+                mp_raise_ValueError(MP_ERROR_TEXT("invalid op"));
+            }
+            self->ops[i].addr = (uint8_t)mp_obj_get_int(op[0]);
+            self->ops[i].reg = (uint8_t)mp_obj_get_int(op[1]);
+            self->ops[i].len = (uint16_t)nbytes;
+            // Offset inside the payload, turned into a pointer when the record is filled
+            self->ops[i].dest = (uint8_t *)(uintptr_t)offset;
+            if ((size_t)(offset + nbytes) > payload_len) {
+                payload_len = (size_t)(offset + nbytes);
+            }
+        }
+    }
+
+    self->payload_len = (uint16_t)payload_len;
+    self->record_size = (uint16_t)(MP_SENSOR_STREAM_TS_SIZE + payload_len);
+    self->ring = m_new0(uint8_t, (size_t)self->record_size * self->depth);
+
+    return MP_OBJ_FROM_PTR(self);
+}
+
+// start() - clear the ring and arm the pin interrupt
+static mp_obj_t sensor_stream_obj_start(mp_obj_t self_in) {
+    ra_sensor_stream_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (self->running) {
+        return mp_const_none;
+    }
+
+    // Keep the object reachable for the GC while the ISR owns it
+    size_t i = 0;
+    while (i < MICROPY_HW_SENSOR_STREAM_MAX && MP_STATE_PORT(machine_sensor_stream_active)[i] != NULL) {
+        i++;
+    }
+    if (i == MICROPY_HW_SENSOR_STREAM_MAX) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("too many active streams"));
+    }
+    MP_STATE_PORT(machine_sensor_stream_active)[i] = self;
+
+    if (self->cs_pin != NULL) {
+        R_IOPORT_PinWrite(&g_ioport_ctrl, self->cs_pin->pin_id, BSP_IO_LEVEL_HIGH);
+    }
+
+    self->head = 0;
+    self->tail = 0;
+    self->busy = false;
+    self->n_records = 0;
+    self->n_overrun = 0;
+    self->n_missed = 0;
+    self->n_errors = 0;
+    self->running = true;
+
+    ra_pin_irq_set_c_handler(self->irq_pin, self->trigger, stream_irq_handler, self);
+
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(sensor_stream_obj_start_obj, sensor_stream_obj_start);
+
+// stop() - disarm the pin interrupt, records already in the ring stay readable
+static mp_obj_t sensor_stream_obj_stop(mp_obj_t self_in) {
+    stream_stop(MP_OBJ_TO_PTR(self_in));
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(sensor_stream_obj_stop_obj, sensor_stream_obj_stop);
+
+// any() - number of complete records waiting
+static mp_obj_t sensor_stream_obj_any(mp_obj_t self_in) {
+    ra_sensor_stream_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return MP_OBJ_NEW_SMALL_INT(self->head - self->tail);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(sensor_stream_obj_any_obj, sensor_stream_obj_any);
+
+// readinto(buf) - copy as many whole records as fit, return the record count
+static mp_obj_t sensor_stream_obj_readinto(mp_obj_t self_in, mp_obj_t buf_in) {
+    ra_sensor_stream_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+
+    uint32_t tail = self->tail;
+    uint32_t avail = self->head - tail;
+    uint32_t n = bufinfo.len / self->record_size;
+    if (n > avail) {
+        n = avail;
+    }
+
+    // At most two contiguous chunks (before and after the ring wraps)
+    uint8_t *dst = bufinfo.buf;
+    uint32_t first = self->depth - (tail & (self->depth - 1));
+    if (first > n) {
+        first = n;
+    }
+    memcpy(dst, stream_slot(self, tail), (size_t)first * self->record_size);
+    memcpy(dst + (size_t)first * self->record_size, self->ring, (size_t)(n - first) * self->record_size);
+
+    // Release the slots only after copying out
+    self->tail = tail + n;
+
+    return MP_OBJ_NEW_SMALL_INT(n);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(sensor_stream_obj_readinto_obj, sensor_stream_obj_readinto);
+
+// record_size() - bytes per record (4-byte ticks_us stamp + payload)
+static mp_obj_t sensor_stream_obj_record_size(mp_obj_t self_in) {
+    ra_sensor_stream_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return MP_OBJ_NEW_SMALL_INT(self->record_size);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(sensor_stream_obj_record_size_obj, sensor_stream_obj_record_size);
+
+// stats() - (records, overruns, missed, errors)
+static mp_obj_t sensor_stream_obj_stats(mp_obj_t self_in) {
+    ra_sensor_stream_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_obj_t items[4] = {
+        mp_obj_new_int_from_uint(self->n_records),
+        mp_obj_new_int_from_uint(self->n_overrun),
+        mp_obj_new_int_from_uint(self->n_missed),
+        mp_obj_new_int_from_uint(self->n_errors),
+    };
+    return mp_obj_new_tuple(4, items);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(sensor_stream_obj_stats_obj, sensor_stream_obj_stats);
+
+// SensorStream class methods dictionary
+static const mp_rom_map_elem_t sensor_stream_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_start), MP_ROM_PTR(&sensor_stream_obj_start_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&sensor_stream_obj_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&sensor_stream_obj_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_any), MP_ROM_PTR(&sensor_stream_obj_any_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readinto), MP_ROM_PTR(&sensor_stream_obj_readinto_obj) },
+    { MP_ROM_QSTR(MP_QSTR_record_size), MP_ROM_PTR(&sensor_stream_obj_record_size_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stats), MP_ROM_PTR(&sensor_stream_obj_stats_obj) },
+};
+static MP_DEFINE_CONST_DICT(sensor_stream_locals_dict, sensor_stream_locals_dict_table);
+
+// SensorStream type definition
+MP_DEFINE_CONST_OBJ_TYPE(
+    ra_sensor_stream_type,
+    MP_QSTR_SensorStream,
+    MP_TYPE_FLAG_NONE,
+    make_new, sensor_stream_obj_make_new,
+    print, sensor_stream_obj_print,
+    locals_dict, &sensor_stream_locals_dict
+);
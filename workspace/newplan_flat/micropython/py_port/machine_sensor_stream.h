@@ -0,0 +1,15 @@
+#ifndef MICROPY_INCLUDED_RA8D1_MACHINE_SENSOR_STREAM_H
+#define MICROPY_INCLUDED_RA8D1_MACHINE_SENSOR_STREAM_H
+
+#include "py/obj.h"
+
+// Size of the timestamp that prefixes every record (ticks_us, little endian)
+#define MP_SENSOR_STREAM_TS_SIZE      (4)
+
+// Forward declaration of SensorStream type
+extern const mp_obj_type_t ra_sensor_stream_type;
+
+// Stop all running streams (soft reset)
+void machine_sensor_stream_deinit_all(void);
+
+#endif // MICROPY_INCLUDED_RA8D1_MACHINE_SENSOR_STREAM_H
@@ -7,6 +7,7 @@
 
 #include "py/runtime.h"
 #include "py/mphal.h"
+#include "py/mptrace.h"
 #include "hal_data.h"
 #include "bsp_api.h"
 #include "machine_spi.h"
@@ -24,6 +25,8 @@ typedef struct _spi_sync_context_t {
     volatile bool transfer_complete;
     volatile fsp_err_t transfer_result;
     volatile spi_event_t last_event;
+    ra_spi_done_t done;            // Asynchronous completion hook (NULL for blocking transfers)
+    void *done_arg;
 } spi_sync_context_t;
 
 // Global context for SPI operations (single instance, so we can only have one SPI operation at a time)
@@ -37,6 +40,8 @@ static spi_b_extended_cfg_t g_spi_runtime_ext_cfg;
 
 // SPI callback function for FSP driver
 void spi_callback(spi_callback_args_t *p_args) {
+    MP_TRACE_EVENT(MP_TRACE_ISR_SPI, p_args->event);
+
     // Store the event and mark transfer as complete
     g_spi_sync_ctx.last_event = p_args->event;
     g_spi_sync_ctx.transfer_result = FSP_SUCCESS;
@@ -52,6 +57,13 @@ void spi_callback(spi_callback_args_t *p_args) {
         g_spi_sync_ctx.transfer_result = FSP_ERR_TRANSFER_ABORTED;
         g_spi_sync_ctx.transfer_complete = true;
     }
+
+    // Asynchronous transfer: hand the result to its owner (one-shot)
+    if (g_spi_sync_ctx.transfer_complete && g_spi_sync_ctx.done != NULL) {
+        ra_spi_done_t done = g_spi_sync_ctx.done;
+        g_spi_sync_ctx.done = NULL;
+        done(g_spi_sync_ctx.transfer_result, g_spi_sync_ctx.done_arg);
+    }
 }
 
 // ========== Synchronous SPI Helper Functions ==========
@@ -63,6 +75,27 @@ static void spi_sync_init(void) {
     g_spi_sync_ctx.last_event = (spi_event_t)0;
 }
 
+fsp_err_t ra_spi_transfer_start(ra_spi_obj_t *self, const uint8_t *tx, uint8_t *rx, size_t len,
+                                ra_spi_done_t done, void *arg) {
+    if (!self->is_open) {
+        return FSP_ERR_NOT_OPEN;
+    }
+    if (g_spi_sync_ctx.done != NULL) {
+        return FSP_ERR_IN_USE;
+    }
+
+    spi_sync_init();
+    g_spi_sync_ctx.done_arg = arg;
+    g_spi_sync_ctx.done = done;
+
+    fsp_err_t err = self->spi_instance->p_api->writeRead(self->spi_instance->p_ctrl,
+                                                        tx, rx, (uint32_t)len, SPI_BIT_WIDTH_8_BITS);
+    if (err != FSP_SUCCESS) {
+        g_spi_sync_ctx.done = NULL;
+    }
+    return err;
+}
+
 // Wait for transfer completion with timeout
 static fsp_err_t spi_sync_wait(uint32_t timeout_ms) {
     uint32_t start_time = mp_hal_ticks_ms();
@@ -39,4 +39,12 @@ typedef struct _ra_spi_obj_t {
 // Forward declaration of SPI type
 extern const mp_obj_type_t ra_spi_type;
 
+// Completion callback of an asynchronous transfer, called from the SPI interrupt
+typedef void (*ra_spi_done_t)(fsp_err_t result, void *arg);
+
+// Start a full-duplex transfer without waiting; safe to call from interrupt context.
+// tx/rx must stay valid until `done` has been called. Chip select is left to the caller.
+fsp_err_t ra_spi_transfer_start(ra_spi_obj_t *self, const uint8_t *tx, uint8_t *rx, size_t len,
+                                ra_spi_done_t done, void *arg);
+
 #endif // MICROPY_INCLUDED_RA8D1_MACHINE_SPI_H
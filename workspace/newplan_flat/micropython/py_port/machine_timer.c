@@ -0,0 +1,429 @@
+/*
+ * machine_timer.c - machine.Timer on GPT channels and a timing wheel for soft timers
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/mphal.h"
+#include "py/gc.h"
+#include "hal_data.h"
+#include "bsp_api.h"
+#include "machine_timer.h"
+#include "ra_irq.h"
+#include "ra_gpt.h"
+
+#define TIMER_IRQ_PRIORITY      (10)
+#define WHEEL_IRQ_PRIORITY      (12)    // same level as pin IRQs
+
+// ========== Timing Wheel ==========
+//
+// WHEEL_LEVELS levels of WHEEL_SLOTS slots each. A timer due in delta ticks sits
+// on level l where 64^l <= delta < 64^(l+1), in the slot selected by bits
+// [6l, 6l+6) of its expiry tick. Level 0 is expired one slot per tick; each time
+// the level-0 index wraps, one slot of level 1 is re-inserted (cascaded) into
+// level 0, and so on up the levels. Insert, remove and expire are O(1) per
+// timer; the cascade touches every timer at most once per level.
+// 4 x 64 slots at 1 kHz cover 2^24 ms (about 4.6 hours); longer delays park in
+// the top level and are re-inserted until they come into range.
+
+#define WHEEL_BITS      (6)
+#define WHEEL_SLOTS     (1U << WHEEL_BITS)
+#define WHEEL_MASK      (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS    (4)
+#define WHEEL_MAX_DELTA ((1UL << (WHEEL_BITS * WHEEL_LEVELS)) - 1)
+#define WHEEL_TICK_HZ   (1000)
+
+MP_STATIC_ASSERT(WHEEL_LEVELS * WHEEL_SLOTS == 256);
+
+// Slot list heads; the GC reaches every active soft timer through them
+MP_REGISTER_ROOT_POINTER(void *machine_timer_wheel[256]);
+// Hardware timer objects, referenced by their ISR context
+MP_REGISTER_ROOT_POINTER(void *machine_timer_hw[MICROPY_HW_TIMER_NUM]);
+
+typedef struct _timer_wheel_t {
+    volatile uint32_t now;      // next tick to be processed
+    uint32_t n_active;          // soft timers linked into the wheel
+    IRQn_Type irq;
+    bool running;
+} timer_wheel_t;
+
+static timer_wheel_t s_wheel = { .irq = RA_IRQ_INVALID };
+
+static inline machine_timer_obj_t **wheel_slot(size_t level, size_t idx) {
+    return (machine_timer_obj_t **)&MP_STATE_PORT(machine_timer_wheel)[level * WHEEL_SLOTS + idx];
+}
+
+static void wheel_link(machine_timer_obj_t **head, machine_timer_obj_t *t) {
+    t->next = *head;
+    if (t->next != NULL) {
+        t->next->pprev = &t->next;
+    }
+    t->pprev = head;
+    *head = t;
+}
+
+static void wheel_unlink(machine_timer_obj_t *t) {
+    *t->pprev = t->next;
+    if (t->next != NULL) {
+        t->next->pprev = t->pprev;
+    }
+    t->next = NULL;
+    t->pprev = NULL;
+}
+
+// Called with interrupts disabled or from the wheel ISR
+static void wheel_insert(machine_timer_obj_t *t) {
+    uint32_t now = s_wheel.now;
+    uint32_t delta = t->expires - now;
+    size_t level = 0;
+    size_t idx;
+    if ((int32_t)delta <= 0) {
+        // Already due: goes into the slot processed by the next tick
+        idx = now & WHEEL_MASK;
+    } else {
+        uint32_t expires = t->expires;
+        if (delta > WHEEL_MAX_DELTA) {
+            delta = WHEEL_MAX_DELTA;
+            expires = now + delta;
+        }
+        while (delta >> (WHEEL_BITS * (level + 1))) {
+            level++;
+        }
+        idx = (expires >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    }
+    wheel_link(wheel_slot(level, idx), t);
+}
+
+// Move every timer of one slot down to where it belongs now
+static void wheel_cascade(size_t level, size_t idx) {
+    machine_timer_obj_t **head = wheel_slot(level, idx);
+    machine_timer_obj_t *t = *head;
+    *head = NULL;
+    while (t != NULL) {
+        machine_timer_obj_t *next = t->next;
+        wheel_insert(t);
+        t = next;
+    }
+}
+
+static void wheel_isr(void);
+
+static void wheel_start(void) {
+    if (s_wheel.irq == RA_IRQ_INVALID) {
+        uint32_t repeat;
+        ra_gpt_periodic_init_counts(MICROPY_HW_TIMER_WHEEL_GPT_CH, ra_gpt_clock_hz() / WHEEL_TICK_HZ, &repeat);
+        s_wheel.irq = ra_irq_alloc(ra_gpt_overflow_event(MICROPY_HW_TIMER_WHEEL_GPT_CH), wheel_isr, WHEEL_IRQ_PRIORITY, NULL);
+    }
+}
+
+// ========== Callback Dispatch ==========
+
+// Run from the timer interrupt: hard=True calls the handler in place (GC locked,
+// like Pin.irq(hard=True)), otherwise it is scheduled at normal priority so
+// sensor IRQs queued at MP_SCHED_PRIO_HIGH run first.
+static void timer_fire(machine_timer_obj_t *self) {
+    mp_obj_t callback = self->callback;
+    if (callback == mp_const_none) {
+        return;
+    }
+    if (!self->hard) {
+        mp_sched_schedule(callback, MP_OBJ_FROM_PTR(self));
+        return;
+    }
+    mp_sched_lock();
+    gc_lock();
+    #if MICROPY_GC_INCREMENTAL
+    // handler 不分配内存也能改写对象间的引用：作废进行中的增量标记
+    gc_inc_note_mutation();
+    #endif
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_call_function_1(callback, MP_OBJ_FROM_PTR(self));
+        nlr_pop();
+    } else {
+        // 未捕获的异常：禁用 callback，避免每个周期都重复报错
+        self->callback = mp_const_none;
+        mp_printf(MICROPY_ERROR_PRINTER, "Uncaught exception in Timer callback\n");
+        mp_obj_print_exception(MICROPY_ERROR_PRINTER, MP_OBJ_FROM_PTR(nlr.ret_val));
+    }
+    gc_unlock();
+    mp_sched_unlock();
+}
+
+// 1 kHz tick of all soft timers
+static void wheel_isr(void) {
+    IRQn_Type irq = R_FSP_CurrentIrqGet();
+    R_BSP_IrqStatusClear(irq);
+
+    uint32_t now = s_wheel.now;
+    size_t idx = now & WHEEL_MASK;
+    if (idx == 0) {
+        for (size_t level = 1; level < WHEEL_LEVELS; level++) {
+            size_t li = (now >> (WHEEL_BITS * level)) & WHEEL_MASK;
+            wheel_cascade(level, li);
+            if (li != 0) {
+                break;
+            }
+        }
+    }
+
+    // Detach the due slot so callbacks can add and remove timers freely
+    machine_timer_obj_t *due = *wheel_slot(0, idx);
+    *wheel_slot(0, idx) = NULL;
+    if (due != NULL) {
+        due->pprev = &due;
+    }
+    s_wheel.now = now + 1;
+
+    while (due != NULL) {
+        machine_timer_obj_t *t = due;
+        wheel_unlink(t);
+        if (t->mode == MP_TIMER_PERIODIC) {
+            t->expires += t->period;
+            wheel_insert(t);
+        } else {
+            t->active = false;
+            s_wheel.n_active--;
+        }
+        timer_fire(t);
+    }
+
+    if (s_wheel.n_active == 0 && s_wheel.running) {
+        ra_gpt_stop(MICROPY_HW_TIMER_WHEEL_GPT_CH);
+        s_wheel.running = false;
+    }
+}
+
+// Hardware timer overflow
+static void timer_hw_isr(void) {
+    IRQn_Type irq = R_FSP_CurrentIrqGet();
+    R_BSP_IrqStatusClear(irq);
+
+    machine_timer_obj_t *self = ra_irq_context_get(irq);
+    if (self == NULL || !self->active) {
+        return;
+    }
+    if (--self->countdown != 0) {
+        return;     // postscaler: period longer than the 16-bit counter
+    }
+    self->countdown = self->period;
+    if (self->mode == MP_TIMER_ONE_SHOT) {
+        ra_gpt_stop(MICROPY_HW_TIMER_GPT_CH(self->id));
+        self->active = false;
+    }
+    timer_fire(self);
+}
+
+// ========== Start / Stop ==========
+
+static void timer_stop(machine_timer_obj_t *self) {
+    if (self->id < 0) {
+        mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+        if (self->active) {
+            wheel_unlink(self);
+            self->active = false;
+            if (--s_wheel.n_active == 0 && s_wheel.running) {
+                ra_gpt_stop(MICROPY_HW_TIMER_WHEEL_GPT_CH);
+                s_wheel.running = false;
+            }
+        }
+        MICROPY_END_ATOMIC_SECTION(atomic_state);
+        return;
+    }
+
+    self->active = false;
+    ra_gpt_stop(MICROPY_HW_TIMER_GPT_CH(self->id));
+    if (self->irq != RA_IRQ_INVALID) {
+        ra_irq_free(self->irq);
+        self->irq = RA_IRQ_INVALID;
+    }
+    MP_STATE_PORT(machine_timer_hw)[self->id] = NULL;
+}
+
+static void timer_start_soft(machine_timer_obj_t *self, uint32_t period_ms) {
+    wheel_start();
+    if (s_wheel.irq == RA_IRQ_INVALID) {
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("no free interrupt slot"));
+    }
+
+    mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+    self->period = period_ms;
+    // The next tick comes within 1 ms: firing at tick now + period keeps the
+    // delay at least period ms
+    self->expires = s_wheel.now + period_ms;
+    wheel_insert(self);
+    self->active = true;
+    s_wheel.n_active++;
+    if (!s_wheel.running) {
+        s_wheel.running = true;
+        ra_gpt_start(MICROPY_HW_TIMER_WHEEL_GPT_CH);
+    }
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
+}
+
+static void timer_start_hw(machine_timer_obj_t *self, uint64_t counts) {
+    uint8_t ch = MICROPY_HW_TIMER_GPT_CH(self->id);
+    uint32_t repeat;
+    if (ra_gpt_periodic_init_counts(ch, counts, &repeat) == 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("period out of range"));
+    }
+    self->period = repeat;
+    self->countdown = repeat;
+
+    self->irq = ra_irq_alloc(ra_gpt_overflow_event(ch), timer_hw_isr, TIMER_IRQ_PRIORITY, self);
+    if (self->irq == RA_IRQ_INVALID) {
+        mp_raise_msg(&mp_type_OSError, MP_ERROR_TEXT("no free interrupt slot"));
+    }
+    MP_STATE_PORT(machine_timer_hw)[self->id] = self;
+    self->active = true;
+    ra_gpt_start(ch);
+}
+
+void machine_timer_deinit_all(void) {
+    for (size_t i = 0; i < MICROPY_HW_TIMER_NUM; i++) {
+        machine_timer_obj_t *self = MP_STATE_PORT(machine_timer_hw)[i];
+        if (self != NULL) {
+            timer_stop(self);
+        }
+    }
+
+    ra_gpt_stop(MICROPY_HW_TIMER_WHEEL_GPT_CH);
+    if (s_wheel.irq != RA_IRQ_INVALID) {
+        ra_irq_free(s_wheel.irq);
+        s_wheel.irq = RA_IRQ_INVALID;
+    }
+    s_wheel.running = false;
+    s_wheel.n_active = 0;
+    memset(MP_STATE_PORT(machine_timer_wheel), 0, sizeof(MP_STATE_PORT(machine_timer_wheel)));
+}
+
+// ========== Timer Object Implementation ==========
+
+static void machine_timer_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
+    machine_timer_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_printf(print, "Timer(%d, mode=%s, hard=%s)", self->id,
+              self->mode == MP_TIMER_PERIODIC ? "PERIODIC" : "ONE_SHOT",
+              self->hard ? "True" : "False");
+}
+
+// init(*, mode=Timer.PERIODIC, freq=-1, period=-1, callback=None, hard=False)
+//   period in ms; soft timers have 1 ms resolution (freq <= 1000)
+static mp_obj_t machine_timer_init_helper(machine_timer_obj_t *self, size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_mode, ARG_callback, ARG_period, ARG_freq, ARG_hard };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_mode, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = MP_TIMER_PERIODIC} },
+        { MP_QSTR_callback, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_period, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = -1} },
+        { MP_QSTR_freq, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_hard, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false} },
+    };
+    mp_arg_val_t vals[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, vals);
+
+    mp_int_t mode = vals[ARG_mode].u_int;
+    if (mode != MP_TIMER_ONE_SHOT && mode != MP_TIMER_PERIODIC) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid mode"));
+    }
+    mp_obj_t callback = vals[ARG_callback].u_obj;
+    if (callback != mp_const_none && !mp_obj_is_callable(callback)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("callback must be callable"));
+    }
+
+    // Period in microseconds (hardware timers use the exact PCLKD count)
+    uint64_t counts;
+    uint32_t clock_hz = ra_gpt_clock_hz();
+    mp_float_t freq = 0;
+    if (vals[ARG_freq].u_obj != mp_const_none) {
+        freq = mp_obj_get_float(vals[ARG_freq].u_obj);
+        if (freq <= 0) {
+            mp_raise_ValueError(MP_ERROR_TEXT("freq must be positive"));
+        }
+        counts = (uint64_t)((mp_float_t)clock_hz / freq);
+    } else if (vals[ARG_period].u_int > 0) {
+        counts = (uint64_t)clock_hz * (uint64_t)vals[ARG_period].u_int / 1000;
+    } else {
+        mp_raise_ValueError(MP_ERROR_TEXT("need freq or period"));
+    }
+
+    timer_stop(self);
+    self->mode = (uint8_t)mode;
+    self->callback = callback;
+    self->hard = vals[ARG_hard].u_bool;
+
+    if (self->id < 0) {
+        uint64_t period_ms = freq > 0 ? (uint64_t)((mp_float_t)1000 / freq + (mp_float_t)0.5)
+                                      : (uint64_t)vals[ARG_period].u_int;
+        if (period_ms == 0 || period_ms > 0xFFFFFFFFULL / 2) {
+            mp_raise_ValueError(MP_ERROR_TEXT("period out of range for a virtual timer"));
+        }
+        timer_start_soft(self, (uint32_t)period_ms);
+    } else {
+        timer_start_hw(self, counts);
+    }
+    return mp_const_none;
+}
+
+// Timer(id=-1, *, mode=Timer.PERIODIC, freq=-1, period=-1, callback=None, hard=False)
+static mp_obj_t machine_timer_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 0, 1, true);
+
+    mp_int_t id = n_args > 0 ? mp_obj_get_int(args[0]) : -1;
+    if (id < -1 || id >= MICROPY_HW_TIMER_NUM) {
+        mp_raise_msg_varg(&mp_type_ValueError, MP_ERROR_TEXT("Timer(%d) doesn't exist"), (int)id);
+    }
+
+    machine_timer_obj_t *self = NULL;
+    if (id >= 0) {
+        // A running hardware timer keeps its object, hand that one back
+        self = MP_STATE_PORT(machine_timer_hw)[id];
+    }
+    if (self == NULL) {
+        self = mp_obj_malloc(machine_timer_obj_t, &machine_timer_type);
+        self->next = NULL;
+        self->pprev = NULL;
+        self->callback = mp_const_none;
+        self->id = (int8_t)id;
+        self->mode = MP_TIMER_PERIODIC;
+        self->hard = false;
+        self->active = false;
+        self->irq = RA_IRQ_INVALID;
+    }
+
+    if (n_kw > 0) {
+        mp_map_t kw_args;
+        mp_map_init_fixed_table(&kw_args, n_kw, args + n_args);
+        machine_timer_init_helper(self, 0, NULL, &kw_args);
+    }
+    return MP_OBJ_FROM_PTR(self);
+}
+
+static mp_obj_t machine_timer_init(size_t n_args, const mp_obj_t *args, mp_map_t *kw_args) {
+    return machine_timer_init_helper(MP_OBJ_TO_PTR(args[0]), n_args - 1, args + 1, kw_args);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(machine_timer_init_obj, 1, machine_timer_init);
+
+// deinit() - stop the timer
+static mp_obj_t machine_timer_deinit(mp_obj_t self_in) {
+    timer_stop(MP_OBJ_TO_PTR(self_in));
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(machine_timer_deinit_obj, machine_timer_deinit);
+
+static const mp_rom_map_elem_t machine_timer_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_init), MP_ROM_PTR(&machine_timer_init_obj) },
+    { MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&machine_timer_deinit_obj) },
+
+    { MP_ROM_QSTR(MP_QSTR_ONE_SHOT), MP_ROM_INT(MP_TIMER_ONE_SHOT) },
+    { MP_ROM_QSTR(MP_QSTR_PERIODIC), MP_ROM_INT(MP_TIMER_PERIODIC) },
+};
+static MP_DEFINE_CONST_DICT(machine_timer_locals_dict, machine_timer_locals_dict_table);
+
+MP_DEFINE_CONST_OBJ_TYPE(
+    machine_timer_type,
+    MP_QSTR_Timer,
+    MP_TYPE_FLAG_NONE,
+    make_new, machine_timer_make_new,
+    print, machine_timer_print,
+    locals_dict, &machine_timer_locals_dict
+);
@@ -0,0 +1,40 @@
+#ifndef MICROPY_INCLUDED_RA8D1_MACHINE_TIMER_H
+#define MICROPY_INCLUDED_RA8D1_MACHINE_TIMER_H
+
+#include "py/obj.h"
+#include "bsp_api.h"
+
+// machine.Timer
+//
+// Timer(0) .. Timer(MICROPY_HW_TIMER_NUM - 1) each own a GPT channel and call
+// back from its overflow interrupt. Timer(-1) is a virtual (soft) timer: all of
+// them share one GPT channel ticking at 1 kHz, which drives a hierarchical
+// timing wheel (O(1) insert, remove and expire), and the tick stops when no
+// soft timer is active.
+
+#define MP_TIMER_ONE_SHOT   (0)
+#define MP_TIMER_PERIODIC   (1)
+
+typedef struct _machine_timer_obj_t {
+    mp_obj_base_t base;
+    // Wheel slot list. next points at the start of the next timer object so the
+    // GC keeps every linked timer alive through the wheel root pointers.
+    struct _machine_timer_obj_t *next;
+    struct _machine_timer_obj_t **pprev;
+    uint32_t expires;               // soft: wheel tick of the next expiry
+    uint32_t period;                // soft: wheel ticks; hardware: overflows per callback
+    volatile uint32_t countdown;    // hardware: overflows left until the callback
+    mp_obj_t callback;
+    int8_t id;                      // -1 for a soft timer
+    uint8_t mode;
+    bool hard;
+    volatile bool active;
+    IRQn_Type irq;
+} machine_timer_obj_t;
+
+extern const mp_obj_type_t machine_timer_type;
+
+// Stop every timer and empty the wheel (soft reset)
+void machine_timer_deinit_all(void);
+
+#endif // MICROPY_INCLUDED_RA8D1_MACHINE_TIMER_H
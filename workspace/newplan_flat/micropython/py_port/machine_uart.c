@@ -53,6 +53,7 @@ void uart1_callback(uart_callback_args_t *p_args) {
         // TX 完成中断
         g_uart1_irq_tx_cnt++;
         self->tx_complete = true;
+        self->tx_buf = NULL;
     }
 }
 
@@ -208,6 +209,7 @@ STATIC mp_obj_t uart_obj_make_new(const mp_obj_type_t *type,
     self->is_open = false;
     self->rx_buf_storage = NULL;
     self->tx_complete = true;
+    self->tx_buf = NULL;
 
     // 初始化 UART 硬件
     uart_obj_init_helper(self, self->baudrate);
@@ -396,6 +398,7 @@ STATIC mp_obj_t uart_obj_write(mp_obj_t self_in, mp_obj_t buf_in) {
     }
 
     self->tx_complete = false;
+    self->tx_buf = bufinfo.buf;
     return mp_obj_new_int((mp_int_t)bufinfo.len);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(uart_obj_write_obj, uart_obj_write);
@@ -18,6 +18,7 @@ typedef struct _ra_uart_obj_t {
     ringbuf_t rx_buf;                     // Ring buffer for RX data
     uint8_t *rx_buf_storage;              // Allocated storage for ring buffer
     volatile bool tx_complete;            // Flag for TX completion
+    const void *volatile tx_buf;          // 发送中的缓冲区：GC 扫描对象时看到它，发送完成前不会释放或移动该缓冲区
     uart_callback_args_t callback_memory;  // Memory for callback arguments
 } ra_uart_obj_t;
 
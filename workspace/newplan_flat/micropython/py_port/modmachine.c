@@ -8,10 +8,15 @@
 #include "bsp_api.h"
 #include "led.h"           // 引入 LED
 #include "machine_pin.h"   // 引入 Pin 类型和常量定义
+#include "machine_port.h"  // 引入 Port 类型定义
 #include "machine_i2c.h"   // 引入 I2C 类型定义
 #include "machine_spi.h"   // 引入 SPI 类型定义
 #include "machine_adc.h"   // 引入 ADC 类型定义
+#include "machine_adc_block.h" // 引入 ADCBlock 类型定义
 #include "machine_dac.h"   // 引入 DAC 类型定义
+#include "machine_sensor_stream.h" // 引入 SensorStream 类型定义
+#include "machine_bitstream.h" // 引入 bitstream / time_pulse_us / capture_pulses
+#include "machine_timer.h" // 引入 Timer 类型定义
 #include "machine_uart.h"  // 旧 RA 端口的 UART 头文件（可以保留，也可以以后删）
 
 // 从 py_port/machine_uart.c 引入 RA8D1 专用 machine.UART 类型
@@ -40,18 +45,48 @@ STATIC mp_obj_t machine_unique_id(void) {
 }
 MP_DEFINE_CONST_FUN_OBJ_0(machine_unique_id_obj, machine_unique_id);
 
+// machine.idle() - WFI 睡眠到下一个中断（最迟下一个 1ms SysTick）
+STATIC mp_obj_t machine_idle(void) {
+    mp_hal_idle();
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_0(machine_idle_obj, machine_idle);
+
+// machine.idle_stats(reset=False) - 返回 (WFI 中的周期数, 统计起点以来的总周期数)
+// 两者之比即 sleep_ms / idle 期间的空闲率（电流的近似指标）
+STATIC mp_obj_t machine_idle_stats(size_t n_args, const mp_obj_t *args) {
+    bool reset = n_args > 0 && mp_obj_is_true(args[0]);
+    uint64_t elapsed;
+    uint64_t idle = mp_hal_idle_stats(&elapsed, reset);
+    mp_obj_t items[2] = {
+        mp_obj_new_int_from_ull(idle),
+        mp_obj_new_int_from_ull(elapsed),
+    };
+    return mp_obj_new_tuple(2, items);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(machine_idle_stats_obj, 0, 1, machine_idle_stats);
+
 // machine 模块的全局变量
 STATIC const mp_rom_map_elem_t machine_module_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__),    MP_ROM_QSTR(MP_QSTR_machine) },
     { MP_ROM_QSTR(MP_QSTR_LED),         MP_ROM_PTR(&ra_led_type) },        // 导出 LED 类
     { MP_ROM_QSTR(MP_QSTR_Pin),         MP_ROM_PTR(&ra_pin_type) },        // 导出 Pin 类
+    { MP_ROM_QSTR(MP_QSTR_Port),        MP_ROM_PTR(&ra_port_type) },       // 导出 Port 类
     { MP_ROM_QSTR(MP_QSTR_I2C),         MP_ROM_PTR(&ra_i2c_type) },        // 导出 I2C 类
     { MP_ROM_QSTR(MP_QSTR_SPI),         MP_ROM_PTR(&ra_spi_type) },        // 导出 SPI 类
     { MP_ROM_QSTR(MP_QSTR_ADC),         MP_ROM_PTR(&ra_adc_type) },        // 导出 ADC 类
+    { MP_ROM_QSTR(MP_QSTR_ADCBlock),    MP_ROM_PTR(&ra_adc_block_type) },  // 导出 ADCBlock 类
     { MP_ROM_QSTR(MP_QSTR_DAC),         MP_ROM_PTR(&ra_dac_type) },        // 导出 DAC 类
+    { MP_ROM_QSTR(MP_QSTR_SensorStream), MP_ROM_PTR(&ra_sensor_stream_type) }, // 导出 SensorStream 类
+    { MP_ROM_QSTR(MP_QSTR_Timer),       MP_ROM_PTR(&machine_timer_type) }, // 导出 Timer 类（GPT 硬件定时器 / 时间轮软件定时器）
     { MP_ROM_QSTR(MP_QSTR_UART),        MP_ROM_PTR(&machine_uart_type) },  // 使用通用 machine.UART 类型
     { MP_ROM_QSTR(MP_QSTR_freq),        MP_ROM_PTR(&machine_freq_obj) },   // 导出 freq 函数
     { MP_ROM_QSTR(MP_QSTR_unique_id),   MP_ROM_PTR(&machine_unique_id_obj) }, // 导出 unique_id 函数
+    { MP_ROM_QSTR(MP_QSTR_idle),        MP_ROM_PTR(&machine_idle_obj) },   // WFI 睡眠到下一个中断
+    { MP_ROM_QSTR(MP_QSTR_idle_stats),  MP_ROM_PTR(&machine_idle_stats_obj) }, // WFI 空闲周期统计
+    { MP_ROM_QSTR(MP_QSTR_bitstream),   MP_ROM_PTR(&machine_bitstream_obj) }, // GPT 定时的 bitstream 输出
+    { MP_ROM_QSTR(MP_QSTR_time_pulse_us), MP_ROM_PTR(&machine_time_pulse_us_obj) }, // GPT 输入捕获测量脉宽
+    { MP_ROM_QSTR(MP_QSTR_capture_pulses), MP_ROM_PTR(&machine_capture_pulses_obj) }, // GPT 输入捕获记录边沿间隔
 
     // Pin 模式常量
     { MP_ROM_QSTR(MP_QSTR_IN),          MP_ROM_INT(MP_PIN_MODE_IN) },
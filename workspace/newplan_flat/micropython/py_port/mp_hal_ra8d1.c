@@ -1,13 +1,21 @@
 // micropython/py_port/mp_hal_ra8d1.c
-// 目标：ticks_us 跨 >9s 不受 DWT 32-bit 回绕影响，并保证密集采样单调不倒退
-// 方法：SysTick(ms)*1000 + ((CYCCNT - base_of_this_ms) -> 0~999us)
-// base_of_this_ms 由 SysTick_Handler 每 1ms 更新
+// 目标：64 位单调时基，ticks_us/ticks_ns 每次调用只做一次 32x32 乘法和移位，没有 64 位除法
+// 方法：SysTick ISR 每 1ms 把“时基起点”按整毫秒推进：
+//   s_cyc_base（64 位 CPU 周期）+= cycles_per_ms，s_us_base（64 位微秒）+= 1000
+// 读取时只需要本 ms 内的增量 delta = CYCCNT - (uint32)s_cyc_base（无符号减法，CYCCNT 回绕也成立），
+// 再用预先算好的倒数做乘法-移位换算。CYCCNT 的 32 位回绕（~8.95s）被 64 位起点吸收。
+//
+// 延时：mp_hal_delay_ms / 长的 mp_hal_delay_us 在 WFI 中睡眠，最迟由下一个 SysTick 唤醒，
+// 任何中断（UART / 引脚 / 定时器）也会提前唤醒；delay_ms 唤醒后立即处理调度队列。
+// 截止时刻落在当前毫秒内时改为 CYCCNT 忙等，短 sleep_us 减去校准过的调用开销。
+// 打开 MICROPY_GC_INCREMENTAL 时，delay_ms 的空闲时间先用来做增量 GC（每片不超过预算），做完再睡。
 
 #include "hal_data.h"
 #include "bsp_api.h"
 #include "py/mpconfig.h"
 #include "py/mphal.h"
 #include "py/runtime.h"
+#include "py/gc.h"
 
 #include <stdint.h>
 #include <core_cm85.h>
@@ -15,47 +23,255 @@
 // SysTick 计数（单位：ms），在 hal_entry.c / SysTick ISR 中递增
 extern volatile uint32_t g_systick_count;
 
-// 由 SysTick ISR 在每个 ms 边界更新：记录“本 ms 起点的 CYCCNT”
-volatile uint32_t g_dwt_cyccnt_ms_base = 0;
+// 时基起点，只由 mp_hal_time_tick()（SysTick ISR）修改；s_seq 在每次修改后递增，
+// 读者据此判断快照是否被 ISR 打断
+static volatile uint64_t s_cyc_base = 0;
+static volatile uint64_t s_us_base = 0;
+static volatile uint32_t s_seq = 0;
 
-// 缓存：每毫秒多少 CPU cycles
+// 缓存：每毫秒 / 每微秒多少 CPU cycles
 static uint32_t s_cycles_per_ms = 480000u;   // 默认 480MHz -> 480000 cycles/ms
+static uint32_t s_cycles_per_us = 480u;
+
+// 忙等延时的固定开销（调用 + 读 CYCCNT + 返回），mp_hal_time_init 中校准
+static uint32_t s_spin_overhead = 0;
+
+// 空闲统计：WFI 中度过的 CPU 周期，以及统计起点（ticks_cpu64）
+static uint64_t s_idle_cycles = 0;
+static uint64_t s_idle_since = 0;
+
+// 换算倒数：us = delta * s_mult_us >> 32（向上取整的倒数，delta < 2^32/cycles_per_us 时结果精确）
+//           ns = delta * s_mult_ns >> 24（向下取整的倒数，保证跨 ms 起点时不倒退）
+#define TICKS_NS_SHIFT  (24)
+static uint32_t s_mult_us = 8947849u;
+static uint32_t s_mult_ns = 34952533u;
+
+static inline bool dwt_enabled(void) {
+    return (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0;
+}
 
 void mp_hal_time_init(void) {
-    // 使能 DWT CYCCNT
     CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
-    DWT->CYCCNT = 0;
-    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
-    // 计算 cycles/ms（尽量用真实 SystemCoreClock）
+    // 计算 cycles/ms 和换算倒数（尽量用真实 SystemCoreClock）
     uint32_t core = SystemCoreClock;
-    if (core == 0) {
+    if (core < 1000000u) {
         core = 480000000u; // 兜底
     }
     s_cycles_per_ms = core / 1000u;
-    if (s_cycles_per_ms == 0) {
-        s_cycles_per_ms = 1;
+    s_cycles_per_us = core / 1000000u;
+    s_mult_us = (uint32_t)(((1000000ull << 32) + core - 1) / core);
+    s_mult_ns = (uint32_t)((1000000000ull << TICKS_NS_SHIFT) / core);
+
+    // 起点与当前 SysTick 计数对齐，ticks_us 与 ticks_ms 保持同一零点
+    uint32_t ms = g_systick_count;
+    s_us_base = (uint64_t)ms * 1000u;
+    s_cyc_base = (uint64_t)ms * s_cycles_per_ms;
+    s_seq++;
+
+    // 最后使能 DWT CYCCNT：之前 SysTick ISR 看到 CYCCNT 未使能，不会推进起点
+    DWT->CYCCNT = (uint32_t)s_cyc_base;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // WFI 进入普通睡眠（CPU 停止，外设和 SysTick 继续运行），不进入深度睡眠
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+    // 校准忙等开销：取零长度延时的最小耗时（第一次调用会把代码装入 I-Cache）
+    s_spin_overhead = 0;
+    uint32_t best = UINT32_MAX;
+    for (int i = 0; i < 8; i++) {
+        uint32_t t0 = DWT->CYCCNT;
+        mp_hal_delay_us(0);
+        uint32_t t = DWT->CYCCNT - t0;
+        if (t < best) {
+            best = t;
+        }
     }
+    s_spin_overhead = best;
+    s_idle_cycles = 0;
+    s_idle_since = mp_hal_ticks_cpu64();
+}
 
-    // 初始化 base（避免刚启动时 sub_us 异常）
-    if (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) {
-        g_dwt_cyccnt_ms_base = DWT->CYCCNT;
-    } else {
-        g_dwt_cyccnt_ms_base = 0;
+// SysTick ISR 调用：按整毫秒推进起点。ISR 被屏蔽多久都能追上，只要不超过 CYCCNT 回绕周期
+void mp_hal_time_tick(void) {
+    if (!dwt_enabled()) {
+        return;
+    }
+    uint32_t cyc = DWT->CYCCNT;
+    uint64_t cyc_base = s_cyc_base;
+    uint64_t us_base = s_us_base;
+    while ((uint32_t)(cyc - (uint32_t)cyc_base) >= s_cycles_per_ms) {
+        cyc_base += s_cycles_per_ms;
+        us_base += 1000u;
     }
+    s_cyc_base = cyc_base;
+    s_us_base = us_base;
+    s_seq++;
 }
 
-// 毫秒延时：每 1ms 轮询一次事件调度
+// 一致快照：起点和 CYCCNT 属于同一个毫秒区间
+static inline uint32_t time_snapshot(uint64_t *cyc_base, uint64_t *us_base) {
+    uint32_t seq, cyc;
+    do {
+        seq = s_seq;
+        *cyc_base = s_cyc_base;
+        *us_base = s_us_base;
+        cyc = DWT->CYCCNT;
+    } while (seq != s_seq);
+    return (uint32_t)(cyc - (uint32_t)*cyc_base);
+}
+
+// 在 WFI 中睡眠到下一个中断（最迟下一个 SysTick），返回后中断已处理完。
+// check_pending：在 PRIMASK 屏蔽下检查调度队列，有待处理工作就不睡；
+// 检查之后 ISR 的请求会让 WFI 立即返回（屏蔽期间挂起的中断照样唤醒），不会丢失唤醒。
+static void idle_wait(bool check_pending) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (!check_pending || !mp_handle_pending_needed()) {
+        // 睡眠时长用 SysTick 计数器测量（向下计数，至多回绕一次：SysTick 中断本身会唤醒）
+        uint32_t load = SysTick->LOAD + 1u;
+        uint32_t val0 = SysTick->VAL;
+        uint32_t cyc0 = DWT->CYCCNT;
+        __DSB();
+        __WFI();
+        uint32_t val1 = SysTick->VAL;
+        uint32_t slept = (val0 >= val1) ? (val0 - val1) : (val0 + load - val1);
+        // 若实现在睡眠中门控内核时钟、CYCCNT 停止计数，按 SysTick 补齐，时基保持连续
+        uint32_t counted = DWT->CYCCNT - cyc0;
+        if (slept > counted) {
+            DWT->CYCCNT += slept - counted;
+        }
+        s_idle_cycles += slept;
+    }
+    __set_PRIMASK(primask);
+}
+
+#if MICROPY_GC_INCREMENTAL
+// 空闲时做一片增量 GC（不超过预算和剩余空闲时间）。返回 false 表示没有 GC 工作，调用者去睡眠。
+// 标记期间没有写屏障，不能跨过 Python 代码：预计本次空闲做不完（按上次标记用时加 1/4 余量）就不开始，
+// 连续作废时每次把要求的空闲时间翻倍（最多 16 倍），标记完成一轮后恢复；
+// 开始了没做完的由 delay_until 在运行回调或返回之前作废；空闲中 hard 回调（Pin / Timer）运行过的，
+// 由下一片 gc_inc_step 作废（gc_inc_note_mutation）
+static bool gc_idle_step(uint64_t remain, void *stack_bottom) {
+    uint32_t budget = MP_STATE_MEM(gc_inc_budget_us);
+    if (budget == 0 || !gc_inc_due()) {
+        return false;
+    }
+    uint32_t remain_us = (uint32_t)MIN(remain, UINT32_MAX) / s_cycles_per_us;
+    if (gc_inc_phase() == GC_INC_IDLE) {
+        uint32_t est = MP_STATE_MEM(gc_inc_last_mark_us);
+        uint64_t need = (uint64_t)est + est / 4;
+        if (MP_STATE_MEM(gc_inc_abort_run) > 0) {
+            // 至少一片的时间，再按连续作废次数翻倍
+            need = MAX(need, budget) << MIN(MP_STATE_MEM(gc_inc_abort_run), 4);
+        }
+        if (remain_us < need) {
+            return false;
+        }
+        mp_gc_inc_start(stack_bottom);
+        return true;
+    }
+    gc_inc_step(MIN(budget, remain_us));
+    return true;
+}
+#endif
+
+// 等待到 64 位 CPU 周期截止时刻。poll=true 时每次唤醒先处理调度队列 / KeyboardInterrupt
+static void delay_until(uint64_t deadline, bool poll) {
+    // 中断上下文（hard 回调）里不睡眠：优先级不高于当前 ISR 的 SysTick 唤醒不了 WFI
+    bool can_sleep = (__get_IPSR() == 0);
+    for (;;) {
+        if (poll) {
+            #if MICROPY_GC_INCREMENTAL
+            // 回调 / KeyboardInterrupt 要运行 Python 代码，未完成的标记作废
+            if (mp_handle_pending_needed()) {
+                gc_inc_abort();
+            }
+            #endif
+            MICROPY_EVENT_POLL_HOOK
+        }
+        uint64_t now = mp_hal_ticks_cpu64();
+        if (now >= deadline) {
+            #if MICROPY_GC_INCREMENTAL
+            gc_inc_abort();
+            #endif
+            return;
+        }
+        uint64_t remain = deadline - now;
+        // 下一个 SysTick 在截止时刻之前：睡眠，由 SysTick 或其他中断唤醒后重新判断
+        if (can_sleep && remain > SysTick->VAL + s_cycles_per_us) {
+            #if MICROPY_GC_INCREMENTAL
+            // 栈从本帧开始扫描：空闲期间本帧和调用者的帧不变
+            if (poll && gc_idle_step(remain, (void *)__get_MSP())) {
+                continue;
+            }
+            #endif
+            idle_wait(poll);
+            continue;
+        }
+        if (remain > UINT32_MAX / 2) {
+            continue;
+        }
+        // 截止时刻在当前毫秒内（或不能睡眠）：CYCCNT 忙等
+        uint32_t target = DWT->CYCCNT + (uint32_t)remain;
+        while ((int32_t)(DWT->CYCCNT - target) < 0) {
+        }
+        return;
+    }
+}
+
+// 毫秒延时：WFI 睡眠，唤醒后立即处理调度队列
 void mp_hal_delay_ms(mp_uint_t ms) {
-    while (ms-- > 0) {
-        R_BSP_SoftwareDelay(1, BSP_DELAY_UNITS_MILLISECONDS);
-        MICROPY_EVENT_POLL_HOOK;
+    if (!dwt_enabled()) {
+        // 时基初始化之前：软件延时
+        while (ms-- > 0) {
+            R_BSP_SoftwareDelay(1, BSP_DELAY_UNITS_MILLISECONDS);
+            MICROPY_EVENT_POLL_HOOK;
+        }
+        return;
     }
+    delay_until(mp_hal_ticks_cpu64() + (uint64_t)ms * s_cycles_per_ms, true);
 }
 
-// 微秒延时：纯阻塞
+// 微秒延时：不处理调度队列（驱动里的时序等待也会用到）
+// 短延时直接 CYCCNT 忙等并扣除校准开销，精度在几个 CPU 周期内；不足 1ms 的延时不睡眠
 void mp_hal_delay_us(mp_uint_t us) {
-    R_BSP_SoftwareDelay((uint32_t)us, BSP_DELAY_UNITS_MICROSECONDS);
+    uint32_t t0 = DWT->CYCCNT;
+    if (!dwt_enabled()) {
+        R_BSP_SoftwareDelay((uint32_t)us, BSP_DELAY_UNITS_MICROSECONDS);
+        return;
+    }
+    if (us < 1000u) {
+        uint32_t cyc = (uint32_t)us * s_cycles_per_us;
+        if (cyc <= s_spin_overhead) {
+            return;
+        }
+        uint32_t target = t0 + cyc - s_spin_overhead;
+        while ((int32_t)(DWT->CYCCNT - target) < 0) {
+        }
+        return;
+    }
+    delay_until(mp_hal_ticks_cpu64() + (uint64_t)us * s_cycles_per_us, false);
+}
+
+// machine.idle()：睡眠到下一个中断
+void mp_hal_idle(void) {
+    idle_wait(true);
+}
+
+// 空闲统计：返回 WFI 中度过的周期数，*elapsed 为统计起点以来的总周期数
+uint64_t mp_hal_idle_stats(uint64_t *elapsed, bool reset) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint64_t now = mp_hal_ticks_cpu64();
+    uint64_t idle = s_idle_cycles;
+    *elapsed = now - s_idle_since;
+    if (reset) {
+        s_idle_cycles = 0;
+        s_idle_since = now;
+    }
+    __set_PRIMASK(primask);
+    return idle;
 }
 
 // ticks_ms：直接用 SysTick 作为长时基
@@ -63,47 +279,64 @@ mp_uint_t mp_hal_ticks_ms(void) {
     return (mp_uint_t)g_systick_count;
 }
 
-// ticks_us：SysTick(ms)*1000 + (CYCCNT - base) 换算成 0~999us
+// ticks_us：起点微秒 + 本 ms 内增量（一次 UMULL）
 mp_uint_t mp_hal_ticks_us(void) {
     // DWT 不可用：退化为 1ms 分辨率
-    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+    if (!dwt_enabled()) {
         return (mp_uint_t)g_systick_count * 1000u;
     }
+    uint64_t cyc_base, us_base;
+    uint32_t delta = time_snapshot(&cyc_base, &us_base);
+    return (mp_uint_t)us_base + (mp_uint_t)(((uint64_t)delta * s_mult_us) >> 32);
+}
 
-    uint32_t ms1, ms2;
-    uint32_t base1, base2;
-    uint32_t cyc;
-
-    // 稳定快照：确保 ms 与 base 属于同一个毫秒边界
-    do {
-        ms1 = g_systick_count;
-        base1 = g_dwt_cyccnt_ms_base;
-        cyc = DWT->CYCCNT;
-        base2 = g_dwt_cyccnt_ms_base;
-        ms2 = g_systick_count;
-    } while (ms1 != ms2 || base1 != base2);
-
-    // 本 ms 已经过的 cycles（无符号减法，CYCCNT 回绕也成立）
-    uint32_t sub_cycles = (uint32_t)(cyc - base1);
-
-    // 如果 SysTick 中断被延迟，sub_cycles 可能超过 1ms，这里折叠回 0~<1ms
-    if (sub_cycles >= s_cycles_per_ms) {
-        sub_cycles %= s_cycles_per_ms;
+// 64 位单调纳秒（启动后），不回绕
+uint64_t mp_hal_monotonic_ns(void) {
+    if (!dwt_enabled()) {
+        return (uint64_t)g_systick_count * 1000000u;
     }
+    uint64_t cyc_base, us_base;
+    uint32_t delta = time_snapshot(&cyc_base, &us_base);
+    return us_base * 1000u + (((uint64_t)delta * s_mult_ns) >> TICKS_NS_SHIFT);
+}
 
-    // sub_us in [0,999]
-    uint32_t sub_us = (uint32_t)(((uint64_t)sub_cycles * 1000u) / (uint64_t)s_cycles_per_ms);
-    if (sub_us > 999u) {
-        sub_us = 999u;
-    }
+// ticks_ns：monotonic_ns 的低 32 位（约 4.29s 回绕，配合 ticks_diff 使用）
+mp_uint_t mp_hal_ticks_ns(void) {
+    return (mp_uint_t)mp_hal_monotonic_ns();
+}
 
-    return (mp_uint_t)ms1 * 1000u + (mp_uint_t)sub_us;
+// 64 位 CPU 周期计数，不回绕
+uint64_t mp_hal_ticks_cpu64(void) {
+    if (!dwt_enabled()) {
+        return (uint64_t)g_systick_count * s_cycles_per_ms;
+    }
+    uint64_t cyc_base, us_base;
+    uint32_t delta = time_snapshot(&cyc_base, &us_base);
+    return cyc_base + delta;
 }
 
-// ticks_cpu：高分辨率 profiling 用（仍是 32-bit CYCCNT，会在 ~8.95s 回绕）
+// ticks_cpu：高分辨率 profiling 用（32 位 CYCCNT，~8.95s 回绕，ticks_diff 可正确处理）
 mp_uint_t mp_hal_ticks_cpu(void) {
-    if (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) {
+    if (dwt_enabled()) {
         return (mp_uint_t)DWT->CYCCNT;
     }
     return mp_hal_ticks_us();
 }
+
+// 原生代码（viper/native）的缓冲区：M85 不能从 DTCM 取指，跳过 TCM 区域
+void *mp_hal_alloc_exec(size_t len) {
+    void *buf = gc_alloc(len, GC_ALLOC_FLAG_NO_TCM);
+    if (buf == NULL) {
+        m_malloc_fail(len);
+    }
+    return buf;
+}
+
+// 原生代码（viper/native）提交：新生成的机器码可能落在 I-Cache 中旧代码的地址上
+// D-Cache 未启用（BSP_CFG_DCACHE_ENABLED = 0），数据已在 RAM 中，只需失效 I-Cache
+void *mp_hal_commit_exec(void *buf, unsigned int len) {
+    (void)len;
+    __DSB();
+    SCB_InvalidateICache();
+    return buf;
+}
@@ -5,6 +5,9 @@
 #include "py/mphal.h"
 #include "py/mperrno.h"
 #include "py/stackctrl.h"
+#include "shared/runtime/gchelper.h"
+
+#include "bsp_api.h"
 
 #include <stdint.h>
 
@@ -18,30 +21,76 @@ mp_lexer_t *mp_lexer_new_from_file(qstr filename) {
 }
 
 /*
- * 最简 GC：扫描当前栈区
+ * GC 根：先把 r4-r12、sp 存进栈上的数组（shared/runtime/gchelper_thumb2.s），
+ * 再从当前 sp 扫描到 stack_top，寄存器里的指针随数组一起被扫描到
  * 依赖 hal_entry.c 已正确调用：mp_stack_set_top + mp_stack_set_limit + mp_stack_ctrl_init
  */
 void gc_collect(void) {
     gc_collect_start();
+    gc_helper_collect_regs_and_stack();
+    gc_collect_end();
+}
 
-    // 把一些“可能在寄存器里的值”压到栈上，增大被扫描到的概率
-    volatile uintptr_t regs[16];
-    for (size_t i = 0; i < (sizeof(regs) / sizeof(regs[0])); i++) {
-        regs[i] = 0;
-    }
+#if MICROPY_GC_INCREMENTAL
+// 增量 GC 的根（空闲时由 mp_hal_ra8d1.c 的 delay_until 调用）。
+// 根范围要到标记结束才扫描，期间必须保持不变：
+// 寄存器保存到静态数组；栈从调用者 delay_until 的栈指针开始（空闲期间上面的帧不变）
+static gc_helper_regs_t s_inc_regs;
 
-    // 当前 sp 近似取 regs 的地址（在栈上）
-    void **sp = (void **)&regs[0];
+void mp_gc_inc_start(void *stack_bottom) {
+    gc_inc_start();
+
+    gc_helper_get_regs_and_sp(s_inc_regs);
+    gc_collect_root((void **)s_inc_regs, MP_ARRAY_SIZE(s_inc_regs));
 
-    // 栈顶由 mp_stack_set_top 设置，Cortex-M 栈向下增长：top > sp
     void *stack_top = (void *)MP_STATE_THREAD(stack_top);
+    if ((uintptr_t)stack_top > (uintptr_t)stack_bottom) {
+        gc_collect_root(stack_bottom, ((uintptr_t)stack_top - (uintptr_t)stack_bottom) / sizeof(void *));
+    }
+}
+#endif
+
+//==================== 栈水位 ====================//
+// 启动时把主栈（g_main_stack，startup.c）当前 sp 以下的部分填成固定图案，
+// 之后从栈底向上找第一个被改写的字，得到 stack_top 以下用到过的最大深度（含中断帧）
 
-    if ((uintptr_t)stack_top > (uintptr_t)sp) {
-        mp_uint_t n = (mp_uint_t)(((uintptr_t)stack_top - (uintptr_t)sp) / sizeof(void *));
-        gc_collect_root(sp, n);
+#define STACK_PAINT (0xA5A5A5A5u)
+
+extern uint8_t g_main_stack[];
+
+// 必须在屏蔽中断时调用：中断帧会压在 sp 下方，正好是要填充的区域。
+// 一直填到本函数的 sp：本函数的帧在 sp 之上，sp 以下没有活的数据；
+// 少填一段的话，reset 之后的第一次 stack_peak 会把这段算成用过的
+static void stack_paint(void) {
+    uint32_t *p = (uint32_t *)g_main_stack;
+    uint32_t *end = (uint32_t *)__get_MSP();
+    while (p < end) {
+        *p++ = STACK_PAINT;
     }
+}
 
-    gc_collect_end();
+void mp_stack_paint_init(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    stack_paint();
+    __set_PRIMASK(primask);
+}
+
+mp_uint_t mp_hal_stack_peak(bool reset) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    const uint32_t *p = (const uint32_t *)g_main_stack;
+    const uint32_t *top = (const uint32_t *)MP_STATE_THREAD(stack_top);
+    while (p < top && *p == STACK_PAINT) {
+        p++;
+    }
+    mp_uint_t peak = (uintptr_t)top - (uintptr_t)p;
+    if (reset) {
+        // 重新填充当前 sp 以下的部分，从现在起重新统计
+        stack_paint();
+    }
+    __set_PRIMASK(primask);
+    return peak;
 }
 
 // nlr_jump 失败时调用：一般是致命异常
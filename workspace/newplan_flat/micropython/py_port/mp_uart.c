@@ -7,6 +7,7 @@
 #include "py/mpconfig.h"
 #include "py/mphal.h"
 #include "py/runtime.h"         // mp_keyboard_interrupt (if enabled)
+#include "py/mptrace.h"
 
 #include <string.h>
 #include <stdint.h>
@@ -125,6 +126,7 @@ void uart_callback(uart_callback_args_t *p_args) {
     if (!p_args) {
         return;
     }
+    MP_TRACE_EVENT(MP_TRACE_ISR_UART, p_args->event);
 
     if (p_args->event == UART_EVENT_RX_COMPLETE) {
         s_rx_armed = false;
@@ -3,6 +3,17 @@
 
 #include "hal_data.h"
 #include "py/obj.h"
+
+// 原子区：关中断并返回进入前的 PRIMASK，退出时恢复（可嵌套，可在中断中使用）。
+// 调度队列、定时轮等在中断和主循环之间共享的状态靠它保护；要在 py/mphal.h 的空默认定义之前给出
+static inline mp_uint_t ra_atomic_begin(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+#define MICROPY_BEGIN_ATOMIC_SECTION()     ra_atomic_begin()
+#define MICROPY_END_ATOMIC_SECTION(state)  __set_PRIMASK(state)
+
 #include "py/mphal.h"   // MicroPython HAL 接口声明
 
 // --- tick 相关 ----------------------------------------------------
@@ -12,15 +23,31 @@
 mp_uint_t mp_hal_ticks_ms(void);
 mp_uint_t mp_hal_ticks_us(void);
 mp_uint_t mp_hal_ticks_cpu(void);
+mp_uint_t mp_hal_ticks_ns(void);
 
-// --- 延时相关：直接用 FSP 的软件延时 -------------------------------
+// 64 位时基：启动后的纳秒数 / CPU 周期数，不回绕
+uint64_t mp_hal_monotonic_ns(void);
+uint64_t mp_hal_ticks_cpu64(void);
 
-static inline void mp_hal_delay_ms(mp_uint_t ms) {
-    R_BSP_SoftwareDelay((uint32_t) ms, BSP_DELAY_UNITS_MILLISECONDS);
-}
+// 启动时初始化 DWT 时基；SysTick ISR（hal_entry.c）每 1ms 调用 mp_hal_time_tick 推进
+void mp_hal_time_init(void);
+void mp_hal_time_tick(void);
 
-static inline void mp_hal_delay_us(mp_uint_t us) {
-    R_BSP_SoftwareDelay((uint32_t) us, BSP_DELAY_UNITS_MICROSECONDS);
-}
+// --- 延时相关：WFI 睡眠 + CYCCNT 忙等，实现在 mp_hal_ra8d1.c 中 ----
+
+void mp_hal_delay_ms(mp_uint_t ms);
+void mp_hal_delay_us(mp_uint_t us);
+
+// 空闲：睡眠到下一个中断；统计 WFI 中度过的周期数
+void mp_hal_idle(void);
+uint64_t mp_hal_idle_stats(uint64_t *elapsed, bool reset);
+
+// 启动时把主栈未用部分填成固定图案，供 mp_hal_stack_peak（micropython.stack_peak()）使用，实现在 mp_stub.c 中
+void mp_stack_paint_init(void);
+
+#if MICROPY_GC_INCREMENTAL
+// 开始增量 GC 并登记根（寄存器和 stack_bottom 以上的栈），实现在 mp_stub.c 中
+void mp_gc_inc_start(void *stack_bottom);
+#endif
 
 #endif // MICROPY_INCLUDED_RA_MPHALPORT_H
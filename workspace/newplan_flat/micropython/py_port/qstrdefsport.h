@@ -33,3 +33,32 @@ Q(read_u16)
 Q(write)
 Q(rxcnt)
 Q(debug_info)
+Q(readfrom_mem_batch)
+Q(SensorStream)
+Q(record_size)
+Q(stats)
+Q(depth)
+Q(cs)
+Q(ops)
+Q(bus)
+Q(ADCBlock)
+Q(connect)
+Q(channels)
+Q(read_timed)
+Q(overruns)
+Q(read_multi)
+Q(write_timed)
+Q(playing)
+Q(LOOP)
+Q(ONESHOT)
+Q(buf)
+Q(Port)
+Q(mask)
+Q(addr)
+Q(port)
+Q(bitstream)
+Q(capture_pulses)
+Q(ticks_ns)
+Q(monotonic_ns)
+Q(idle)
+Q(idle_stats)
@@ -0,0 +1,123 @@
+/*
+ * ra_dtc.c - Data Transfer Controller helpers (direct register access)
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+#include "py/gc.h"
+#include "bsp_api.h"
+#include "ra_dtc.h"
+
+// DTCVBR ignores the low 10 bits: the vector table must be 1 KB aligned
+static transfer_info_t *ra_dtc_vector_table[BSP_ICU_VECTOR_MAX_ENTRIES] __attribute__((aligned(1024)));
+static bool ra_dtc_started = false;
+
+static void ra_dtc_start(void) {
+    if (ra_dtc_started) {
+        return;
+    }
+
+    R_BSP_MODULE_START(FSP_IP_DTC, 0);
+
+    R_DTC->DTCST = 0;
+    memset(ra_dtc_vector_table, 0, sizeof(ra_dtc_vector_table));
+#if (BSP_FEATURE_TZ_VERSION == 2) && BSP_TZ_SECURE_BUILD
+    R_DTC->DTCVBR_SEC = (uint32_t)ra_dtc_vector_table;
+#else
+    R_DTC->DTCVBR = (uint32_t)ra_dtc_vector_table;
+#endif
+    // Transfer records are rewritten between runs: never skip re-reading them
+    R_DTC->DTCCR_b.RRS = 0;
+    R_DTC->DTCST = 1;
+
+    ra_dtc_started = true;
+}
+
+void *ra_dtc_alloc(size_t n_bytes) {
+    void *ptr = gc_alloc(n_bytes, GC_ALLOC_FLAG_NO_TCM);
+    if (ptr == NULL) {
+        m_malloc_fail(n_bytes);
+    }
+    return ptr;
+}
+
+void ra_dtc_check_buffer(const void *buf, size_t len) {
+    // DTCM size = 2^(DTCMCR.SZ + 9) bytes from 0x20000000 (same as the heap setup in hal_entry.c)
+    uintptr_t dtcm_start = 0x20000000UL;
+    uintptr_t dtcm_end = dtcm_start + (1UL << (((MEMSYSCTL->DTCMCR & MEMSYSCTL_DTCMCR_SZ_Msk) >> MEMSYSCTL_DTCMCR_SZ_Pos) + 9U));
+    uintptr_t a = (uintptr_t)buf;
+    if (a < dtcm_end && a + len > dtcm_start) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer in DTCM, allocate it under gc.alloc_hint(gc.BULK)"));
+    }
+}
+
+void ra_dtc_set_info(IRQn_Type irq, transfer_info_t *info) {
+    ra_dtc_start();
+    ra_dtc_vector_table[irq] = info;
+    __DSB();
+}
+
+void ra_dtc_enable(IRQn_Type irq) {
+    R_ICU->IELSR_b[irq].DTCE = 1;
+}
+
+void ra_dtc_disable(IRQn_Type irq) {
+    R_ICU->IELSR_b[irq].DTCE = 0;
+}
+
+void ra_dtc_info_block16(transfer_info_t *info, const volatile void *src, void *dest,
+                         uint8_t block_len, uint16_t num_blocks) {
+    info->transfer_settings_word = 0;
+    info->transfer_settings_word_b.mode = TRANSFER_MODE_BLOCK;
+    info->transfer_settings_word_b.size = TRANSFER_SIZE_2_BYTE;
+    info->transfer_settings_word_b.src_addr_mode = TRANSFER_ADDR_MODE_INCREMENTED;
+    info->transfer_settings_word_b.dest_addr_mode = TRANSFER_ADDR_MODE_INCREMENTED;
+    info->transfer_settings_word_b.repeat_area = TRANSFER_REPEAT_AREA_SOURCE;
+    info->transfer_settings_word_b.irq = TRANSFER_IRQ_END;
+    info->transfer_settings_word_b.chain_mode = TRANSFER_CHAIN_MODE_DISABLED;
+    info->p_src = (const void *)src;
+    info->p_dest = dest;
+    // CRA holds the block size twice (reload value in the upper byte)
+    info->length = (uint16_t)((block_len << 8) | block_len);
+    info->num_blocks = num_blocks;
+}
+
+void ra_dtc_info_normal16(transfer_info_t *info, const void *src, volatile void *dest, uint16_t count) {
+    info->transfer_settings_word = 0;
+    info->transfer_settings_word_b.mode = TRANSFER_MODE_NORMAL;
+    info->transfer_settings_word_b.size = TRANSFER_SIZE_2_BYTE;
+    info->transfer_settings_word_b.src_addr_mode = TRANSFER_ADDR_MODE_INCREMENTED;
+    info->transfer_settings_word_b.dest_addr_mode = TRANSFER_ADDR_MODE_FIXED;
+    info->transfer_settings_word_b.irq = TRANSFER_IRQ_END;
+    info->transfer_settings_word_b.chain_mode = TRANSFER_CHAIN_MODE_DISABLED;
+    info->p_src = src;
+    info->p_dest = (void *)dest;
+    info->length = count;
+    info->num_blocks = 0;
+}
+
+void ra_dtc_info_repeat16(transfer_info_t *info, const void *src, volatile void *dest, uint16_t count) {
+    ra_dtc_info_normal16(info, src, dest, count);
+    info->transfer_settings_word_b.mode = TRANSFER_MODE_REPEAT;
+    info->transfer_settings_word_b.repeat_area = TRANSFER_REPEAT_AREA_SOURCE;
+    // CRA holds the repeat size twice (reload value in the upper byte), 256 is encoded as 0
+    uint8_t n = (uint8_t)count;
+    info->length = (uint16_t)((n << 8) | n);
+}
+
+void ra_dtc_info_write32(transfer_info_t *info, const void *src, volatile void *dest, uint16_t count) {
+    ra_dtc_info_normal16(info, src, dest, count);
+    info->transfer_settings_word_b.size = TRANSFER_SIZE_4_BYTE;
+}
+
+void ra_dtc_info_read32(transfer_info_t *info, const volatile void *src, void *dest, uint16_t count) {
+    ra_dtc_info_normal16(info, (const void *)src, dest, count);
+    info->transfer_settings_word_b.size = TRANSFER_SIZE_4_BYTE;
+    info->transfer_settings_word_b.src_addr_mode = TRANSFER_ADDR_MODE_FIXED;
+    info->transfer_settings_word_b.dest_addr_mode = TRANSFER_ADDR_MODE_INCREMENTED;
+}
+
+void ra_dtc_info_chain(transfer_info_t *info) {
+    info->transfer_settings_word_b.chain_mode = TRANSFER_CHAIN_MODE_EACH;
+}
@@ -0,0 +1,52 @@
+#ifndef MICROPY_INCLUDED_RA8D1_RA_DTC_H
+#define MICROPY_INCLUDED_RA8D1_RA_DTC_H
+
+#include <stddef.h>
+
+#include "bsp_api.h"
+#include "r_transfer_api.h"  // transfer_info_t (hardware layout of a DTC transfer record)
+
+// Minimal DTC support for py_port peripherals (no r_dtc driver in this project)
+//
+// The DTC is activated by the same IELSR slot that would otherwise interrupt
+// the CPU. While IELSR.DTCE is set each event triggers one transfer; when the
+// transfer count runs out DTCE is cleared and the event is passed to the CPU
+// instead, which is where the owner re-arms or finishes the transfer.
+
+// The DTC is a bus master and cannot reach the CPU's DTCM. Transfer records
+// and buffers that the DTC reads or writes must live elsewhere: drivers
+// allocate them with ra_dtc_alloc, and check buffers passed in by Python code
+// with ra_dtc_check_buffer (raises ValueError for a buffer in DTCM; small
+// buffers allocated under gc.alloc_hint(gc.BULK) never land there).
+void *ra_dtc_alloc(size_t n_bytes);
+void ra_dtc_check_buffer(const void *buf, size_t len);
+
+// Point the DTC vector of irq at info (info must stay valid while enabled)
+void ra_dtc_set_info(IRQn_Type irq, transfer_info_t *info);
+
+// Let the event of irq activate the DTC / stop doing so
+void ra_dtc_enable(IRQn_Type irq);
+void ra_dtc_disable(IRQn_Type irq);
+
+// Fill info for a 16-bit block transfer: every event copies block_len halfwords
+// starting at src (restored after each block) to dest (keeps incrementing).
+void ra_dtc_info_block16(transfer_info_t *info, const volatile void *src, void *dest,
+                         uint8_t block_len, uint16_t num_blocks);
+
+// Fill info for a normal 16-bit transfer: every event copies one halfword
+// from src (incrementing) to the fixed register dest, count times.
+void ra_dtc_info_normal16(transfer_info_t *info, const void *src, volatile void *dest, uint16_t count);
+
+// Same as normal16, but src wraps back to its start after count transfers and
+// the transfer never ends (count <= 256, no CPU interrupt).
+void ra_dtc_info_repeat16(transfer_info_t *info, const void *src, volatile void *dest, uint16_t count);
+
+// 32-bit normal transfers for GPT registers: write32 copies from src (incrementing)
+// to the fixed register dest, read32 from the fixed register src to dest (incrementing).
+void ra_dtc_info_write32(transfer_info_t *info, const void *src, volatile void *dest, uint16_t count);
+void ra_dtc_info_read32(transfer_info_t *info, const volatile void *src, void *dest, uint16_t count);
+
+// Run info[1] right after every transfer of info[0] (the two records must be adjacent)
+void ra_dtc_info_chain(transfer_info_t *info);
+
+#endif // MICROPY_INCLUDED_RA8D1_RA_DTC_H
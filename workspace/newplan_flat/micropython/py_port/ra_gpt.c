@@ -0,0 +1,147 @@
+/*
+ * ra_gpt.c - General PWM Timer helpers (direct register access)
+ */
+
+#include "bsp_api.h"
+#include "ra_gpt.h"
+
+#define RA_GPT_REG_STRIDE     ((uint32_t)R_GPT1 - (uint32_t)R_GPT0)
+#define RA_GPT_EVENT_STRIDE   (ELC_EVENT_GPT1_COUNTER_OVERFLOW - ELC_EVENT_GPT0_COUNTER_OVERFLOW)
+
+R_GPT0_Type *ra_gpt_regs(uint8_t ch) {
+    return (R_GPT0_Type *)((uint32_t)R_GPT0 + RA_GPT_REG_STRIDE * ch);
+}
+
+uint32_t ra_gpt_clock_hz(void) {
+    return R_FSP_SystemClockHzGet(FSP_PRIV_CLOCK_PCLKD);
+}
+
+uint32_t ra_gpt_periodic_init(uint8_t ch, uint32_t freq) {
+    uint32_t clock_hz = ra_gpt_clock_hz();
+    if (freq == 0 || freq > clock_hz / 2) {
+        return 0;
+    }
+    uint32_t period = clock_hz / freq;
+    if (!(BSP_FEATURE_GPT_32BIT_CHANNEL_MASK & (1U << ch)) && period > 0x10000) {
+        return 0;
+    }
+
+    R_BSP_MODULE_START(FSP_IP_GPT, ch);
+
+    R_GPT0_Type *gpt = ra_gpt_regs(ch);
+    gpt->GTCR = 0;                                  // stop, saw-wave PWM mode, PCLKD/1
+    gpt->GTUDDTYC = R_GPT0_GTUDDTYC_UDF_Msk | R_GPT0_GTUDDTYC_UD_Msk;
+    gpt->GTUDDTYC = R_GPT0_GTUDDTYC_UD_Msk;         // count up
+    gpt->GTPR = period - 1;
+    gpt->GTPBR = period - 1;
+    gpt->GTCNT = 0;
+    gpt->GTST = 0;
+
+    return period;
+}
+
+// GTCR.TPCS divides PCLKD by 2^TPCS; 7 and 9 are reserved on RA8D1
+static const uint8_t ra_gpt_tpcs[] = {0, 1, 2, 3, 4, 5, 6, 8, 10};
+
+uint64_t ra_gpt_periodic_init_counts(uint8_t ch, uint64_t counts, uint32_t *repeat) {
+    uint64_t max = (BSP_FEATURE_GPT_32BIT_CHANNEL_MASK & (1U << ch)) ? 0x100000000ULL : 0x10000ULL;
+    if (counts < 2) {
+        return 0;
+    }
+
+    // Smallest prescaler that fits, else the largest one plus a postscaler
+    uint32_t n = 1;
+    uint8_t tpcs = ra_gpt_tpcs[sizeof(ra_gpt_tpcs) - 1];
+    for (size_t i = 0; i < sizeof(ra_gpt_tpcs); i++) {
+        if ((counts >> ra_gpt_tpcs[i]) <= max) {
+            tpcs = ra_gpt_tpcs[i];
+            break;
+        }
+    }
+    uint64_t period = counts >> tpcs;
+    if (period > max) {
+        uint64_t reps = (period + max - 1) / max;
+        if (reps > 0xFFFFFFFFULL) {
+            return 0;
+        }
+        n = (uint32_t)reps;
+        period /= n;
+    }
+
+    R_BSP_MODULE_START(FSP_IP_GPT, ch);
+
+    R_GPT0_Type *gpt = ra_gpt_regs(ch);
+    gpt->GTCR = (uint32_t)tpcs << R_GPT0_GTCR_TPCS_Pos;    // stop, saw-wave PWM mode
+    gpt->GTUDDTYC = R_GPT0_GTUDDTYC_UDF_Msk | R_GPT0_GTUDDTYC_UD_Msk;
+    gpt->GTUDDTYC = R_GPT0_GTUDDTYC_UD_Msk;         // count up
+    gpt->GTPR = (uint32_t)(period - 1);
+    gpt->GTPBR = (uint32_t)(period - 1);
+    gpt->GTCNT = 0;
+    gpt->GTST = 0;
+
+    *repeat = n;
+    return period << tpcs;
+}
+
+void ra_gpt_start(uint8_t ch) {
+    ra_gpt_regs(ch)->GTCR_b.CST = 1;
+}
+
+void ra_gpt_stop(uint8_t ch) {
+    R_GPT0_Type *gpt = ra_gpt_regs(ch);
+    gpt->GTCR_b.CST = 0;
+    gpt->GTCNT = 0;
+}
+
+elc_event_t ra_gpt_overflow_event(uint8_t ch) {
+    return (elc_event_t)(ELC_EVENT_GPT0_COUNTER_OVERFLOW + RA_GPT_EVENT_STRIDE * ch);
+}
+
+elc_event_t ra_gpt_capture_event(uint8_t ch, bool io_b) {
+    return (elc_event_t)(ELC_EVENT_GPT0_CAPTURE_COMPARE_A + RA_GPT_EVENT_STRIDE * ch + (io_b ? 1 : 0));
+}
+
+typedef struct _ra_gpt_pin_t {
+    bsp_io_port_pin_t pin;
+    uint8_t ch;
+    uint8_t io_b;
+} ra_gpt_pin_t;
+
+// From the pin function list of the FSP configuration (ra_cfg.txt)
+static const ra_gpt_pin_t ra_gpt_pins[] = {
+    {BSP_IO_PORT_01_PIN_15, 5, 0},   // P115 GTIOC5A
+    {BSP_IO_PORT_03_PIN_01, 4, 1},   // P301 GTIOC4B
+    {BSP_IO_PORT_03_PIN_02, 4, 0},   // P302 GTIOC4A
+    {BSP_IO_PORT_03_PIN_03, 7, 1},   // P303 GTIOC7B
+    {BSP_IO_PORT_03_PIN_04, 7, 0},   // P304 GTIOC7A
+    {BSP_IO_PORT_04_PIN_00, 6, 0},   // P400 GTIOC6A
+    {BSP_IO_PORT_04_PIN_01, 6, 1},   // P401 GTIOC6B
+    {BSP_IO_PORT_06_PIN_00, 6, 1},   // P600 GTIOC6B
+    {BSP_IO_PORT_06_PIN_01, 6, 0},   // P601 GTIOC6A
+    {BSP_IO_PORT_06_PIN_02, 7, 1},   // P602 GTIOC7B
+    {BSP_IO_PORT_06_PIN_03, 7, 0},   // P603 GTIOC7A
+    {BSP_IO_PORT_06_PIN_09, 5, 1},   // P609 GTIOC5B
+    {BSP_IO_PORT_06_PIN_10, 4, 0},   // P610 GTIOC4A
+    {BSP_IO_PORT_06_PIN_11, 4, 1},   // P611 GTIOC4B
+    {BSP_IO_PORT_07_PIN_00, 5, 0},   // P700 GTIOC5A
+    {BSP_IO_PORT_07_PIN_01, 5, 1},   // P701 GTIOC5B
+    {BSP_IO_PORT_07_PIN_02, 6, 0},   // P702 GTIOC6A
+    {BSP_IO_PORT_07_PIN_03, 6, 1},   // P703 GTIOC6B
+    {BSP_IO_PORT_09_PIN_14, 5, 1},   // P914 GTIOC5B
+    {BSP_IO_PORT_09_PIN_15, 5, 0},   // P915 GTIOC5A
+    {BSP_IO_PORT_10_PIN_06, 7, 1},   // PA06 GTIOC7B
+    {BSP_IO_PORT_10_PIN_07, 7, 0},   // PA07 GTIOC7A
+    {BSP_IO_PORT_10_PIN_11, 6, 0},   // PA11 GTIOC6A
+    {BSP_IO_PORT_10_PIN_12, 6, 1},   // PA12 GTIOC6B
+};
+
+bool ra_gpt_pin_lookup(bsp_io_port_pin_t pin, uint8_t *ch, bool *io_b) {
+    for (size_t i = 0; i < sizeof(ra_gpt_pins) / sizeof(ra_gpt_pins[0]); i++) {
+        if (ra_gpt_pins[i].pin == pin) {
+            *ch = ra_gpt_pins[i].ch;
+            *io_b = ra_gpt_pins[i].io_b;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,44 @@
+#ifndef MICROPY_INCLUDED_RA8D1_RA_GPT_H
+#define MICROPY_INCLUDED_RA8D1_RA_GPT_H
+
+#include "bsp_api.h"
+
+// Minimal GPT support for py_port peripherals (no r_gpt driver in this project)
+//
+// Channels 0-7 are 32-bit on RA8D1 and count PCLKD. The timers are used as
+// hardware pacing sources: their overflow event is routed through the ELC to
+// ADC/DAC/DTC, so the sample clock does not depend on CPU or VM latency.
+
+#define RA_GPT_NUM_CHANNELS  (14)
+
+// Register block of channel ch
+R_GPT0_Type *ra_gpt_regs(uint8_t ch);
+
+// Count clock in Hz (PCLKD, no prescaler)
+uint32_t ra_gpt_clock_hz(void);
+
+// Set channel ch up as a saw-wave up counter overflowing freq times per second.
+// The counter is left stopped. Returns the period in counts, 0 if freq is out of range.
+uint32_t ra_gpt_periodic_init(uint8_t ch, uint32_t freq);
+
+// Set channel ch up to overflow every `counts` PCLKD cycles, for timers that are
+// not tied to an exact ELC rate. Uses the smallest GTCR.TPCS prescaler that fits
+// the counter width; a period longer than the largest prescaler allows is split
+// into *repeat equal overflows (software postscaler, the ISR counts them).
+// Returns the PCLKD cycles per overflow, 0 if counts is out of range.
+uint64_t ra_gpt_periodic_init_counts(uint8_t ch, uint64_t counts, uint32_t *repeat);
+
+void ra_gpt_start(uint8_t ch);
+void ra_gpt_stop(uint8_t ch);
+
+// ELC event raised on counter overflow of channel ch
+elc_event_t ra_gpt_overflow_event(uint8_t ch);
+
+// ELC event raised on capture/compare match A (or B) of channel ch
+elc_event_t ra_gpt_capture_event(uint8_t ch, bool io_b);
+
+// GTIOCnA/GTIOCnB pin of the channels free for pin I/O (GPT4-7: 32-bit, not used
+// for ADC/DAC pacing). Returns false if pin has no such function.
+bool ra_gpt_pin_lookup(bsp_io_port_pin_t pin, uint8_t *ch, bool *io_b);
+
+#endif // MICROPY_INCLUDED_RA8D1_RA_GPT_H
@@ -0,0 +1,118 @@
+/*
+ * ra_irq.c - Runtime interrupt allocation (RAM vector table + IELSR slots)
+ */
+
+#include <string.h>
+
+#include "bsp_api.h"
+#include "ra_irq.h"
+
+#define RA_IRQ_VECTOR_ENTRIES   (BSP_VECTOR_TABLE_MAX_ENTRIES)
+#define RA_IRQ_FIRST_DYNAMIC    ((int)BSP_ICU_VECTOR_NUM_ENTRIES)
+#define RA_IRQ_LAST_DYNAMIC     ((int)BSP_ICU_VECTOR_MAX_ENTRIES - 1)
+
+// VTOR needs the table aligned to the next power of two of its size (112 words -> 512 bytes)
+static uint32_t ra_irq_vector_table[RA_IRQ_VECTOR_ENTRIES] __attribute__((aligned(512)));
+static bool ra_irq_vector_table_in_ram = false;
+static const uint32_t *ra_irq_rom_vectors;
+
+static void *ra_irq_contexts[BSP_ICU_VECTOR_MAX_ENTRIES];
+static bool ra_irq_allocated[BSP_ICU_VECTOR_MAX_ENTRIES];
+
+static void ra_irq_vector_table_to_ram(void) {
+    if (ra_irq_vector_table_in_ram) {
+        return;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    ra_irq_rom_vectors = (const uint32_t *)SCB->VTOR;
+    memcpy(ra_irq_vector_table, ra_irq_rom_vectors, sizeof(ra_irq_vector_table));
+    __DSB();
+    SCB->VTOR = (uint32_t)ra_irq_vector_table;
+    __DSB();
+    __ISB();
+    __set_PRIMASK(primask);
+
+    ra_irq_vector_table_in_ram = true;
+}
+
+static IRQn_Type ra_irq_install(int irq, ra_irq_handler_t isr, uint32_t priority, void *context) {
+    ra_irq_allocated[irq] = true;
+    ra_irq_contexts[irq] = context;
+    ra_irq_vector_table[BSP_CORTEX_VECTOR_TABLE_ENTRIES + irq] = (uint32_t)isr;
+
+    R_BSP_IrqStatusClear((IRQn_Type)irq);
+    NVIC_ClearPendingIRQ((IRQn_Type)irq);
+    NVIC_SetPriority((IRQn_Type)irq, priority);
+    NVIC_EnableIRQ((IRQn_Type)irq);
+
+    return (IRQn_Type)irq;
+}
+
+IRQn_Type ra_irq_alloc(elc_event_t event, ra_irq_handler_t isr, uint32_t priority, void *context) {
+    ra_irq_vector_table_to_ram();
+
+    // The e2studio project may already link this event to a slot (e.g. ICU IRQ12 for
+    // g_external_irq_s2). Linking one event to two slots is not allowed, so take it over.
+    for (int irq = 0; irq < RA_IRQ_FIRST_DYNAMIC; irq++) {
+        if ((R_ICU->IELSR[irq] & R_ICU_IELSR_IELS_Msk) == (uint32_t)event) {
+            if (ra_irq_allocated[irq]) {
+                return RA_IRQ_INVALID;
+            }
+            NVIC_DisableIRQ((IRQn_Type)irq);
+            return ra_irq_install(irq, isr, priority, context);
+        }
+    }
+
+    for (int irq = RA_IRQ_FIRST_DYNAMIC; irq <= RA_IRQ_LAST_DYNAMIC; irq++) {
+        // A slot is free if nobody (FSP or us) linked an event to it
+        if (ra_irq_allocated[irq] || R_ICU->IELSR[irq] != 0) {
+            continue;
+        }
+
+        R_ICU->IELSR[irq] = (uint32_t)event;
+        return ra_irq_install(irq, isr, priority, context);
+    }
+
+    return RA_IRQ_INVALID;
+}
+
+void ra_irq_free(IRQn_Type irq) {
+    if (irq < 0 || irq > RA_IRQ_LAST_DYNAMIC || !ra_irq_allocated[irq]) {
+        return;
+    }
+
+    NVIC_DisableIRQ(irq);
+    if (irq < RA_IRQ_FIRST_DYNAMIC) {
+        // Slot taken over from the FSP configuration: keep the link, restore its ISR
+        ra_irq_vector_table[BSP_CORTEX_VECTOR_TABLE_ENTRIES + irq] =
+            ra_irq_rom_vectors[BSP_CORTEX_VECTOR_TABLE_ENTRIES + irq];
+    } else {
+        R_ICU->IELSR[irq] = 0;
+    }
+    NVIC_ClearPendingIRQ(irq);
+
+    ra_irq_contexts[irq] = NULL;
+    ra_irq_allocated[irq] = false;
+}
+
+void ra_irq_set_context(IRQn_Type irq, void *context) {
+    if (irq < 0 || (uint32_t)irq >= BSP_ICU_VECTOR_MAX_ENTRIES) {
+        return;
+    }
+    ra_irq_contexts[irq] = context;
+}
+
+void *ra_irq_context_get(IRQn_Type irq) {
+    if (irq < 0 || (uint32_t)irq >= BSP_ICU_VECTOR_MAX_ENTRIES) {
+        return NULL;
+    }
+    return ra_irq_contexts[irq];
+}
+
+void ra_irq_deinit_all(void) {
+    for (int irq = 0; irq <= RA_IRQ_LAST_DYNAMIC; irq++) {
+        ra_irq_free((IRQn_Type)irq);
+    }
+}
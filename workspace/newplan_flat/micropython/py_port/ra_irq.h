@@ -0,0 +1,35 @@
+#ifndef MICROPY_INCLUDED_RA8D1_RA_IRQ_H
+#define MICROPY_INCLUDED_RA8D1_RA_IRQ_H
+
+#include "bsp_api.h"
+
+// Runtime interrupt allocation for RA8D1
+//
+// The FSP vector table (ra_gen/vector_data.c) is const and only covers the
+// interrupts configured in the e2studio project. Peripherals driven directly
+// from py_port (GPT, DTC-fed ADC/DAC, ...) get their NVIC slot here instead:
+// the vector table is copied to RAM once, SCB->VTOR is moved to it, and free
+// IELSR slots above the FSP ones are linked to the requested ELC event.
+
+#define RA_IRQ_INVALID  ((IRQn_Type)-1)
+
+typedef void (*ra_irq_handler_t)(void);
+
+// Allocate an IELSR slot for event, install isr and enable it in the NVIC.
+// If the FSP configuration already links event to a slot, that slot is reused.
+// Returns RA_IRQ_INVALID if all slots are in use.
+IRQn_Type ra_irq_alloc(elc_event_t event, ra_irq_handler_t isr, uint32_t priority, void *context);
+
+// Disable the interrupt and release its slot
+void ra_irq_free(IRQn_Type irq);
+
+// Replace the context pointer of an allocated slot
+void ra_irq_set_context(IRQn_Type irq, void *context);
+
+// Context pointer of an allocated slot (FSP's R_FSP_IsrContextGet only covers the FSP slots)
+void *ra_irq_context_get(IRQn_Type irq);
+
+// Release every slot allocated at runtime (soft reset)
+void ra_irq_deinit_all(void);
+
+#endif // MICROPY_INCLUDED_RA8D1_RA_IRQ_H
@@ -35,6 +35,7 @@
 #include "py/gc.h"
 #include "py/frozenmod.h"
 #include "py/mphal.h"
+#include "py/mptrace.h"
 #include "shared/readline/readline.h"
 #include "shared/runtime/pyexec.h"
 #include "genhdr/mpversion.h"
@@ -68,6 +69,7 @@ static int parse_compile_execute(const void *source, mp_parse_input_kind_t input
     #ifdef MICROPY_BOARD_BEFORE_PYTHON_EXEC
     MICROPY_BOARD_BEFORE_PYTHON_EXEC(input_kind, exec_flags);
     #endif
+    MP_TRACE_EVENT(MP_TRACE_PYEXEC_BEGIN, input_kind);
 
     nlr_buf_t nlr;
     nlr.ret_val = NULL;
@@ -200,6 +202,7 @@ static int parse_compile_execute(const void *source, mp_parse_input_kind_t input
     if (exec_flags & EXEC_FLAG_PRINT_EOF) {
         mp_hal_stdout_tx_strn("\x04", 1);
     }
+    MP_TRACE_EVENT(MP_TRACE_PYEXEC_END, ret);
 
     #ifdef MICROPY_BOARD_AFTER_PYTHON_EXEC
     MICROPY_BOARD_AFTER_PYTHON_EXEC(input_kind, exec_flags, nlr.ret_val, &ret);
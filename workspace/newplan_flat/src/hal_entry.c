@@ -9,15 +9,21 @@
 #include "py/gc.h"
 #include "py/stackctrl.h"
 #include "py/pystack.h"
+#include "py/sampleprof.h"
 #include "shared/runtime/pyexec.h"
 #include "shared/readline/readline.h"
 
+/* 软复位前停止 ISR/DTC 驱动的外设，释放运行时分配的中断槽（*_deinit_all） */
+#include "machine_sensor_stream.h"
+#include "machine_adc_block.h"
+#include "machine_dac.h"
+#include "machine_pin.h"
+#include "machine_timer.h"
+#include "ra_irq.h"
+
 /* CMSIS: DWT/CoreDebug */
 #include <core_cm85.h>
 
-/* DWT 时间初始化（在 mp_hal_ra8d1.c 里实现） */
-void mp_hal_time_init(void);
-
 /* 串口底层在 mp_uart.c 里实现 */
 void mp_uart_init(void);
 
@@ -28,24 +34,51 @@ void mp_uart_init(void);
 static uint8_t mp_heap[MP_HEAP_SIZE];
 
 #if MICROPY_ENABLE_PYSTACK
-static mp_obj_t mp_pystack[1024];
+/* pystack 在 DTCM 中，紧接 FSP 的 DTCM 段之后，起止地址由链接脚本（script/fsp.ld 的 .mp_pystack 段）给出 */
+extern uint8_t __mp_pystack_start[];
+extern uint8_t __mp_pystack_end[];
+#endif
+
+/* 多区域堆：DTCM 区域在前（同类区域按链表顺序查找），SRAM 主堆其次，SDRAM 标记为 BULK */
+static void mp_heap_init(void) {
+#if MICROPY_HW_DTCM_HEAP_SIZE
+    /* DTCM 大小 = 2^(DTCMCR.SZ + 9) 字节，堆放在顶端，不与下面的 pystack 重叠 */
+    uint32_t dtcm_size = 1U << (((MEMSYSCTL->DTCMCR & MEMSYSCTL_DTCMCR_SZ_Msk) >> MEMSYSCTL_DTCMCR_SZ_Pos) + 9U);
+    uint8_t *dtcm_end = (uint8_t *)(0x20000000UL + dtcm_size);
+    uint8_t *dtcm_heap = dtcm_end - MICROPY_HW_DTCM_HEAP_SIZE;
+#if MICROPY_ENABLE_PYSTACK
+    if (dtcm_heap < __mp_pystack_end) {
+        dtcm_heap = __mp_pystack_end;
+    }
+#endif
+    /* CPU 不能从 DTCM 取指，DTC 也访问不到：标记为 TCM，机器码和 DTC 用的内存不会分配到这里 */
+    gc_init_kind(dtcm_heap, dtcm_end, GC_AREA_FAST | GC_AREA_TCM);
+    gc_add(mp_heap, mp_heap + MP_HEAP_SIZE);
+#else
+    gc_init(mp_heap, mp_heap + MP_HEAP_SIZE);
 #endif
 
+#if MICROPY_HW_SDRAM_HEAP_SIZE
+    uint8_t *sdram = (uint8_t *)BSP_FEATURE_SDRAM_START_ADDRESS;
+    gc_add_kind(sdram, sdram + MICROPY_HW_SDRAM_HEAP_SIZE, GC_AREA_BULK);
+#endif
+}
+
 /*-------------------------------
  * SysTick 1ms
  *------------------------------*/
 volatile uint32_t g_systick_count = 0;
 
-/* 在 mp_hal_ra8d1.c 里定义，用于记录“本 ms 起点”的 CYCCNT */
-extern volatile uint32_t g_dwt_cyccnt_ms_base;
-
 void SysTick_Handler(void) {
     g_systick_count++;
 
-    // 记录“本 ms 起点”的 CYCCNT，供 ticks_us 计算 ms 内子微秒，保证单调不倒退
-    if (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) {
-        g_dwt_cyccnt_ms_base = DWT->CYCCNT;
-    }
+    // 按整毫秒推进 64 位时基，CYCCNT 的 32 位回绕由此吸收
+    mp_hal_time_tick();
+
+#if MICROPY_PY_MICROPYTHON_PROFILE
+    // 采样 profiler：记录当前正在执行的字节码帧（只在 profile_start() 之后生效）
+    mp_sampleprof_tick();
+#endif
 }
 
 void hal_entry(void) {
@@ -56,6 +89,7 @@ void hal_entry(void) {
     mp_stack_ctrl_init();
     mp_stack_set_top((void *)__get_MSP());
     mp_stack_set_limit(7 * 1024);
+    mp_stack_paint_init();
 
     /* 2) SysTick & DWT */
     SysTick_Config(SystemCoreClock / 1000U);
@@ -71,12 +105,17 @@ void hal_entry(void) {
     /* 4) start RX (ring buffer) */
     mp_uart_init();
 
+#if MICROPY_HW_SDRAM_HEAP_SIZE
+    /* SDRAM 控制器和存储器初始化（复位后只能调用一次） */
+    R_BSP_SdramInit(true);
+#endif
+
 soft_reset:
     /* 5) MicroPython runtime init */
-    gc_init(mp_heap, mp_heap + MP_HEAP_SIZE);
+    mp_heap_init();
 
 #if MICROPY_ENABLE_PYSTACK
-    mp_pystack_init(mp_pystack, &mp_pystack[MP_ARRAY_SIZE(mp_pystack)]);
+    mp_pystack_init(__mp_pystack_start, __mp_pystack_end);
 #endif
 
     mp_init();
@@ -97,6 +136,15 @@ soft_reset:
 
         if (pyexec_event_repl_process_char(c)) {
             mp_hal_stdout_tx_str("\r\nsoft reboot\r\n");
+            machine_sensor_stream_deinit_all();
+            machine_adc_block_deinit_all();
+            machine_dac_deinit_all();
+            machine_pin_irq_deinit_all();
+            machine_timer_deinit_all();
+            ra_irq_deinit_all();
+#if MICROPY_PY_MICROPYTHON_PROFILE
+            mp_sampleprof_deinit();
+#endif
             mp_deinit();
             goto soft_reset;
         }
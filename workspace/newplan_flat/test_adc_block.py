@@ -0,0 +1,79 @@
+"""
+测试 machine.ADCBlock：GPT 定时触发 + DTC 搬运的多通道连续采样
+Timed multi-channel ADC capture (GPT -> ELC -> ADC scan -> DTC)
+
+硬件：DAC0 (P014) 输出接到 ADC 输入 P004 (AN000)，P005/P006 悬空或接固定电压
+"""
+
+import machine
+import utime
+from machine import ADCBlock, DAC
+from utime import ticks_diff
+
+FREQ = 100000       # 每秒帧数（每帧包含全部已连接通道）
+FRAMES = 2000
+
+
+def sample(buf, idx):
+    """buf 中第 idx 个 uint16（小端）"""
+    return buf[2 * idx] | (buf[2 * idx + 1] << 8)
+
+
+def test_read_timed(block, nch):
+    print("read_timed: {} frames x {} ch @ {} Hz".format(FRAMES, nch, FREQ))
+    buf = bytearray(2 * FRAMES * nch)
+
+    dac = DAC("P014")
+    for level in (0, 128, 255):
+        dac.write(level)
+        utime.sleep_ms(2)
+        t0 = utime.ticks_us()
+        n = block.read_timed(buf, FREQ)
+        dt = ticks_diff(utime.ticks_us(), t0)
+        ch0 = [sample(buf, i * nch) for i in range(n)]
+        avg = sum(ch0) // n
+        print("  DAC={:3d}  AN000 avg={:4d} min={:4d} max={:4d}  {} frames in {} us ({} kS/s)".format(
+            level, avg, min(ch0), max(ch0), n, dt, n * nch * 1000 // dt))
+        # 8 位 DAC -> 12 位 ADC，约 16 LSB/step，允许较大误差
+        assert abs(avg - level * 16) < 200, "loopback mismatch"
+
+
+def test_continuous(block, nch):
+    print("continuous: double buffer, {} frames per half".format(FRAMES // 2))
+    buf = bytearray(2 * FRAMES * nch)
+    halves = [0, 0]
+
+    def on_half(h):
+        halves[h] += 1
+
+    block.start(buf, FREQ, on_half)
+    utime.sleep_ms(500)
+    block.stop()
+
+    expected = FREQ * 500 // 1000 // (FRAMES // 2)
+    print("  halves filled: {} + {} (expected ~{}), overruns={}".format(
+        halves[0], halves[1], expected, block.overruns()))
+
+
+def test_adc_block():
+    print("Test ADCBlock")
+    print("=" * 40)
+
+    block = ADCBlock(0)
+    adc = block.connect("P004")     # AN000
+    block.connect("P005")           # AN001
+    block.connect("P006")           # AN002
+    print(block, "channels:", block.channels())
+    nch = len(block.channels())
+
+    test_read_timed(block, nch)
+    test_continuous(block, nch)
+
+    # 定时采样结束后单次读取应恢复正常
+    print("read_u16 after capture: {}".format(adc.read_u16()))
+
+    print("\nADCBlock test completed!")
+
+
+if __name__ == "__main__":
+    test_adc_block()
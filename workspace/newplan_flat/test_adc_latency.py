@@ -0,0 +1,66 @@
+"""
+测试 ADC 单次读取延迟：read_u16 与 ADC.read_multi 每次调用的 CPU 周期数
+Per-read latency of ADC.read_u16 / ADC.read_multi in CPU cycles
+
+扫描配置缓存之前，每次 read_u16 都会复制 adc_channel_cfg_t 并调用 scanCfg 重新编程 ADC；
+缓存之后只有新通道加入扫描组时才会重配置。在旧固件上运行本脚本（只跑 read_u16 部分）即可得到对比基线。
+
+硬件：P004 (AN000)、P005 (AN001)、P006 (AN002)、P003 (AN104)
+"""
+
+import machine
+import utime
+from machine import ADC
+from utime import ticks_diff
+
+N = 1000
+
+
+def cycles_per_call(fn):
+    fn()    # 首次调用包含扫描组配置，不计入
+    t0 = utime.ticks_cpu()
+    for _ in range(N):
+        fn()
+    return ticks_diff(utime.ticks_cpu(), t0) // N
+
+
+def test_adc_latency():
+    print("Test ADC read latency")
+    print("=" * 40)
+    print("CPU freq: {} Hz".format(machine.freq()))
+
+    a0 = ADC("P004")
+    a1 = ADC("P005")
+    a2 = ADC("P006")
+    b4 = ADC("P003")
+
+    # 空循环开销
+    loop = cycles_per_call(lambda: None)
+    print("loop overhead          : {} cycles".format(loop))
+
+    single = cycles_per_call(a0.read_u16) - loop
+    print("read_u16 (1 ch)        : {} cycles".format(single))
+
+    three = cycles_per_call(lambda: (a0.read_u16(), a1.read_u16(), a2.read_u16())) - loop
+    print("read_u16 x3            : {} cycles".format(three))
+
+    if hasattr(ADC, "read_multi"):
+        buf = bytearray(8)
+        chans3 = (a0, a1, a2)
+        chans4 = (a0, a1, a2, b4)
+        multi3 = cycles_per_call(lambda: ADC.read_multi(chans3, buf)) - loop
+        print("read_multi (3 ch)      : {} cycles".format(multi3))
+        multi4 = cycles_per_call(lambda: ADC.read_multi(chans4, buf)) - loop
+        print("read_multi (3+1 ch, 2 units): {} cycles".format(multi4))
+
+        # 结果与单次读取一致（允许噪声）
+        ADC.read_multi(chans3, buf)
+        v = [buf[2 * i] | (buf[2 * i + 1] << 8) for i in range(3)]
+        s = [a0.read_u16(), a1.read_u16(), a2.read_u16()]
+        print("read_multi values: {}  read_u16 values: {}".format(v, s))
+
+    print("\nADC latency test completed!")
+
+
+if __name__ == "__main__":
+    test_adc_latency()
@@ -0,0 +1,131 @@
+"""
+测试 machine.bitstream / time_pulse_us / capture_pulses（GPT 比较输出与输入捕获）
+GPT-timed bitstream output and input-capture pulse measurement
+
+bitstream 和捕获函数都会阻塞到传输结束，所以回环的另一端用异步外设：
+  - bitstream 输出 P302 (GTIOC4A) 接 ADC 输入 P004 (AN000)，由 ADCBlock.start 连续采样解码
+  - DAC0 (P014) 经 write_timed 输出方波，接到捕获引脚 P400 (GTIOC6A)
+
+硬件：P302 -> P004，P014 -> P400
+"""
+
+import machine
+import utime
+from machine import ADCBlock, DAC
+
+OUT_PIN = 0x0302            # GTIOC4A
+CAP_PIN = 0x0400            # GTIOC6A
+
+# 慢速时序便于 ADC 解码（0: 20us 高 / 60us 低，1: 60us 高 / 20us 低）
+SLOW = (20000, 60000, 60000, 20000)
+ADC_FREQ = 200000           # 5us 一个样本
+WS2812 = (400, 850, 800, 450)
+
+
+def sample(buf, idx):
+    return buf[2 * idx] | (buf[2 * idx + 1] << 8)
+
+
+def decode_highs(levels, threshold):
+    """返回所有高电平段的样本数"""
+    runs = []
+    n = 0
+    for v in levels:
+        if v > threshold:
+            n += 1
+        elif n:
+            runs.append(n)
+            n = 0
+    return runs
+
+
+def bits_of(data):
+    return [(b >> (7 - i)) & 1 for b in data for i in range(8)]
+
+
+def test_bitstream_loopback():
+    print("bitstream -> ADCBlock loopback")
+    block = ADCBlock(0)
+    block.connect("P004")
+    data = b"\xA5\x0F\x3C"
+    # 每比特 80us = 16 个样本，多留余量
+    buf = bytearray(2 * 16 * (len(data) * 8 + 40))
+    block.start(buf, ADC_FREQ, None)
+    utime.sleep_ms(1)
+    machine.bitstream(OUT_PIN, 0, SLOW, data)
+    utime.sleep_ms(1)
+    block.stop()
+
+    levels = [sample(buf, i) for i in range(len(buf) // 2)]
+    runs = decode_highs(levels, 2048)
+    # 缓冲区足够容纳整段波形；按高电平长度（4 或 12 个样本）判比特，在结果中查找源数据
+    got = [1 if r > 8 else 0 for r in runs]
+    want = bits_of(data)
+    print("  high runs:", runs)
+    ok = any(got[i:i + len(want)] == want for i in range(len(got) - len(want) + 1))
+    print("  decoded {} bits, match={}".format(len(got), ok))
+    assert ok, "bitstream decode mismatch"
+
+
+def test_bitstream_duration():
+    print("bitstream WS2812 timing, 3 LEDs x 100")
+    data = bytearray(300)
+    t0 = utime.ticks_us()
+    machine.bitstream(OUT_PIN, 0, WS2812, data)
+    dt = utime.ticks_diff(utime.ticks_us(), t0)
+    expected = len(data) * 8 * 1250 // 1000
+    print("  {} bits in {} us (wire time {} us)".format(len(data) * 8, dt, expected))
+    assert dt >= expected, "bitstream finished too early"
+
+
+def square(n_high, n_low):
+    buf = bytearray(2 * (n_high + n_low))
+    for i in range(n_high):
+        buf[2 * i] = 0xFF
+        buf[2 * i + 1] = 0x0F
+    return buf
+
+
+def test_capture():
+    print("capture_pulses / time_pulse_us on DAC square wave")
+    dac = DAC("P014")
+    freq = 100000                       # 10us 一个 DAC 样本
+    dac.write_timed(square(3, 7), freq, DAC.LOOP)   # 30us 高 / 70us 低
+    utime.sleep_ms(2)
+
+    intervals = bytearray(4 * 20)
+    n = machine.capture_pulses(CAP_PIN, intervals, 100000)
+    ns = [int.from_bytes(intervals[4 * i:4 * i + 4], "little") for i in range(n)]
+    print("  {} intervals (ns): {}".format(n, ns))
+    assert n == 20, "capture timed out"
+    # 边沿交替为 30us / 70us（DAC 建立时间带来 ±2us 误差）
+    for i in range(n - 1):
+        assert abs(ns[i] + ns[i + 1] - 100000) < 2000, "period mismatch"
+        assert min(abs(ns[i] - 30000), abs(ns[i] - 70000)) < 3000, "width mismatch"
+
+    # 调用时若已处于该电平，会从当前时刻开始计时（与 extmod 语义一致），取多次测量的最大值
+    hi = max(machine.time_pulse_us(CAP_PIN, 1, 10000) for _ in range(5))
+    lo = max(machine.time_pulse_us(CAP_PIN, 0, 10000) for _ in range(5))
+    print("  time_pulse_us: high={} us low={} us".format(hi, lo))
+    assert abs(hi - 30) <= 3 and abs(lo - 70) <= 3, "pulse width mismatch"
+
+    dac.stop()
+    utime.sleep_ms(1)
+    dac.write(0)
+    # 无脉冲时：等待高电平超时返回 -2
+    r = machine.time_pulse_us(CAP_PIN, 1, 1000)
+    print("  timeout result: {}".format(r))
+    assert r == -2
+
+
+def test_bitstream():
+    print("Test machine.bitstream / pulse capture")
+    print("=" * 40)
+    test_bitstream_loopback()
+    test_bitstream_duration()
+    test_capture()
+    print("\nbitstream test completed!")
+
+
+if __name__ == "__main__":
+    test_bitstream()
@@ -0,0 +1,125 @@
+"""
+测试编译器 arena（MICROPY_COMP_ARENA）：编译 2000 行模块的耗时与编译后的堆碎片
+Compiler arena: compile time and post-compile heap fragmentation for a 2000-line module
+
+分别用 MICROPY_COMP_ARENA = 1 / 0 编译运行，对比两次输出。
+
+步骤：
+  1. 生成约 2000 行的模块源码（函数、类、常量），exec 编译并执行（只定义函数，执行本身很快），
+     用 ticks_us 计时，重复 5 次取最短
+  2. 丢弃源码并 gc.collect() 后，统计留在堆中的内存、空闲段数与最大空闲段
+     （有 gc.heap_map() 时直接统计分配表，否则二分查找最大可分配的 bytearray）
+  3. 调用几个生成的函数，确认编译结果正确；micropython.mem_info() 打印 arena 峰值，编译后应已全部释放
+"""
+
+import gc
+import utime
+
+LINES = 2000
+
+
+def make_source(lines):
+    out = []
+    i = 0
+    while len(out) < lines:
+        if i % 10 == 9:
+            out.append("class C{}:".format(i))
+            out.append("    K = ({}, 'k{}', {}.5)".format(i, i, i))
+            out.append("    def m(self, v):")
+            out.append("        return [v + k for k in range({})]".format(i % 7 + 1))
+            out.append("")
+        else:
+            out.append("def f{}(a, b={}):".format(i, i))
+            out.append("    x = a * {} + b".format(i))
+            out.append("    s = 'str{}'".format(i))
+            out.append("    if x > {}:".format(i * 3))
+            out.append("        x -= 1")
+            out.append("    for k in range(3):")
+            out.append("        x += k")
+            out.append("    return x, s")
+            out.append("")
+        i += 1
+    return "\n".join(out), i
+
+
+def heap_stats():
+    # 返回 (空闲字节, 空闲段数, 最大空闲段字节)，空闲段数未知时为 -1
+    try:
+        m = gc.heap_map()
+    except AttributeError:
+        m = None
+    if m is None:
+        free = gc.mem_free()
+        lo, hi = 0, free
+        while lo < hi:
+            mid = (lo + hi + 1) // 2
+            try:
+                bytearray(mid)
+                lo = mid
+            except MemoryError:
+                hi = mid - 1
+        return free, -1, lo
+    n_areas, block = int.from_bytes(m[8:12], "little"), int.from_bytes(m[12:16], "little")
+    o = 16
+    free = runs = largest = 0
+    for _ in range(n_areas):
+        n_blocks = int.from_bytes(m[o + 4:o + 8], "little")
+        o += 12
+        run = 0
+        for i in range(n_blocks):
+            if (m[o + i // 4] >> (2 * (i & 3))) & 3 == 0:
+                if run == 0:
+                    runs += 1
+                run += 1
+                free += 1
+                if run > largest:
+                    largest = run
+            else:
+                run = 0
+        o += n_blocks // 4
+    return free * block, runs, largest * block
+
+
+def test_compile_arena():
+    print("Test compiler arena ({} lines)".format(LINES))
+    best = 0
+    for rep in range(5):
+        src, n_defs = make_source(LINES)
+        g = {}
+        gc.collect()
+        t0 = utime.ticks_us()
+        exec(src, g)
+        dt = utime.ticks_diff(utime.ticks_us(), t0)
+        if rep == 0 or dt < best:
+            best = dt
+        src = None
+        g = None
+    print("  compile+exec: {} us for {} definitions ({} lines/ms)".format(best, n_defs, LINES * 1000 // best))
+
+    # 单独编译一次，只保留编译结果，统计堆的状态
+    gc.collect()
+    base = gc.mem_alloc()
+    src, n_defs = make_source(LINES)
+    g = {}
+    exec(src, g)
+    src = None
+    gc.collect()
+    print("  kept after compile: {} bytes".format(gc.mem_alloc() - base))
+    free, runs, largest = heap_stats()
+    frag = 100 - largest * 100 // free if free else 0
+    print("  free {} bytes in {} runs, largest {} bytes, fragmentation {}%".format(free, runs, largest, frag))
+
+    assert g["f5"](2) == (2 * 5 + 5 + 3 - (1 if 2 * 5 + 5 > 15 else 0), "str5")
+    assert g["C9"]().m(1) == [1, 2, 3]
+    assert g["C9"].K == (9, "k9", 9.5)
+    g = None
+    try:
+        import micropython
+        micropython.mem_info()
+    except (ImportError, AttributeError):
+        pass
+    print("\ncompiler arena test completed!")
+
+
+if __name__ == "__main__":
+    test_compile_arena()
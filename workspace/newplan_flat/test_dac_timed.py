@@ -0,0 +1,117 @@
+"""
+测试 DAC.write_timed：GPT 定时触发 + DTC 搬运的波形输出
+Timed DAC playback (GPT overflow -> DTC -> DADR) and half-buffer swapping
+
+硬件：DAC0 (P014) 输出接到 ADC 输入 P004 (AN000)
+"""
+
+import gc
+import utime
+from machine import DAC, ADCBlock
+
+N = 200          # 每个缓冲区的样本数（两半各 100）
+FREQ = 20000     # 样本/秒
+
+
+def put(buf, i, v):
+    buf[2 * i] = v & 0xFF
+    buf[2 * i + 1] = v >> 8
+
+
+def get(buf, i):
+    return buf[2 * i] | (buf[2 * i + 1] << 8)
+
+
+def make_ramp(n):
+    # DTC 访问不到 DTCM：小缓冲区默认可能落在 DTCM，在 BULK 提示下分配
+    prev = gc.alloc_hint(gc.BULK)
+    try:
+        buf = bytearray(2 * n)
+    finally:
+        gc.alloc_hint(*prev)
+    for i in range(n):
+        put(buf, i, i * 4095 // (n - 1))
+    return buf
+
+
+def test_half_swap(dac):
+    """LOOP 模式：回调顺序必须是 0,1,0,1,...，且每半缓冲区间隔约 N/2/FREQ 秒"""
+    print("LOOP + callback: half swap order")
+    order = []
+    stamps = []
+
+    def on_half(h):
+        order.append(h)
+        stamps.append(utime.ticks_us())
+
+    dac.write_timed(make_ramp(N), FREQ, DAC.LOOP, callback=on_half)
+    utime.sleep_ms(100)
+    dac.stop()
+
+    ok = all(order[i] == (i & 1) for i in range(len(order)))
+    gaps = [utime.ticks_diff(stamps[i + 1], stamps[i]) for i in range(len(stamps) - 1)]
+    print("  halves={} order_ok={} overruns={}".format(len(order), ok, dac.overruns()))
+    if gaps:
+        print("  half period: min={} max={} us (expected {} us)".format(
+            min(gaps), max(gaps), N // 2 * 1000000 // FREQ))
+    assert ok, "halves out of order"
+
+
+def test_oneshot(dac):
+    """ONESHOT：回调 0、1 各一次，然后自动停止"""
+    print("ONESHOT")
+    order = []
+    dac.write_timed(make_ramp(N), FREQ, DAC.ONESHOT, callback=order.append)
+    utime.sleep_ms(N * 1000 // FREQ + 20)
+    print("  callbacks={} playing={}".format(order, dac.playing()))
+    assert order == [0, 1] and not dac.playing()
+
+
+def test_waveform(dac):
+    """无回调的短缓冲 LOOP 使用 DTC 重复模式（零中断）；用 ADCBlock 回采检查斜坡"""
+    print("LOOP repeat mode + ADC loopback")
+    ramp = make_ramp(N)
+    dac.write_timed(ramp, FREQ)
+    block = ADCBlock(0)
+    block.connect("P004")
+    cap = bytearray(2 * 4 * N)
+    block.read_timed(cap, FREQ * 4)       # 每个 DAC 样本采 4 次
+    dac.stop()
+    vals = [get(cap, i) for i in range(4 * N)]
+    print("  captured min={} max={}".format(min(vals), max(vals)))
+    assert max(vals) - min(vals) > 3000, "ramp not seen on ADC"
+
+
+def test_dtcm_buffer(dac):
+    """DTCM 中的缓冲区 DTC 读不到，write_timed 必须拒绝"""
+    print("buffer in DTCM")
+    prev = gc.alloc_hint(gc.FAST)
+    try:
+        bufs = [bytearray(2 * N) for _ in range(4)]
+    finally:
+        gc.alloc_hint(*prev)
+    # id() 是对象头的地址，数据区紧随其后分配，通常在同一区域
+    for buf in bufs:
+        if 0x20000000 <= id(buf) < 0x20020000:
+            try:
+                dac.write_timed(buf, FREQ)
+            except ValueError as e:
+                print("  rejected:", e)
+                return
+            dac.stop()
+    print("  no buffer data landed in DTCM, skip")
+
+
+def test_dac_timed():
+    print("Test DAC.write_timed")
+    print("=" * 40)
+    dac = DAC("P014")
+    test_half_swap(dac)
+    test_oneshot(dac)
+    test_waveform(dac)
+    test_dtcm_buffer(dac)
+    print("\nDAC write_timed test completed!")
+
+
+if __name__ == "__main__":
+    test_dac_timed()
@@ -0,0 +1,106 @@
+"""
+float 基准：对比 MICROPY_OBJ_REPR 为 0(A) / 2(C) / 3(D) 的固件
+Float-heavy benchmark: time, heap bytes allocated per float op and collections, per object representation
+
+步骤：
+  1. 由 float 运算是否分配堆内存、float 精度判断当前固件的对象表示
+  2. 三个 float 密集循环（IIR 滤波、点积、多项式求值）：关闭 GC 统计每步分配的字节数，
+     打开 GC 统计耗时和回收次数（micropython.trace 的 GC 开始事件）
+  3. 校验结果与 CPython 双精度参考值一致（C 为单精度，放宽误差）
+  端口目前只开放 A；C / D 通过测试集后在对应固件上运行同一脚本对比输出
+"""
+
+import gc
+import micropython
+import utime
+
+GC_BEGIN = 1
+N = 10000
+
+
+def collections():
+    dump = micropython.trace_dump()
+    u32 = lambda o: int.from_bytes(dump[o:o + 4], "little")
+    n = 0
+    for i in range(u32(8)):
+        if u32(16 + 8 * i + 4) & 0xFFFF == GC_BEGIN:
+            n += 1
+    return n
+
+
+def representation():
+    x = 1.5
+    gc.collect()
+    gc.disable()
+    a0 = gc.mem_alloc()
+    y = x * x
+    a1 = gc.mem_alloc()
+    gc.enable()
+    if a1 == a0:
+        # 立即数 float：单精度为 C，双精度为 D
+        return "C" if 1.0 + 2.0 ** -30 == 1.0 else "D"
+    return "A"
+
+
+def iir(n):
+    y = 0.0
+    a = 0.25
+    for i in range(n):
+        y = a * (i & 63) + (1.0 - a) * y
+    return y
+
+
+def dot(n):
+    xs = [i * 0.5 for i in range(64)]
+    s = 0.0
+    for i in range(n):
+        s += xs[i & 63] * xs[(i * 7) & 63]
+    return s
+
+
+def poly(n):
+    s = 0.0
+    for i in range(n):
+        x = (i & 255) / 256.0
+        s += ((0.5 * x - 1.25) * x + 2.0) * x - 0.125
+    return s
+
+
+def alloc_per_step(f, n):
+    gc.collect()
+    gc.disable()
+    a0 = gc.mem_alloc()
+    f(n)
+    a1 = gc.mem_alloc()
+    gc.enable()
+    return (a1 - a0) / n
+
+
+def bench(name, f, expect, tol):
+    per = alloc_per_step(f, 200)
+    gc.collect()
+    micropython.trace_start()
+    t0 = utime.ticks_us()
+    r = f(N)
+    dt = utime.ticks_diff(utime.ticks_us(), t0)
+    micropython.trace_stop()
+    print("  {:5s} {:6d} us, {:5.1f} bytes/step, {:3d} collections".format(name, dt, per, collections()))
+    assert abs(r - expect) <= abs(expect) * tol, "{} result {}, expected {}".format(name, r, expect)
+    return dt
+
+
+def test_float_bench():
+    print("Test float benchmark")
+    repr_ = representation()
+    print("  object representation {}".format(repr_))
+    # 参考值为 CPython 双精度结果；C 的 30 位单精度累加误差约 1e-3
+    tol = 1e-2 if repr_ == "C" else 1e-9
+    total = bench("iir", iir, 12.641446134960221, tol)
+    total += bench("dot", dot, 2543146.0, tol)
+    total += bench("poly", poly, 5798.5265827178955, tol)
+    print("  total {} us".format(total))
+    print("\nfloat benchmark completed!")
+
+
+if __name__ == "__main__":
+    test_float_bench()
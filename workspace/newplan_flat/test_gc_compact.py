@@ -0,0 +1,146 @@
+"""
+测试可移动缓冲区整理（MICROPY_GC_MOVABLE）：gc.compact() / gc.compact_threshold()
+Movable buffers: bytearrays slide together so a large allocation fits again
+
+步骤：
+  1. 按伪随机序列反复分配 / 释放不同大小的 bytearray，每个写入可校验的内容，
+     gc.compact() 之后全部内容不变
+  2. memoryview 引用的缓冲区被钉住：整理后通过 memoryview 写入，原 bytearray 能读到
+  3. 交替保留大缓冲区制造碎片，使一次大分配只有整理之后才放得下：分配失败触发的回收会自动整理
+  4. gc.compact_threshold() 读取 / 设置阈值，负数报 ValueError
+"""
+
+import gc
+
+seed = 12345
+
+
+def rand(n):
+    # 简单的线性同余发生器，保证每次运行的序列相同
+    global seed
+    seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF
+    return seed % n
+
+
+def fill(b, tag):
+    for i in range(len(b)):
+        b[i] = (tag + i * 7) & 0xFF
+
+
+def check(b, tag):
+    for i in range(len(b)):
+        if b[i] != (tag + i * 7) & 0xFF:
+            return False
+    return True
+
+
+def test_random_trace():
+    print("random alloc/free trace")
+    slots = [None] * 40
+    tags = [0] * 40
+    moved = 0
+    for step in range(600):
+        i = rand(len(slots))
+        if slots[i] is None or rand(3) == 0:
+            n = 64 + rand(1200)
+            slots[i] = bytearray(n)
+            tags[i] = step & 0xFF
+            fill(slots[i], tags[i])
+        else:
+            slots[i] = None
+        if step % 100 == 99:
+            moved += gc.compact()
+            for j in range(len(slots)):
+                if slots[j] is not None:
+                    assert check(slots[j], tags[j]), "buffer {} corrupted at step {}".format(j, step)
+    print("  moved {} buffers, contents ok".format(moved))
+    slots = None
+
+
+def test_memoryview_pin():
+    print("memoryview pins its buffer")
+    try:
+        memoryview
+    except NameError:
+        print("  memoryview disabled, skipped")
+        return
+    gap = []
+    for i in range(8):
+        gap.append(bytearray(512))
+    b = bytearray(1024)
+    fill(b, 3)
+    mv = memoryview(b)
+    gap = None
+    gc.compact()
+    mv[0] = 0xAA
+    mv[1023] = 0x55
+    assert b[0] == 0xAA and b[1023] == 0x55, "memoryview lost its buffer"
+    mv = None
+    b[0] = 3
+    b[1023] = (3 + 1023 * 7) & 0xFF
+    gc.compact()
+    assert check(b, 3), "buffer corrupted after unpinning"
+    print("  ok")
+
+
+def test_fragmented_alloc():
+    print("allocation after compaction")
+    gc.collect()
+    free = gc.mem_free()
+    chunk = 2048
+    keep = []
+    drop = []
+    try:
+        for i in range(free // chunk):
+            b = bytearray(chunk)
+            fill(b, i)
+            (keep if i & 1 else drop).append(b)
+    except MemoryError:
+        pass
+    drop = None
+    b = None
+    # 阈值设为 0：普通回收不整理，只有放不下的分配触发的回收才整理
+    old = gc.compact_threshold(0)
+    gc.collect()
+    print("  {} buffers kept, {} bytes free in holes of {} bytes".format(len(keep), gc.mem_free(), chunk))
+    # 空闲总量足够，但没有任何一段连续空闲能放下 4 个缓冲区
+    big = bytearray(4 * chunk)
+    print("  got {} bytes".format(len(big)))
+    for i in range(len(keep)):
+        assert check(keep[i], 2 * i + 1), "kept buffer {} corrupted".format(i)
+    gc.compact_threshold(old)
+    keep = None
+    big = None
+
+
+def test_threshold():
+    print("threshold")
+    old = gc.compact_threshold()
+    assert gc.compact_threshold(8192) == old
+    assert gc.compact_threshold() == 8192
+    try:
+        gc.compact_threshold(-1)
+        assert False, "negative threshold accepted"
+    except ValueError:
+        pass
+    gc.compact_threshold(old)
+    print("  ok")
+
+
+def test_gc_compact():
+    print("Test movable buffer compaction")
+    test_random_trace()
+    test_memoryview_pin()
+    test_fragmented_alloc()
+    test_threshold()
+    gc.collect()
+    try:
+        import micropython
+        micropython.mem_info()
+    except (ImportError, AttributeError):
+        pass
+    print("\ncompaction test completed!")
+
+
+if __name__ == "__main__":
+    test_gc_compact()
@@ -0,0 +1,175 @@
+"""
+测试增量 GC（MICROPY_GC_INCREMENTAL）：sleep_ms 的空闲时间里分片标记 / 清扫
+Incremental GC: slice pauses measured from the event trace, compared with a full gc.collect()
+
+步骤：
+  1. 建一个约 100KB 的存活对象图（list / dict / bytes 互相引用），反复制造垃圾并 sleep_ms，
+     让增量 GC 在空闲时间完成若干轮；用 micropython.trace 记录每一片的 GC 开始/结束事件
+     （arg = 1 标记片、2 清扫片、0 完整 gc.collect()），统计每片停顿，要求最长一片 < 500us
+  2. 校验存活对象图的内容没有被破坏（标记遗漏会导致对象被回收后重用）
+  3. 1ms 软件定时器回调不断打断空闲：标记被作废（aborted 增加）后重新开始，对象图仍然完好
+  4. hard=True 定时器回调在空闲中（标记进行时）把对象在两个列表之间搬来搬去，不分配内存：
+     标记被作废，搬动过的对象不会被回收
+"""
+
+import gc
+import machine
+import micropython
+import utime
+
+GC_BEGIN, GC_END = 1, 2
+PAUSE_LIMIT_US = 500
+
+
+def records(dump):
+    assert dump[:4] == b"MPTR", "bad magic"
+    u32 = lambda o: int.from_bytes(dump[o:o + 4], "little")
+    hz, n = u32(4), u32(8)
+    recs = []
+    for i in range(n):
+        o = 16 + 8 * i
+        recs.append((u32(o), u32(o + 4) & 0xFFFF, u32(o + 4) >> 16))
+    return hz, recs
+
+
+def pauses():
+    """从追踪记录中配对 GC 开始/结束，返回 {arg: [停顿 us, ...]}"""
+    hz, recs = records(micropython.trace_dump())
+    out = {}
+    begin = None
+    for ts, ev, arg in recs:
+        if ev == GC_BEGIN:
+            begin = ts
+        elif ev == GC_END and begin is not None:
+            us = ((ts - begin) & 0xFFFFFFFF) * 1000000 // hz
+            out.setdefault(arg, []).append(us)
+            begin = None
+    return out
+
+
+def build(n):
+    """存活对象图：每个节点 [序号, bytes, dict, 上一个节点]"""
+    nodes = []
+    prev = None
+    for i in range(n):
+        node = [i, bytes([i & 0xFF]) * (16 + i % 48), {"i": i, "s": str(i)}, prev]
+        nodes.append(node)
+        prev = node
+    return nodes
+
+
+def check(nodes):
+    for i, node in enumerate(nodes):
+        assert node[0] == i, "bad index"
+        assert node[1] == bytes([i & 0xFF]) * (16 + i % 48), "bad bytes"
+        assert node[2]["i"] == i and node[2]["s"] == str(i), "bad dict"
+        assert node[3] is (nodes[i - 1] if i else None), "bad link"
+
+
+def churn(n):
+    junk = None
+    for i in range(n):
+        junk = [i, str(i), (i, i)]
+    return junk
+
+
+def run(nodes, rounds, sleep_ms):
+    for _ in range(rounds):
+        churn(400)
+        utime.sleep_ms(sleep_ms)
+    check(nodes)
+
+
+def test_slices():
+    print("incremental slices vs full collection")
+    nodes = build(1500)
+    gc.collect()
+    budget, trigger = gc.incremental()
+    print("  budget {} us, trigger {} bytes, heap used {}".format(budget, trigger, gc.mem_alloc()))
+    gc.incremental_stats(True)
+
+    micropython.trace_start()
+    run(nodes, 200, 20)
+    gc.collect()
+    micropython.trace_stop()
+
+    p = pauses()
+    cycles, aborts, max_slice, mark_us = gc.incremental_stats()
+    full = p.get(0, [0])
+    for arg, name in ((1, "mark"), (2, "sweep")):
+        s = p.get(arg, [])
+        if s:
+            print("  {} slices: {}, max {} us".format(name, len(s), max(s)))
+    print("  full gc.collect(): {} us".format(max(full)))
+    print("  cycles {}, aborted {}, longest slice {} us, last mark {} us".format(cycles, aborts, max_slice, mark_us))
+    assert cycles > 0, "no incremental cycle completed"
+    assert max_slice < PAUSE_LIMIT_US, "slice too long"
+    del nodes
+
+
+def test_aborts():
+    print("marks interrupted by timer callbacks")
+    nodes = build(1000)
+    gc.collect()
+    gc.incremental_stats(True)
+    ticks = [0]
+
+    def cb(t):
+        ticks[0] += 1
+
+    tim = machine.Timer(-1, mode=machine.Timer.PERIODIC, period=1, callback=cb)
+    try:
+        run(nodes, 100, 10)
+    finally:
+        tim.deinit()
+    cycles, aborts, max_slice, mark_us = gc.incremental_stats()
+    print("  callbacks {}, cycles {}, aborted {}".format(ticks[0], cycles, aborts))
+    # 回调每 1ms 作废一次未完成的标记；没有回调的睡眠里才能做完
+    run(nodes, 50, 50)
+    cycles, aborts, max_slice, mark_us = gc.incremental_stats()
+    print("  after quiet sleeps: cycles {}, aborted {}".format(cycles, aborts))
+    assert cycles > 0, "no incremental cycle completed"
+
+
+def test_hard_moves():
+    print("references moved by a hard timer callback")
+    n = 1000
+    # 互不引用的 bytes，只被 a 或 b 引用：标记扫过 a 之后、扫到 b 之前搬过去的，只有作废标记才不会漏掉
+    a = [bytes([i & 0xFF]) * (16 + i % 48) for i in range(n)]
+    b = [None] * n
+    gc.collect()
+    gc.incremental_stats(True)
+    moves = [0]
+
+    def cb(t):
+        i = moves[0] % n
+        if a[i] is None:
+            a[i], b[i] = b[i], None
+        else:
+            b[i], a[i] = a[i], None
+        moves[0] += 1
+
+    tim = machine.Timer(-1, mode=machine.Timer.PERIODIC, period=3, callback=cb, hard=True)
+    try:
+        for _ in range(60):
+            churn(400)
+            utime.sleep_ms(20)
+    finally:
+        tim.deinit()
+    cycles, aborts, max_slice, mark_us = gc.incremental_stats()
+    print("  moves {}, cycles {}, aborted {}".format(moves[0], cycles, aborts))
+    for i in range(n):
+        x = a[i] if a[i] is not None else b[i]
+        assert x == bytes([i & 0xFF]) * (16 + i % 48), "moved object lost"
+
+
+def test_gc_incremental():
+    print("Test incremental GC")
+    test_slices()
+    test_aborts()
+    test_hard_moves()
+    print("\nincremental GC test completed!")
+
+
+if __name__ == "__main__":
+    test_gc_incremental()
@@ -0,0 +1,118 @@
+"""
+测试分配点追踪（MICROPY_GC_ALLOC_SITES）：gc.alloc_sites() / gc.heap_map()
+Allocation sites: live blocks by site and size, heap map snapshots for tools/gc_heapmap.py
+
+步骤：
+  1. gc.alloc_sites(True) 清空分配点表后，在已知的函数里分配对象，
+     快照中该函数的对象数、块数和大小分布与分配的一致
+  2. 释放这些对象并回收后，快照中该分配点的对象随之消失
+  3. gc.heap_map() 的空闲块数与 gc.mem_free() 一致；交替释放制造碎片，最大空闲段变小
+  4. 打印 heap_map 十六进制串，串口日志可交给 tools/gc_heapmap.py 画出碎片随时间的变化
+"""
+
+import gc
+
+N = 50
+
+
+def make_buffers(n):
+    out = []
+    for i in range(n):
+        out.append(bytearray(40))
+    return out
+
+
+def u32(b, o):
+    return int.from_bytes(b[o:o + 4], "little")
+
+
+def parse_map(m):
+    assert m[:4] == b"MPHM", "bad magic"
+    n_areas, block = u32(m, 8), u32(m, 12)
+    o = 16
+    free = used = largest = 0
+    for _ in range(n_areas):
+        n_blocks = u32(m, o + 4)
+        o += 12
+        run = 0
+        for i in range(n_blocks):
+            kind = (m[o + i // 4] >> (2 * (i & 3))) & 3
+            if kind == 0:
+                free += 1
+                run += 1
+                if run > largest:
+                    largest = run
+            else:
+                used += 1
+                run = 0
+        o += n_blocks // 4
+    return block, free, used, largest
+
+
+def test_sites():
+    print("allocation sites")
+    gc.collect()
+    gc.alloc_sites(True)
+    keep = make_buffers(N)
+    sites = gc.alloc_sites()
+    for s in sites[:5]:
+        print("  {:5d} blocks {:4d} objects  {}  {}:{}  sizes {}".format(*s))
+    s = None
+    for cand in sites:
+        if cand[2] == "make_buffers":
+            s = cand
+            break
+    assert s is not None, "make_buffers site missing"
+    assert s[4] > 0, "no source line"
+    blocks, objects, sizes = s[0], s[1], s[5]
+    # 每个 bytearray(40) 是一个对象头加一段 40 字节的数据
+    assert objects >= N, "objects {} < {}".format(objects, N)
+    assert sum(sizes) == objects, "size histogram does not add up"
+    assert blocks >= objects, "fewer blocks than objects"
+    untracked = [t for t in sites if t[2] == "<untracked>"]
+    print("  untracked objects (allocated before reset): {}".format(untracked[0][1] if untracked else 0))
+
+    keep = None
+    gc.collect()
+    s = None
+    for cand in gc.alloc_sites():
+        if cand[2] == "make_buffers":
+            s = cand
+    assert s is None or s[1] < N, "site still holds the freed objects"
+    print("  freed: ok")
+
+
+def test_heap_map():
+    print("heap map")
+    gc.collect()
+    m = gc.heap_map()
+    free_bytes = gc.mem_free()
+    block, free, used, largest = parse_map(m)
+    print("  block {} bytes, free {} blocks, used {}, largest free run {}".format(block, free, used, largest))
+    # heap_map 返回后创建的 bytes 对象会占用几个块
+    assert abs(free * block - free_bytes) <= 4 * block + len(m), "free blocks do not match gc.mem_free()"
+
+    # 交替保留 / 丢弃，制造碎片
+    keep = []
+    drop = []
+    for i in range(200):
+        (keep if i & 1 else drop).append(bytearray(100))
+    drop = None
+    gc.collect()
+    _, free2, _, largest2 = parse_map(gc.heap_map())
+    print("  after fragmenting: free {} blocks, largest free run {}".format(free2, largest2))
+    assert largest2 <= largest, "largest free run grew"
+    print("heap map hex (for tools/gc_heapmap.py):")
+    print(gc.heap_map().hex())
+    keep = None
+
+
+def test_gc_sites():
+    print("Test allocation sites and heap map")
+    test_sites()
+    test_heap_map()
+    print("\nallocation sites test completed!")
+
+
+if __name__ == "__main__":
+    test_gc_sites()
@@ -0,0 +1,94 @@
+"""
+测试 GPIO 翻转速率：Python 方法调用、Port 整端口写、@micropython.native、@micropython.viper
+GPIO toggle rate from Python, native and viper code
+
+硬件：P413 上接示波器/逻辑分析仪可观察实际波形（脚本本身只用 DWT 计时）
+"""
+
+import machine
+import micropython
+import utime
+from machine import Pin, Port
+from utime import ticks_diff
+
+PIN_ID = 0x040D     # P413
+PORT_NUM = PIN_ID >> 8
+BIT = 1 << (PIN_ID & 0xFF)
+N = 10000           # 每种方式翻转 N 个周期（2N 次写）
+
+
+def bench(name, fn, *args):
+    t0 = utime.ticks_cpu()
+    fn(*args)
+    cycles = ticks_diff(utime.ticks_cpu(), t0)
+    per = cycles // N
+    khz = machine.freq() // per // 1000 if per else 0
+    print("  {:<24} {:6d} cycles/period  -> {:6d} kHz".format(name, per, khz))
+
+
+def toggle_on_off(p):
+    on = p.on
+    off = p.off
+    for _ in range(N):
+        on()
+        off()
+
+
+def toggle_value(p):
+    v = p.value
+    for _ in range(N):
+        v(1)
+        v(0)
+
+
+def toggle_port(port):
+    v = port.value
+    for _ in range(N):
+        v(BIT)
+        v(0)
+
+
+@micropython.native
+def toggle_native(p):
+    on = p.on
+    off = p.off
+    for _ in range(N):
+        on()
+        off()
+
+
+@micropython.viper
+def toggle_viper(addr: uint, bit: uint, n: int):
+    posr = ptr16(addr + 8)     # PCNTR3.POSR
+    porr = ptr16(addr + 10)    # PCNTR3.PORR
+    for _ in range(n):
+        posr[0] = bit
+        porr[0] = bit
+
+
+def test_gpio_speed():
+    print("Test GPIO toggle speed")
+    print("=" * 40)
+    print("CPU freq: {} Hz, N = {}".format(machine.freq(), N))
+
+    p = Pin(PIN_ID, Pin.OUT)
+    port = Port(PORT_NUM, BIT, Pin.OUT)
+    print(port, "addr=0x{:08X}".format(port.addr()))
+
+    bench("Pin.on()/off()", toggle_on_off, p)
+    bench("Pin.value(1/0)", toggle_value, p)
+    bench("Port.value(bits)", toggle_port, port)
+    bench("native Pin.on()/off()", toggle_native, p)
+    bench("viper POSR/PORR", toggle_viper, port.addr(), BIT, N)
+
+    # 读回检查：Pin 与 Port 看到相同的电平
+    p.on()
+    assert p.value() == 1 and port.value() == BIT
+    p.off()
+    assert p.value() == 0 and port.value() == 0
+
+    print("\nGPIO speed test completed!")
+
+
+if __name__ == "__main__":
+    test_gpio_speed()
@@ -0,0 +1,80 @@
+"""
+测试字节码统计：micropython.opcode_stats()（需要 MICROPY_VM_OPCODE_STATS = 1 的插桩固件）
+Per-opcode execution counts / DWT cycles and dispatch-path counters of the VM
+
+用已知次数的循环验证计数，然后打印最耗周期的 opcode 和各分派路径的平均周期数。
+"""
+
+import micropython
+
+MP_BC_FOR_ITER = 0x4B
+N = 1000
+
+
+def add(a, b):
+    return a + b
+
+
+class Point:
+    def __init__(self):
+        self.x = 1
+
+
+def loop(n):
+    p = Point()
+    s = 0
+    for i in range(n):
+        s = add(s, p.x)     # call_bc + load_attr + load_global
+    return s
+
+
+def stats_dict():
+    ops, paths = micropython.opcode_stats()
+    return {op: (count, cycles) for op, count, cycles in ops}, paths
+
+
+def test_counts():
+    print("counts for a {}-iteration loop".format(N))
+    micropython.opcode_stats(True)      # 清零
+    loop(N)
+    ops, paths = stats_dict()
+    for_iter = ops.get(MP_BC_FOR_ITER, (0, 0))[0]
+    print("  FOR_ITER: {}".format(for_iter))
+    print("  call_bc: {}  load_global: {}  load_attr: {}".format(
+        paths["call_bc"][0], paths["load_global"][0],
+        paths["load_attr_fast"][0] + paths["load_attr_slow"][0]))
+    # range 迭代 N 次 + 结束时 1 次
+    assert for_iter == N + 1, "FOR_ITER count"
+    assert paths["call_bc"][0] >= N
+    assert paths["load_global"][0] >= N
+    assert paths["load_attr_fast"][0] + paths["load_attr_slow"][0] >= N
+
+
+def test_report():
+    print("hottest opcodes (cycles)")
+    micropython.opcode_stats(True)
+    loop(N)
+    ops, paths = micropython.opcode_stats()
+    ops.sort(key=lambda r: -r[2])
+    for op, count, cycles in ops[:10]:
+        print("  op 0x{:02x}: {:6d} x {:5d} cycles".format(op, count, cycles // count))
+    print("dispatch paths (average cycles, inclusive)")
+    for name in sorted(paths):
+        count, cycles = paths[name]
+        if count:
+            print("  {:15s}: {:6d} x {:5d}".format(name, count, cycles // count))
+
+
+def test_opcode_stats():
+    print("Test VM opcode statistics")
+    print("=" * 40)
+    if not hasattr(micropython, "opcode_stats"):
+        print("firmware built without MICROPY_VM_OPCODE_STATS, skipped")
+        return
+    test_counts()
+    test_report()
+    print("\nopcode stats test completed!")
+
+
+if __name__ == "__main__":
+    test_opcode_stats()
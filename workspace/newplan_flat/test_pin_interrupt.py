@@ -31,7 +31,7 @@ def test_pin_interrupt():
 
     # 测试 3: 测试不支持中断的引脚
     try:
-        pin_invalid = machine.Pin(0x0001, machine.Pin.IN)  # P001 不支持中断
+        pin_invalid = machine.Pin(0x0003, machine.Pin.IN)  # P003 没有 IRQ 复用功能
         pin_invalid.irq(handler=interrupt_handler, trigger=machine.Pin.IRQ_RISING)
         print("✗ Should have failed for unsupported pin")
         return False
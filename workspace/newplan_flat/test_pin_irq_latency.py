@@ -0,0 +1,85 @@
+"""
+测试引脚中断延迟：边沿 -> handler 第一条语句 的 CPU 周期数（DWT CYCCNT）
+Edge-to-handler latency of Pin.irq() with hard=False / hard=True
+
+硬件：P413 (输出) 跳线到 P008 (IRQ12 输入)
+"""
+
+import machine
+import utime
+from machine import Pin
+from utime import ticks_diff
+
+PIN_OUT = 0x040D    # P413
+PIN_IN = 0x0008     # P008 -> IRQ12
+N = 200
+
+stamp = [0]
+
+
+def on_edge(p):
+    stamp[0] = utime.ticks_cpu()
+
+
+def measure(out, busy_us=0):
+    """返回 N 次上升沿的 (min, avg, max) 延迟（周期），busy_us>0 时在边沿后忙等模拟长 delay"""
+    # out.on() 本身的开销，从结果中扣除
+    t0 = utime.ticks_cpu()
+    out.on()
+    on_cost = ticks_diff(utime.ticks_cpu(), t0)
+    out.off()
+
+    lat = []
+    for _ in range(N):
+        stamp[0] = 0
+        t0 = utime.ticks_cpu()
+        out.on()
+        if busy_us:
+            utime.sleep_us(busy_us)
+        while stamp[0] == 0:
+            pass
+        lat.append(ticks_diff(stamp[0], t0) - on_cost)
+        out.off()
+        utime.sleep_us(50)
+    return min(lat), sum(lat) // N, max(lat)
+
+
+def report(name, res):
+    mhz = machine.freq() // 1000000
+    print("  {:<28} min={:6d} avg={:6d} max={:6d} cycles  (avg {} ns)".format(
+        name, res[0], res[1], res[2], res[1] * 1000 // mhz))
+
+
+def test_pin_irq_latency():
+    print("Test Pin IRQ latency")
+    print("=" * 40)
+    print("CPU freq: {} Hz".format(machine.freq()))
+
+    out = Pin(PIN_OUT, Pin.OUT)
+    out.off()
+    pin = Pin(PIN_IN, Pin.IN, Pin.PULL_UP)
+
+    pin.irq(on_edge, Pin.IRQ_RISING)
+    report("soft", measure(out))
+    report("soft, 1 ms busy after edge", measure(out, 1000))
+
+    pin.irq(on_edge, Pin.IRQ_RISING, hard=True)
+    report("hard", measure(out))
+    report("hard, 1 ms busy after edge", measure(out, 1000))
+
+    # hard handler 中分配内存会抛出 MemoryError，handler 随后被禁用
+    def alloc(p):
+        stamp[0] = [1, 2, 3]
+
+    pin.irq(alloc, Pin.IRQ_RISING, hard=True)
+    out.on()
+    utime.sleep_ms(1)
+    out.off()
+    print("  alloc in hard handler -> stamp={}".format(stamp[0]))
+
+    pin.irq(None)
+    print("\nPin IRQ latency test completed!")
+
+
+if __name__ == "__main__":
+    test_pin_irq_latency()
@@ -0,0 +1,187 @@
+"""
+测试 pystack（MICROPY_ENABLE_PYSTACK）：调用密集代码的调用速度与堆压力、水位统计、溢出到堆
+pystack: calls/s and heap use of call-heavy code (bm_fib style), high-water mark, overflow into the heap
+
+分别用 MICROPY_ENABLE_PYSTACK = 1 / 0 编译运行，对比第 1 步的输出。
+
+步骤：
+  1. 递归 fib(20)（21891 次调用，帧小）和 1000 次 wide(10)（11000 次调用，局部变量多、帧大），
+     gc.disable() 后计时并统计运行期间从堆分配的字节数，重复 5 次取最短，算出 calls/s
+  2. micropython.pystack_stats(True) 清零后，水位随递归深度增加，返回后 use 回到原值，没有溢出
+  3. 用 *args 调用让参数数组占满 pystack，在里面递归：放不下的帧改从堆分配（overflows > 0），
+     结果正确，异常穿过这些帧后 use 也回到原值；不定长迭代器展开时参数数组在中途溢出到堆
+"""
+
+import gc
+import utime
+import micropython
+
+FIB_N = 20
+
+
+def fib(n):
+    if n < 2:
+        return n
+    return fib(n - 1) + fib(n - 2)
+
+
+def fib_calls(n):
+    # fib(n) 的调用次数
+    a, b = 1, 1
+    for _ in range(n - 1):
+        a, b = b, a + b + 1
+    return b
+
+
+def depth(n):
+    if n == 0:
+        return micropython.pystack_stats()[0]
+    return depth(n - 1) + 0
+
+
+def wide(n):
+    # 局部变量多，帧比 fib 大
+    a0 = a1 = a2 = a3 = a4 = a5 = a6 = a7 = n
+    b0 = b1 = b2 = b3 = b4 = b5 = b6 = b7 = n + 1
+    if n == 0:
+        return 0
+    return wide(n - 1) + 1 + a7 - b7 + 1 + a0 - b0 + 1
+
+
+def wide_raise(n):
+    a0 = a1 = a2 = a3 = a4 = a5 = a6 = a7 = n
+    if n == 0:
+        raise ValueError(a7)
+    return wide_raise(n - 1)
+
+
+def probe(*args):
+    return micropython.pystack_stats()[0]
+
+
+def word_size():
+    # 参数数组每项一个字：展开 64 个参数与不展开时 pystack 用量之差
+    return (probe(*tuple(range(64))) - probe(*())) // 64
+
+
+def inside(*args):
+    # 参数数组还在 pystack 上（调用返回时才释放），此时递归
+    return len(args), wide(10)
+
+
+def inside_raise(*args):
+    return wide_raise(10)
+
+
+def wide_loop(k):
+    r = 0
+    for _ in range(k):
+        r += wide(10)
+    return r
+
+
+def heap_total():
+    # 累计分配字节数（需要 MICROPY_MEM_STATS）；没有时用已分配字节数，调用结束就释放的帧统计不到
+    try:
+        return micropython.mem_total()
+    except AttributeError:
+        return gc.mem_alloc()
+
+
+def bench(name, fn, arg, calls, expect):
+    best = 0
+    for rep in range(5):
+        gc.collect()
+        gc.disable()
+        m0 = heap_total()
+        t0 = utime.ticks_us()
+        r = fn(arg)
+        dt = utime.ticks_diff(utime.ticks_us(), t0)
+        heap = heap_total() - m0
+        gc.enable()
+        assert r == expect
+        if rep == 0 or dt < best:
+            best = dt
+    print("  {}: {} calls, {} us, {} calls/s, {} heap bytes allocated".format(
+        name, calls, best, calls * 1000 // best * 1000, heap))
+
+
+def test_bench():
+    print("call-heavy benchmarks (gc disabled)")
+    # fib 的帧小，不开 pystack 时在 C 栈上；wide 的帧超过 VM_MAX_STATE_ON_STACK，不开 pystack 时每次调用都从堆分配
+    bench("fib({})".format(FIB_N), fib, FIB_N, fib_calls(FIB_N), 6765)
+    bench("wide(10) x1000", wide_loop, 1000, 11 * 1000, 10 * 1000)
+
+
+def test_peak():
+    print("pystack high-water mark")
+    micropython.pystack_stats(True)
+    use, peak, limit, over = micropython.pystack_stats()
+    print("  use {}, peak {}, limit {}".format(use, peak, limit))
+    assert peak >= use and limit > 0
+    last = peak
+    for n in (5, 10, 20):
+        micropython.pystack_stats(True)
+        deep = depth(n)
+        use2, peak, limit, over = micropython.pystack_stats()
+        print("  depth {:2d}: use at bottom {}, peak {}".format(n, deep, peak))
+        assert peak >= deep > use, "peak below recursion depth"
+        assert peak >= last, "peak not increasing with depth"
+        assert use2 == use, "pystack not released"
+        assert over == 0, "unexpected overflow"
+        last = peak
+
+
+def test_overflow():
+    print("pystack overflow into the heap")
+    w = word_size()
+    use, peak, limit, over = micropython.pystack_stats(True)
+    # 参数数组占到只剩约 48 个字，下面 10 层递归的帧放不下
+    n = (limit - use) // w - 48
+    t = tuple(range(n))
+    r = inside(*t)
+    use2, peak, limit, over = micropython.pystack_stats()
+    print("  {} args + 10 frames: peak {} of {}, {} blocks to heap".format(n, peak, limit, over))
+    assert r == (n, 10), "wrong result"
+    assert over > 0, "no overflow"
+    assert use2 == use, "pystack not released"
+
+    micropython.pystack_stats(True)
+    for _ in range(20):
+        try:
+            inside_raise(*t)
+            assert False
+        except ValueError as e:
+            assert e.args[0] == 0
+        gc.collect()
+    use2, peak, limit, over = micropython.pystack_stats()
+    print("  exception through overflowed frames x20: use {}, {} blocks to heap".format(use2, over))
+    assert over > 0 and use2 == use
+
+    # 迭代器长度未知，参数数组边读边扩，扩到放不下时搬到堆上
+    micropython.pystack_stats(True)
+    m = (limit - use) // w + 100
+    r = inside(*iter(range(m)))
+    use2, peak, limit, over = micropython.pystack_stats()
+    print("  {} args from an iterator: {} blocks to heap".format(m, over))
+    assert r == (m, 10), "wrong result"
+    assert over > 0 and use2 == use
+
+
+def test_pystack():
+    print("Test pystack")
+    test_bench()
+    try:
+        micropython.pystack_stats
+    except AttributeError:
+        print("  pystack not enabled, skipping statistics")
+        print("\npystack test completed!")
+        return
+    test_peak()
+    test_overflow()
+    micropython.mem_info()
+    print("\npystack test completed!")
+
+
+if __name__ == "__main__":
+    test_pystack()
@@ -0,0 +1,132 @@
+"""
+测试调度器：优先级队列、突发调度和溢出计数
+micropython.schedule(func, arg, prio) / micropython.schedule_stats()
+
+用 hard=True 的引脚中断模拟 ISR，在中断里一次性调度一批回调（调度器在 hard
+handler 中被锁住，回调全部排队，等中断返回后才执行）。
+
+检查三点：
+  1. 同一批中高优先级回调全部先于普通回调执行，同级内保持 FIFO
+  2. 每级队列深度 DEPTH，超出的调度失败并计入 schedule_stats() 的溢出数
+  3. 连续 N 个边沿、每个边沿调度一次，回调不丢失
+
+硬件：P413 (输出) 跳线到 P008 (IRQ12 输入)
+"""
+
+import micropython
+import utime
+from machine import Pin
+
+PIN_OUT = 0x040D    # P413
+PIN_IN = 0x0008     # P008 -> IRQ12
+DEPTH = 32          # MICROPY_SCHEDULER_DEPTH
+HIGH = 1            # MP_SCHED_PRIO_HIGH（两级）
+
+order = []
+state = {"n_low": 0, "n_high": 0, "fails": 0}
+
+
+def low(i):
+    order.append(("low", i))
+
+
+def high(i):
+    order.append(("high", i))
+
+
+def burst(p):
+    # 在 ISR 中执行：不能分配内存，只调用 schedule
+    for i in range(state["n_low"]):
+        try:
+            micropython.schedule(low, i)
+        except Exception:
+            state["fails"] += 1
+    for i in range(state["n_high"]):
+        try:
+            micropython.schedule(high, i, HIGH)
+        except Exception:
+            state["fails"] += 1
+
+
+def fire(out, n_low, n_high, expected):
+    state["n_low"], state["n_high"], state["fails"] = n_low, n_high, 0
+    del order[:]
+    out.off()
+    out.on()
+    t0 = utime.ticks_ms()
+    while len(order) < expected:
+        assert utime.ticks_diff(utime.ticks_ms(), t0) < 1000, "callbacks lost"
+    utime.sleep_ms(5)
+
+
+def test_priority(out):
+    print("priority order: 8 normal then 8 high scheduled from ISR")
+    micropython.schedule_stats(True)
+    fire(out, 8, 8, 16)
+    print("  order:", order)
+    assert [c for c, _ in order[:8]] == ["high"] * 8, "high priority did not run first"
+    assert [i for _, i in order[:8]] == list(range(8))
+    assert order[8:] == [("low", i) for i in range(8)]
+    ovf, peak = micropython.schedule_stats()
+    print("  overflows {} peak {}".format(ovf, peak))
+    assert ovf == 0 and peak >= 16
+
+
+def test_overflow(out):
+    print("overflow: {} normal + {} high from one ISR".format(DEPTH + 10, 4))
+    micropython.schedule_stats(True)
+    fire(out, DEPTH + 10, 4, DEPTH + 4)
+    ovf, peak = micropython.schedule_stats()
+    print("  ran {}, failed {}, overflows {}, peak {}".format(len(order), state["fails"], ovf, peak))
+    assert len(order) == DEPTH + 4
+    assert state["fails"] == 10 and ovf == 10, "overflow count mismatch"
+    # 普通队列满不影响高优先级队列
+    assert order[:4] == [("high", i) for i in range(4)]
+
+
+count = [0]
+
+
+def tick(_):
+    count[0] += 1
+
+
+def per_edge(p):
+    micropython.schedule(tick, None)
+
+
+def test_rate(out, pin_in):
+    n = 2000
+    print("{} edges, one callback per edge".format(n))
+    pin_in.irq(per_edge, Pin.IRQ_RISING, hard=True)
+    micropython.schedule_stats(True)
+    count[0] = 0
+    t0 = utime.ticks_us()
+    for _ in range(n):
+        out.on()
+        out.off()
+    dt = utime.ticks_diff(utime.ticks_us(), t0)
+    utime.sleep_ms(10)
+    ovf, peak = micropython.schedule_stats()
+    print("  {} callbacks in {} us, overflows {}, peak {}".format(count[0], dt, ovf, peak))
+    assert count[0] + ovf == n
+    assert ovf == 0, "callbacks dropped"
+
+
+def test_scheduler():
+    print("Test scheduler priorities / overflow counter")
+    print("=" * 40)
+    out = Pin(PIN_OUT, Pin.OUT, value=0)
+    pin_in = Pin(PIN_IN, Pin.IN)
+    pin_in.irq(burst, Pin.IRQ_RISING, hard=True)
+    try:
+        test_priority(out)
+        test_overflow(out)
+        test_rate(out, pin_in)
+    finally:
+        pin_in.irq(None)
+    print("\nscheduler test completed!")
+
+
+if __name__ == "__main__":
+    test_scheduler()
@@ -0,0 +1,90 @@
+"""
+测试 WFI 睡眠延时：sleep_ms 期间的空闲率、sleep_us 精度、睡眠中调度回调的响应
+WFI-based delays: idle ratio during sleep_ms, sleep_us accuracy, scheduler latency while sleeping
+
+检查三点：
+  1. sleep_ms(1000) 期间 CPU 在 WFI 中的周期占比（电流的近似指标），应 > 95%
+  2. sleep_us(1 ~ 2000) 的实测时长（ticks_cpu 周期），短延时误差应在 1us 以内
+  3. sleep_ms(1000) 期间 Timer(0) 每 10ms 触发一次软回调，
+     回调从 hard 中断到调度执行的延迟（trace 时间戳）不超过 1 个 SysTick 周期
+"""
+
+import machine
+import micropython
+import utime
+from machine import Timer
+
+HZ = machine.freq()
+
+
+def test_idle_ratio():
+    utime.sleep_ms(10)
+    machine.idle_stats(True)
+    utime.sleep_ms(1000)
+    idle, total = machine.idle_stats()
+    pct = 100 * idle / total
+    print("sleep_ms(1000): idle {} / {} cycles = {:.2f}%".format(idle, total, pct))
+    assert pct > 95, "idle ratio too low"
+
+
+def test_sleep_us():
+    print("sleep_us accuracy (cycles @ {} MHz):".format(HZ // 1000000))
+    worst = 0
+    for us in (1, 2, 5, 10, 50, 100, 500, 999, 1000, 2000):
+        best = None
+        for _ in range(5):
+            t0 = utime.ticks_cpu()
+            utime.sleep_us(us)
+            dt = utime.ticks_diff(utime.ticks_cpu(), t0)
+            if best is None or dt < best:
+                best = dt
+        err_ns = (best * 1000000000 // HZ) - us * 1000
+        print("  {:5d} us -> {:8d} cycles, error {:+d} ns".format(us, best, err_ns))
+        if us < 1000:
+            worst = max(worst, abs(err_ns))
+    # 包含 Python 调用 ticks_cpu / sleep_us 本身的开销，允许 1us
+    assert worst < 1000, "short sleep_us error too large"
+
+
+def test_sched_latency():
+    FIRE, RUN = 0x8001, 0x8002
+    count = [0]
+
+    def soft(t):
+        micropython.trace(RUN)
+        count[0] += 1
+
+    def hard(t):
+        micropython.trace(FIRE)
+        micropython.schedule(soft, t)
+
+    tim = Timer(0)
+    micropython.trace_start()
+    tim.init(mode=Timer.PERIODIC, freq=100, callback=hard, hard=True)
+    utime.sleep_ms(1000)
+    tim.deinit()
+    micropython.trace_stop()
+
+    dump = micropython.trace_dump()
+    u32 = lambda o: int.from_bytes(dump[o:o + 4], "little")
+    hz, n = u32(4), u32(8)
+    last_fire = None
+    worst = 0
+    for i in range(n):
+        o = 16 + 8 * i
+        t, ev = u32(o), u32(o + 4) & 0xFFFF
+        if ev == FIRE:
+            last_fire = t
+        elif ev == RUN and last_fire is not None:
+            worst = max(worst, (t - last_fire) & 0xFFFFFFFF)
+            last_fire = None
+    worst_us = worst * 1000000 // hz
+    print("scheduled callbacks during sleep_ms(1000): {}, worst latency {} us".format(count[0], worst_us))
+    assert 95 <= count[0] <= 101
+    assert worst_us < 1000, "callback waited for the next 1ms tick"
+
+
+test_idle_ratio()
+test_sleep_us()
+test_sched_latency()
+print("OK")
@@ -0,0 +1,69 @@
+"""
+测试 C 栈深度统计：micropython.stack_use() / micropython.stack_peak()
+C stack usage: current depth and high-water mark (painted stack), checked against recursion depth
+
+步骤：
+  1. stack_peak(True) 清零水位后，水位不小于当前深度 stack_use()
+  2. 递归 10 / 20 / 40 层，水位随递归深度单调增加，且不超过主栈大小
+  3. 递归过程中反复 gc.collect()：只保存在局部变量里的对象必须存活（寄存器 + 栈扫描）
+"""
+
+import gc
+import micropython
+
+MAIN_STACK_BYTES = 0x2000  # BSP_CFG_STACK_MAIN_BYTES
+
+
+def recurse(n):
+    if n == 0:
+        return micropython.stack_use()
+    return recurse(n - 1) + 0
+
+
+def hold(n):
+    # 每层一个只被局部变量引用的对象，到最深处做一次回收，返回后逐层校验
+    local = bytearray([n]) * 8
+    if n == 0:
+        gc.collect()
+        return 0
+    r = hold(n - 1)
+    assert local == bytearray([n]) * 8, "local object lost"
+    return r + 1
+
+
+def test_peak():
+    print("stack high-water mark")
+    now = micropython.stack_use()
+    micropython.stack_peak(True)
+    base = micropython.stack_peak()
+    print("  stack_use {}, peak after reset {}".format(now, base))
+    assert base >= now, "peak below current depth"
+
+    last = base
+    for depth in (10, 20, 40):
+        micropython.stack_peak(True)
+        use = recurse(depth)
+        peak = micropython.stack_peak()
+        print("  depth {:2d}: stack_use {}, peak {}".format(depth, use, peak))
+        assert peak >= use, "peak below recursion depth"
+        assert peak >= last, "peak not increasing with depth"
+        assert peak < MAIN_STACK_BYTES, "peak beyond main stack"
+        last = peak
+
+
+def test_roots():
+    print("objects held only by locals survive gc.collect()")
+    for _ in range(20):
+        assert hold(15) == 15
+    print("  ok")
+
+
+def test_stack():
+    print("Test C stack usage")
+    test_peak()
+    test_roots()
+    print("\nstack test completed!")
+
+
+if __name__ == "__main__":
+    test_stack()
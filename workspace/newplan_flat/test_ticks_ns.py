@@ -0,0 +1,87 @@
+"""
+测试 64 位时基：ticks_us / ticks_ns / monotonic_ns 的单调性、一致性和调用开销
+Test the 64-bit time base (ticks_ns / monotonic_ns) and per-call cost of ticks_us
+
+ticks_us 由 SysTick 推进的 64 位起点 + 本毫秒内 CYCCNT 增量的乘法-移位换算得到，没有 64 位除法。
+"""
+
+import utime
+from utime import ticks_diff
+
+N = 1000
+
+
+def cycles_per_call(fn):
+    t0 = utime.ticks_cpu()
+    for _ in range(N):
+        fn()
+    return ticks_diff(utime.ticks_cpu(), t0) // N
+
+
+def test_monotonic():
+    """密集采样不倒退，跨越毫秒边界也一样"""
+    print("monotonic: 20000 dense samples")
+    prev_us = utime.ticks_us()
+    prev_ns = utime.monotonic_ns()
+    for _ in range(20000):
+        us = utime.ticks_us()
+        ns = utime.monotonic_ns()
+        assert ticks_diff(us, prev_us) >= 0, "ticks_us went backwards"
+        assert ns >= prev_ns, "monotonic_ns went backwards"
+        prev_us, prev_ns = us, ns
+    print("  ok")
+
+
+def test_consistency():
+    """ticks_ms / ticks_us / monotonic_ns 在 200ms 内的增量一致"""
+    print("consistency over 200 ms")
+    ms0, us0, ns0 = utime.ticks_ms(), utime.ticks_us(), utime.monotonic_ns()
+    utime.sleep_ms(200)
+    ms1, us1, ns1 = utime.ticks_ms(), utime.ticks_us(), utime.monotonic_ns()
+    d_ms = ticks_diff(ms1, ms0)
+    d_us = ticks_diff(us1, us0)
+    d_ns = ns1 - ns0
+    print("  ms={} us={} ns={}".format(d_ms, d_us, d_ns))
+    assert abs(d_us - d_ms * 1000) <= 1000
+    assert abs(d_ns // 1000 - d_us) <= 5
+
+    # ticks_ns 是 monotonic_ns 的低 32 位，短间隔可直接用 ticks_diff
+    t0 = utime.ticks_ns()
+    utime.sleep_us(1000)
+    dt = ticks_diff(utime.ticks_ns(), t0)
+    print("  ticks_ns over sleep_us(1000): {} ns".format(dt))
+    assert 1000000 <= dt < 1200000
+
+
+def test_cpu_wrap():
+    """monotonic_ns 跨越 CYCCNT 回绕（约 8.95s）仍连续"""
+    print("CYCCNT wrap: sleeping 10 s")
+    ns0 = utime.monotonic_ns()
+    ms0 = utime.ticks_ms()
+    utime.sleep_ms(10000)
+    d_ns = utime.monotonic_ns() - ns0
+    d_ms = ticks_diff(utime.ticks_ms(), ms0)
+    print("  monotonic_ns delta={} ns, ticks_ms delta={} ms".format(d_ns, d_ms))
+    assert abs(d_ns // 1000000 - d_ms) <= 1
+
+
+def test_cost():
+    print("per-call cost (cycles, includes call overhead)")
+    loop = cycles_per_call(lambda: None)
+    for name in ("ticks_ms", "ticks_us", "ticks_cpu", "ticks_ns", "monotonic_ns"):
+        fn = getattr(utime, name)
+        print("  {:13s}: {}".format(name, cycles_per_call(fn) - loop))
+
+
+def test_ticks_ns():
+    print("Test 64-bit time base")
+    print("=" * 40)
+    test_monotonic()
+    test_consistency()
+    test_cost()
+    test_cpu_wrap()
+    print("\nticks_ns test completed!")
+
+
+if __name__ == "__main__":
+    test_ticks_ns()
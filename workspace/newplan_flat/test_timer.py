@@ -0,0 +1,150 @@
+"""
+测试 machine.Timer：GPT 硬件定时器和时间轮软件定时器
+GPT hardware timers and timing-wheel soft timers
+
+时间戳用事件追踪环记录（micropython.trace 写入 DWT 周期数，hard 回调里不分配内存）。
+
+检查四点：
+  1. 200 个单次软件定时器，延时跨越时间轮的各层（1 ~ 4097 ms），
+     每个都在 (D, D+1] ms 内触发（1kHz 节拍）
+  2. 100 个 10ms 周期软件定时器同时运行 1s，每个约触发 100 次
+  3. 硬件定时器 Timer(0, freq=1000, hard=True) 的周期抖动（基准测试，打印统计）
+  4. 超过 16 位计数范围的长周期（ISR 软件分频）
+"""
+
+import machine
+import micropython
+import utime
+from machine import Timer
+
+USER = 0x8000
+CREATE = 0x4000
+DELAYS = [1, 2, 3, 10, 62, 63, 64, 65, 100, 127, 128, 129, 500, 1000,
+          2047, 4095, 4096, 4097, 1500, 3000]
+
+
+def records():
+    """返回 [(cycles, id, arg)]，时间戳已展开为相对第一条记录的累计周期"""
+    dump = micropython.trace_dump()
+    u32 = lambda o: int.from_bytes(dump[o:o + 4], "little")
+    hz, n = u32(4), u32(8)
+    out = []
+    t_abs = 0
+    prev = None
+    for i in range(n):
+        o = 16 + 8 * i
+        t, w = u32(o), u32(o + 4)
+        if prev is not None:
+            t_abs += (t - prev) & 0xFFFFFFFF
+        prev = t
+        out.append((t_abs, w & 0xFFFF, w >> 16))
+    return hz, out
+
+
+def test_wheel_oneshot():
+    n = 200
+    print("{} one-shot soft timers, delays up to {} ms".format(n, max(DELAYS)))
+    delays = [DELAYS[i % len(DELAYS)] for i in range(n)]
+
+    def fired(t):
+        micropython.trace(idx[t])
+
+    timers = [Timer(-1) for _ in range(n)]
+    idx = {t: i for i, t in enumerate(timers)}
+    micropython.trace_start()
+    for i, t in enumerate(timers):
+        micropython.trace(CREATE | i)
+        t.init(mode=Timer.ONE_SHOT, period=delays[i], callback=fired, hard=True)
+    utime.sleep_ms(max(DELAYS) + 50)
+    micropython.trace_stop()
+
+    hz, recs = records()
+    created = {}
+    late = []
+    seen = 0
+    for t, ev, _ in recs:
+        if not ev & USER:
+            continue
+        i = ev & ~USER
+        if i & CREATE:
+            created[i & ~CREATE] = t
+            continue
+        seen += 1
+        us = (t - created[i]) * 1000000 // hz
+        if not (delays[i] * 1000 <= us <= delays[i] * 1000 + 1100):
+            late.append((i, delays[i], us))
+    print("  fired {} / {}, out of window: {}".format(seen, n, late[:5]))
+    assert seen == n and not late
+
+
+def test_wheel_periodic():
+    n = 100
+    print("{} periodic soft timers at 10 ms for 1 s".format(n))
+    counts = bytearray(n)
+
+    def tick(t):
+        counts[idx[t]] += 1
+
+    timers = [Timer(-1) for _ in range(n)]
+    idx = {t: i for i, t in enumerate(timers)}
+    for t in timers:
+        t.init(period=10, callback=tick, hard=True)
+    utime.sleep_ms(1000)
+    for t in timers:
+        t.deinit()
+    print("  min {} max {}".format(min(counts), max(counts)))
+    assert 98 <= min(counts) and max(counts) <= 101
+
+
+def test_hw_jitter():
+    n = 800     # 追踪环 1024 条，留出余量给其它事件
+    print("Timer(0, freq=1000, hard=True) jitter over {} periods".format(n))
+
+    def cb(t):
+        micropython.trace(1)
+
+    micropython.trace_start()
+    tim = Timer(0, freq=1000, callback=cb, hard=True)
+    utime.sleep_ms(n + 20)
+    tim.deinit()
+    micropython.trace_stop()
+
+    hz, recs = records()
+    ts = [t for t, ev, _ in recs if ev == USER | 1][:n]
+    period = hz // 1000
+    dev = [ts[i + 1] - ts[i] - period for i in range(len(ts) - 1)]
+    ns = lambda c: c * 1000000000 // hz
+    mean = sum(abs(d) for d in dev) // len(dev)
+    print("  {} periods, jitter min {} ns max {} ns mean |dev| {} ns".format(
+        len(dev), ns(min(dev)), ns(max(dev)), ns(mean)))
+    assert len(ts) >= n - 20
+    # 累计漂移为 0：硬件周期由 GPT 决定，抖动只来自中断延迟
+    assert abs(ts[-1] - ts[0] - period * (len(ts) - 1)) < period // 10
+
+
+def test_hw_long_period():
+    print("Timer(1, period=2000, ONE_SHOT): postscaled 16-bit GPT")
+    done = []
+    t0 = utime.ticks_ms()
+    tim = Timer(1, mode=Timer.ONE_SHOT, period=2000, callback=lambda t: done.append(utime.ticks_ms()))
+    while not done and utime.ticks_diff(utime.ticks_ms(), t0) < 3000:
+        utime.sleep_ms(10)
+    tim.deinit()
+    dt = utime.ticks_diff(done[0], t0) if done else -1
+    print("  fired after {} ms".format(dt))
+    assert 1995 <= dt <= 2030
+
+
+def test_timer():
+    print("Test machine.Timer")
+    print("=" * 40)
+    print(Timer(0), Timer(-1))
+    test_wheel_oneshot()
+    test_wheel_periodic()
+    test_hw_jitter()
+    test_hw_long_period()
+    print("\nTimer test completed!")
+
+
+if __name__ == "__main__":
+    test_timer()
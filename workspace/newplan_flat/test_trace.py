@@ -0,0 +1,109 @@
+"""
+测试事件追踪环：micropython.trace_start / trace_stop / trace_dump / trace
+Lock-free event trace ring (GC, scheduler, pyexec and ISR events with DWT timestamps)
+
+检查三点：
+  1. gc.collect()、micropython.schedule 回调和用户事件都被记录，时间戳单调
+  2. 环形缓冲区写满后保留最新的记录，并报告丢失数
+  3. 每条记录的开销（开启与关闭追踪时 trace() 调用耗时之差）小于 50 个周期
+
+导出给主机：
+  print(micropython.trace_dump().hex())
+然后在 PC 上把串口日志转换为 Chrome trace：
+  python3 tools/mptrace_chrome.py serial.log -o trace.json
+CYCCNT 时间戳 480MHz 下约 8.9s 回绕，相邻事件间隔需小于一半（约 4.4s）才能正确展开。
+"""
+
+import gc
+import machine
+import micropython
+import utime
+
+GC_BEGIN, GC_END = 1, 2
+SCHED_BEGIN, SCHED_END = 3, 4
+USER = 0x8000
+RING = 1024
+
+
+def records(dump):
+    assert dump[:4] == b"MPTR", "bad magic"
+    u32 = lambda o: int.from_bytes(dump[o:o + 4], "little")
+    hz, n, lost = u32(4), u32(8), u32(12)
+    recs = []
+    for i in range(n):
+        o = 16 + 8 * i
+        recs.append((u32(o), u32(o + 4) & 0xFFFF, u32(o + 4) >> 16))
+    return hz, lost, recs
+
+
+def test_events():
+    print("gc / scheduler / user events")
+    flag = []
+    micropython.trace_start()
+    micropython.trace(1, 100)
+    gc.collect()
+    micropython.schedule(flag.append, 1)
+    while not flag:
+        pass
+    micropython.trace(2, 200)
+    n = micropython.trace_stop()
+    hz, lost, recs = records(micropython.trace_dump())
+    ids = [r[1] for r in recs]
+    print("  {} records at {} Hz: {}".format(n, hz, [hex(i) for i in ids]))
+    assert hz == machine.freq() and lost == 0 and len(recs) == n
+    u1, u2 = ids.index(USER | 1), ids.index(USER | 2)
+    assert recs[u1][2] == 100 and recs[u2][2] == 200
+    # GC 与调度器事件成对出现，且位于两个用户事件之间
+    for b, e in ((GC_BEGIN, GC_END), (SCHED_BEGIN, SCHED_END)):
+        assert u1 < ids.index(b) < ids.index(e) < u2, "missing pair {}/{}".format(b, e)
+    t = [r[0] for r in recs]
+    assert all(((t[i + 1] - t[i]) & 0xFFFFFFFF) < 0x80000000 for i in range(len(t) - 1))
+    gc_cycles = recs[ids.index(GC_END)][0] - recs[ids.index(GC_BEGIN)][0]
+    print("  gc.collect(): {} us".format(gc_cycles * 1000000 // hz))
+
+
+def test_wrap():
+    print("ring overwrite")
+    micropython.trace_start()
+    for i in range(RING + 100):
+        micropython.trace(3, i)
+    micropython.trace_stop()
+    hz, lost, recs = records(micropython.trace_dump())
+    print("  kept {} lost {}".format(len(recs), lost))
+    assert len(recs) == RING and lost >= 100
+    args = [r[2] for r in recs if r[1] == USER | 3]
+    assert args[-1] == RING + 99 and args == list(range(args[0], args[0] + len(args)))
+
+
+def loop_us(n):
+    tr = micropython.trace
+    t0 = utime.ticks_us()
+    for _ in range(n):
+        tr(4)
+    return utime.ticks_diff(utime.ticks_us(), t0)
+
+
+def test_cost():
+    print("per-record cost")
+    n = 20000
+    micropython.trace_stop()
+    off = min(loop_us(n) for _ in range(3))
+    micropython.trace_start()
+    on = min(loop_us(n) for _ in range(3))
+    micropython.trace_stop()
+    cycles = (on - off) * (machine.freq() // 1000000) / n
+    print("  off {} us, on {} us -> {:.1f} cycles/record".format(off, on, cycles))
+    assert cycles < 50, "recording too slow"
+
+
+def test_trace():
+    print("Test micropython event trace ring")
+    print("=" * 40)
+    test_events()
+    test_wrap()
+    test_cost()
+    print("\ntrace test completed!")
+
+
+if __name__ == "__main__":
+    test_trace()
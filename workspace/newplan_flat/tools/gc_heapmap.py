@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""
+把 gc.heap_map() 快照画成堆碎片随时间变化的图
+Render gc.heap_map() snapshots as a heap fragmentation timeline (SVG, or text)
+
+输入可以是：
+  - 一个或多个原始二进制快照（以 b"MPHM" 开头）
+  - 串口日志文本，其中包含若干次 print(gc.heap_map().hex()) 打印的十六进制串（按出现顺序）
+
+每个快照画成一行：横轴为堆中的块（每个格子合并若干块，颜色越深占用越多），
+纵轴为时间（ticks_ms）；右侧标出空闲量、最大空闲段和碎片率（1 - 最大空闲段 / 空闲总量）。
+
+用法:
+    python3 tools/gc_heapmap.py serial.log -o heap.svg
+    python3 tools/gc_heapmap.py serial.log --text
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+MAGIC = b"MPHM"
+HEADER = struct.Struct("<4sIII")
+AREA = struct.Struct("<III")
+
+# 与 py/gc.c 中的 AT_xxx 保持一致
+AT_FREE, AT_HEAD, AT_TAIL, AT_MARK = 0, 1, 2, 3
+KIND_NAMES = {0: "fast", 1: "bulk"}
+
+
+def load(paths):
+    dumps = []
+    for path in paths:
+        with open(path, "rb") as f:
+            data = f.read()
+        if data.startswith(MAGIC):
+            dumps.append(data)
+            continue
+        # 文本日志："MPHM" 的十六进制形式开头的每一段十六进制串都是一个快照
+        for m in re.finditer(rb"4d50484d[0-9a-fA-F]*", data):
+            hexstr = m.group(0)
+            dumps.append(bytes.fromhex(hexstr[: len(hexstr) // 2 * 2].decode()))
+    if not dumps:
+        raise ValueError("no MPHM snapshot found")
+    return dumps
+
+
+def decode(data):
+    magic, ticks_ms, n_areas, block_bytes = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("bad magic")
+    o = HEADER.size
+    areas = []
+    for _ in range(n_areas):
+        addr, n_blocks, kind = AREA.unpack_from(data, o)
+        o += AREA.size
+        atb = data[o : o + n_blocks // 4]
+        if len(atb) < n_blocks // 4:
+            raise ValueError("truncated snapshot")
+        o += n_blocks // 4
+        kinds = bytearray(n_blocks)
+        for i in range(n_blocks):
+            kinds[i] = (atb[i // 4] >> (2 * (i & 3))) & 3
+        areas.append((addr, kind, kinds))
+    return ticks_ms, block_bytes, areas
+
+
+def stats(kinds):
+    free = objects = largest = runs = run = 0
+    for k in kinds:
+        if k == AT_FREE:
+            free += 1
+            run += 1
+        else:
+            if run:
+                runs += 1
+                largest = max(largest, run)
+            run = 0
+            if k != AT_TAIL:
+                objects += 1
+    if run:
+        runs += 1
+        largest = max(largest, run)
+    frag = 1.0 - largest / free if free else 0.0
+    return {"blocks": len(kinds), "free": free, "objects": objects, "largest": largest, "runs": runs, "frag": frag}
+
+
+def cells(kinds, width):
+    # 每个格子中占用块的比例
+    n = len(kinds)
+    out = []
+    for c in range(width):
+        a, b = c * n // width, max(c * n // width + 1, (c + 1) * n // width)
+        used = sum(1 for k in kinds[a:b] if k != AT_FREE)
+        out.append(used / (b - a))
+    return out
+
+
+def text_report(snapshots, width):
+    shade = " .:-=+*#%@"
+    t0 = snapshots[0][0]
+    for ticks, block_bytes, areas in snapshots:
+        for i, (addr, kind, kinds) in enumerate(areas):
+            s = stats(kinds)
+            row = "".join(shade[min(len(shade) - 1, int(f * (len(shade) - 1) + 0.999))] for f in cells(kinds, width))
+            print("{:8.3f}s area{} |{}| free {:6d} B, largest {:6d} B, {:4d} runs, frag {:5.1f}%".format(
+                (ticks - t0) / 1000, i, row, s["free"] * block_bytes, s["largest"] * block_bytes,
+                s["runs"], 100 * s["frag"]))
+
+
+def svg_report(snapshots, width, out):
+    row_h, gap, label_w, cell_w = 12, 2, 150, 1
+    n_areas = max(len(a) for _, _, a in snapshots)
+    area_gap = 20
+    total_w = label_w + n_areas * (width * cell_w + area_gap) + 320
+    total_h = 30 + len(snapshots) * (row_h + gap) + 10
+    w = out.write
+    w('<svg xmlns="http://www.w3.org/2000/svg" width="{}" height="{}" font-family="monospace" font-size="10">\n'.format(total_w, total_h))
+    w('<rect width="100%" height="100%" fill="white"/>\n')
+    t0 = snapshots[0][0]
+    first = snapshots[0][2]
+    for i, (addr, kind, kinds) in enumerate(first):
+        x = label_w + i * (width * cell_w + area_gap)
+        w('<text x="{}" y="14">area{} 0x{:08x} ({}, {} blocks)</text>\n'.format(
+            x, i, addr, KIND_NAMES.get(kind, kind), len(kinds)))
+    for r, (ticks, block_bytes, areas) in enumerate(snapshots):
+        y = 30 + r * (row_h + gap)
+        w('<text x="4" y="{}">{:.3f} s</text>\n'.format(y + row_h - 2, (ticks - t0) / 1000))
+        free = largest = 0
+        for i, (addr, kind, kinds) in enumerate(areas):
+            x0 = label_w + i * (width * cell_w + area_gap)
+            for c, f in enumerate(cells(kinds, width)):
+                # 空闲为白色，全部占用为深蓝
+                v = int(255 - f * 200)
+                w('<rect x="{}" y="{}" width="{}" height="{}" fill="rgb({},{},255)"/>\n'.format(
+                    x0 + c * cell_w, y, cell_w, row_h, v, v))
+            s = stats(kinds)
+            free += s["free"]
+            largest = max(largest, s["largest"])
+        frag = 1.0 - largest / free if free else 0.0
+        w('<text x="{}" y="{}">free {} B, largest {} B, frag {:.1f}%</text>\n'.format(
+            label_w + n_areas * (width * cell_w + area_gap), y + row_h - 2,
+            free * block_bytes, largest * block_bytes, 100 * frag))
+    w("</svg>\n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("dumps", nargs="+", help="binary snapshots or serial logs containing hex snapshots")
+    ap.add_argument("-o", "--output", help="output SVG file (default: stdout)")
+    ap.add_argument("-w", "--width", type=int, default=512, help="cells per area and row (default: 512)")
+    ap.add_argument("--text", action="store_true", help="print a text map per snapshot instead of SVG")
+    args = ap.parse_args()
+
+    snapshots = [decode(d) for d in load(args.dumps)]
+    if args.text:
+        text_report(snapshots, min(args.width, 64))
+    elif args.output:
+        with open(args.output, "w") as f:
+            svg_report(snapshots, args.width, f)
+    else:
+        svg_report(snapshots, args.width, sys.stdout)
+    last = [stats(kinds) for _, _, kinds in snapshots[-1][2]]
+    print("{} snapshots; last: {} objects, {} free blocks in {} runs".format(
+        len(snapshots), sum(s["objects"] for s in last), sum(s["free"] for s in last),
+        sum(s["runs"] for s in last)), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
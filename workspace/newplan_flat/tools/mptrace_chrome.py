@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""
+把 micropython.trace_dump() 的输出转换为 Chrome trace JSON
+Convert a micropython.trace_dump() ring dump into Chrome trace event JSON,
+viewable in chrome://tracing or https://ui.perfetto.dev
+
+输入可以是：
+  - 原始二进制（以 b"MPTR" 开头）
+  - 串口日志文本，其中包含 print(micropython.trace_dump().hex()) 打印的十六进制串
+
+用法:
+    python3 tools/mptrace_chrome.py dump.bin -o trace.json
+    python3 tools/mptrace_chrome.py serial.log > trace.json
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+MAGIC = b"MPTR"
+HEADER = struct.Struct("<4sIII")
+RECORD = struct.Struct("<IHH")
+
+# 与 py/mptrace.h 中的事件 id 保持一致
+# id -> (name, phase, track)；B/E 成对生成时间段，i 为瞬时事件
+EVENTS = {
+    1: ("gc", "B", "vm"),
+    2: ("gc", "E", "vm"),
+    3: ("sched", "B", "vm"),
+    4: ("sched", "E", "vm"),
+    5: ("pyexec", "B", "vm"),
+    6: ("pyexec", "E", "vm"),
+    7: ("uart_isr", "i", "isr"),
+    8: ("spi_isr", "i", "isr"),
+    9: ("pin_isr", "i", "isr"),
+}
+USER = 0x8000
+TRACKS = {"vm": 1, "isr": 2, "user": 3}
+
+
+def load(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data.startswith(MAGIC):
+        return data
+    # 文本日志：查找 "MPTR" 的十六进制形式开头的最长十六进制串
+    m = re.search(rb"4d505452[0-9a-fA-F]*", data)
+    if not m:
+        raise ValueError("no MPTR dump found in " + path)
+    hexstr = m.group(0)
+    return bytes.fromhex(hexstr[: len(hexstr) // 2 * 2].decode())
+
+
+def decode(data):
+    magic, hz, n, lost = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("bad magic")
+    if len(data) < HEADER.size + n * RECORD.size:
+        raise ValueError("truncated dump: {} of {} records".format(
+            (len(data) - HEADER.size) // RECORD.size, n))
+    records = []
+    t_prev = None
+    t_abs = 0
+    for i in range(n):
+        t, ev, arg = RECORD.unpack_from(data, HEADER.size + i * RECORD.size)
+        if t_prev is None:
+            t_abs = 0
+        else:
+            # 32 位时间戳回绕：按有符号差值展开（相邻事件间隔须小于 2^31 个计数）
+            d = (t - t_prev) & 0xFFFFFFFF
+            if d >= 0x80000000:
+                d -= 0x100000000
+            t_abs += d
+        t_prev = t
+        records.append((t_abs, ev, arg))
+    return hz, lost, records
+
+
+def to_chrome(hz, lost, records):
+    scale = 1e6 / hz     # Chrome trace 的 ts 单位为微秒
+    events = [
+        {"name": "process_name", "ph": "M", "pid": 1, "args": {"name": "MicroPython"}},
+    ]
+    for name, tid in TRACKS.items():
+        events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": tid, "args": {"name": name}})
+    depth = {}
+    for t, ev, arg in records:
+        ts = t * scale
+        if ev & USER:
+            name, ph, track = "user{}".format(ev & ~USER), "i", "user"
+        elif ev in EVENTS:
+            name, ph, track = EVENTS[ev]
+        else:
+            name, ph, track = "event{}".format(ev), "i", "vm"
+        if ph == "E":
+            # 环形缓冲区覆盖了开始事件时，丢弃孤立的结束事件
+            if depth.get(name, 0) == 0:
+                continue
+            depth[name] -= 1
+        elif ph == "B":
+            depth[name] = depth.get(name, 0) + 1
+        e = {"name": name, "ph": ph, "ts": ts, "pid": 1, "tid": TRACKS[track], "args": {"arg": arg}}
+        if ph == "i":
+            e["s"] = "t"
+        events.append(e)
+    return {
+        "traceEvents": events,
+        "displayTimeUnit": "ns",
+        "otherData": {"timestamp_hz": hz, "records": len(records), "lost": lost},
+    }
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("dump", help="binary dump or serial log containing the hex dump")
+    ap.add_argument("-o", "--output", help="output JSON file (default: stdout)")
+    args = ap.parse_args()
+
+    hz, lost, records = decode(load(args.dump))
+    trace = to_chrome(hz, lost, records)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+        sys.stdout.write("\n")
+    print("{} records, {} lost, {} Hz timestamps".format(len(records), lost, hz), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()